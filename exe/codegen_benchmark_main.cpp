@@ -0,0 +1,478 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+/**
+	@ file main file for benchmark application of solvers generated by LB-LMC solver code generator
+	@author Matthew Milton
+	@date 2020
+**/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdlib>
+#include <chrono>
+
+#include "codegen/netlist/Netlist.hpp"
+#include "codegen/netlist/NetlistLoader.hpp"
+#include "codegen/netlist/ComponentFactory.hpp"
+#include "codegen/netlist/NetlistRenumberer.hpp"
+#include "codegen/SolverEngineGenerator.hpp"
+#include "codegen/DecomposedSolverEngineGenerator.hpp"
+#include "codegen/InputWaveform.hpp"
+#include "codegen/ModelCache.hpp"
+
+#define STRINGFY(x) #x
+#define TOSTRING(x) STRINGFY(x)
+
+#ifndef LBLMC_INCLUDE_DIR
+#define LBLMC_INCLUDE_DIR include
+#endif
+
+const static std::string PROGRAM_TITLE =
+"ORTiS Solver C++ Code Generator Benchmark";
+
+const static std::string PROGRAM_VERSION =
+"Built: " __DATE__ " " __TIME__
+;
+
+const static std::string COPYRIGHT =
+"Copyright (c) 2019-2020 Matthew Milton and others";
+
+const static std::string HELP_TEXT =
+R"(
+
+Usage: benchmark [options] netlist_file
+
+Generates the solver of the netlist as the codegen tool does, along with a driver program
+<model_name>_benchmark.cpp that steps the solver, then compiles and runs the driver.  The driver
+reports the time per step, hardware event counts per step (instructions, cycles, cache misses,
+L1D read misses, branch misses) where Linux perf_event_open permits, and a checksum of the
+solutions to compare runs of different code generation options.
+
+OPTIONS:
+
+-steps n -- number of time steps to measure; default is 100000, after n/10 warm-up steps
+-dt t -- time step of the model in seconds, for the time of input waveforms; default is 50e-9
+-input name=waveform -- drive input signal name of the solver with a waveform, one of:
+		const:value
+		sine:amplitude:frequency[:offset[:phase_degrees]]
+		square:frequency[:duty_cycle[:high[:low]]]
+		step:time[:final[:initial]]
+		name[i]=waveform drives element i of an array input; inputs without waveform are zero/false
+-cxx compiler -- compiler of the driver; default is $CXX, or g++ if not set
+-cxxflags flags -- flags of the compiler, quoted; default is "-O3 -march=native -std=c++11"
+-include dir -- include directory of this library, for runtime headers; default is the one it was built with
+-no_run -- only generate the solver and driver, without compiling and running them
+-partition k -- benchmark the solver decomposed into k subsystem solvers, as codegen -partition
+-reference tol -- also generate the default monolithic solver <model_name>_reference.hpp; after the
+		measurement, the driver steps the solver and the reference through the same steps and inputs
+		and fails if their solutions of any step deviate by more than tol*(1 + max |x| of the reference)
+
+-block_sparse, -simd w, -tree k, -fused, -overlap, -factorize, -fixed w i, -source_bound s, -demand, -renumber ordering,
+-threads t, -cache, -no_optimize, -schedule
+		-- code generation options, same as codegen
+
+Example:
+
+benchmark -steps 1000000 -input sw[0]=square:20e3 -input sw[1]=square:20e3:0.5:0:1 model.netlist
+)";
+
+int main(int argc, char* argv[])
+{
+	using namespace lblmc;
+
+	if(argc <= 1)
+	{
+		std::cout << PROGRAM_TITLE + "\n" + COPYRIGHT + "\n" + PROGRAM_VERSION + HELP_TEXT << std::endl;
+		return 0;
+	}
+
+	std::string netlist_filename;
+	unsigned long num_steps = 100000;
+	double time_step = 50.0e-9;
+	std::vector<InputWaveform> waveforms;
+	std::string cxx = std::getenv("CXX") ? std::getenv("CXX") : "g++";
+	std::string cxxflags = "-O3 -march=native -std=c++11";
+	std::string include_dir = TOSTRING(LBLMC_INCLUDE_DIR);
+	bool run_enable = true;
+	bool renumber_enable = false;
+	NetlistRenumberer::Ordering renumber_ordering = NetlistRenumberer::NATURAL;
+	unsigned int num_threads = 0;
+	bool cache_enable = false;
+	unsigned int num_subsystems = 0;
+	double reference_tolerance = 0.0;
+
+	SolverEngineGeneratorParameters seg_params;
+	seg_params.codegen_solver_templated_function_enable = true;
+	seg_params.codegen_solver_templated_real_type_enable = true;
+
+	for(int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		const bool has_value = (i+1 < argc);
+
+		if(arg == std::string("-help") )
+		{
+			std::cout << PROGRAM_TITLE + "\n" + COPYRIGHT + "\n" + PROGRAM_VERSION + HELP_TEXT << std::endl;
+			return 0;
+		}
+		else if(arg == std::string("-steps") && has_value)
+		{
+			num_steps = std::strtoul(argv[++i], nullptr, 10);
+
+			if(num_steps == 0)
+			{
+				std::cout << "Switch -steps requires a positive number of steps.\n" << std::endl;
+				return 0;
+			}
+		}
+		else if(arg == std::string("-dt") && has_value)
+		{
+			time_step = std::atof(argv[++i]);
+
+			if(!(time_step > 0.0))
+			{
+				std::cout << "Switch -dt requires a positive time step.\n" << std::endl;
+				return 0;
+			}
+		}
+		else if(arg == std::string("-input") && has_value)
+		{
+			try
+			{
+				waveforms.push_back(InputWaveform::parse(argv[++i]));
+			}
+			catch(const std::exception& e)
+			{
+				std::cout << e.what() << "\n" << std::endl;
+				return 0;
+			}
+		}
+		else if(arg == std::string("-cxx") && has_value)
+		{
+			cxx = argv[++i];
+		}
+		else if(arg == std::string("-cxxflags") && has_value)
+		{
+			cxxflags = argv[++i];
+		}
+		else if(arg == std::string("-include") && has_value)
+		{
+			include_dir = argv[++i];
+		}
+		else if(arg == std::string("-no_run") )
+		{
+			run_enable = false;
+		}
+		else if(arg == std::string("-partition") && has_value)
+		{
+			const int k = std::atoi(argv[++i]);
+
+			if(k <= 0)
+			{
+				std::cout << "Switch -partition requires a positive number of subsystems.\n" << std::endl;
+				return 0;
+			}
+
+			num_subsystems = k;
+		}
+		else if(arg == std::string("-reference") && has_value)
+		{
+			reference_tolerance = std::atof(argv[++i]);
+
+			if(!(reference_tolerance > 0.0))
+			{
+				std::cout << "Switch -reference requires a positive tolerance.\n" << std::endl;
+				return 0;
+			}
+		}
+		else if(arg == std::string("-block_sparse") )
+		{
+			seg_params.inv_conduct_matrix_block_sparse_enable = true;
+		}
+		else if(arg == std::string("-simd") && has_value)
+		{
+			const int width = std::atoi(argv[++i]);
+
+			if(width != 2 && width != 4 && width != 8 && width != 16)
+			{
+				std::cout << "Switch -simd requires a vector width of 2, 4, 8, or 16.\n" << std::endl;
+				return 0;
+			}
+
+			seg_params.inv_conduct_matrix_simd_enable = true;
+			seg_params.inv_conduct_matrix_simd_width = width;
+		}
+		else if(arg == std::string("-tree") && has_value)
+		{
+			const int fan_in = std::atoi(argv[++i]);
+
+			if(fan_in < 2)
+			{
+				std::cout << "Switch -tree requires a fan-in of 2 or more.\n" << std::endl;
+				return 0;
+			}
+
+			seg_params.inv_conduct_matrix_tree_fan_in = fan_in;
+		}
+		else if(arg == std::string("-factorize") )
+		{
+			seg_params.conduct_matrix_factorization_enable = true;
+		}
+		else if(arg == std::string("-no_optimize") )
+		{
+			seg_params.codegen_ir_optimization_enable = false;
+		}
+		else if(arg == std::string("-schedule") )
+		{
+			seg_params.codegen_dataflow_schedule_enable = true;
+		}
+		else if(arg == std::string("-fused") )
+		{
+			seg_params.inv_conduct_matrix_fused_enable = true;
+		}
+		else if(arg == std::string("-overlap") )
+		{
+			seg_params.inv_conduct_matrix_overlapped_enable = true;
+		}
+		else if(arg == std::string("-demand") )
+		{
+			seg_params.solve_demand_driven_enable = true;
+		}
+		else if(arg == std::string("-renumber") && has_value)
+		{
+			try
+			{
+				renumber_ordering = NetlistRenumberer::getOrdering(argv[++i]);
+				renumber_enable = true;
+			}
+			catch(const std::exception& e)
+			{
+				std::cout << e.what() << "\n" << std::endl;
+				return 0;
+			}
+		}
+		else if(arg == std::string("-threads") && has_value)
+		{
+			const int threads = std::atoi(argv[++i]);
+
+			if(threads < 0)
+			{
+				std::cout << "Switch -threads requires a number of threads, or 0 for one per hardware thread.\n" << std::endl;
+				return 0;
+			}
+
+			num_threads = threads;
+		}
+		else if(arg == std::string("-cache"))
+		{
+			cache_enable = true;
+		}
+		else if(arg == std::string("-fixed") && i+2 < argc)
+		{
+			const int word_width = std::atoi(argv[i+1]);
+			const int int_width = std::atoi(argv[i+2]);
+
+			if(word_width < 2 || word_width > 64 || int_width < 1 || int_width >= word_width)
+			{
+				std::cout << "Switch -fixed requires a word width of 2 to 64 bits and an integral width less than it.\n" << std::endl;
+				return 0;
+			}
+
+			seg_params.fixed_point_enable = true;
+			seg_params.fixed_point_word_width = word_width;
+			seg_params.fixed_point_int_width = int_width;
+			seg_params.inv_conduct_matrix_rescale_enable = true;
+			i += 2;
+		}
+		else if(arg == std::string("-source_bound") && has_value)
+		{
+			seg_params.fixed_point_source_bound = std::atof(argv[++i]);
+		}
+		else if(arg[0] == '-' )
+		{
+			std::cout << "Unsupported or incomplete switch/option given: " << arg << "\n" << std::endl;
+			return 0;
+		}
+		else if(netlist_filename.empty())
+		{
+			netlist_filename = arg;
+		}
+		else
+		{
+			std::cout << "More than 1 netlist file is currently not supported.\n" << std::endl;
+			return 0;
+		}
+	}
+
+	if(netlist_filename.empty())
+	{
+		std::cout << "No netlist file given.\n" << std::endl;
+		return 0;
+	}
+
+	if(num_subsystems != 0 && (renumber_enable || seg_params.conduct_matrix_factorization_enable || seg_params.inv_conduct_matrix_overlapped_enable ||
+	                           seg_params.solve_demand_driven_enable || seg_params.codegen_dataflow_schedule_enable))
+	{
+		std::cout << "Switch -partition cannot be used with switches -renumber, -factorize, -overlap, -demand, or -schedule.\n" << std::endl;
+		return 0;
+	}
+
+	ComponentFactory factory;
+	factory.registerBuiltinComponentProducers();
+
+	NetlistLoader netlist_loader(num_threads);
+	Netlist netlist;
+
+	ModelCache model_cache;
+	const std::string cache_filename = ModelCache::getCacheFilename(netlist_filename);
+
+	const auto load_start = std::chrono::steady_clock::now();
+
+	try
+	{
+		if(cache_enable)
+		{
+			model_cache.loadFromFile(cache_filename);
+			netlist = std::move(netlist_loader.loadFromFile(netlist_filename, model_cache));
+		}
+		else
+		{
+			netlist = std::move(netlist_loader.loadFromFile(netlist_filename));
+		}
+
+		if(renumber_enable)
+		{
+			NetlistRenumberer renumberer;
+			netlist = renumberer.renumber(netlist, renumber_ordering);
+			seg_params.io_solution_netlist_nodes = renumberer.getNetlistNodes();
+		}
+	}
+	catch(std::exception& e)
+	{
+		std::cerr<<
+		"Error occurred during loading netlist:\n" <<
+		e.what() << std::endl;
+
+		return 1;
+	}
+
+	const auto load_end = std::chrono::steady_clock::now();
+
+	const std::string model_name = netlist.getModelName();
+	const std::string model_solver_src_filename = model_name + ".hpp";
+	const std::string driver_src_filename = model_name + "_benchmark.cpp";
+	const std::string driver_filename = model_name + "_benchmark";
+	const std::string reference_model_name = (reference_tolerance > 0.0) ? model_name + "_reference" : "";
+
+	std::vector< ComponentFactory::ComponentPtr > component_generators;
+
+	SolverEngineGenerator seg(model_name, netlist.getNumberOfNodes());
+	seg.setParameters(seg_params);
+
+	if(cache_enable)
+		seg.setModelCache(&model_cache);
+
+	try
+	{
+		component_generators = factory.produceComponents(netlist.getComponents(), num_threads);
+
+		seg.stampComponents(component_generators, num_threads);
+
+		if(num_subsystems != 0)
+		{
+			DecomposedSolverEngineGenerator dseg(netlist, factory, num_subsystems, seg_params);
+			dseg.generateCFunctionAndExport(model_solver_src_filename);
+		}
+		else
+		{
+			seg.generateCFunctionAndExport(model_solver_src_filename);
+		}
+
+		if(!reference_model_name.empty())
+		{
+			SolverEngineGeneratorParameters reference_params;
+			reference_params.codegen_solver_templated_function_enable = true;
+			reference_params.codegen_solver_templated_real_type_enable = true;
+			reference_params.io_solution_netlist_nodes = seg_params.io_solution_netlist_nodes;
+
+			SolverEngineGenerator reference_seg(reference_model_name, netlist.getNumberOfNodes());
+			reference_seg.setParameters(reference_params);
+			reference_seg.stampComponents(factory.produceComponents(netlist.getComponents(), num_threads), num_threads);
+			reference_seg.generateCFunctionAndExport(reference_model_name + ".hpp");
+		}
+
+		seg.generateBenchmarkDriverAndExport(driver_src_filename, model_solver_src_filename, waveforms, num_steps, time_step,
+		                                     reference_model_name, reference_tolerance, (num_subsystems != 0) ? 1 : 0);
+
+		if(cache_enable && model_cache.isModified())
+			model_cache.exportToFile(cache_filename);
+	}
+	catch(const std::exception& e)
+	{
+		std::cerr<<
+		"Error occurred during generation of solver code:\n" <<
+		e.what() << std::endl;
+
+		return 1;
+	}
+
+	const auto codegen_end = std::chrono::steady_clock::now();
+
+	std::cout
+	<< "netlist load ms " << std::chrono::duration<double, std::milli>(load_end-load_start).count() << "\n"
+	<< "codegen ms " << std::chrono::duration<double, std::milli>(codegen_end-load_end).count() << std::endl;
+
+	std::cout << "\'" << model_solver_src_filename << "\' and \'" << driver_src_filename << "\' generated from netlist \'"
+	          << netlist_filename << "\'" << std::endl;
+
+	if(!run_enable)
+		return 0;
+
+	const std::string compile_command = cxx + " " + cxxflags + " -I\"" + include_dir + "\" -o \"" + driver_filename + "\" \"" + driver_src_filename + "\"";
+
+	std::cout << compile_command << std::endl;
+
+	const auto compile_start = std::chrono::steady_clock::now();
+
+	if(std::system(compile_command.c_str()) != 0)
+	{
+		std::cerr << "Error occurred during compilation of benchmark driver" << std::endl;
+		return 1;
+	}
+
+	const auto compile_end = std::chrono::steady_clock::now();
+
+	std::cout << "compile ms " << std::chrono::duration<double, std::milli>(compile_end-compile_start).count() << std::endl;
+
+	const std::string run_command = "./\"" + driver_filename + "\" " + std::to_string(num_steps);
+
+	if(std::system(run_command.c_str()) != 0)
+	{
+		std::cerr << "Error occurred during run of benchmark driver" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
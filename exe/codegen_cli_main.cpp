@@ -28,12 +28,19 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 #include <iostream>
 #include <string>
+#include <vector>
 #include <utility>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
 
 #include "codegen/netlist/Netlist.hpp"
 #include "codegen/netlist/NetlistLoader.hpp"
 #include "codegen/netlist/ComponentFactory.hpp"
+#include "codegen/netlist/NetlistRenumberer.hpp"
 #include "codegen/SolverEngineGenerator.hpp"
+#include "codegen/DecomposedSolverEngineGenerator.hpp"
+#include "codegen/ModelCache.hpp"
 
 #define STRINGFY(x) #x
 #define TOSTRING(x) STRINGFY(x)
@@ -52,6 +59,7 @@ const static std::string PROGRAM_DESCRIPTION =
 R"(
 
 Simple usage: codegen netlist_file
+Usage with options: codegen [options] netlist_file
 
 For help, use codegen -help
 To learn more about this tool, use codegen -about
@@ -61,12 +69,60 @@ const static std::string HELP_TEXT =
 R"(
 
 Simple usage: codegen netlist_file
+Usage with options: codegen [options] netlist_file
 
 To see this help text, use codegen -help
 To learn more about this tool, use codegen -about
 
 For more detailed information, see the manual/user guide.
 
+OPTIONS:
+
+-block_sparse -- solve x = G^-1 * b per independent block of G^-1, sharing multiplications of equal coefficients
+-simd w -- solve x = G^-1 * b with explicit SIMD vector code over blocks of w solutions (w = 2, 4, 8, or 16;
+		such as 4 for AVX2 or 8 for AVX-512 with double); needs a GCC/Clang compatible compiler
+-tree k -- sum each row of x = G^-1 * b as a balanced tree of additions of k operands (k >= 2) instead of a
+		left to right chain, shortening its critical path from n-1 to ceil(log_k(n)) additions
+-fused -- solve each row of x = G^-1 * b directly from the component sources with the precomputed
+		operator G^-1 * S (S the source incidence) where it takes fewer multiplications, aggregating
+		only the elements of b read by the other rows
+-overlap -- fold the source contributions of each component into running sums of the solutions right after
+		its update, with the columns of the precomputed operator G^-1 * S, overlapping the solve with
+		the component updates instead of aggregating b and solving after all of them
+-no_optimize -- print the source aggregation and the dense solve x = G^-1 * b as generated, without folding
+		constants, propagating copies, and eliminating common subexpressions and dead stores
+-schedule -- order the component updates, output signal updates, and source aggregation of a time step by
+		their dependencies, each aggregation following the updates it reads, instead of in netlist order;
+		reports the critical path of a time step
+-factorize -- solve Gx = b by substitution with AMD ordered sparse LU/LDL^T factors of G instead of G^-1
+-demand -- compute only the solutions read by the components and output signals, aggregating only the
+		elements of b they read; the other elements of x_out are left unassigned
+-keep n1,n2,... -- with -demand, also compute the solutions of the listed nodes and output them in x_out
+-fixed w i -- solve x = G^-1 * b in fixed point of word width w and integral width i, with formats of
+		sources, coefficients, and solutions chosen by range analysis, in portable integer arithmetic;
+		writes <model_name>_fixed_point.txt with the formats, bounds, and error bounds per node
+-source_bound s -- with -fixed, bound the magnitude of each component source contribution by s for the
+		range analysis; default is the range of the fixed point words
+-batch -- also generate <model_name>_batch.hpp, a solver stepping N independent scenarios of the model
+		in one call with structure-of-arrays state, for Monte-Carlo runs and parameter/fault sweeps
+-reentrant -- also generate <model_name>_state.hpp, a solver keeping the state of each model instance
+		in a structure instead of static variables, for checkpointing and stepping instances from many threads
+-renumber ordering -- renumber the nodes before stamping by an ordering of the graph of G, one of rcm
+		(reverse Cuthill-McKee; least bandwidth, for contiguous blocks and accesses of x and b) or amd
+		(approximate minimum degree; least fill-in of factors); x_out stays indexed by netlist node
+-export_g -- also export the conductance matrix G to <model_name>_conductance.mtx, listing its nonzero
+		elements in Matrix Market coordinate format
+-partition k -- decompose the model into k subsystem solvers cut at series inductors and capacitors,
+		generated to <model_name>_sub<i>.hpp, with the top-level solver wiring them together
+-multicore -- with -partition, also generate <model_name>_multicore.hpp, a class stepping each subsystem
+		on its own pinned thread, one object alive at a time per instantiation (compile with include/runtime
+		of this library on the include path)
+-threads t -- parse the netlist lines, produce the components and generate their code on t threads; 0, the
+		default, uses one per hardware thread.  The generated code does not depend on t
+-cache -- keep the parsed netlist and the inverse of G in <netlist_file>.ir, a binary cache next to the
+		netlist, and reuse them while the netlist text and G are unchanged, such as when only source
+		parameters or code generation options change
+
 NETLIST FORMAT:
 
 Only 1 command, comment, or component listing can be placed in each line.
@@ -85,6 +141,10 @@ IdealVoltageSource component is not supported yet, though VoltageSource with ser
 
 	component listing:
 ComponentType label (param1, ..., paramP) {node_index1, ..., node_indexN} -- (mandatory) define a component
+ComponentType label (param1, ..., paramP) {node_index1, ..., node_indexN} [rate=k, phase=p] -- (optional) update a
+		component only every k time steps, on steps p, p+k, p+2k, ..., holding its source contributions in between;
+		phase defaults to 0.  Give its time step parameter as k*DT.  Suits slow components (large capacitors, cable
+		inductors) beside fast switching converters; staggering phases spreads their updates over the steps.
 
 	Example Netlist:
 
@@ -133,92 +193,605 @@ int main(int argc, char* argv[])
 		return 0;
 	}
 
-	if(argc == 2)
+	std::string netlist_filename;
+	bool block_sparse_enable = false;
+	bool factorization_enable = false;
+	bool fused_enable = false;
+	bool overlap_enable = false;
+	bool demand_enable = false;
+	std::vector<unsigned int> kept_nodes;
+	unsigned int simd_width = 0;
+	unsigned int tree_fan_in = 0;
+	unsigned int fixed_word_width = 0;
+	unsigned int fixed_int_width = 0;
+	double source_bound = 0.0;
+	unsigned int num_subsystems = 0;
+	bool multicore_enable = false;
+	bool batch_enable = false;
+	bool reentrant_enable = false;
+	bool export_g_enable = false;
+	bool renumber_enable = false;
+	NetlistRenumberer::Ordering renumber_ordering = NetlistRenumberer::NATURAL;
+	unsigned int num_threads = 0;
+	bool cache_enable = false;
+	bool optimize_enable = true;
+	bool schedule_enable = false;
+
+	for(int i = 1; i < argc; i++)
 	{
-		if(std::string(argv[1]) == std::string("-help") )
+		std::string arg(argv[i]);
+
+		if(arg == std::string("-help") )
 		{
 			std::cout << PROGRAM_TITLE + "\n" + COPYRIGHT + "\n" + PROGRAM_VERSION + HELP_TEXT << std::endl;
 			return 0;
 		}
-		else if(std::string(argv[1]) == std::string("-about") )
+		else if(arg == std::string("-about") )
 		{
 			std::cout << PROGRAM_TITLE + "\n" + COPYRIGHT + "\n" + PROGRAM_VERSION + ABOUT_TEXT << std::endl;
 			return 0;
 		}
-		else if(std::string(argv[1])[0] == '-' )
+		else if(arg == std::string("-block_sparse") )
 		{
-			std::cout << "Unsupported switch/option given.\n" << std::endl;
-			return 0;
+			block_sparse_enable = true;
 		}
-		else
+		else if(arg == std::string("-simd") )
 		{
-			std::string netlist_filename(argv[1]);
+			const int width = (i+1 < argc) ? std::atoi(argv[i+1]) : 0;
 
-			ComponentFactory factory;
-			factory.registerBuiltinComponentProducers();
+			if(width != 2 && width != 4 && width != 8 && width != 16)
+			{
+				std::cout << "Switch -simd requires a vector width of 2, 4, 8, or 16.\n" << std::endl;
+				return 0;
+			}
 
-			NetlistLoader netlist_loader;
-			Netlist netlist;
+			simd_width = width;
+			i++;
+		}
+		else if(arg == std::string("-tree") )
+		{
+			const int fan_in = (i+1 < argc) ? std::atoi(argv[i+1]) : 0;
 
-			try
+			if(fan_in < 2)
 			{
-				netlist = std::move(netlist_loader.loadFromFile(netlist_filename));
+				std::cout << "Switch -tree requires a fan-in of 2 or more.\n" << std::endl;
+				return 0;
 			}
-			catch(std::exception& e)
-			{
-				std::cerr<<
-				"Error occurred during loading netlist:\n" <<
-				e.what() << std::endl;
 
-				return 1;
+			tree_fan_in = fan_in;
+			i++;
+		}
+		else if(arg == std::string("-fixed") )
+		{
+			const int word_width = (i+2 < argc) ? std::atoi(argv[i+1]) : 0;
+			const int int_width = (i+2 < argc) ? std::atoi(argv[i+2]) : 0;
+
+			if(word_width < 2 || word_width > 64 || int_width < 1 || int_width >= word_width)
+			{
+				std::cout << "Switch -fixed requires a word width of 2 to 64 bits and an integral width less than it.\n" << std::endl;
+				return 0;
 			}
 
-			std::string model_name = netlist.getModelName();
-			std::string model_solver_src_filename = model_name+std::string(".hpp");
-			unsigned int num_solutions = netlist.getNumberOfNodes();
+			fixed_word_width = word_width;
+			fixed_int_width = int_width;
+			i += 2;
+		}
+		else if(arg == std::string("-source_bound") )
+		{
+			source_bound = (i+1 < argc) ? std::atof(argv[i+1]) : 0.0;
 
-			std::vector< ComponentFactory::ComponentPtr > component_generators;
+			if(!(source_bound > 0.0))
+			{
+				std::cout << "Switch -source_bound requires a positive bound.\n" << std::endl;
+				return 0;
+			}
 
-			SolverEngineGenerator seg(model_name, num_solutions);
-			SolverEngineGeneratorParameters seg_params;
-			seg_params.codegen_solver_templated_function_enable = true;
-			seg_params.codegen_solver_templated_real_type_enable = true;
-				seg.setParameters(seg_params);
+			i++;
+		}
+		else if(arg == std::string("-no_optimize") )
+		{
+			optimize_enable = false;
+		}
+		else if(arg == std::string("-schedule") )
+		{
+			schedule_enable = true;
+		}
+		else if(arg == std::string("-factorize") )
+		{
+			factorization_enable = true;
+		}
+		else if(arg == std::string("-fused") )
+		{
+			fused_enable = true;
+		}
+		else if(arg == std::string("-overlap") )
+		{
+			overlap_enable = true;
+		}
+		else if(arg == std::string("-demand") )
+		{
+			demand_enable = true;
+		}
+		else if(arg == std::string("-keep") )
+		{
+			std::stringstream nodes((i+1 < argc) ? argv[i+1] : "");
+			std::string node;
 
-			try
+			while(std::getline(nodes, node, ','))
 			{
-				for(const auto& comp_listing : netlist.getComponents())
+				if(std::atoi(node.c_str()) <= 0)
 				{
-					component_generators.push_back( factory.produceComponent(comp_listing) );
+					std::cout << "Switch -keep requires a comma separated list of positive node indices.\n" << std::endl;
+					return 0;
 				}
 
-				for(const auto& comp_gen_ptr : component_generators)
-				{
-					comp_gen_ptr->stampSystem(seg);
-				}
+				kept_nodes.push_back(std::atoi(node.c_str()));
+			}
 
-				seg.generateCFunctionAndExport(model_solver_src_filename);
+			if(kept_nodes.empty())
+			{
+				std::cout << "Switch -keep requires a comma separated list of positive node indices.\n" << std::endl;
+				return 0;
 			}
-			catch(const std::exception& e)
+
+			i++;
+		}
+		else if(arg == std::string("-partition") )
+		{
+			if(i+1 >= argc || std::atoi(argv[i+1]) <= 0)
 			{
-				std::cerr<<
-				"Error occurred during generation of solver code:\n" <<
-				e.what() << std::endl;
+				std::cout << "Switch -partition requires a positive number of subsystems.\n" << std::endl;
+				return 0;
+			}
+
+			num_subsystems = std::atoi(argv[++i]);
+		}
+		else if(arg == std::string("-batch") )
+		{
+			batch_enable = true;
+		}
+		else if(arg == std::string("-reentrant") )
+		{
+			reentrant_enable = true;
+		}
+		else if(arg == std::string("-multicore") )
+		{
+			multicore_enable = true;
+		}
+		else if(arg == std::string("-export_g") )
+		{
+			export_g_enable = true;
+		}
+		else if(arg == std::string("-renumber") )
+		{
+			const std::string name = (i+1 < argc) ? argv[i+1] : "";
 
-				return 1;
+			if(name != "rcm" && name != "amd")
+			{
+				std::cout << "Switch -renumber requires an ordering of rcm or amd.\n" << std::endl;
+				return 0;
 			}
 
-			std::cout <<"\'"<< model_solver_src_filename << "\' generated from netlist \'" << netlist_filename <<"\'"<< std::endl;
+			renumber_enable = true;
+			renumber_ordering = NetlistRenumberer::getOrdering(argv[++i]);
+		}
+		else if(arg == std::string("-threads") )
+		{
+			if(i+1 >= argc || std::atoi(argv[i+1]) < 0)
+			{
+				std::cout << "Switch -threads requires a number of threads, or 0 for one per hardware thread.\n" << std::endl;
+				return 0;
+			}
 
+			num_threads = std::atoi(argv[++i]);
+		}
+		else if(arg == std::string("-cache") )
+		{
+			cache_enable = true;
+		}
+		else if(arg[0] == '-' )
+		{
+			std::cout << "Unsupported switch/option given: " << arg << "\n" << std::endl;
+			return 0;
+		}
+		else if(netlist_filename.empty())
+		{
+			netlist_filename = arg;
+		}
+		else
+		{
+			std::cout << "More than 1 netlist file is currently not supported.\n" << std::endl;
 			return 0;
 		}
 	}
 
-	if(argc > 2)
+	if(netlist_filename.empty())
+	{
+		std::cout << "No netlist file given.\n" << std::endl;
+		return 0;
+	}
+
+	if(fixed_word_width != 0 && (factorization_enable || simd_width != 0))
+	{
+		std::cout << "Switch -fixed cannot be used with switches -factorize or -simd.\n" << std::endl;
+		return 0;
+	}
+
+	if(fused_enable && (factorization_enable || simd_width != 0 || fixed_word_width != 0 || block_sparse_enable))
+	{
+		std::cout << "Switch -fused cannot be used with switches -factorize, -simd, -fixed, or -block_sparse.\n" << std::endl;
+		return 0;
+	}
+
+	if(overlap_enable && (factorization_enable || simd_width != 0 || fixed_word_width != 0 || fused_enable || block_sparse_enable ||
+	                      tree_fan_in != 0 || num_subsystems != 0))
+	{
+		std::cout << "Switch -overlap cannot be used with switches -factorize, -simd, -fixed, -fused, -block_sparse, -tree, or -partition.\n" << std::endl;
+		return 0;
+	}
+
+	if(tree_fan_in != 0 && (factorization_enable || simd_width != 0 || fixed_word_width != 0 || fused_enable))
+	{
+		std::cout << "Switch -tree cannot be used with switches -factorize, -simd, -fixed, or -fused.\n" << std::endl;
+		return 0;
+	}
+
+	if(demand_enable && (factorization_enable || num_subsystems != 0))
+	{
+		std::cout << "Switch -demand cannot be used with switches -factorize or -partition.\n" << std::endl;
+		return 0;
+	}
+
+	if(!kept_nodes.empty() && !demand_enable)
+	{
+		std::cout << "Switch -keep requires switch -demand.\n" << std::endl;
+		return 0;
+	}
+
+	if(source_bound > 0.0 && fixed_word_width == 0)
+	{
+		std::cout << "Switch -source_bound requires switch -fixed.\n" << std::endl;
+		return 0;
+	}
+
+	if(multicore_enable && num_subsystems == 0)
+	{
+		std::cout << "Switch -multicore requires switch -partition.\n" << std::endl;
+		return 0;
+	}
+
+	if(batch_enable && num_subsystems != 0)
+	{
+		std::cout << "Switch -batch cannot be used with switch -partition.\n" << std::endl;
+		return 0;
+	}
+
+	if(reentrant_enable && num_subsystems != 0)
 	{
-		std::cout << "More than 1 argument is currently not supported.\n" << std::endl;
+		std::cout << "Switch -reentrant cannot be used with switch -partition.\n" << std::endl;
 		return 0;
 	}
 
+	if(export_g_enable && num_subsystems != 0)
+	{
+		std::cout << "Switch -export_g cannot be used with switch -partition.\n" << std::endl;
+		return 0;
+	}
+
+	if(renumber_enable && num_subsystems != 0)
+	{
+		std::cout << "Switch -renumber cannot be used with switch -partition.\n" << std::endl;
+		return 0;
+	}
+
+	if(schedule_enable && num_subsystems != 0)
+	{
+		std::cout << "Switch -schedule cannot be used with switch -partition.\n" << std::endl;
+		return 0;
+	}
+
+	ComponentFactory factory;
+	factory.registerBuiltinComponentProducers();
+
+	NetlistLoader netlist_loader(num_threads);
+	Netlist netlist;
+
+	ModelCache model_cache;
+	const std::string cache_filename = ModelCache::getCacheFilename(netlist_filename);
+
+	auto exportModelCache = [&]()
+	{
+		if(!cache_enable)
+			return;
+
+		if(!model_cache.isModified())
+		{
+			std::cout << "\'" << cache_filename << "\' cache reused" << std::endl;
+			return;
+		}
+
+		model_cache.exportToFile(cache_filename);
+		std::cout << "\'" << cache_filename << "\' cache updated" << std::endl;
+	};
+
+	try
+	{
+		if(cache_enable)
+		{
+			model_cache.loadFromFile(cache_filename);
+			netlist = std::move(netlist_loader.loadFromFile(netlist_filename, model_cache));
+		}
+		else
+		{
+			netlist = std::move(netlist_loader.loadFromFile(netlist_filename));
+		}
+	}
+	catch(std::exception& e)
+	{
+		std::cerr<<
+		"Error occurred during loading netlist:\n" <<
+		e.what() << std::endl;
+
+		return 1;
+	}
+
+	NetlistRenumberer renumberer;
+
+	if(renumber_enable)
+	{
+		netlist = renumberer.renumber(netlist, renumber_ordering);
+
+		std::cout << "nodes renumbered: bandwidth of G " << renumberer.getBandwidthAfter()
+		          << " (netlist numbering: " << renumberer.getBandwidthBefore() << ")" << std::endl;
+	}
+
+	std::string model_name = netlist.getModelName();
+	std::string model_solver_src_filename = model_name+std::string(".hpp");
+	unsigned int num_solutions = netlist.getNumberOfNodes();
+
+	std::vector< ComponentFactory::ComponentPtr > component_generators;
+
+	SolverEngineGenerator seg(model_name, num_solutions);
+	SolverEngineGeneratorParameters seg_params;
+	seg_params.codegen_solver_templated_function_enable = true;
+	seg_params.codegen_solver_templated_real_type_enable = true;
+	seg_params.inv_conduct_matrix_block_sparse_enable = block_sparse_enable;
+	seg_params.conduct_matrix_factorization_enable = factorization_enable;
+	seg_params.inv_conduct_matrix_fused_enable = fused_enable;
+	seg_params.inv_conduct_matrix_overlapped_enable = overlap_enable;
+	seg_params.solve_demand_driven_enable = demand_enable;
+	seg_params.solve_demanded_solutions = kept_nodes;
+	seg_params.io_solution_netlist_nodes = renumberer.getNetlistNodes();
+	seg_params.inv_conduct_matrix_simd_enable = (simd_width != 0);
+	seg_params.inv_conduct_matrix_simd_width = (simd_width != 0) ? simd_width : 4;
+	seg_params.inv_conduct_matrix_tree_fan_in = tree_fan_in;
+	seg_params.codegen_ir_optimization_enable = optimize_enable;
+	seg_params.codegen_dataflow_schedule_enable = schedule_enable;
+	if(fixed_word_width != 0)
+	{
+		seg_params.fixed_point_enable = true;
+		seg_params.fixed_point_word_width = fixed_word_width;
+		seg_params.fixed_point_int_width = fixed_int_width;
+		seg_params.fixed_point_source_bound = source_bound;
+		seg_params.inv_conduct_matrix_rescale_enable = true;
+	}
+	seg.setParameters(seg_params);
+
+	if(cache_enable)
+		seg.setModelCache(&model_cache);
+
+	if(num_subsystems != 0)
+	{
+		try
+		{
+			DecomposedSolverEngineGenerator dseg(netlist, factory, num_subsystems, seg_params);
+
+			dseg.generateCFunctionAndExport(model_solver_src_filename);
+
+			if(multicore_enable)
+			{
+				dseg.generateMulticoreSolverAndExport(model_name + "_multicore.hpp");
+				std::cout << "\'" << model_name << "_multicore.hpp\' generated with multicore solver class" << std::endl;
+			}
+
+			std::cout << "decomposed into " << dseg.getNumberOfSubsystems() << " subsystems with "
+			          << dseg.getNumberOfPorts() << " ports at " << dseg.getNumberOfCutComponents() << " cut components:" << std::endl;
+
+			for(unsigned int s = 0; s < dseg.getNumberOfSubsystems(); s++)
+			{
+				std::cout << "\t\'" << dseg.getSubsystemGenerator(s).getModelName() << ".hpp\' with "
+				          << dseg.getSubsystem(s).num_owned_nodes << " nodes and "
+				          << dseg.getSubsystem(s).ports.size() << " ports" << std::endl;
+			}
+
+			exportModelCache();
+		}
+		catch(const std::exception& e)
+		{
+			std::cerr<<
+			"Error occurred during generation of solver code:\n" <<
+			e.what() << std::endl;
+
+			return 1;
+		}
+
+		std::cout <<"\'"<< model_solver_src_filename << "\' generated from netlist \'" << netlist_filename <<"\'"<< std::endl;
+
+		return 0;
+	}
+
+	try
+	{
+		component_generators = factory.produceComponents(netlist.getComponents(), num_threads);
+
+		seg.stampComponents(component_generators, num_threads);
+
+		seg.generateCFunctionAndExport(model_solver_src_filename);
+
+		if(batch_enable)
+		{
+			seg.generateBatchedCCodeAndExport(model_name + "_batch.hpp");
+			std::cout << "\'" << model_name << "_batch.hpp\' generated with batched solver" << std::endl;
+		}
+
+		if(reentrant_enable)
+		{
+			seg.generateReentrantCCodeAndExport(model_name + "_state.hpp");
+			std::cout << "\'" << model_name << "_state.hpp\' generated with reentrant solver" << std::endl;
+		}
+
+		if(export_g_enable)
+		{
+			seg.getConductanceGenerator().exportAsMatrixMarket(model_name + "_conductance.mtx");
+			std::cout << "\'" << model_name << "_conductance.mtx\' exported with "
+			          << seg.getConductanceGenerator().getNumberOfNonzeros() << " nonzeros of conductance matrix" << std::endl;
+		}
+
+		if(!factorization_enable)
+		{
+			const SystemConductanceGenerator& invg_gen = seg.getInverseConductanceGenerator();
+
+			std::cout << "conductance matrix inverted with " << (invg_gen.isInvertedSymmetric() ? "LDL^T" : "LU")
+			          << ", condition number estimate " << invg_gen.getInverseConditionNumber() << std::endl;
+		}
+
+		if(factorization_enable)
+		{
+			SystemFactorizedSolverGenerator factor_gen(seg.getConductanceGenerator());
+
+			std::cout << "factorized solve (" << (factor_gen.isSymmetric() ? "LDL^T" : "LU") << "): "
+			          << factor_gen.countMultiplies() << " multiplies, "
+			          << factor_gen.getNumberOfConstants() << " constants (inverse: "
+			          << num_solutions*num_solutions << " constants)" << std::endl;
+		}
+		else if(simd_width != 0)
+		{
+			SystemConductanceGenerator invg_gen(seg.getInverseConductanceGenerator());
+
+			SystemSolverGenerator solver_gen(invg_gen.asArray(), num_solutions, seg.getSourceVectorGenerator().getNumSources());
+
+			std::cout << "SIMD solve: " << solver_gen.countSimdMultiplies(simd_width) << " vector multiplies of width "
+			          << simd_width << " (dense solve: " << solver_gen.countDenseMultiplies() << " multiplies)" << std::endl;
+		}
+		else if(fused_enable)
+		{
+			SystemConductanceGenerator invg_gen(seg.getInverseConductanceGenerator());
+
+			SystemFusedSolverGenerator fused_gen(invg_gen.asArray(), num_solutions, seg.getSourceVectorGenerator());
+
+			unsigned int num_aggregated = 0;
+			for(const bool used : fused_gen.getUsedSourceVectorElements())
+				num_aggregated += used;
+
+			std::cout << "fused solve: " << fused_gen.getNumberOfFusedRows() << " of " << num_solutions << " rows fused, "
+			          << fused_gen.countMultiplies() << " multiplies, " << num_aggregated << " elements of b aggregated (dense solve: "
+			          << fused_gen.countTwoStageMultiplies() << " multiplies)" << std::endl;
+		}
+		else if(overlap_enable)
+		{
+			SystemConductanceGenerator invg_gen(seg.getInverseConductanceGenerator());
+
+			SystemSolverGenerator solver_gen(invg_gen.asArray(), num_solutions, seg.getSourceVectorGenerator().getNumSources());
+			SystemOverlappedSolverGenerator overlapped_gen(invg_gen.asArray(), num_solutions, seg.getSourceVectorGenerator());
+
+			std::cout << "overlapped solve: " << overlapped_gen.countMultiplies() << " multiplies folded into the component updates (dense solve: "
+			          << solver_gen.countDenseMultiplies() << " multiplies)" << std::endl;
+		}
+		else if(block_sparse_enable)
+		{
+			SystemConductanceGenerator invg_gen(seg.getInverseConductanceGenerator());
+
+			SystemSolverGenerator solver_gen(invg_gen.asArray(), num_solutions, seg.getSourceVectorGenerator().getNumSources());
+
+			std::cout << "block sparse solve: " << solver_gen.findBlocks().size() << " blocks, "
+			          << solver_gen.countBlockSparseMultiplies() << " multiplies (dense solve: "
+			          << solver_gen.countDenseMultiplies() << " multiplies)" << std::endl;
+		}
+
+		if(optimize_enable && !factorization_enable && simd_width == 0 && fixed_word_width == 0 && !fused_enable && !overlap_enable &&
+		   !block_sparse_enable && tree_fan_in == 0)
+		{
+			CodeIR ir = seg.generateSolveCodeIR();
+
+			const std::size_t multiplies = ir.countMultiplies();
+			const std::size_t additions = ir.countAdditions();
+			const std::size_t assignments = ir.getNumberOfAssignments();
+
+			ir.optimize();
+
+			std::cout << "optimized solve: " << ir.countMultiplies() << " multiplies, " << ir.countAdditions() << " additions, "
+			          << ir.getNumberOfAssignments() << " assignments (as generated: " << multiplies << " multiplies, "
+			          << additions << " additions, " << assignments << " assignments)" << std::endl;
+		}
+
+		if(tree_fan_in != 0)
+		{
+			SystemConductanceGenerator invg_gen(seg.getInverseConductanceGenerator());
+
+			SystemSolverGenerator solver_gen(invg_gen.asArray(), num_solutions, seg.getSourceVectorGenerator().getNumSources());
+			solver_gen.setSolvedRows(seg.findDemandedSolutions());
+
+			const unsigned int chain_depth = solver_gen.countCriticalPathDepth(block_sparse_enable);
+			solver_gen.setAdderTree(tree_fan_in);
+
+			std::cout << "adder tree solve: fan-in " << tree_fan_in << ", critical path depth of "
+			          << solver_gen.countCriticalPathDepth(block_sparse_enable) << " operations (chains: "
+			          << chain_depth << " operations)" << std::endl;
+		}
+
+		if(schedule_enable)
+		{
+			const SolverStepDataflow dataflow = seg.analyzeStepDataflow();
+
+			std::cout << "dataflow schedule: " << dataflow.num_tasks << " tasks in " << dataflow.num_regions
+			          << " dataflow regions, critical path of " << dataflow.critical_path_length << " of "
+			          << dataflow.num_operations << " operations per time step (estimated)" << std::endl;
+		}
+
+		if(demand_enable)
+		{
+			const std::vector<bool> demanded = seg.findDemandedSolutions();
+
+			unsigned int num_demanded = 0;
+			for(const bool d : demanded)
+				num_demanded += d;
+
+			SystemConductanceGenerator invg_gen(seg.getInverseConductanceGenerator());
+
+			SystemSolverGenerator solver_gen(invg_gen.asArray(), num_solutions, seg.getSourceVectorGenerator().getNumSources());
+
+			const unsigned int all_multiplies = solver_gen.countDenseMultiplies();
+			solver_gen.setSolvedRows(demanded);
+
+			std::cout << "demand-driven solve: " << num_demanded << " of " << num_solutions << " solutions computed, "
+			          << solver_gen.countDenseMultiplies() << " dense multiplies (all solutions: "
+			          << all_multiplies << " multiplies)" << std::endl;
+		}
+
+		if(fixed_word_width != 0)
+		{
+			const std::string report = seg.generateFixedPointReport();
+			const std::string report_filename = model_name + "_fixed_point.txt";
+
+			std::ofstream report_file(report_filename.c_str(), std::ofstream::out | std::ofstream::trunc);
+			report_file << report;
+
+			std::cout << "fixed point solve: " << report.substr(report.rfind('\n', report.size()-2)+1)
+			          << "\'" << report_filename << "\' generated with formats and error bounds per node" << std::endl;
+		}
+
+		exportModelCache();
+	}
+	catch(const std::exception& e)
+	{
+		std::cerr<<
+		"Error occurred during generation of solver code:\n" <<
+		e.what() << std::endl;
+
+		return 1;
+	}
+
+	std::cout <<"\'"<< model_solver_src_filename << "\' generated from netlist \'" << netlist_filename <<"\'"<< std::endl;
+
 	return 0;
 }
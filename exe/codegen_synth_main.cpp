@@ -0,0 +1,224 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+/**
+	@ file main file for netlist synthesis application for scaling studies of LB-LMC solver code generator
+	@author Matthew Milton
+	@date 2020
+**/
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "codegen/netlist/Netlist.hpp"
+#include "codegen/netlist/NetlistSynthesizer.hpp"
+
+const static std::string PROGRAM_TITLE =
+"ORTiS Solver C++ Code Generator Netlist Synthesizer";
+
+const static std::string PROGRAM_VERSION =
+"Built: " __DATE__ " " __TIME__
+;
+
+const static std::string COPYRIGHT =
+"Copyright (c) 2019-2020 Matthew Milton and others";
+
+const static std::string HELP_TEXT =
+R"(
+
+Usage: synth [options] topology num_nodes
+
+Synthesizes a netlist of a system model of the given topology with approximately num_nodes nodes,
+for profiling code generation time, memory and generated solver step cost as functions of system size.
+The netlist is written to <model_name>.netlist.
+
+TOPOLOGIES:
+
+ladder -- source feeding a chain of series R-L line sections with shunt C and load R
+mesh -- nearly square grid of buses with R and L branches, shunt C and load R at each bus
+feeder -- radial distribution feeder tree of R-L laterals with shunt C and load R at each bus
+microgrid -- bipolar DC bus daisy-chained through R-L cables to 3-leg converters with AC side loads
+
+OPTIONS:
+
+-name model_name -- name of the model; default is <topology>_<num_nodes>
+-branching b -- laterals leaving each bus of a feeder; default is 2
+-dt t -- time step of the model in seconds; default is 50e-9
+-vs v -- voltage of the sources; default is 1000
+-rs r -- internal resistance of the sources; default is 0.01
+-rline r -- resistance of a line or cable segment; default is 0.01
+-lline l -- inductance of a line or cable segment; default is 1e-6
+-cshunt c -- shunt capacitance of a bus; default is 1e-6
+-rload r -- load resistance of a bus; default is 10
+-slow k -- update line inductors and shunt capacitors every k time steps, with their time step k*dt; default is 1
+
+Example:
+
+synth -branching 3 feeder 10000
+)";
+
+int main(int argc, char* argv[])
+{
+	using namespace lblmc;
+
+	if(argc <= 1)
+	{
+		std::cout << PROGRAM_TITLE + "\n" + COPYRIGHT + "\n" + PROGRAM_VERSION + HELP_TEXT << std::endl;
+		return 0;
+	}
+
+	std::string topology_name;
+	std::string model_name;
+	long num_nodes = 0;
+	unsigned int branching = 2;
+	NetlistSynthesizerParameters params;
+
+	for(int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		const bool has_value = (i+1 < argc);
+
+		if(arg == std::string("-help") )
+		{
+			std::cout << PROGRAM_TITLE + "\n" + COPYRIGHT + "\n" + PROGRAM_VERSION + HELP_TEXT << std::endl;
+			return 0;
+		}
+		else if(arg == std::string("-name") && has_value)
+		{
+			model_name = argv[++i];
+		}
+		else if(arg == std::string("-branching") && has_value)
+		{
+			const int b = std::atoi(argv[++i]);
+
+			if(b < 1)
+			{
+				std::cout << "Switch -branching requires 1 or more laterals.\n" << std::endl;
+				return 0;
+			}
+
+			branching = b;
+		}
+		else if(arg == std::string("-dt") && has_value)
+		{
+			params.dt = std::atof(argv[++i]);
+		}
+		else if(arg == std::string("-vs") && has_value)
+		{
+			params.source_voltage = std::atof(argv[++i]);
+		}
+		else if(arg == std::string("-rs") && has_value)
+		{
+			params.source_resistance = std::atof(argv[++i]);
+		}
+		else if(arg == std::string("-rline") && has_value)
+		{
+			params.line_resistance = std::atof(argv[++i]);
+		}
+		else if(arg == std::string("-lline") && has_value)
+		{
+			params.line_inductance = std::atof(argv[++i]);
+		}
+		else if(arg == std::string("-cshunt") && has_value)
+		{
+			params.shunt_capacitance = std::atof(argv[++i]);
+		}
+		else if(arg == std::string("-rload") && has_value)
+		{
+			params.load_resistance = std::atof(argv[++i]);
+		}
+		else if(arg == std::string("-slow") && has_value)
+		{
+			const int k = std::atoi(argv[++i]);
+
+			if(k < 1)
+			{
+				std::cout << "Switch -slow requires a rate divisor of 1 or more.\n" << std::endl;
+				return 0;
+			}
+
+			params.slow_rate_divisor = k;
+		}
+		else if(arg[0] == '-' )
+		{
+			std::cout << "Unsupported or incomplete switch/option given: " << arg << "\n" << std::endl;
+			return 0;
+		}
+		else if(topology_name.empty())
+		{
+			topology_name = arg;
+		}
+		else if(num_nodes == 0)
+		{
+			num_nodes = std::atol(arg.c_str());
+
+			if(num_nodes < 1)
+			{
+				std::cout << "Number of nodes must be 1 or greater.\n" << std::endl;
+				return 0;
+			}
+		}
+		else
+		{
+			std::cout << "Unexpected argument given: " << arg << "\n" << std::endl;
+			return 0;
+		}
+	}
+
+	if(topology_name.empty() || num_nodes == 0)
+	{
+		std::cout << "Topology and number of nodes must be given.\n" << std::endl;
+		return 0;
+	}
+
+	if(model_name.empty())
+		model_name = topology_name + "_" + std::to_string(num_nodes);
+
+	const std::string netlist_filename = model_name + ".netlist";
+
+	try
+	{
+		NetlistSynthesizer synth(params);
+
+		Netlist netlist = synth.synthesize(model_name, NetlistSynthesizer::getTopology(topology_name), num_nodes, branching);
+
+		const std::string comment =
+			"ORTiS LB-LMC solver codegen tools netlist of a synthesized " + topology_name + " system model\n\n" +
+			std::to_string(netlist.getNumberOfNodes()) + " nodes, " + std::to_string(netlist.getComponentsCount()) + " components";
+
+		NetlistSynthesizer::generateNetlistTextAndExport(netlist, netlist_filename, comment);
+
+		std::cout << "\'" << netlist_filename << "\' synthesized with "
+		          << netlist.getNumberOfNodes() << " nodes and " << netlist.getComponentsCount() << " components" << std::endl;
+	}
+	catch(const std::exception& e)
+	{
+		std::cerr<<
+		"Error occurred during synthesis of netlist:\n" <<
+		e.what() << std::endl;
+
+		return 1;
+	}
+
+	return 0;
+}
@@ -37,6 +37,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #define LBLMC_CODEGENDATATYPES_HPP
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 
 namespace lblmc
 {
@@ -53,6 +54,10 @@ typedef Eigen::Matrix<double,
 		Eigen::Dynamic, 1>
 VectorRMXd; ///< dynamically-allocated row-major double Eigen3 vector type
 
+typedef Eigen::SparseMatrix<double,
+		Eigen::RowMajor>
+SparseMatrixRMXd; ///< compressed row-major double Eigen3 sparse matrix type
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 } //namespace lblmc
@@ -0,0 +1,288 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef LBLMC_CODEIR_HPP
+#define LBLMC_CODEIR_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+#include "codegen/ArrayObject.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief intermediate representation of straight-line code of assignments of sums of products to
+	array elements, optimized before it is printed as C++ code
+
+	The source aggregation and the solve x = G^-1 * b of a solver are straight-line code whose
+	every statement assigns an element of an array a signed sum of terms, each an operand
+	optionally multiplied by a coefficient of a constant table:\n
+	<pre>
+	b[2] = b_components[4] - b_components[7];
+	x[3] = inv_g[2][0]*b[0] + inv_g[2][2]*b[2];
+	</pre>
+	Printed as text, nothing of such code can be optimized across statements.  CodeIR instead keeps
+	the statements over arrays described by ArrayObject, each array of a Storage telling whether
+	it is read, known, or assigned by the code and whether it is read after it, and optimizes them
+	with passes before printing:\n
+	<pre>
+	foldConstants()                 -- drops terms of zero coefficients or of operands assigned zero,
+	                                   and multiplications by coefficients of 1 or -1
+	propagateCopies()               -- replaces reads of elements assigned a copy of an operand, such
+	                                   as b[i] = -b_components[j], with the operand
+	eliminateCommonSubexpressions() -- replaces sums equal to, or the negation of, an earlier sum with
+	                                   its element, and computes products of the same coefficient value
+	                                   and operand repeated in several sums once into temporaries
+	eliminateDeadStores()           -- drops assignments of elements of TEMPORARY arrays that are not read
+	</pre>
+	The passes keep the order of the terms of each sum and only drop exact zeros and exact
+	multiplications by 1, so the optimized code computes the same values as the code it is made
+	from, up to the contraction of products and sums into fused multiply-adds by the compiler.
+
+	Each element is assigned at most once, and before it is read, so the value of an element is
+	the same wherever it is read and the passes need not track versions of the elements.
+**/
+class CodeIR
+{
+public:
+
+	/**
+		\brief storage of an array of the code
+	**/
+	enum class Storage : int
+	{
+		INPUT = 0,	///< read only, assigned before the code, such as the component source contributions
+		CONSTANT,	///< read only, of values known to the code generator, such as the inverse of G; used for coefficients
+		OUTPUT,		///< assigned by the code and read after it, such as the solutions
+		TEMPORARY	///< assigned by the code and read only by the code, such as the source vector
+	};
+
+	/**
+		\brief element of an array of the code
+	**/
+	struct Operand
+	{
+		unsigned int array; ///< index of the array, as returned by insertArray()
+		unsigned int index; ///< index of the element in the array, in row major order of its dimensions
+	};
+
+	/**
+		\brief signed term of a sum: an operand, optionally multiplied by a coefficient of a constant array
+	**/
+	struct Term
+	{
+		bool has_coefficient; ///< true if the operand is multiplied by coefficient
+		Operand coefficient;  ///< element of a CONSTANT array multiplying the operand; unused if has_coefficient is false
+		Operand operand;      ///< the operand
+		bool negative;        ///< true if the term is subtracted
+
+		/**
+			\brief makes a term of an operand
+		**/
+		static Term of(Operand operand, bool negative = false)
+		{
+			return Term{false, Operand{0, 0}, operand, negative};
+		}
+
+		/**
+			\brief makes a term of an operand multiplied by a coefficient
+		**/
+		static Term of(Operand coefficient, Operand operand, bool negative = false)
+		{
+			return Term{true, coefficient, operand, negative};
+		}
+	};
+
+private:
+
+	/**
+		\brief array of the code
+	**/
+	struct Array
+	{
+		ArrayObject object; ///< description of the array; its label and dimensions are used to print its elements
+		Storage storage;
+		std::size_t size; ///< number of elements
+		std::size_t offset; ///< number of elements of the arrays other than CONSTANT inserted before the array; unused for CONSTANT arrays
+		std::vector<double> values; ///< values of the elements of a CONSTANT array; empty otherwise
+	};
+
+	/**
+		\brief assignment of a sum of terms to an element
+	**/
+	struct Statement
+	{
+		Operand target; ///< assigned element
+		std::vector<Term> terms; ///< terms of the sum, in order of summation; empty assigns zero
+		unsigned int section; ///< array whose code the statement is printed with; that of target, or of the statement using a temporary
+	};
+
+	static const unsigned int TEMPORARIES = ~0u; ///< array index of the operands of the temporaries of common products
+
+	std::vector<Array> arrays;
+	std::vector<Statement> statements;
+	std::size_t num_elements; ///< number of elements of the arrays other than CONSTANT, which hold no operands
+
+	std::string temporary_type; ///< data type of the temporaries of common products
+	std::string temporary_prefix; ///< label of the temporaries of common products, followed by their number
+	unsigned int num_temporaries;
+
+	/**
+		\brief flags of the assigned elements of each array, empty for INPUT and CONSTANT arrays
+	**/
+	std::vector<std::vector<bool>> assigned;
+
+	const Array& getArray(unsigned int array, const char* caller) const;
+	void checkOperand(const Operand& operand, const char* caller) const;
+
+	bool isTemporary(const Operand& operand) const { return operand.array == TEMPORARIES; }
+	double getCoefficientValue(const Term& term) const;
+	std::string printElement(const Operand& operand) const;
+	std::string printStatement(const Statement& statement) const;
+
+	/**
+		\brief index of an operand among the elements of the arrays other than CONSTANT and the
+		temporaries, for tables over all operands
+	**/
+	std::size_t getElementIndex(const Operand& operand) const
+	{
+		return isTemporary(operand) ? num_elements + operand.index : arrays[operand.array].offset + operand.index;
+	}
+
+	std::size_t getNumberOfElements() const { return num_elements + num_temporaries; }
+
+public:
+
+	/**
+		\brief constructor of an empty code
+		\param temporary_type data type of the temporaries made for common products; default is real
+		\param temporary_prefix label of the temporaries made for common products, followed by their
+		number; must not be the start of another label of the code; default is cse
+	**/
+	explicit CodeIR(std::string temporary_type = "real", std::string temporary_prefix = "cse");
+
+	/**
+		\brief inserts an array the code reads or assigns
+		\param array description of the array, whose label and dimensions are used to print its elements
+		\param storage how the array is read and assigned by the code
+		\param values values of the elements of a CONSTANT array in row major order, copied; ignored
+		for the other storages
+		\return index of the array, to make its elements with getElement()
+		\throw invalid_argument if the array has no elements, or is CONSTANT without values
+	**/
+	unsigned int insertArray(const ArrayObject& array, Storage storage, const double* values = nullptr);
+
+	/**
+		\brief finds an array by label
+		\param label label of the array
+		\return index of the array
+		\throw out_of_range if the code has no array of the label
+	**/
+	unsigned int findArray(const std::string& label) const;
+
+	/**
+		\brief gets an element of a one dimensional array
+		\throw out_of_range if the array does not exist or i is out of its bounds
+	**/
+	Operand getElement(unsigned int array, unsigned int i) const;
+
+	/**
+		\brief gets an element of a two dimensional array
+		\throw out_of_range if the array does not exist or i or j is out of its bounds
+	**/
+	Operand getElement(unsigned int array, unsigned int i, unsigned int j) const;
+
+	/**
+		\brief appends an assignment of a sum of terms to an element
+		\param target the assigned element, of an OUTPUT or TEMPORARY array
+		\param terms terms of the sum, in order of summation; empty assigns zero
+		\throw invalid_argument if target is not of an OUTPUT or TEMPORARY array or is already
+		assigned, if a coefficient is not of a CONSTANT array, or if an operand is of a CONSTANT
+		array or is an element of an OUTPUT or TEMPORARY array not yet assigned
+	**/
+	void insertAssignment(Operand target, std::vector<Term> terms);
+
+	/**
+		\brief folds constant terms and coefficients
+		\return number of terms dropped or simplified
+	**/
+	unsigned int foldConstants();
+
+	/**
+		\brief propagates the operands of copies to the terms reading the copies
+		\return number of terms reading a copy replaced
+	**/
+	unsigned int propagateCopies();
+
+	/**
+		\brief eliminates sums equal to earlier sums, and products repeated in several sums
+		\return number of sums and products eliminated
+	**/
+	unsigned int eliminateCommonSubexpressions();
+
+	/**
+		\brief eliminates assignments of elements of TEMPORARY arrays, and temporaries, that are not read
+		\return number of assignments eliminated
+	**/
+	unsigned int eliminateDeadStores();
+
+	/**
+		\brief runs all of the passes, in an order where each uses what the others exposed
+	**/
+	void optimize();
+
+	/**
+		\return number of assignments of the code, including those of temporaries
+	**/
+	inline std::size_t getNumberOfAssignments() const { return statements.size(); }
+
+	/**
+		\return number of multiplications of the code
+	**/
+	std::size_t countMultiplies() const;
+
+	/**
+		\return number of additions and subtractions of the code, not counting negations
+	**/
+	std::size_t countAdditions() const;
+
+	/**
+		\brief generates C/C++ code of the assignments of elements of an array, and of the temporaries
+		they read that are not read by earlier assignments
+		\param array index of the array
+		\return string containing a line of code per assignment, in order
+	**/
+	std::string generateCInlineCode(unsigned int array) const;
+
+	/**
+		\brief generates C/C++ code of all of the assignments
+		\return string containing a line of code per assignment, in order
+	**/
+	std::string generateCInlineCode() const;
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_CODEIR_HPP
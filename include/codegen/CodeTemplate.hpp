@@ -0,0 +1,154 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef LBLMC_CODETEMPLATE_HPP
+#define LBLMC_CODETEMPLATE_HPP
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstddef>
+
+namespace lblmc
+{
+
+/**
+	\brief code template whose words are substituted in a single pass
+
+	A component generator specializes a template of code, such as its update body, for a component
+	instance by replacing words of the template: names of states and parameters get the component
+	name appended, and names of terminals and sources become solution vector and source
+	contribution indices.  Doing so with a chain of StringProcessor::replaceWordAll() rescans and
+	reallocates the whole code for every word, and makes the result depend on the order of the chain
+	when a replacement contains a word replaced later.
+
+	CodeTemplate instead splits its code into words once, on construction, and substitute() replaces
+	all of the words in one pass over the code, looking up each distinct word of the template once.
+	The cost of a substitution is linear in the size of the code, and every word is replaced by
+	what was given for it in the original code, regardless of the other substitutions.  Words are
+	delimited as by StringProcessor::isWordDelimiter().
+
+	A template does not change after construction, so the template of a component type is meant to
+	be constructed once, such as a function local static, and shared by all of its instances and
+	threads:\n
+	<pre>
+	static const CodeTemplate update_template(UPDATE_BODY_BASE_STRING);
+
+	CodeTemplate::Substitutions subs;
+	subs.set("NumType", "real");
+	subs.set("*bout", "b_components[3]");
+
+	return update_template.substitute(subs);
+	</pre>
+**/
+class CodeTemplate
+{
+public:
+
+	/**
+		\brief replacements of words of a code template, keyed by word
+	**/
+	class Substitutions
+	{
+	private:
+
+		friend class CodeTemplate;
+
+		/**
+			\brief replacement of a word preceded by a prefix of delimiters
+		**/
+		struct Replacement
+		{
+			std::string prefix; ///< word delimiters that must precede the word, as * of *bout; empty if none
+			std::string replacement; ///< string replacing the prefix and the word
+		};
+
+		std::unordered_map<std::string, std::vector<Replacement>> replacements; ///< replacements of each word, from longest to shortest prefix
+
+	public:
+
+		/**
+			\brief sets the replacement of a word
+
+			As with StringProcessor::replaceWordAll(), the word may be preceded by word delimiters
+			that are replaced with it, such as the dereference in *bout, in which case the
+			delimiters must follow a word delimiter or the start of the code.  Of replacements of
+			the same word, the one of the longest matching prefix is made.
+
+			\param word the word to replace, optionally preceded by word delimiters
+			\param replacement the replacement of the word
+			\throw invalid_argument if word has no word characters or has word delimiters after its
+			first word character
+		**/
+		void set(const std::string& word, std::string replacement);
+
+		/**
+			\return true if no replacements are set
+		**/
+		inline bool empty() const { return replacements.empty(); }
+	};
+
+private:
+
+	/**
+		\brief word of the code
+	**/
+	struct Word
+	{
+		std::size_t begin; ///< position of first character of the word in code
+		std::size_t end; ///< position after last character of the word in code
+		unsigned int id; ///< index of the word in vocabulary
+	};
+
+	std::string code; ///< code of the template
+	std::vector<Word> words; ///< words of code in order of position
+	std::vector<std::string> vocabulary; ///< distinct words of code
+
+public:
+
+	/**
+		\brief constructor of a template from its code
+		\param code code of the template
+	**/
+	explicit CodeTemplate(std::string code);
+
+	/**
+		\brief gets the code of the template
+	**/
+	inline const std::string& getCode() const { return code; }
+
+	/**
+		\brief gets the number of words of the template
+	**/
+	inline std::size_t getNumberOfWords() const { return words.size(); }
+
+	/**
+		\brief substitutes words of the code of the template
+		\param subs replacements of the words
+		\return copy of the code with its words replaced as set in subs
+	**/
+	std::string substitute(const Substitutions& subs) const;
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_CODETEMPLATE_HPP
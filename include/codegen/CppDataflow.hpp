@@ -0,0 +1,130 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef LBLMC_CPPDATAFLOW_HPP
+#define LBLMC_CPPDATAFLOW_HPP
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+
+namespace lblmc
+{
+
+/**
+	\brief dataflow analysis of generated C++ code: the names it reads and assigns, and the
+	length of its dependency chains
+
+	Generated solver code, such as the component update bodies, is plain C++ text.  CppDataflow
+	finds which names a piece of such code reads and assigns, so code generators can tell which
+	pieces depend on each other and may reorder the others, and estimates how many operations deep
+	the computations of a sequence of pieces are, so they can report the critical path of a time step.
+
+	Elements of arrays indexed by constants are names of their own, such as "x[3]" and
+	"b_components[12]"; an array indexed otherwise is accessed as a whole by its name, such as "x".
+	Pointer outputs assigned through * are accessed by the name of the pointer.
+
+	The depth of an operation is one more than the latest of its operands, where names not yet
+	assigned by the analyzed code are ready at depth 0.  Each binary, ternary, or compound
+	assignment operator and each function call counts as one operation; casts, negations, and
+	copies count as none.  Assignments under if, for, while, or switch are also not ready before
+	their conditions.  Loop bodies are analyzed once, so the depth of code with loops is
+	underestimated.  Only the code constructs emitted by the code generators are understood; others
+	are skipped over without error.
+**/
+class CppDataflow
+{
+public:
+
+	/**
+		\brief names read and assigned by code
+	**/
+	struct Access
+	{
+		std::set<std::string> reads;  ///< names read, including those read before being assigned
+		std::set<std::string> writes; ///< names assigned or declared
+	};
+
+private:
+
+	std::map<std::string, unsigned int> ready; ///< depth at which the last value assigned to each name is ready
+	unsigned int critical_path_length; ///< greatest depth of the analyzed code
+	unsigned int num_operations; ///< number of operations of the analyzed code
+
+public:
+
+	/**
+		\brief constructor of an analyzer of no code yet
+	**/
+	CppDataflow();
+
+	/**
+		\brief analyzes code following the code already analyzed
+
+		Names assigned by the code already analyzed are ready at the depths they were assigned at,
+		so analyzing the pieces of a sequence of code in turn finds the depths of the whole sequence.
+
+		\param code the code
+		\return names read and assigned by the code
+	**/
+	Access analyze(const std::string& code);
+
+	/**
+		\brief finds the names read and assigned by code
+		\param code the code
+		\return names read and assigned by the code
+	**/
+	static Access findAccess(const std::string& code);
+
+	/**
+		\brief finds the dependencies among a sequence of pieces of code
+
+		A piece depends on an earlier piece if one assigns a name the other reads or assigns, that
+		is, if swapping them could change what they compute.  Pieces that depend on none of the
+		pieces between them may be reordered freely.
+
+		\param accesses names read and assigned by each piece, in order of the sequence
+		\return indices of the earlier pieces each piece depends on, in ascending order
+	**/
+	static std::vector< std::vector<unsigned int> > findDependencies(const std::vector<Access>& accesses);
+
+	/**
+		\return number of operations on the longest dependency chain of the code analyzed so far
+	**/
+	inline unsigned int getCriticalPathLength() const { return critical_path_length; }
+
+	/**
+		\return number of operations of the code analyzed so far
+	**/
+	inline unsigned int getNumberOfOperations() const { return num_operations; }
+
+	/**
+		\brief forgets the code analyzed so far
+	**/
+	void reset();
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_CPPDATAFLOW_HPP
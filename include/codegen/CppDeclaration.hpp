@@ -0,0 +1,108 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef LBLMC_CPPDECLARATION_HPP
+#define LBLMC_CPPDECLARATION_HPP
+
+#include <string>
+#include <vector>
+
+namespace lblmc
+{
+
+/**
+	\brief parsed form of a single C++ object declaration found in generated code
+
+	Generated component code declares its fields, inputs, and outputs as plain C++ text, such as
+	"static real v_cap = 0.0", "bool sw_ctrl[3]", or "real* i_out".  CppDeclaration splits such
+	text into its parts so that code generators can re-declare the objects in another form, for
+	example as members of a state structure or as per-scenario arrays of a batched solver.
+
+	Only the simple declarations emitted by the code generators are supported: an optional
+	static and/or const qualifier, a type, an optional pointer or reference specifier, a name,
+	optional array dimensions, and an optional initializer.
+**/
+struct CppDeclaration
+{
+	bool is_static;      ///< true if declared static
+	bool is_const;       ///< true if declared const
+	std::string type;    ///< type of the object without qualifiers and specifiers, such as "real" or "unsigned int"
+	bool is_pointer;     ///< true if declared as pointer (*)
+	bool is_reference;   ///< true if declared as reference (&)
+	std::string name;    ///< name of the object
+	std::vector<std::string> dimensions; ///< array dimensions in order of declaration; empty for non-array objects
+	std::string initializer; ///< initializer following '=', without the '='; empty if not initialized
+
+	CppDeclaration() :
+		is_static(false),
+		is_const(false),
+		type(),
+		is_pointer(false),
+		is_reference(false),
+		name(),
+		dimensions(),
+		initializer()
+	{}
+
+	/**
+		\brief parses a single declaration
+		\param decl declaration text without the ending ';' or ','
+		\return parsed declaration
+		\throw std::invalid_argument if decl has no type or name
+	**/
+	static CppDeclaration parse(const std::string& decl);
+
+	/**
+		\brief splits code at its top-level delimiters into trimmed, non-empty items
+
+		Delimiters within brackets, parentheses, and braces are ignored, and // line comments are
+		discarded.  Use ',' for parameter lists and ';' for declaration statements.
+
+		\param code code text to split
+		\param delimiter character separating the items
+		\return items of the code in order
+	**/
+	static std::vector<std::string> split(const std::string& code, char delimiter);
+
+	/**
+		\brief parses all declarations in code
+		\param code code text of declarations separated by delimiter
+		\param delimiter character separating the declarations
+		\return parsed declarations in order
+	**/
+	static std::vector<CppDeclaration> parseAll(const std::string& code, char delimiter);
+
+	/**
+		\return array dimensions as declared, such as "[3][2]"; empty for non-array objects
+	**/
+	std::string generateArrayDimensions() const;
+
+	/**
+		\return initializer values listed in the initializer, such as {"0.0","1.0"} for "{ 0.0, 1.0 }"
+	**/
+	std::vector<std::string> getInitializerValues() const;
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_CPPDECLARATION_HPP
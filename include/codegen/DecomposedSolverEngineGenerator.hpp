@@ -0,0 +1,196 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef LBLMC_DECOMPOSEDSOLVERENGINEGENERATOR_HPP
+#define LBLMC_DECOMPOSEDSOLVERENGINEGENERATOR_HPP
+
+#include <string>
+#include <vector>
+
+#include "codegen/SolverEngineGenerator.hpp"
+#include "codegen/SubsystemSolverEngineGenerator.hpp"
+#include "codegen/netlist/Netlist.hpp"
+#include "codegen/netlist/NetlistPartitioner.hpp"
+#include "codegen/netlist/ComponentFactory.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief Generates a LB-LMC simulation solver engine decomposed into subsystem solvers
+
+	This generator partitions a system netlist with NetlistPartitioner, builds a
+	SubsystemSolverEngineGenerator for each subsystem, and exchanges the Norton port models of
+	the subsystems so that each subsystem sees the rest of the system at its ports.  It then
+	generates the subsystem solver functions along with a top-level solver function that wires
+	the port injections between the subsystems.
+
+	The top-level solver has the same parameter list as the solver generated by
+	SolverEngineGenerator for the whole netlist, so it can replace the monolithic solver.  All
+	port injections read by the subsystems in a time step are those computed in the previous time
+	step, so the subsystem solvers are independent within a time step and may be executed in any
+	order or in parallel.  As the subsystem solvers solve before they update their sources, the
+	solutions of the top-level solver lag those of the monolithic solver by one time step.  They
+	are otherwise the same, except where a subsystem couples ports to two other subsystems; the
+	coupling reaches each of them through the port injections, one time step late.
+
+	The subsystem solvers may also be run concurrently by a generated multicore solver class,
+	which steps each subsystem on its own thread pinned to its own core, moves the port injections
+	between the threads through lock-free SpscDoubleBuffer exchanges, and synchronizes the time
+	steps with a SpinBarrier.  See generateMulticoreSolverClass().
+
+	\note Output of the source vector and component sources (io_source_vector_output_enable and
+	io_component_sources_output_enable) is not supported and is disabled for the subsystems.
+
+	\see SubsystemSolverEngineGenerator
+	\see NetlistPartitioner
+**/
+class DecomposedSolverEngineGenerator
+{
+private:
+
+	std::string model_name; ///< name of the whole system model
+	unsigned int num_solutions; ///< number of solutions of the whole system
+	std::vector<NetlistPartitioner::Subsystem> subsystems; ///< subsystem netlists from partitioning
+	std::vector<SubsystemSolverEngineGenerator> subsystem_gens; ///< solver engine generators of the subsystems
+	std::vector<std::string> comp_outputs; ///< output signals of all components, in netlist order
+	std::vector<std::string> comp_inputs; ///< input signals of all components, in netlist order
+	unsigned int num_ports; ///< number of ports between subsystems
+	unsigned int num_cut_components; ///< number of decoupling components cut between subsystems
+	SolverEngineGeneratorParameters parameters;
+
+	/**
+		\brief generates template parameter list and arguments of generated code, such as "< int instance, typename real >" and "<instance, real>"
+	**/
+	void generateTemplateParameters(std::string& params, std::string& args) const;
+
+	/**
+		\brief exports the subsystem solvers to header files in the directory of the given file
+		\return directory path of the given file, including trailing separator
+	**/
+	std::string exportSubsystems(const std::string& filename, double zero_bound) const;
+
+public:
+
+	DecomposedSolverEngineGenerator() = delete;
+
+	/**
+		\brief parameter constructor; partitions the netlist and builds the subsystem generators
+		\param netlist netlist of the whole system model
+		\param factory factory that produces the component generators of the netlist
+		\param num_subsystems number of subsystems to decompose the system into
+		\param parameters settings for generation of the solvers
+		\param partitioner partitioner used to decompose the netlist
+		\throw error if the netlist cannot be partitioned or a subsystem's port models cannot be
+		computed
+	**/
+	DecomposedSolverEngineGenerator
+	(
+		const Netlist& netlist,
+		ComponentFactory& factory,
+		unsigned int num_subsystems,
+		const SolverEngineGeneratorParameters& parameters = SolverEngineGeneratorParameters(),
+		NetlistPartitioner partitioner = NetlistPartitioner()
+	);
+
+	inline const std::string& getModelName() const { return model_name; }
+
+	inline unsigned int getNumberOfSolutions() const { return num_solutions; }
+
+	inline unsigned int getNumberOfSubsystems() const { return subsystems.size(); }
+
+	inline unsigned int getNumberOfPorts() const { return num_ports; }
+
+	inline unsigned int getNumberOfCutComponents() const { return num_cut_components; }
+
+	inline const NetlistPartitioner::Subsystem& getSubsystem(unsigned int s) const { return subsystems.at(s); }
+
+	inline const SubsystemSolverEngineGenerator& getSubsystemGenerator(unsigned int s) const { return subsystem_gens.at(s); }
+
+	/**
+		\brief generates valid parameter (argument) list for the top-level solver function
+		\return string containing valid C++ parameter list, same as that of the monolithic solver
+	**/
+	std::string generateCFunctionParameterList() const;
+
+	/**
+		\brief generates the top-level solver function that calls the subsystem solvers and
+		exchanges their port injections
+		\return string containing valid C++ function definition
+	**/
+	std::string generateCFunction() const;
+
+	/**
+		\brief generates the subsystem solvers and the top-level solver, exporting them to header files
+
+		Each subsystem solver is exported to <subsystem model name>.hpp in the same directory as
+		the given file, and the top-level solver, which includes the subsystem headers, is exported
+		to the given file.
+
+		\param filename name of the header file for the top-level solver, including directory path and file extension
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+	**/
+	void generateCFunctionAndExport(std::string filename, double zero_bound = 1.0e-12) const;
+
+	/**
+		\brief generates a class that steps the subsystem solvers concurrently on separate cores
+
+		The generated class <model name>_multicore_solver holds the solutions and component signals
+		of the whole system as public members, named as the parameters of the top-level solver.
+		Its constructor starts a worker thread for each subsystem but the first, which is stepped
+		by the thread calling step() or run(); given a core index per subsystem, each thread is
+		pinned to its core.  Each subsystem's port injections are published through a
+		lblmc::SpscDoubleBuffer and read by the neighbouring subsystem in the next time step, and
+		all threads meet at a lblmc::SpinBarrier once per time step.
+
+		The subsystem solvers keep their state in static variables of their functions, one set per
+		instantiation of their templates, so the class holds the signals of the system but not the
+		state of its subsystems.  Its constructor throws logic_error while another object of the same
+		class (the same template arguments) is alive, so no two objects step the same state.  The
+		results of an object equal those of the top-level solver from generateCFunction() as long as
+		that solver is not called with the same template arguments meanwhile, since it steps the same
+		subsystem solvers; independent solvers use another instance template argument.
+
+		The generated code includes the headers in include/runtime of this library and needs C++11
+		threads; it is meant for multicore CPU targets, not for HLS.
+
+		\return string containing valid C++ class definition
+	**/
+	std::string generateMulticoreSolverClass() const;
+
+	/**
+		\brief generates the subsystem solvers and the multicore solver class, exporting them to header files
+
+		Each subsystem solver is exported to <subsystem model name>.hpp in the same directory as
+		the given file, and the multicore solver class, which includes the subsystem headers, is
+		exported to the given file.
+
+		\param filename name of the header file for the multicore solver class, including directory path and file extension
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+	**/
+	void generateMulticoreSolverAndExport(std::string filename, double zero_bound = 1.0e-12) const;
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_DECOMPOSEDSOLVERENGINEGENERATOR_HPP
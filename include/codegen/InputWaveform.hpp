@@ -0,0 +1,97 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef LBLMC_INPUTWAVEFORM_HPP
+#define LBLMC_INPUTWAVEFORM_HPP
+
+#include <string>
+
+namespace lblmc
+{
+
+/**
+	\brief waveform of an input signal of a solver, driven by generated simulation drivers
+
+	A waveform is specified in text as name=type:parameters, or name[i]=type:parameters for
+	element i of an array input, where the name is that of the input in the solver function and
+	time is in seconds:\n
+	<pre>
+	const:value
+	sine:amplitude:frequency[:offset[:phase_degrees]]
+	square:frequency[:duty_cycle[:high[:low]]]          (defaults: 0.5, 1, 0)
+	step:time[:final[:initial]]                         (defaults: 1, 0)
+	</pre>
+	For bool inputs, a value is true when it is nonzero, and a sine is true when positive.
+	A waveform of an array input without an element index drives all of its elements.
+**/
+struct InputWaveform
+{
+	/**
+		\brief shapes of waveforms
+	**/
+	enum Type
+	{
+		CONSTANT,
+		SINE,
+		SQUARE,
+		STEP
+	};
+
+	std::string name; ///< name of the input signal
+	int index;        ///< index of the driven element of an array input; -1 for all elements or non-array inputs
+	Type type;        ///< shape of the waveform
+	double amplitude; ///< amplitude of sine; value of constant; high value of square; final value of step
+	double frequency; ///< frequency in Hz of sine and square
+	double offset;    ///< offset of sine; low value of square; initial value of step
+	double phase;     ///< phase in degrees of sine; duty cycle of square; time in seconds of step
+
+	InputWaveform() :
+		name(),
+		index(-1),
+		type(CONSTANT),
+		amplitude(0.0),
+		frequency(0.0),
+		offset(0.0),
+		phase(0.0)
+	{}
+
+	/**
+		\brief parses a waveform from its text specification
+		\param spec text specification of the waveform, such as "v_ref=sine:100:60" or "sw[2]=square:20e3:0.25"
+		\return parsed waveform
+		\throw std::invalid_argument if spec is malformed
+	**/
+	static InputWaveform parse(const std::string& spec);
+
+	/**
+		\brief generates a C++ expression of the value of the waveform at a time
+		\param time_name name of the variable holding the time in seconds
+		\param is_bool true if the expression is for a bool input
+		\return C++ expression of the waveform; uses std::sin and std::fmod of <cmath>
+	**/
+	std::string generateCExpression(const std::string& time_name, bool is_bool) const;
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_INPUTWAVEFORM_HPP
@@ -0,0 +1,172 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef LBLMC_MODELCACHE_HPP
+#define LBLMC_MODELCACHE_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#include "codegen/CodeGenDataTypes.hpp"
+#include "codegen/SystemConductanceGenerator.hpp"
+#include "codegen/netlist/Netlist.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief binary cache of the products of the expensive stages of solver code generation of a model
+
+	Each run of the code generator parses the netlist text, resolving its constants, and inverts the
+	conductance matrix G of the model, whose cost grows with the cube of the number of nodes.  The
+	cache keeps the resolved netlist, keyed by a hash of the netlist text, and the inverses of G,
+	each keyed by G itself, so that a later run on the same model skips them:\n
+	<pre>
+	netlist -- loaded by NetlistLoader::loadFromFile(std::string, ModelCache&) in place of parsing
+	           the netlist text, if the text is unchanged
+	inverse -- taken by SolverEngineGenerator::getInverseConductanceGenerator() in place of
+	           inverting G, if the stamped G is identical to a cached one; a model whose changed
+	           parameters do not change G, such as source voltages, keeps its inverse
+	</pre>
+	The cache file is read through a memory mapping where the platform supports it.  It is
+	written in the byte order and number formats of the machine, with a header that is checked
+	on load; a cache file that is missing, of another format, or truncated is not an error, but
+	is loaded as an empty cache.  Only the inverses found or added since the cache was loaded are
+	exported, so the cache file holds the inverses of the last run instead of growing with every
+	change of G.
+
+	\note the cache is not synchronized, so it must not be used by generators running concurrently
+**/
+class ModelCache
+{
+private:
+
+	/**
+		\brief inverse of a conductance matrix, keyed by the matrix
+	**/
+	struct InverseEntry
+	{
+		std::uint64_t conductance_hash; ///< hash of the compressed arrays of conductance
+		SparseMatrixRMXd conductance; ///< compressed conductance matrix G that inverse is the inverse of
+		std::shared_ptr<const SystemConductanceGenerator> inverse; ///< inverse G^-1 of conductance
+		mutable bool used; ///< true if found or added since the cache was loaded
+	};
+
+	std::uint64_t netlist_hash; ///< hash of the netlist text that netlist_data was loaded from
+	std::string netlist_data; ///< netlist serialized as in the netlist section of a cache file; empty if none
+	std::vector<InverseEntry> inverses;
+	bool modified; ///< true if the netlist or an inverse was set since the cache was loaded or exported
+
+	static std::uint64_t hashConductance(const SparseMatrixRMXd& conductance);
+
+public:
+
+	/**
+		\brief default constructor of an empty cache
+	**/
+	ModelCache();
+
+	/**
+		\brief hashes data with 64 bit FNV-1a
+		\param data pointer to the data
+		\param size number of bytes of the data
+		\param seed hash of preceding data to continue from
+		\return the hash
+	**/
+	static std::uint64_t hash(const void* data, std::size_t size, std::uint64_t seed = 14695981039346656037ULL);
+
+	/**
+		\brief gets the filename of the cache file kept next to a netlist file
+		\param netlist_filename filename of the netlist, including directory path and file extension
+		\return filename of the cache file: the netlist filename with the extension .ir appended
+	**/
+	static std::string getCacheFilename(const std::string& netlist_filename);
+
+	/**
+		\brief loads the cache from a cache file, replacing the contents of the cache
+		\param filename name of the cache file, including directory path and file extension
+		\return true if the cache file was loaded; false if it is missing, of another format or
+		version, or truncated, in which case the cache is left empty
+	**/
+	bool loadFromFile(const std::string& filename);
+
+	/**
+		\brief exports the cache to a cache file
+		\param filename name of the cache file, including directory path and file extension
+		\throw runtime_error if the file cannot be written
+	**/
+	void exportToFile(const std::string& filename) const;
+
+	/**
+		\brief empties the cache
+	**/
+	void clear();
+
+	/**
+		\return true if exporting the cache would change its cache file: a netlist or an inverse
+		was added since the cache was loaded or exported, or a loaded inverse has not been used
+	**/
+	bool isModified() const;
+
+	/**
+		\brief keeps a netlist loaded from netlist text
+		\param text_hash hash() of the netlist text
+		\param netlist the netlist loaded from the text
+	**/
+	void setNetlist(std::uint64_t text_hash, const Netlist& netlist);
+
+	/**
+		\brief loads the netlist loaded from netlist text
+		\param text_hash hash() of the netlist text
+		\param netlist netlist to hold the cached netlist; unchanged if the cache has none of the text
+		\return true if the cache holds the netlist of netlist text of the given hash; false otherwise
+	**/
+	bool loadNetlist(std::uint64_t text_hash, Netlist& netlist) const;
+
+	/**
+		\brief keeps the inverse of a conductance matrix
+		\param conductance compressed conductance matrix G
+		\param inverse generator holding the inverse G^-1, as from SystemConductanceGenerator::invertSelf()
+		\throw invalid_argument if inverse is null or not of the dimension of G
+	**/
+	void addInverse(const SparseMatrixRMXd& conductance, std::shared_ptr<const SystemConductanceGenerator> inverse);
+
+	/**
+		\brief finds the inverse of a conductance matrix
+		\param conductance compressed conductance matrix G
+		\return the cached inverse of a conductance matrix identical to G, with the same structure and
+		values; nullptr if there is none
+	**/
+	std::shared_ptr<const SystemConductanceGenerator> findInverse(const SparseMatrixRMXd& conductance) const;
+
+	/**
+		\return number of inverses in the cache
+	**/
+	inline unsigned int getNumberOfInverses() const { return inverses.size(); }
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_MODELCACHE_HPP
@@ -0,0 +1,113 @@
+/*
+
+Copyright (C) 2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef LBLMC_PARALLELFOR_HPP
+#define LBLMC_PARALLELFOR_HPP
+
+#include <vector>
+#include <thread>
+#include <exception>
+#include <system_error>
+#include <algorithm>
+
+namespace lblmc
+{
+
+/**
+	\brief gets the number of blocks a range of items is split into by parallelFor()
+	\param num_items number of items in the range
+	\param num_threads requested number of threads; 0 requests one per hardware thread
+	\return number of blocks, at least 1 and at most num_items if there are items
+**/
+inline unsigned int getParallelForBlocks(unsigned int num_items, unsigned int num_threads)
+{
+	if(num_threads == 0)
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+	return std::max(1u, std::min(num_threads, num_items));
+}
+
+/**
+	\brief runs a function over contiguous blocks of a range of items concurrently
+
+	The range 0 to num_items-1 is split into getParallelForBlocks() blocks of nearly equal size, in
+	order, so block b covers items before those of block b+1.  Block 0 runs on the calling thread
+	and the others on their own threads, which are joined before returning.  Work that must merge
+	deterministically should write per-item or per-block results, and merge them in order after
+	this returns.
+
+	\param num_items number of items in the range
+	\param num_threads requested number of threads; 0 requests one per hardware thread
+	\param function callable as function(block, begin, end) over the items begin to end-1 of block
+	\throw the exception thrown by the function for the lowest block, after all blocks finish
+**/
+template<typename Function>
+void parallelFor(unsigned int num_items, unsigned int num_threads, Function function)
+{
+	const unsigned int num_blocks = getParallelForBlocks(num_items, num_threads);
+
+	auto begin = [=](unsigned int block) { return (unsigned int)( (unsigned long long)(num_items)*block/num_blocks ); };
+
+	std::vector<std::exception_ptr> errors(num_blocks);
+
+	auto run = [&](unsigned int block)
+	{
+		try
+		{
+			function(block, begin(block), begin(block+1));
+		}
+		catch(...)
+		{
+			errors[block] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(num_blocks-1);
+
+	for(unsigned int block = 1; block < num_blocks; block++)
+	{
+		try
+		{
+			workers.emplace_back(run, block);
+		}
+		catch(const std::system_error&)
+		{
+			run(block); // no thread available; run the block here instead
+		}
+	}
+
+	run(0);
+
+	for(auto& worker : workers)
+		worker.join();
+
+	for(const auto& error : errors)
+	{
+		if(error)
+			std::rethrow_exception(error);
+	}
+}
+
+} //namespace lblmc
+
+#endif // LBLMC_PARALLELFOR_HPP
@@ -25,14 +25,48 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 #include <string>
 #include <vector>
+#include <memory>
 
 #include "codegen/SystemConductanceGenerator.hpp"
 #include "codegen/SystemSourceVectorGenerator.hpp"
 #include "codegen/SystemSolverGenerator.hpp"
+#include "codegen/SystemFactorizedSolverGenerator.hpp"
+#include "codegen/SystemFixedPointSolverGenerator.hpp"
+#include "codegen/SystemFusedSolverGenerator.hpp"
+#include "codegen/SystemOverlappedSolverGenerator.hpp"
+#include "codegen/CppDeclaration.hpp"
+#include "codegen/CodeIR.hpp"
+#include "codegen/InputWaveform.hpp"
 
 namespace lblmc
 {
 
+class Component;
+class ModelCache;
+
+/**
+	\brief interface of the ports of a solver function synthesized with Xilinx HLS
+**/
+enum class XilinxHlsInterface : int
+{
+	DEFAULT = 0, ///< no interface directives; the ports get the default interfaces of the tool
+	AP_NONE,     ///< ports are wires without handshake; array ports are partitioned into a port per element
+	S_AXILITE,   ///< ports and the block level control are registers of one AXI4-Lite slave interface
+	AXIS         ///< ports are AXI4-Stream interfaces, without block level control; array ports are streamed in order of their elements
+};
+
+/**
+	\brief implementation of the arithmetic operations of a solver synthesized with Xilinx HLS
+**/
+enum class XilinxHlsOperatorImpl : int
+{
+	DEFAULT = 0, ///< no binding directives; the tool chooses the implementation
+	FABRIC,      ///< operations in logic fabric, without DSP slices
+	MEDDSP,      ///< floating point multiplications with some DSP slices, additions in fabric; DSP slices for fixed point
+	FULLDSP,     ///< operations with DSP slices
+	MAXDSP       ///< floating point multiplications with the most DSP slices, additions with DSP slices; DSP slices for fixed point
+};
+
 /**
 	\brief stores settings for the LB-LMC Simulation Engine Code Generator
 	\note as of March 02, 2019, only a subset of these settings are supported
@@ -42,6 +76,8 @@ struct SolverEngineGeneratorParameters
 	// General code generation settings
 	bool codegen_solver_templated_function_enable; ///< enables making the generated solver function into a template; default is false
 	bool codegen_solver_templated_real_type_enable; ///< enables templating the generated solver function's real type; depends on codegen_solver_templated_function_enable being true; default is false
+	bool codegen_ir_optimization_enable; ///< enable optimizing the source aggregation and the solve x=(G^-1)*b as a CodeIR, with constant folding, copy propagation, common subexpression elimination and dead store elimination, before printing them; applies to the dense solve summed as chains, not to the other solves; default is true
+	bool codegen_dataflow_schedule_enable; ///< enable ordering the component updates, output signal updates and source aggregation of a time step by their dependencies instead of in netlist order: interleaved, each aggregation following the updates it reads, for CPU targets, or grouped into regions of independent tasks for Xilinx HLS; default is false
 
 	// Xilinx (Vivado) High-Level Synthesis settings
 	bool         xilinx_hls_enable;       ///< enable code generation for Xilinx HL synthesis; default is false
@@ -50,42 +86,96 @@ struct SolverEngineGeneratorParameters
 	unsigned int xilinx_hls_latency_min;  ///< set minimum number of clock cycles to execute; default is 0
 	unsigned int xilinx_hls_latency_max;  ///< set maximum number of clock cycles to execute; default is 0
 	bool         xilinx_hls_inline;       ///< enable inlining of the generated code into top-level design; default is true
+	bool         xilinx_hls_tree_register_enable; ///< enable registering the partial sums of each level of the adder trees of the solve for pipelining; needs inv_conduct_matrix_tree_fan_in of 2 or more; default is false
+	bool         xilinx_hls_array_partition_enable; ///< enable partitioning x, b, b_components and the constant tables of the solve completely into registers, so all of their elements can be accessed in the same clock cycle; default is false
+	bool         xilinx_hls_pipeline_enable; ///< enable pipelining of the solver function; meant for a solver function that is not inlined; default is false
+	unsigned int xilinx_hls_pipeline_ii;  ///< set initiation interval in clock cycles of the pipelined solver function; default is 1
+	XilinxHlsOperatorImpl xilinx_hls_mac_impl; ///< set implementation of the multiplications, additions and subtractions of the source aggregation and the solve, for double real type, or ap_fixed with fixed point, each bound on the scalar temporary it is assigned to; default is DEFAULT
+	bool         xilinx_hls_bind_op_enable; ///< enable binding implementations of operations with BIND_OP directives of Vitis HLS instead of RESOURCE directives of Vivado HLS; default is false
+	XilinxHlsInterface xilinx_hls_interface; ///< set interface of the ports of the solver function; meant for a solver function synthesized as top function, not inlined; default is DEFAULT
 
 	// Fixed Point settings
 	bool         fixed_point_enable;         ///< enable use of fixed point for real numbers; default is false
 	unsigned int fixed_point_word_width;  ///< set word width in bits of the fixed point words; default is 64
 	unsigned int fixed_point_int_width;   ///< set the integral width in bits of the fixed point words; default is 32
+	double       fixed_point_source_bound; ///< set bound of the magnitude of each component source contribution, for range analysis of the fixed point solve; 0 bounds them by the range of the fixed point words; default is 0
 
 	// Inverted Conductance Matrix Optimizations
-	bool inv_conduct_matrix_rescale_enable;     ///< enable rescaling of the inverted conductance matrix by a power of 2 scalar; default is false
-	unsigned int inv_conduct_matrix_divider; ///< set power of 2 divider scalar for the inverted conductance matrix; default is 2
+	bool inv_conduct_matrix_rescale_enable;     ///< enable rescaling of the inverted conductance matrix by a power of 2 scalar; with fixed point, each row is rescaled by its own power of 2 found by range analysis instead of using one format for the whole matrix; default is false
+	unsigned int inv_conduct_matrix_divider; ///< set power of 2 divider scalar for the inverted conductance matrix; not used by fixed point, whose scalars are found by range analysis; default is 2
+	bool inv_conduct_matrix_block_sparse_enable; ///< enable solving x=(G^-1)*b per independent block of G^-1 with shared coefficients factored out; default is false
+	bool inv_conduct_matrix_simd_enable; ///< enable solving x=(G^-1)*b with explicit SIMD vector operations (GCC vector extensions) over blocks of rows; needs floating point real type; overrides block sparse solve; default is false
+	unsigned int inv_conduct_matrix_simd_width; ///< set number of real values per SIMD vector, a power of 2, such as 4 for double on AVX2 or 8 for double on AVX-512; default is 4
+	unsigned int inv_conduct_matrix_tree_fan_in; ///< set number of operands per addition of balanced adder trees summing each row of x=(G^-1)*b in the dense and block sparse solves, shortening the sequential additions of a row of n terms from n-1 to ceil(log_fan_in(n)); 0 or 1 sums rows as left to right chains; default is 0
+	bool inv_conduct_matrix_fused_enable; ///< enable solving each row of x=(G^-1)*b directly from the component sources with the precomputed operator G^-1*S, where S is the source incidence, when it takes fewer multiplications than aggregating b first; only elements of b read by the other rows are aggregated; overrides block sparse solve; default is false
+	bool inv_conduct_matrix_overlapped_enable; ///< enable overlapping the solve x=(G^-1)*b with the component updates: the source contributions assigned by each component update, or group of multirate updates, are folded into running sums of the solutions with the columns of the precomputed operator G^-1*S, where S is the source incidence, right after it, instead of aggregating b and solving after all of the updates; b is only aggregated if it is output; needs floating point real type; overrides block sparse, SIMD, adder tree and fused solves and CodeIR optimization; not applied to subsystem solvers of decomposed models; default is false
+
+	// Conductance Matrix Factorization settings
+	bool conduct_matrix_factorization_enable; ///< enable solving Gx=b by substitution with AMD ordered sparse LU or LDL^T factors of G instead of G^-1; overrides inverted conductance matrix optimizations; default is false
+
+	// Demand-Driven Solve settings
+	bool solve_demand_driven_enable; ///< enable computing only the rows of x=(G^-1)*b whose solutions are read by the component updates, the output signal updates, or are listed in solve_demanded_solutions; the other solutions and their elements of x_out are not assigned, and only the elements of b read by the computed rows are aggregated; not applied to the factorized solve or to subsystem solvers of decomposed models; default is false
+	std::vector<unsigned int> solve_demanded_solutions; ///< nodes (1 and up) whose solutions are computed and output through x_out[node-1] in addition to those read by the components, when solve_demand_driven_enable is true; default is empty
 
 	// Input/Output Signal settings
 	bool io_signal_output_enable;  ///< enable use of output signals; default is true
 	bool io_source_vector_output_enable; ///< enable output of the system source vector b; default is false
 	bool io_component_sources_output_enable; ///< enable output of component source values as array (*not* same as b); default is false
+	std::vector<unsigned int> io_solution_netlist_nodes; ///< netlist node (1 and up) of each solution, element i-1 for x[i], when the nodes were renumbered before stamping (see NetlistRenumberer); x_out, b_out, and solve_demanded_solutions are then indexed by netlist node so the renumbering is not seen by callers of the solver; empty if nodes are not renumbered; default is empty
 
 	SolverEngineGeneratorParameters() :
 		codegen_solver_templated_function_enable(false),
 		codegen_solver_templated_real_type_enable(false),
+		codegen_ir_optimization_enable(true),
+		codegen_dataflow_schedule_enable(false),
 		xilinx_hls_enable(false),
 		xilinx_hls_clock_period(50.0e-9),
 		xilinx_hls_latency_enable(false),
 		xilinx_hls_latency_min(0),
 		xilinx_hls_latency_max(0),
 		xilinx_hls_inline(true),
+		xilinx_hls_tree_register_enable(false),
+		xilinx_hls_array_partition_enable(false),
+		xilinx_hls_pipeline_enable(false),
+		xilinx_hls_pipeline_ii(1),
+		xilinx_hls_mac_impl(XilinxHlsOperatorImpl::DEFAULT),
+		xilinx_hls_bind_op_enable(false),
+		xilinx_hls_interface(XilinxHlsInterface::DEFAULT),
 		fixed_point_enable(false),
         fixed_point_word_width(64),
         fixed_point_int_width(32),
+		fixed_point_source_bound(0.0),
 		inv_conduct_matrix_rescale_enable(false),
         inv_conduct_matrix_divider(2),
+		inv_conduct_matrix_block_sparse_enable(false),
+		inv_conduct_matrix_simd_enable(false),
+		inv_conduct_matrix_simd_width(4),
+		inv_conduct_matrix_tree_fan_in(0),
+		inv_conduct_matrix_fused_enable(false),
+		inv_conduct_matrix_overlapped_enable(false),
+		conduct_matrix_factorization_enable(false),
+		solve_demand_driven_enable(false),
+		solve_demanded_solutions(),
 		io_signal_output_enable(true),
 		io_source_vector_output_enable(false),
-		io_component_sources_output_enable(false)
+		io_component_sources_output_enable(false),
+		io_solution_netlist_nodes()
 	{}
 
 };
 
+/**
+	\brief summary of the dataflow of a time step of a generated solver
+	\see SolverEngineGenerator::analyzeStepDataflow()
+**/
+struct SolverStepDataflow
+{
+	unsigned int num_tasks; ///< number of tasks scheduled before the solve: component updates, groups of multirate updates, output signal updates, and source aggregations
+	unsigned int num_regions; ///< number of dataflow regions, the levels of the dependency graph of the tasks, and one more for the solve
+	unsigned int critical_path_length; ///< estimated number of operations on the longest dependency chain of a time step
+	unsigned int num_operations; ///< estimated number of operations of a time step
+};
+
 /**
 	\brief Generates top-level code for a LB-LMC simulation solver engine
 
@@ -109,11 +199,161 @@ protected:
 	std::vector<std::string> comp_outputs;
 	std::vector<std::string> comp_outputs_update_bodies;
 	std::vector<std::string> comp_update_bodies;
-	SystemConductanceGenerator conductance_matrix_gen;
+	std::vector<unsigned int> comp_update_rate_divisors; ///< time steps between updates of each of comp_update_bodies
+	std::vector<unsigned int> comp_update_rate_phases; ///< time step, modulo its rate divisor, of the updates of each of comp_update_bodies
+	SystemConductanceGenerator conductance_matrix_gen; ///< stored sparse, so stamping scales with the nonzeros of G
 	SystemSourceVectorGenerator source_vector_gen;
 
 	SolverEngineGeneratorParameters parameters;
 
+	mutable SparseMatrixRMXd inverse_source; ///< conductance matrix that inverse_cache is the inverse of
+	mutable std::shared_ptr<const SystemConductanceGenerator> inverse_cache; ///< inverse of G reused while G is unchanged
+	ModelCache* model_cache; ///< persistent cache of inverses of G looked up before inverting G; not owned, null if none
+
+	/**
+		\brief generates code of the constants and operations that solve the system x = G^-1 * b
+		\param solve_constants_code string to hold the definitions of the constant tables used by the solve
+		\param aggregation_code string to hold the aggregation of the elements of b read by the solve, and all of b if it is output
+		\param solve_code string to hold the solve operations
+		\param source_fold_codes vector to hold the code of the overlapped solve following each task of
+		generateComponentUpdateTasks(), with inv_conduct_matrix_overlapped_enable; emptied otherwise
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+	**/
+	void generateSolveCode(std::string& solve_constants_code, std::string& aggregation_code, std::string& solve_code,
+	                       std::vector<std::string>& source_fold_codes, double zero_bound) const;
+
+	/**
+		\brief finds the sources folded by the overlapped solve after each task of generateComponentUpdateTasks()
+
+		A source is folded after the last task assigning it, or, if a task or output signal update
+		body indexes b_components other than by constant, not before the solve.
+
+		\return sources folded after each task; sources in none are folded by the solve
+	**/
+	std::vector< std::vector<unsigned int> > findSourceFolds() const;
+
+	/**
+		\brief finds the solution of each netlist node from io_solution_netlist_nodes
+		\return solution index (1 and up) of each netlist node, element n-1 for node n; identity if
+		nodes are not renumbered
+		\throw invalid_argument if io_solution_netlist_nodes is not a permutation of the nodes
+	**/
+	std::vector<unsigned int> findNetlistNodeSolutions() const;
+
+	/**
+		\brief analyzes the ranges of the solve x = G^-1 * b for fixed point code with the fixed point settings
+		\param invg the inverted conductance matrix G^-1 in row major order
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+		\return generator of the fixed point solve; ap_fixed code if Xilinx HLS is enabled, otherwise portable integer code
+	**/
+	SystemFixedPointSolverGenerator createFixedPointSolverGenerator(const double* invg, double zero_bound) const;
+
+	/**
+		\brief generates definition of the real type for generated code whose real type is not templated,
+		the headers needed by fixed point code, and the register function of registered adder trees
+		\return string containing typedef of real, includes, and definitions, or empty string if none are needed
+	**/
+	std::string generateRealTypeDefinition() const;
+
+	/**
+		\brief generates the Xilinx HLS directives of the solver function: the clock period comment,
+		inlining, latency, pipelining, and the interfaces of the ports of generateCFunctionParameterList()
+		\return string containing the directives, placed at the start of the body of the solver function
+	**/
+	std::string generateHlsFunctionDirectives() const;
+
+	/**
+		\brief generates the Xilinx HLS directives of the arrays of the solver: complete partitioning
+		of the arrays declared by declarations_code
+		\param declarations_code code declaring the solutions, the source vectors, and the constant
+		tables of the solve, after which the directives are placed
+		\return string containing the directives, or empty string if none are enabled
+	**/
+	std::string generateHlsArrayDirectives(const std::string& declarations_code) const;
+
+	/**
+		\brief binds the implementations of the operations of the statements of code, such as the source
+		aggregation and the solve, with Xilinx HLS directives per xilinx_hls_mac_impl
+
+		Each statement assigning products or sums, such as x[r] = a*b + c*d, is emitted through scalar
+		temporaries holding each of its products and sums, and each temporary is bound with a
+		directive per operation it is assigned, since binding directives apply to the scalar variables
+		operations are assigned to and not to arrays.
+		\param code code of statements, one per line
+		\return the code with the temporaries and directives, or code as is if no binding is enabled
+	**/
+	std::string generateHlsBoundCode(const std::string& code) const;
+
+	/**
+		\brief generates declarations of the fields of multirate component updates: a step counter
+		for each rate divisor above 1, and a held copy of each source contribution of the components
+		updated at those rates
+		\return string containing the declarations, or empty string if all components are updated every time step
+		\throw invalid_argument if the update body of such a component does not index b_components by constants
+	**/
+	std::string generateMultirateFieldsCode() const;
+
+	/**
+		\brief generates code of each task of the component updates of a time step
+
+		Components updated every time step are updated in the order they were inserted, each in a
+		task of its own.  The others are updated in groups of the same rate divisor and phase, each
+		a task under a test of the step counter of its divisor, whose source contributions are
+		restored from held copies on the time steps they are not updated.  The step counters are
+		advanced by the last task.
+
+		\param source_fold_codes code appended to each task, the folds of the overlapped solve from
+		generateSolveCode(); empty appends none
+		\return code of each task in order
+	**/
+	std::vector<std::string> generateComponentUpdateTasks(const std::vector<std::string>& source_fold_codes = std::vector<std::string>()) const;
+
+	/**
+		\brief generates code of the component updates of a time step, the tasks of generateComponentUpdateTasks() in order
+		\return string containing the code of the component updates
+	**/
+	std::string generateComponentUpdatesCode() const;
+
+	/**
+		\brief schedules the tasks of a time step preceding the solve by their dataflow
+
+		The tasks are those of generateComponentUpdateTasks(), an update per output signal update
+		body if output signals are enabled, and a source aggregation per line of aggregation_code.
+		Their dependencies are found with CppDataflow; each is in the dataflow region one after the
+		latest region of the tasks it depends on, so the tasks of a region are independent of each
+		other and read only results of earlier regions.
+
+		For Xilinx HLS, the tasks are ordered by region.  Otherwise they are interleaved: an output
+		signal update or aggregation is scheduled as soon as the tasks it depends on are, and of the
+		component update tasks ready to schedule, the one closest to completing the dependencies of
+		another task is scheduled first.  Either way, the tasks depending on each other stay in the
+		order of generateUpdateAndSolveCode() without scheduling.
+
+		\param aggregation_code code of the source aggregation from generateSolveCode(), a statement per line
+		\param source_fold_codes code of the overlapped solve from generateSolveCode(), appended to the component update tasks
+		\param tasks vector to hold the code of each task in schedule order
+		\param regions vector to hold the dataflow region (0 and up) of each task of tasks
+	**/
+	void scheduleStepTasks(const std::string& aggregation_code, const std::vector<std::string>& source_fold_codes,
+	                       std::vector<std::string>& tasks, std::vector<unsigned int>& regions) const;
+
+	/**
+		\brief generates code of the component updates, output signal updates, source aggregation, and solve of a time step
+		\param aggregation_code code of the source aggregation from generateSolveCode()
+		\param solve_code code of the solve operations from generateSolveCode()
+		\param source_fold_codes code of the overlapped solve from generateSolveCode(), appended to the component update tasks
+		\return string containing the code of the time step following the definitions of the solver
+	**/
+	std::string generateUpdateAndSolveCode(const std::string& aggregation_code, const std::string& solve_code,
+	                                       const std::vector<std::string>& source_fold_codes) const;
+
+	/**
+		\brief parses component fields code into persistent (static) fields and temporary declarations
+		\param fields vector to hold the declarations of the persistent fields
+		\param temporaries vector to hold the code of the other declarations, such as temporaries, each ending with ';'
+	**/
+	void parseComponentFields(std::vector<CppDeclaration>& fields, std::vector<std::string>& temporaries) const;
+
 public:
 
 	/**
@@ -169,6 +409,36 @@ public:
 	**/
 	SystemConductanceGenerator&  getConductanceGenerator();
 
+	/**
+		\brief sets the model cache in which getInverseConductanceGenerator() looks up the inverse of
+		G before inverting it, and keeps the inverses it computes
+		\param cache pointer to the model cache, which must outlive its use by this generator; null
+		for none, which is the default
+	**/
+	inline void setModelCache(ModelCache* cache) { model_cache = cache; }
+
+	/**
+		\return pointer to the model cache of the inverses of G; null if none
+	**/
+	inline ModelCache* getModelCache() const { return model_cache; }
+
+	/**
+		\brief gets the inverse G^-1 of the conductance matrix
+
+		The inverse is computed once and reused by the code generation methods and the callers of
+		this method for as long as the conductance matrix is not restamped, so that a model with
+		several solvers or reports generated from it factorizes G only once.  With a model cache set
+		by setModelCache(), the inverse of an identical G is taken from the cache instead of being
+		computed, and a computed inverse is kept in the cache.
+
+		\return reference to generator of the inverted conductance matrix; valid until G is changed
+		and this method is called again
+		\throw std::runtime_error if the conductance matrix is singular
+		\note the reuse is not synchronized, so this method must not be called concurrently on the
+		same generator
+	**/
+	const SystemConductanceGenerator& getInverseConductanceGenerator() const;
+
 	/**
 		\return reference to generator's internal Source Vector generator
 	**/
@@ -270,6 +540,40 @@ public:
 	**/
 	void insertComponentUpdateBody(std::string& code);
 
+	/**
+		\brief inserts C++ code string for the update method body of a component updated every
+		rate_divisor time steps
+
+		The component's source contributions are held between its updates.  Its update body must
+		write its source contributions as b_components[index] with constant index.
+
+		\param code string containing code for a component's update method body in valid C++
+		\param rate_divisor number of time steps between updates of the component; 1 updates it every time step
+		\param rate_phase time step, modulo rate_divisor, on which the component is updated
+		\throw invalid_argument if rate_divisor is 0 or rate_phase is not less than it
+	**/
+	void insertComponentUpdateBody(std::string& code, unsigned int rate_divisor, unsigned int rate_phase);
+
+	/**
+		\brief stamps components into this generator concurrently
+
+		The result is identical to calling Component::stampSystem() of each component in order.  The
+		components are split into contiguous shares, one per thread: each share stamps its
+		conductances into its own partial conductance generator, which are accumulated in order of
+		the shares; the sources are stamped in component order so their ids do not change; and the
+		component code is generated concurrently and then inserted in component order.
+
+		\param components the component generators, in netlist order
+		\param num_threads number of threads to use; 0 uses one per hardware thread
+		\param outputs vector of supported outputs that the components will have; default is ALL outputs supported
+	**/
+	void stampComponents
+	(
+		const std::vector< std::unique_ptr<Component> >& components,
+		unsigned int num_threads = 0,
+		const std::vector<std::string>& outputs = {"ALL"}
+	);
+
 	/**
 		\brief generates valid parameter (argument) list for the simulation engine top-level function
 
@@ -302,6 +606,186 @@ public:
 	**/
 	virtual void generateCFunctionAndExport(std::string filename, double zero_bound = 1.0e-12) const;
 
+	/**
+		\brief generates a report of the fixed point formats, ranges, and error bounds of the solve per node
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+		\return string containing the report
+		\see SystemFixedPointSolverGenerator::generateReport()
+	**/
+	std::string generateFixedPointReport(double zero_bound = 1.0e-12) const;
+
+	/**
+		\brief finds the solutions computed by the generated solvers
+
+		With solve_demand_driven_enable, the component fields, update bodies and, if output signals
+		are enabled, output signal update bodies are scanned for the solutions they read as x[<node>].
+		These and the nodes of solve_demanded_solutions are the demanded solutions.  If any code
+		refers to x other than with a literal node index, its reads cannot be known, so all
+		solutions are demanded.
+
+		\return flags of the computed solutions, one per solution (element i is x[i+1]); all true if
+		solve_demand_driven_enable is false or the solve is factorized
+		\throw invalid_argument if a node of solve_demanded_solutions is 0 or greater than the number of solutions
+	**/
+	std::vector<bool> findDemandedSolutions() const;
+
+	/**
+		\brief generates the IR of the source aggregation and the dense solve x = G^-1 * b, before optimization
+
+		The IR holds the arrays inv_g (CONSTANT), b_components (INPUT), b (OUTPUT if the source vector
+		is output, TEMPORARY otherwise) and x (OUTPUT) of the generated solvers.  Every element of b
+		is aggregated, and the rows of the solutions found by findDemandedSolutions() are solved.  The
+		solvers optimize it with CodeIR::optimize() when codegen_ir_optimization_enable is set, so
+		comparing its operation counts before and after optimization measures the passes.
+
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+		\return the IR, whose products common to several rows are stored in temporaries inv_g_product<k>
+		\throw std::runtime_error if the conductance matrix is singular
+	**/
+	CodeIR generateSolveCodeIR(double zero_bound = 1.0e-12) const;
+
+	/**
+		\brief analyzes the dataflow of the code of a time step, as scheduled with codegen_dataflow_schedule_enable
+
+		The critical path and operation counts are estimated by CppDataflow over the code of the
+		scheduled tasks followed by the solve.  The critical path does not depend on the schedule,
+		only on the dependencies, and bounds the latency of a time step given unlimited parallel
+		units, such as on an FPGA.
+
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+		\return summary of the dataflow
+	**/
+	SolverStepDataflow analyzeStepDataflow(double zero_bound = 1.0e-12) const;
+
+	/**
+		\brief generates C++ code of a batched solver that advances many independent scenarios of the model in one call
+
+		The generated code defines, with N being the number of scenarios:\n
+		<pre>
+		template< int N, typename real > struct model_batch;
+		template< int N, typename real > void model_batch_init(model_batch<N, real>* batch);
+		template< int N, typename real > void model_batch_solver(model_batch<N, real>* batch);
+		</pre>
+		where typename real is only present if the real type is templated.  The model_batch
+		structure stores the solutions, component signals, and component fields and states of all
+		scenarios in structure-of-arrays layout, so a value such as name[i] of the solver is stored
+		as name[i][N] with the scenarios contiguous in memory; booleans are stored as int.  The solver steps all scenarios in a
+		single loop over the scenarios whose body is the solver of the model, loading and storing
+		the state of each scenario with unit stride, so the loop can be vectorized by the compiler
+		(the loop is marked with "#pragma omp simd"; compile with -fopenmp-simd or equivalent).
+
+		All scenarios share the model parameters and the system conductance matrix, so the
+		scenarios differ by their input signals and states, such as source waveforms, switching
+		and fault signals, and initial conditions.  The solutions x_out of a scenario are also its
+		previous solutions for the next time step.
+
+		Each time step streams the whole state of the batch through the processor, so N should be
+		kept small enough for a batch to stay in cache, such as a few times the SIMD width; larger
+		ensembles are best held as arrays of batches stepped in turn or on separate threads.
+
+		\note batched solvers are meant for CPU targets; Xilinx HLS settings are ignored.
+
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+		\return string containing valid C++ definitions of the batch structure, initializer, and solver
+	**/
+	std::string generateBatchedCCode(double zero_bound = 1.0e-12) const;
+
+	/**
+		\brief generates C++ code of a batched solver and exports it to a header file
+		\param filename name of the header file that will contain the batched solver, including directory path and file extension
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+		\see generateBatchedCCode()
+	**/
+	void generateBatchedCCodeAndExport(std::string filename, double zero_bound = 1.0e-12) const;
+
+	/**
+		\brief generates C++ code of a reentrant solver that keeps the state of the model in a structure instead of static variables
+
+		The generated code defines:\n
+		<pre>
+		template< typename real > struct model_state;
+		template< typename real > void model_init(model_state<real>* state);
+		template< typename real > void model_step(model_state<real>* state, ...);
+		</pre>
+		where typename real is only present if the real type is templated; otherwise the functions
+		are inline.  model_step takes the parameters of the solver function after the state.  The
+		model_state structure holds the solutions and the component fields and states of one
+		instance of the model, so instances can be kept in arrays or arenas, copied to checkpoint
+		and restore simulations, and stepped concurrently from different threads.  model_init
+		must be called on a state before it is stepped.
+
+		\note reentrant solvers are meant for CPU targets; Xilinx HLS settings are ignored.
+
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+		\return string containing valid C++ definitions of the state structure, initializer, and solver
+	**/
+	std::string generateReentrantCCode(double zero_bound = 1.0e-12) const;
+
+	/**
+		\brief generates C++ code of a reentrant solver and exports it to a header file
+		\param filename name of the header file that will contain the reentrant solver, including directory path and file extension
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+		\see generateReentrantCCode()
+	**/
+	void generateReentrantCCodeAndExport(std::string filename, double zero_bound = 1.0e-12) const;
+
+	/**
+		\brief generates C++ code of a program that benchmarks the solver generated by generateCFunctionAndExport()
+
+		The program steps the solver for a number of time steps, given as its first command line
+		argument or num_steps by default, after a tenth as many warm-up steps.  Inputs of the
+		solver are driven by the given waveforms at time k*time_step of step k, and inputs without a
+		waveform are zero or false.  The program then prints the time per step in ns, the hardware
+		event counts per step from lblmc::PerfCounters where available (instructions, cycles,
+		cache misses, L1D read misses, branch misses), and a checksum of the solutions.  Only the
+		solutions the solver assigns to x_out are checksummed and compared below, which with
+		solve_demand_driven_enable are those of findDemandedSolutions().
+
+		The measured time includes the evaluation of the waveforms, so constant waveforms give the
+		closest measure of the solver itself.  The program must be compiled with the include
+		directory of this library on the include path for runtime/PerfCounters.hpp.
+
+		Given a reference solver of the same model, such as the default monolithic solver of a model
+		solved by another solver here, the program afterwards steps a second instance of the solver
+		and the reference through the same steps and inputs, prints the largest deviation of their
+		solutions over all steps, and returns 2 if it exceeds reference_tolerance*(1 + max |x| of the
+		reference).  Solvers whose solutions lag those of the reference, such as decomposed solvers
+		that solve before they update their sources, are compared at the same time step.
+
+		\param solver_filename name of the header file of the solver, as included by the program
+		\param waveforms waveforms of the inputs of the solver
+		\param num_steps default number of time steps to measure
+		\param time_step time step of the model in seconds, for the time of the waveforms
+		\param reference_model_name model name of the reference solver, whose header file is <reference_model_name>.hpp
+		and whose parameters match those of this solver; empty for no reference
+		\param reference_tolerance relative deviation of the solutions from the reference allowed
+		\param reference_delay number of time steps the solutions of the solver lag those of the reference
+		\return string containing the C++ source code of the program
+		\throw std::invalid_argument if a waveform refers to an input that does not exist or to an element out of its bounds,
+		or a reference is given without templated solver functions
+	**/
+	std::string generateBenchmarkDriver(std::string solver_filename, const std::vector<InputWaveform>& waveforms,
+	                                    unsigned long num_steps = 100000, double time_step = 50.0e-9,
+	                                    std::string reference_model_name = "", double reference_tolerance = 1.0e-6,
+	                                    unsigned int reference_delay = 0) const;
+
+	/**
+		\brief generates C++ code of a benchmark program for the solver and exports it to a source file
+		\param filename name of the source file that will contain the program, including directory path and file extension
+		\param solver_filename name of the header file of the solver, as included by the program
+		\param waveforms waveforms of the inputs of the solver
+		\param num_steps default number of time steps to measure
+		\param time_step time step of the model in seconds, for the time of the waveforms
+		\param reference_model_name model name of the reference solver to compare the solutions with; empty for no reference
+		\param reference_tolerance relative deviation of the solutions from the reference allowed
+		\param reference_delay number of time steps the solutions of the solver lag those of the reference
+		\see generateBenchmarkDriver()
+	**/
+	void generateBenchmarkDriverAndExport(std::string filename, std::string solver_filename, const std::vector<InputWaveform>& waveforms,
+	                                      unsigned long num_steps = 100000, double time_step = 50.0e-9,
+	                                      std::string reference_model_name = "", double reference_tolerance = 1.0e-6,
+	                                      unsigned int reference_delay = 0) const;
+
 };
 
 } //namespace lblmc
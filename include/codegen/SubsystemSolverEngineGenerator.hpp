@@ -124,6 +124,7 @@ private:
 	std::vector<Port> ports; ///< ports across where subsystem is decomposed from rest of a system
 	std::map< unsigned int, std::map<unsigned int, double> > source_gains; ///< source weight gains for each port H, mapped to each port by id; gains are mapped to source id's of component contribution sources in subsystem ( key port id -> value ( key source id -> value gain) )
 	std::map< unsigned int, unsigned int> port_source_ids; ///< ids of port sources attached to subsystem from other subsystems, each source id mapped to id of associated port (key port_id -> value source_id)
+	std::map< unsigned int, std::map<unsigned int, double> > port_couplings; ///< transconductances T of the port models of this subsystem from ports the receiving subsystem does not have, mapped to each port by id ( key port id -> value ( key other port id -> value transconductance) )
 
 public:
 
@@ -182,6 +183,12 @@ public:
 	**/
 	const Port& getPort(unsigned int id) const;
 
+	/**
+		\param id of the port to check
+		\return true if subsystem has a port with the given id
+	**/
+	bool hasPort(unsigned int id) const;
+
 	/**
 		\return ports of the subsystem which for a solver engine will be generated
 	**/
@@ -205,6 +212,11 @@ public:
 		This method takes the port model of another subsystem and adds its contributions
 		to the conductance and source vector of this subsystem
 
+		Transconductances of the model from ports that this subsystem does not have are not stamped;
+		the other subsystem carries them in the injection of the port instead.
+
+		\see addOwnPortCoupling()
+
 		\param port_model port model from other subsystem
 	**/
 	void stampOthersPortModel(const PortModel& port_model);
@@ -239,6 +251,20 @@ public:
 	**/
 	void addOwnSourceGains(const std::vector<PortModel>& port_models);
 
+	/**
+		\brief adds a coupling of a port model of this subsystem from a port the receiving subsystem does not have
+
+		The receiving subsystem cannot stamp the transconductance, so the injection of the port
+		instead carries the current of the transconductance at the voltage of the other port in
+		the last solution of this subsystem.  Couplings are only added to ports with source gains.
+
+		\param port_id id of the port whose injection carries the coupling
+		\param other_port_id id of the port whose voltage the coupling is from
+		\param transconductance transconductance T of the port model of port_id from other_port_id
+		\throw invalid_argument if either port is not a port of this subsystem
+	**/
+	void addOwnPortCoupling(unsigned int port_id, unsigned int other_port_id, double transconductance);
+
 	/**
 		\brief generates string defining code for equation of a port's source contribution H to
 		be injected into another subsystem
@@ -48,14 +48,47 @@ namespace lblmc
 	the matrix can be exported by this class's instances to file or memory to be processed for
 	development of a LB-LMC simulation engine that is RTL synthesizable.
 
+	The matrix is stored either dense or sparse.  In sparse mode, stamps are recorded as
+	(row, column, value) entries and are summed into a compressed sparse matrix only when the
+	matrix is read, so stamping and the storage of the matrix scale with the number of nonzeros
+	rather than the square of the dimension.  The entries of each element are summed in the order
+	they were stamped, so the sparse matrix is identical to the dense matrix for the same stamps.
+	Reading the matrix in sparse mode through its const dense accessors builds a dense copy on
+	demand; its non-const dense accessors and invertSelf() switch the generator to dense mode.
+
 	\note This class is NOT intended for RTL Synthesis.
 
  **/
 class SystemConductanceGenerator
 {
 private:
-	MatrixRMXd matrix;
+
+	/**
+		\brief stamp of an element of the matrix recorded in sparse mode
+	**/
+	struct Entry
+	{
+		unsigned int row; ///< zero-based row of element
+		unsigned int col; ///< zero-based column of element
+		double value; ///< value added to or assigned to element
+		bool assign; ///< true if value replaces the element rather than adds to it
+	};
+
+	mutable MatrixRMXd matrix; ///< dense matrix; in sparse mode, dense copy built on demand
 	unsigned int dimension;
+	bool sparse; ///< true if matrix is stored as sparse entries
+	mutable std::vector<Entry> entries; ///< stamps in sparse mode; summed into unique entries when compressed
+	mutable SparseMatrixRMXd sparse_matrix; ///< compressed matrix of the entries in sparse mode
+	mutable bool compressed; ///< true if sparse_matrix holds the current entries
+	mutable bool dense_cached; ///< true if matrix holds the current dense copy in sparse mode
+	double inverse_rcond; ///< reciprocal condition number estimate of the matrix last inverted by invertSelf(); 0 if none
+	bool inverse_symmetric; ///< true if the matrix last inverted by invertSelf() was inverted with LDL^T
+
+	void add(unsigned int r, unsigned int c, double value);
+	void assign(unsigned int r, unsigned int c, double value);
+	void compress() const;
+	const MatrixRMXd& denseView() const;
+	MatrixRMXd& denseStorage();
 
 public:
 
@@ -67,6 +100,13 @@ public:
 	 */
 	SystemConductanceGenerator(unsigned int dimension);
 
+	/**
+	 * parameter constructor with storage mode
+	 * \param dimension non-zero dimension of square conductance matrix (length or width)
+	 * \param sparse true to store the matrix sparse; false to store it dense
+	 */
+	SystemConductanceGenerator(unsigned int dimension, bool sparse);
+
 	/**
 	 * initialization constructor
 	 *
@@ -110,8 +150,23 @@ public:
 	 */
 	void reset(const SystemConductanceGenerator& base);
 
+	/**
+		\brief sets the storage mode of the conductance matrix, converting the stored matrix
+		\param sparse true to store the matrix sparse; false to store it dense
+	**/
+	void setSparse(bool sparse);
+
+	/**
+		\brief checks if the conductance matrix is stored sparse
+		\return true if stored sparse; false if stored dense
+	**/
+	bool isSparse() const;
+
 	/**
 	 * returns conductance matrix as an observer pointer
+	 *
+	 * In sparse mode, the generator is switched to dense mode first.
+	 *
 	 * \return pointer to conductance matrix data
 	 */
 	double* asPointer();
@@ -129,12 +184,28 @@ public:
 
 	/**
 	 * returns the conductance matrix as a Eigen3 Matrix Type
+	 *
+	 * In sparse mode, the non-const version switches the generator to dense mode first, while
+	 * the const version returns a dense copy built on demand.
+	 *
 	 * \return
 	 */
 	MatrixRMXd& asEigen3Matrix();
 
 	const MatrixRMXd& asEigen3Matrix() const;
 
+	/**
+		\brief returns the conductance matrix as a Eigen3 sparse matrix
+		\return compressed sparse matrix of the nonzero elements of the conductance matrix
+	**/
+	SparseMatrixRMXd asEigen3SparseMatrix() const;
+
+	/**
+		\brief gets the number of nonzero elements of the conductance matrix
+		\return number of nonzero elements
+	**/
+	unsigned int getNumberOfNonzeros() const;
+
 	/**
 	 * gets dimension of square conductance matrix
 	 * \return dimension of matrix
@@ -223,6 +294,19 @@ public:
 	**/
 	void stampIdealVoltageSourceIncidence(unsigned int solution_id, unsigned int p, unsigned int n);
 
+	/**
+		\brief stamps the stamps of another conductance generator into this one
+
+		Generators stamped concurrently, each with its own share of the components, are reduced into
+		one by accumulating them in the order of their shares.  The stamps of a sparse partial are
+		replayed in their stamp order, so the result is identical to stamping all components into
+		this generator; a dense partial is added element by element.
+
+		\param partial the conductance generator whose stamps are accumulated; must be of the same dimension
+		\throw invalid_argument if the dimensions differ
+	**/
+	void accumulate(const SystemConductanceGenerator& partial);
+
 	/**
 		\brief checks if generated matrix is invertible (non-singular)
 		\return true if invertible (non-singular); false if non-invertible (singular)
@@ -231,11 +315,46 @@ public:
 
 	/**
 	 * inverts the conductance matrix and stores the result into itself
+	 *
+	 * The matrix is factorized once, and the inverse is solved from that decomposition:
+	 * with LDL^T if the matrix is symmetric and semidefinite, otherwise with LU of partial
+	 * pivoting.  The estimated condition number of the matrix is kept for getInverseConditionNumber().
+	 * The solve for the inverse is a blocked matrix product that Eigen runs multithreaded when the
+	 * library is compiled with OpenMP (see Eigen::setNbThreads()).
+	 *
+	 * The inverse is dense in general, so the generator is switched to dense mode.
+	 *
 	 * \throw std::runtime_error if matrix is singular (non-invertible)
 	 * \see isInvertible() to check if matrix is invertible
 	 */
 	void invertSelf();
 
+	/**
+		\brief gets the estimated 1-norm condition number of the matrix last inverted by invertSelf()
+
+		The condition number bounds the relative error amplification of the inverse and of the
+		solutions computed with it; about log10 of it decimal digits of precision are lost.
+
+		\return the condition number estimate; 0 if the matrix has not been inverted
+	**/
+	double getInverseConditionNumber() const;
+
+	/**
+		\brief checks if the matrix last inverted by invertSelf() was inverted with LDL^T
+		\return true if inverted with LDL^T; false if inverted with LU or not inverted
+	**/
+	bool isInvertedSymmetric() const;
+
+	/**
+		\brief resets the generator to an inverse computed earlier by invertSelf(), such as one kept
+		by a ModelCache, so it is as if invertSelf() computed it
+		\param inverse the inverted matrix; must be square and nonzero in dimension
+		\param condition_number condition number estimate of the inverted matrix, from getInverseConditionNumber()
+		\param inverted_symmetric true if the matrix was inverted with LDL^T, from isInvertedSymmetric()
+		\throw invalid_argument if inverse is not square or is empty
+	**/
+	void resetToInverse(MatrixRMXd inverse, double condition_number, bool inverted_symmetric);
+
 	/**
 		\brief inverts the conductance matrix and returns the result
 
@@ -296,6 +415,19 @@ public:
 	 */
 	void exportAsCSV(std::string filename) const;
 
+	/**
+		\brief exports the nonzero elements of the conductance matrix to a Matrix Market coordinate text file
+
+		The exported file lists the nonzero elements only, so its size scales with the number of
+		nonzeros rather than the square of the dimension.  It can be opened by many tools, including
+		Mathworks MATLAB (mmread), GNU Octave, SciPy (scipy.io.mmread) and Eigen (loadMarket).
+
+		\param filename filename of the text file to store matrix
+		\param pattern_only true to export the sparsity pattern only, without values
+		\throw std::runtime_error if file cannot be written
+	**/
+	void exportAsMatrixMarket(std::string filename, bool pattern_only = false) const;
+
 	/**
 	 * exports the conductance matrix to a C/C++ Header file containing a constant 2D array
 	 *
@@ -0,0 +1,139 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date Fall 2020
+
+ **/
+#ifndef SYSTEMFACTORIZEDSOLVERGENERATOR_HPP
+#define SYSTEMFACTORIZEDSOLVERGENERATOR_HPP
+
+#include <vector>
+#include <string>
+#include <utility>
+
+#include "codegen/SystemConductanceGenerator.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief Generates code for solving Gx=b by substitution with sparse factors of G
+
+	Instead of baking the dense inverse G^-1 into the generated code, this generator factorizes
+	the conductance matrix at code generation time as P*G*Q = L*D*U, where P and Q are row and
+	column permutations, L is unit lower triangular, D is diagonal, and U is unit upper
+	triangular.  The generated code then solves for x with unrolled forward and back substitution
+	over only the nonzero factors.
+
+	The rows and columns of G are first ordered with Approximate Minimum Degree (AMD) to reduce
+	fill-in of the factors.  If G is symmetric, it is factorized with Eigen's sparse LDL^T
+	so that U = L^T and only L is stored; otherwise, G is factorized with a sparse right-looking
+	LU over its nonzeros using threshold partial pivoting that prefers the AMD ordered diagonal.
+
+	For large sparse networks, the factors have far fewer nonzeros than G^-1, reducing both the
+	operations per solve and the size of the constant tables in the generated code.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemFactorizedSolverGenerator
+{
+private:
+
+	/**
+		\brief nonzero element of a triangular factor referred to by the generated code
+	**/
+	struct Factor
+	{
+		unsigned int col;   ///< factor row or column the element multiplies
+		double value;       ///< value of the element
+		unsigned int index; ///< index of the element in its constant table of the generated code
+		bool in_lower;      ///< true if element is stored in the table of L, false if in that of U
+	};
+
+	unsigned int dimension; ///< number of solutions in the system Gx=b
+	double zero_bound; ///< range from zero within which factor elements are discarded
+	bool symmetric; ///< true if G was factorized as symmetric L*D*L^T
+	std::vector<unsigned int> row_order; ///< source vector element b[row_order[k]] read by factor row k (P)
+	std::vector<unsigned int> col_order; ///< solution x[col_order[k]+1] produced by factor row k (Q)
+	std::vector< std::vector<Factor> > lower; ///< strictly lower elements of L for each factor row
+	std::vector< std::vector<Factor> > upper; ///< strictly upper elements of U for each factor row
+	std::vector<double> inv_diagonal; ///< reciprocals of D
+	unsigned int num_lower; ///< number of elements in table of L
+	unsigned int num_upper; ///< number of elements in table of U
+
+	void factorizeLDLT(const Eigen::SparseMatrix<double>& Gp);
+	void factorizeLU(const Eigen::SparseMatrix<double>& Gp);
+
+public:
+
+	SystemFactorizedSolverGenerator() = delete;
+
+	/**
+		\brief parameter constructor; factorizes the given conductance matrix
+		\param G conductance matrix of the system Gx=b
+		\param zero_bound range from zero within which elements of G and its factors are discarded; defaults to 1e-12
+		\throw runtime_error if G is empty or singular
+	**/
+	SystemFactorizedSolverGenerator(const SystemConductanceGenerator& G, double zero_bound = 1.0e-12);
+
+	/**
+		\return true if G was symmetric and factorized with LDL^T
+	**/
+	inline bool isSymmetric() const { return symmetric; }
+
+	/**
+		\return number of nonzero constants in the tables of the generated code
+	**/
+	unsigned int getNumberOfConstants() const;
+
+	/**
+		\return number of multiplications in the code generated by generateCInlineCode()
+	**/
+	unsigned int countMultiplies() const;
+
+	/**
+		\brief generates C/C++ code defining the constant tables of the factors
+		\param prefix prefix for the names of the tables; tables are named <prefix>_l, <prefix>_u, and <prefix>_inv_d
+		\return string containing C++ code for the constant tables
+	**/
+	std::string generateCFactorsLiteral(std::string prefix = "lu") const;
+
+	/**
+		\brief generates C/C++ inline-able code that solves Gx=b by forward and back substitution
+
+		Input of the inline code is the source vector real b[<num_nodes>] and the output is
+		real x[<num_nodes>+1] where x[0] is ground, same as SystemSolverGenerator.  The code refers
+		to the tables generated by generateCFactorsLiteral() with the same prefix.
+
+		\param prefix prefix for the names of the factor tables and temporaries
+		\return string containing the generated code
+	**/
+	std::string generateCInlineCode(std::string prefix = "lu") const;
+};
+
+} //namespace lblmc
+
+#endif //SYSTEMFACTORIZEDSOLVERGENERATOR_HPP
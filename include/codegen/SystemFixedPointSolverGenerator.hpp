@@ -0,0 +1,221 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date Fall 2020
+
+ **/
+#ifndef SYSTEMFIXEDPOINTSOLVERGENERATOR_HPP
+#define SYSTEMFIXEDPOINTSOLVERGENERATOR_HPP
+
+#include <vector>
+#include <string>
+
+namespace lblmc
+{
+
+/**
+	\brief Generates fixed point code for solving x=(G^-1)*b with formats chosen by range analysis
+
+	Given bounds on the magnitudes of the source vector b, the magnitude of each solution is
+	bounded by |x[r]| <= sum_j |G^-1[r][j]| * |b[j]|.  From these bounds and the range of G^-1,
+	this generator chooses signed fixed point formats Q<I>.<F> (I integral bits including sign, F
+	fractional bits) for the source vector, the coefficients of G^-1, and each solution, so that
+	no value of the solve overflows while keeping as many fractional bits as the word width
+	allows.  Solutions whose bound exceeds the range of the real type are saturated.
+
+	The solve can be generated in two forms:
+	- ap_fixed arithmetic of Xilinx Vivado HLS, with a type for each format; the products and sums
+	  are computed at full precision and rounded once to the format of the solution.
+	- portable integer arithmetic of standard C++, with the source vector and coefficients in
+	  32-bit integers and sums in 64-bit integers, which computes bit for bit the same solve on any
+	  platform and so can be used to verify a fixed point design against floating point simulation.
+
+	The generator also bounds the error of each solution from the quantization of the coefficients
+	and sources and the rounding of the solution, for reports of precision and overflow per node.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemFixedPointSolverGenerator
+{
+public:
+
+	/**
+		\brief signed fixed point format of W bits with I integral bits, including the sign bit,
+		and W-I fractional bits; I may be negative or exceed W
+	**/
+	struct Format
+	{
+		int word_width; ///< number of bits of the word
+		int int_width;  ///< number of integral bits of the word, including the sign bit
+
+		/**
+			\return number of fractional bits of the word
+		**/
+		inline int getFracWidth() const { return word_width - int_width; }
+
+		/**
+			\return format as string in Q<I>.<F> notation
+		**/
+		std::string asString() const;
+	};
+
+private:
+
+	/**
+		\brief nonzero quantized coefficient of a row of G^-1
+	**/
+	struct Term
+	{
+		unsigned int col; ///< source vector element b[col] the coefficient multiplies
+		double value;     ///< coefficient scaled by 2^F of the coefficient format of the row, an integer
+	};
+
+	unsigned int dimension; ///< number of solutions in the system Gx=b
+	bool integer_arithmetic; ///< true if the code is generated with portable integer arithmetic, false for ap_fixed
+	Format real_format; ///< format of the real type of the generated code
+	Format source_format; ///< format of the source vector b
+	double source_bound; ///< bound of the magnitude of the elements of the source vector b used by the solve
+	std::vector<Format> coeff_formats; ///< format of the coefficients of each row of G^-1
+	std::vector<Format> solution_formats; ///< format of each solution
+	std::vector< std::vector<Term> > rows; ///< quantized nonzero coefficients of each row of G^-1
+	std::vector<bool> used_sources; ///< true for each source vector element multiplied by a nonzero coefficient
+	std::vector<double> solution_bounds; ///< bound of the magnitude of each solution
+	std::vector<double> error_bounds; ///< bound of the absolute error of each solution
+	std::vector<bool> saturable_reads; ///< true for each row reading an element of b whose bound exceeds the range of its format
+	std::vector<unsigned int> num_flushed; ///< number of nonzero coefficients of each row quantized to zero
+
+	static int findIntWidth(double bound);
+
+public:
+
+	SystemFixedPointSolverGenerator() = delete;
+
+	/**
+		\brief parameter constructor; analyzes the ranges of the solve and chooses its formats
+		\param A the inverted conductance matrix ( A = G^-1 of Gx=b ) in row major order
+		\param dimension number of solutions in the system Gx=b
+		\param source_bounds bound of the magnitude of each element of the source vector b
+		\param real_format fixed point format of the real type of the generated code; sources and
+		solutions beyond its range saturate, and the solutions they reach are reported saturable
+		\param integer_arithmetic true to generate portable integer code, false for ap_fixed code
+		\param row_formats true to choose the coefficient format of each row of G^-1 from the range
+		of the row, false to use one format from the range of the whole of G^-1
+		\param zero_bound range from zero within which elements of G^-1 are discarded; defaults to 1e-12
+		\throw invalid_argument if A is null, dimension is zero, or source_bounds is not of size dimension
+	**/
+	SystemFixedPointSolverGenerator
+	(
+		const double* A,
+		unsigned int dimension,
+		const std::vector<double>& source_bounds,
+		Format real_format,
+		bool integer_arithmetic,
+		bool row_formats,
+		double zero_bound = 1.0e-12
+	);
+
+	/**
+		\return format of the source vector b
+	**/
+	inline Format getSourceFormat() const { return source_format; }
+
+	/**
+		\param r index of the solution, as row r of G^-1 for solution x[r+1]
+		\return format of the coefficients of row r of G^-1
+	**/
+	Format getCoefficientFormat(unsigned int r) const;
+
+	/**
+		\param r index of the solution, as row r of G^-1 for solution x[r+1]
+		\return format of solution x[r+1]
+	**/
+	Format getSolutionFormat(unsigned int r) const;
+
+	/**
+		\param r index of the solution, as row r of G^-1 for solution x[r+1]
+		\return bound of the magnitude of solution x[r+1] before saturation
+	**/
+	double getSolutionBound(unsigned int r) const;
+
+	/**
+		\param r index of the solution, as row r of G^-1 for solution x[r+1]
+		\return bound of the absolute error of solution x[r+1] from quantization and rounding, when not saturated
+	**/
+	double getErrorBound(unsigned int r) const;
+
+	/**
+		\param r index of the solution, as row r of G^-1 for solution x[r+1]
+		\return true if the bound of solution x[r+1] exceeds the range of the real type, or it reads an element of
+		the source vector whose bound exceeds the range of the source format, so it may be saturated
+	**/
+	bool isSaturable(unsigned int r) const;
+
+	/**
+		\return number of multiplications in the code generated by generateCInlineCode()
+	**/
+	unsigned int countMultiplies() const;
+
+	/**
+		\brief generates a report of the formats, ranges, and error bounds of the solve per node
+		\param netlist_nodes netlist node of each solution to list it by, element i-1 for x[i]; if
+		empty, solution x[i] is listed as node i
+		\return string containing the report as a table with one line per solution
+	**/
+	std::string generateReport(const std::vector<unsigned int>& netlist_nodes = std::vector<unsigned int>()) const;
+
+	/**
+		\brief generates C/C++ code of the definitions used by the code of generateCInlineCode()
+
+		For ap_fixed arithmetic, these are the types of the formats of the solve, named
+		<prefix>_b_fixed, <prefix>_r<r>_fixed for the coefficients of row r, and
+		<prefix>_x<r+1>_fixed for solution x[r+1].  For integer arithmetic, there are no definitions.
+
+		\param prefix prefix for the names of the definitions
+		\return string containing C++ code of the definitions
+	**/
+	std::string generateCTypesLiteral(const std::string& prefix = "inv_g") const;
+
+	/**
+		\brief generates C/C++ inline-able code for the solver x=(G^-1)*b in fixed point arithmetic
+
+		Input of the inline code is the source vector real b[<num_nodes>] and the output is
+		real x[<num_nodes>+1] where x[0] is ground, same as SystemSolverGenerator.  The source
+		vector is first quantized to its format with saturation, then each solution is computed
+		as the sum of the products of the quantized coefficients and sources, rounded and
+		saturated to the format of the solution.
+
+		Integer arithmetic code uses std::int32_t, std::int64_t, std::llrint, std::fmin, and
+		std::fmax, so the generated code must include <cstdint> and <cmath>.
+
+		\param prefix prefix for the names of the definitions and temporaries
+		\return string containing the generated code
+	**/
+	std::string generateCInlineCode(const std::string& prefix = "inv_g") const;
+};
+
+} //namespace lblmc
+
+#endif //SYSTEMFIXEDPOINTSOLVERGENERATOR_HPP
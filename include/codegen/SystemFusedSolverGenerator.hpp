@@ -0,0 +1,151 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date Fall 2020
+
+ **/
+#ifndef SYSTEMFUSEDSOLVERGENERATOR_HPP
+#define SYSTEMFUSEDSOLVERGENERATOR_HPP
+
+#include <vector>
+#include <string>
+#include <utility>
+
+#include "codegen/SystemSourceVectorGenerator.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief Generates code for solving x=(G^-1)*b with the source aggregation fused into the solve
+	where it is cheaper
+
+	The source vector is b = S*b_components, where S is the signed incidence of the component
+	sources held by SystemSourceVectorGenerator, so each solution can either be computed in two
+	stages as x[r] = sum of (G^-1)[r][c]*b[c] after aggregating b, or directly from the component
+	sources as x[r] = sum of (G^-1*S)[r][s]*b_components[s] with the combined operator G^-1*S
+	precomputed at code generation time.
+
+	For each row, the form with fewer operations is chosen, preferring the fused form on ties.  A
+	two-stage row costs a multiply-add per element of b it reads, plus its share of the additions
+	aggregating those elements, split evenly among the rows that read each element; a fused row
+	costs a multiply-add per nonzero coefficient of its row of G^-1*S.
+	Only the elements of b read by the rows left in two-stage form are aggregated, so when every row
+	is fused, the pass over b and its memory traffic are removed from the solve.  Coefficients of
+	G^-1*S that cancel to within the zero bound are discarded.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemFusedSolverGenerator
+{
+private:
+
+	unsigned int dimension; ///< number of solutions in the system Gx=b
+	unsigned int num_sources; ///< number of component source contributions
+	std::vector<bool> solved; ///< whether each row is solved by the generated code
+	std::vector<bool> fused; ///< whether each row is solved in fused form
+	std::vector< std::vector< std::pair<unsigned int, double> > > fused_terms; ///< source index and coefficient of G^-1*S of each term of fused rows
+	std::vector< std::vector<unsigned int> > two_stage_terms; ///< columns of G^-1 of each term of two-stage rows
+	std::vector<bool> b_used; ///< whether each element of b is read by a two-stage row
+	unsigned int num_fused_coefficients; ///< number of coefficients in the table of G^-1*S
+	unsigned int num_two_stage_multiplies; ///< multiplications of the solve if every solved row were two-stage
+
+public:
+
+	SystemFusedSolverGenerator() = delete;
+
+	/**
+		\brief parameter constructor; computes G^-1*S and chooses the form of each row
+		\param A the inverted conductance matrix ( A = G^-1 of Gx=b ) in row major order
+		\param dimension number of solutions in the system Gx=b
+		\param sources source vector generator holding the source incidence S
+		\param zero_bound range from zero within which coefficients of G^-1 and G^-1*S are discarded; defaults to 1e-12
+		\param solved_rows flags of the rows to solve, one per solution; rows not solved are neither computed
+		nor assigned by the generated code and read no element of b; empty solves all rows
+		\throw invalid_argument if A is null, dimension does not match that of sources, or solved_rows
+		is neither empty nor of size dimension
+	**/
+	SystemFusedSolverGenerator
+	(
+		const double* A,
+		unsigned int dimension,
+		const SystemSourceVectorGenerator& sources,
+		double zero_bound = 1.0e-12,
+		const std::vector<bool>& solved_rows = std::vector<bool>()
+	);
+
+	/**
+		\param r zero-based index of the row of solution x[r+1]
+		\return true if the row is solved in fused form
+	**/
+	inline bool isFused(unsigned int r) const { return fused.at(r); }
+
+	/**
+		\return number of rows solved in fused form
+	**/
+	unsigned int getNumberOfFusedRows() const;
+
+	/**
+		\return flags of the elements of b that are read by the rows in two-stage form and must be aggregated
+	**/
+	inline const std::vector<bool>& getUsedSourceVectorElements() const { return b_used; }
+
+	/**
+		\return number of multiplications in the code generated by generateCInlineCode()
+	**/
+	unsigned int countMultiplies() const;
+
+	/**
+		\return number of multiplications of the two-stage solve of every solved row, as generated by SystemSolverGenerator::generateCInlineCode()
+	**/
+	inline unsigned int countTwoStageMultiplies() const { return num_two_stage_multiplies; }
+
+	/**
+		\brief generates C/C++ code defining the constant table of the coefficients of G^-1*S of the fused rows
+		\param table_name name of the table
+		\return string containing C++ code for the table; empty if no row is fused
+	**/
+	std::string generateCFusedLiteral(std::string table_name = "inv_g_s") const;
+
+	/**
+		\brief generates C/C++ inline-able code that solves x=(G^-1)*b row by row in fused or two-stage form
+
+		Inputs of the inline code are the component source contributions real b_components[<num_sources>]
+		and the elements of the source vector real b[<num_nodes>] flagged by getUsedSourceVectorElements().
+		The output is real x[<num_nodes>+1] where x[0] is ground, same as SystemSolverGenerator.  The code
+		refers to G^-1 as a 2D table named invg_name for two-stage rows and to the table generated by
+		generateCFusedLiteral() for fused rows.
+
+		\param invg_name name of the inverted conductance matrix G^-1
+		\param table_name name of the table of G^-1*S
+		\return string containing the generated code
+	**/
+	std::string generateCInlineCode(std::string invg_name = "inv_g", std::string table_name = "inv_g_s") const;
+};
+
+} //namespace lblmc
+
+#endif //SYSTEMFUSEDSOLVERGENERATOR_HPP
@@ -0,0 +1,163 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef SYSTEMOVERLAPPEDSOLVERGENERATOR_HPP
+#define SYSTEMOVERLAPPEDSOLVERGENERATOR_HPP
+
+#include <vector>
+#include <string>
+#include <utility>
+
+#include "codegen/SystemSourceVectorGenerator.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief Generates code for solving x=(G^-1)*b overlapped with the component updates, folding
+	the source contributions into the solutions as soon as they are updated
+
+	The source vector is b = S*b_components, where S is the signed incidence of the component
+	sources held by SystemSourceVectorGenerator, so x = (G^-1*S)*b_components is a sum over the
+	sources of their contributions times the columns of G^-1*S, each a signed sum of the columns of
+	G^-1 of the nodes the source is incident to.  Instead of aggregating b and multiplying it by
+	G^-1 after every component is updated, the solve keeps a running sum per solution,
+	x_sum_<node>, and each fold adds the contributions of a group of sources, such as those a
+	component update has just assigned, times their columns:\n
+	<pre>
+	real x_sum_3 = inv_g_s[0]*b_components[4] + inv_g_s[1]*b_components[5];   // first fold into x[3]
+	x_sum_3 += inv_g_s[7]*b_components[9];                                      // later folds
+	...
+	x[3] = x_sum_3;                                                             // after the last fold
+	</pre>
+	so the multiply-adds of the solve are spread among the component updates, where they can run
+	alongside the updates that follow, and no pass over b is left after them.  Coefficients of
+	G^-1*S that cancel to within the zero bound are discarded, as with SystemFusedSolverGenerator.
+**/
+class SystemOverlappedSolverGenerator
+{
+private:
+
+	unsigned int dimension; ///< number of solutions in the system Gx=b
+	unsigned int num_sources; ///< number of component source contributions
+	std::vector<bool> solved; ///< whether each row is solved by the generated code
+	std::vector< std::vector< std::pair<unsigned int, double> > > columns; ///< row and coefficient of each nonzero of each column of G^-1*S, by row
+	std::vector< std::vector<unsigned int> > folds; ///< sources of each fold, in order of the code
+	std::vector<unsigned int> final_sources; ///< sources in no fold, folded by generateCInlineCode()
+
+	/**
+		\brief collects the terms of a fold of sources by the rows they contribute to
+		\param sources the sources of the fold
+		\return row, and source and coefficient of G^-1*S of each term, of each row the sources contribute to, by row
+	**/
+	std::vector< std::pair< unsigned int, std::vector< std::pair<unsigned int, double> > > >
+	collectFoldTerms(const std::vector<unsigned int>& sources) const;
+
+	/**
+		\brief generates the statements of a fold of sources, one per row the sources contribute to
+		\param sources the sources of the fold
+		\param table_name name of the table of G^-1*S
+		\param sum_prefix name of the running sums, followed by their node
+		\param index index in the table of the first coefficient of the fold; advanced past the coefficients of the fold
+		\param summed flags of the rows whose running sum is declared; set for the rows of the fold
+		\return the statements of the fold
+	**/
+	std::string generateCFoldCode(const std::vector<unsigned int>& sources, const std::string& table_name, const std::string& sum_prefix,
+	                              unsigned int& index, std::vector<bool>& summed) const;
+
+public:
+
+	SystemOverlappedSolverGenerator() = delete;
+
+	/**
+		\brief parameter constructor; computes the columns of G^-1*S, and folds all sources in the
+		final code until setFolds() is called
+		\param A the inverted conductance matrix ( A = G^-1 of Gx=b ) in row major order
+		\param dimension number of solutions in the system Gx=b
+		\param sources source vector generator holding the source incidence S
+		\param zero_bound range from zero within which coefficients of G^-1 and G^-1*S are discarded; defaults to 1e-12
+		\param solved_rows flags of the rows to solve, one per solution; rows not solved are neither computed
+		nor assigned by the generated code; empty solves all rows
+		\throw invalid_argument if A is null, dimension does not match that of sources, or solved_rows
+		is neither empty nor of size dimension
+	**/
+	SystemOverlappedSolverGenerator
+	(
+		const double* A,
+		unsigned int dimension,
+		const SystemSourceVectorGenerator& sources,
+		double zero_bound = 1.0e-12,
+		const std::vector<bool>& solved_rows = std::vector<bool>()
+	);
+
+	/**
+		\brief sets the groups of sources folded together, in order of the code
+		\param source_folds sources of each fold, such as those assigned by a component update; each
+		source must be in at most one fold, made after its contribution is final for the time step.
+		Sources in no fold are folded by the code of generateCInlineCode()
+		\throw invalid_argument if a source is out of range or in more than one fold
+	**/
+	void setFolds(const std::vector< std::vector<unsigned int> >& source_folds);
+
+	/**
+		\return number of multiplications of the generated code, one per nonzero coefficient of G^-1*S
+	**/
+	unsigned int countMultiplies() const;
+
+	/**
+		\brief generates C/C++ code defining the constant table of the coefficients of G^-1*S, in the
+		order the folds and the final code read them
+		\param table_name name of the table
+		\return string containing C++ code for the table; empty if G^-1*S has no nonzero coefficient
+	**/
+	std::string generateCColumnsLiteral(std::string table_name = "inv_g_s") const;
+
+	/**
+		\brief generates C/C++ inline-able code of each fold set with setFolds()
+
+		Inputs of the code of a fold are the component source contributions of the fold, elements of
+		real b_components[<num_sources>], and the running sums of the rows it contributes to, which
+		are declared by the first fold into them.  The folds must be placed in the order they were set.
+
+		\param table_name name of the table of G^-1*S
+		\param sum_prefix name of the running sums, followed by their node, such as x_sum_ for x_sum_3
+		\return string containing the code of each fold, empty for folds contributing to no solved row
+	**/
+	std::vector<std::string> generateCFoldCode(std::string table_name = "inv_g_s", std::string sum_prefix = "x_sum_") const;
+
+	/**
+		\brief generates C/C++ inline-able code ending the solve x=(G^-1)*b, placed after the folds
+
+		The code folds the sources in no fold, then assigns the solutions of the solved rows their
+		running sums.  The output is real x[<num_nodes>+1] where x[0] is ground, same as SystemSolverGenerator.
+
+		\param table_name name of the table of G^-1*S
+		\param sum_prefix name of the running sums, followed by their node
+		\return string containing the generated code
+	**/
+	std::string generateCInlineCode(std::string table_name = "inv_g_s", std::string sum_prefix = "x_sum_") const;
+};
+
+} //namespace lblmc
+
+#endif //SYSTEMOVERLAPPEDSOLVERGENERATOR_HPP
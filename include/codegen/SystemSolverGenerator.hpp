@@ -32,17 +32,69 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 #include <vector>
 #include <string>
+#include <utility>
 
 namespace lblmc
 {
+
+class CodeIR;
 
 class SystemSolverGenerator
 {
+public:
+
+	/**
+		\brief independent block of the system solve x=(G^-1)*b
+
+		A block is a set of solutions x that depend only on a set of source vector b elements which
+		no solution outside of the block depends on.  Blocks are found from the nonzero pattern of
+		G^-1 and may be permuted anywhere within the matrix, so they need not be contiguous.
+	**/
+	struct Block
+	{
+		std::vector<unsigned int> rows; ///< indices of solutions in block, ascending (row r is solution x[r+1])
+		std::vector<unsigned int> cols; ///< indices of source vector elements b[c] in block, ascending
+	};
+
 private:
 	const double* A; ///< the inverted conductance matrix ( A = G^-1 of Gx=b )
 	unsigned int dimension; ///< number of solutions in the system Gx=b
 	unsigned int num_components; ///< number of components in system to contribute to vector b of Gx=b
 	double zero_bound; ///< range from zero when determining whether Aij*bi=xi is close to zero to be ignored; defaults to 1e-12.
+	std::vector<bool> solved_rows; ///< whether each row is solved by the generated code; empty solves all rows
+	unsigned int tree_fan_in; ///< number of operands per addition of the balanced adder trees summing the rows; 0 sums rows as left to right chains
+	bool tree_registered; ///< whether partial sums of the adder trees are registered for Xilinx HLS pipelining
+
+	/**
+		\brief term of a solution row in which a single coefficient is shared by several sources
+	**/
+	struct SharedTerm
+	{
+		unsigned int coeff_col; ///< column of G^-1 the coefficient of the term is taken from
+		std::vector<std::pair<unsigned int, bool>> sources; ///< source vector indices of the term paired with whether their sign is negated
+	};
+
+	std::vector<SharedTerm> factorRow(unsigned int r, double share_tolerance) const;
+	bool rowsEqual(unsigned int r1, unsigned int r2, double share_tolerance) const;
+	bool isZero(double a) const { return a < zero_bound && a > -zero_bound; }
+	bool isSolvedRow(unsigned int r) const { return solved_rows.empty() || solved_rows[r]; }
+
+	/**
+		\brief generates the statements assigning the sum of the terms of row r to x[r+1], as a left to
+		right chain or a balanced adder tree per the adder tree settings
+	**/
+	std::string generateRowSum(unsigned int r, const std::vector<std::string>& terms, const char* A_name) const;
+
+	/**
+		\brief generates an expression summing operands, each optionally led by '-' to subtract it, as a
+		balanced adder tree with tree_fan_in operands per addition; parenthesized if it has several groups
+	**/
+	std::string generateTreeExpression(const std::vector<std::string>& operands) const;
+
+	/**
+		\brief finds, for each block of width consecutive rows, the columns of G^-1 with a nonzero coefficient in the block
+	**/
+	std::vector<std::vector<unsigned int>> findSimdColumns(unsigned int width) const;
 
 public:
 
@@ -60,6 +112,65 @@ public:
 
 	void reset(const double* A, unsigned int dimension, unsigned int num_components, double zero_bound = 1.0e-12);
 	void reset(const SystemSolverGenerator& base);
+
+	/**
+		\brief sets which solutions are computed by generateCInlineCode() and generateCInlineCodeBlockSparse(),
+		and counted by countDenseMultiplies() and countBlockSparseMultiplies()
+
+		Solutions that are not solved are not assigned by the generated code at all, so they keep
+		whatever value x held before.  This is meant for solutions that nothing reads.
+
+		\param rows flags of the solved rows, one per solution (row r is solution x[r+1]); empty solves all rows
+		\throw invalid_argument if rows is neither empty nor of size dimension
+	**/
+	void setSolvedRows(const std::vector<bool>& rows);
+
+	/**
+		\return flags of the solved rows set by setSolvedRows(); empty if all rows are solved
+	**/
+	inline const std::vector<bool>& getSolvedRows() const { return solved_rows; }
+
+	/**
+		\brief sets the form of the sums of the rows in the code generated by generateCInlineCode() and
+		generateCInlineCodeBlockSparse()
+
+		By default, each row is summed as a left to right chain t0 + t1 + ... + tn-1, whose additions
+		depend on each other, so a row takes n-1 sequential additions.  With fan_in of 2 or more, the
+		terms are instead summed as a balanced tree with fan_in operands per addition, such as
+		((t0 + t1) + (t2 + t3)) for fan_in 2, so a row takes ceil(log_fan_in(n)) sequential additions
+		and the independent additions of a level can execute in parallel.  Parentheses are kept by
+		compilers without unsafe math optimizations, so the tree holds in the compiled code.
+
+		With registered set, the partial sums of each level of the trees are stored in temporaries
+		passed through lblmc_hls_reg<real>(), which must be defined by the code using the solve, such as
+		with generateCHlsRegisterDefinition(), to register them between levels for pipelining in Xilinx HLS.
+
+		\param fan_in number of operands per addition; 0 or 1 sums rows as left to right chains
+		\param registered whether to register the partial sums of each level of the trees; ignored for chains
+	**/
+	void setAdderTree(unsigned int fan_in, bool registered = false);
+
+	/**
+		\return number of operands per addition of the adder trees; 0 if rows are summed as chains
+	**/
+	inline unsigned int getAdderTreeFanIn() const { return tree_fan_in; }
+
+	/**
+		\brief generates the definition of the Xilinx HLS register function lblmc_hls_reg<T>() used by
+		registered adder trees; the definition is guarded so it can be included many times
+		\return string containing the C++ definition
+	**/
+	static std::string generateCHlsRegisterDefinition();
+
+	/**
+		\brief finds the critical path depth of the solve, the largest number of sequential arithmetic
+		operations (multiplications and additions) computing a solution, with the current adder tree settings
+		\param block_sparse whether the depth is of the code generated by generateCInlineCodeBlockSparse()
+		instead of generateCInlineCode()
+		\param share_tolerance relative difference under which two coefficients of a row are treated as equal; default is 1e-12
+		\return the critical path depth in operations; 0 if no solution depends on the sources
+	**/
+	unsigned int countCriticalPathDepth(bool block_sparse = false, double share_tolerance = 1.0e-12) const;
 
 	/**
 		\brief generates C/C++ inline-able code that includes only the solver for x=(G^-1)*b
@@ -74,7 +185,103 @@ public:
 		\deprecated This method is to be replaced by std::string generateCInlineCode(std::string invg_name) const;
 	**/
 	void generateCInlineCode(std::string& buffer, const char* invg_name = "inv_g");
+
+	/**
+		\brief appends the solver for x=(G^-1)*b to an IR of code, for optimization before it is printed
+
+		The appended assignments are those of generateCInlineCode() with rows summed as left to right
+		chains: x[0] is assigned zero, and each solved row r assigns x[r+1] the sum of the products
+		of the coefficients of row r of G^-1 not close to zero and their elements of b.
+
+		\param ir the IR of code to append the assignments to
+		\param invg_array index in ir of the CONSTANT array of G^-1, of dimension by dimension elements
+		holding the inverted conductance matrix of this generator
+		\param b_array index in ir of the array of the source vector b, whose elements must be assigned
+		\param x_array index in ir of the array of the solutions x, of dimension+1 elements
+		\throw runtime_error if the conductance matrix or dimension is not set
+	**/
+	void generateCodeIR(CodeIR& ir, unsigned int invg_array, unsigned int b_array, unsigned int x_array) const;
+
+	/**
+		\brief finds the independent blocks of the system solve x=(G^-1)*b
+
+		Solutions that are coupled through a common nonzero source vector element are placed in the
+		same block.  Solutions with no nonzero coefficients in G^-1 are not part of any block.
+
+		\return blocks of the system solve, ordered by their first solution
+	**/
+	std::vector<Block> findBlocks() const;
+
+	/**
+		\brief generates C/C++ inline-able code for the solver x=(G^-1)*b that exploits the sparsity
+		of G^-1
+
+		The solve is emitted as one kernel per independent block found by findBlocks().  Within a
+		row, sources whose coefficients are equal in magnitude share one multiplication, such as
+		inv_g[r][c]*(b[c] - b[d]), and rows that equal an earlier row of the same block are copied
+		instead of recomputed.
+
+		Input and output of the inline code are the same as those of generateCInlineCode().
+
+		\param buffer the string that will store the generated code
+		\param invg_name name of the inverted conductance matrix G^-1; default is inv_g
+		\param share_tolerance relative difference under which two coefficients of a row are treated as equal; default is 1e-12
+	**/
+	void generateCInlineCodeBlockSparse(std::string& buffer, const char* invg_name = "inv_g", double share_tolerance = 1.0e-12) const;
+
+	/**
+		\return number of multiplications in the code generated by generateCInlineCode()
+	**/
+	unsigned int countDenseMultiplies() const;
+
+	/**
+		\param share_tolerance relative difference under which two coefficients of a row are treated as equal; default is 1e-12
+		\return number of multiplications in the code generated by generateCInlineCodeBlockSparse()
+	**/
+	unsigned int countBlockSparseMultiplies(double share_tolerance = 1.0e-12) const;
 
+	/**
+		\brief generates C/C++ code of the vector type and the constant table used by the code of generateCInlineCodeSimd()
+
+		Rows of G^-1 are grouped into blocks of width consecutive rows, the last block padded with
+		zero rows.  For each block, the column segments that have a nonzero coefficient are stored
+		as vectors, in the order they are used by the solve, in a flat table of the vector type
+		real __attribute__((vector_size(width*sizeof(real)))).  The vector type is aligned to its
+		size, so the table is aligned for vector loads.
+
+		\note the vector type uses GCC vector extensions (also supported by Clang), so real must be a
+		floating point type.
+
+		\param width number of rows per vector; must be a power of 2
+		\param table_name name of the table; the vector type is named <table_name>_vec
+		\return string containing the definitions of the vector type and the table
+	**/
+	std::string generateCSimdLiteral(unsigned int width, const std::string& table_name = "inv_g_simd") const;
+
+	/**
+		\brief generates C/C++ inline-able code for the solver x=(G^-1)*b as explicit SIMD vector operations
+
+		Each block of width rows is solved as a sum of its nonzero column segments of G^-1, each
+		multiplied by the source vector element of its column, accumulated into num_accumulators
+		interleaved vector accumulators to shorten the chain of dependent additions.  The sums are
+		then written to the solutions of the block.
+
+		Input and output of the inline code are the same as those of generateCInlineCode(), and
+		the code needs the definitions from generateCSimdLiteral() with the same width and name.
+
+		\param buffer the string that will store the generated code
+		\param width number of rows per vector; must be a power of 2
+		\param table_name name of the table from generateCSimdLiteral()
+		\param num_accumulators number of vector accumulators per block of rows; default is 4
+	**/
+	void generateCInlineCodeSimd(std::string& buffer, unsigned int width, const std::string& table_name = "inv_g_simd", unsigned int num_accumulators = 4) const;
+
+	/**
+		\param width number of rows per vector
+		\return number of vector multiplications in the code generated by generateCInlineCodeSimd()
+	**/
+	unsigned int countSimdMultiplies(unsigned int width) const;
+
 	/**
 		\brief generates C/C++ code for system solver function to solve x=(G^-1)*b
 
@@ -38,6 +38,8 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 namespace lblmc
 {
 
+class CodeIR;
+
 /**
  * \brief encapsulates information of the source vector b of a system model in LB-LMC method
  *
@@ -123,6 +125,21 @@ public:
 	 */
 	unsigned int getNumSources() const;
 
+	/**
+		\brief gets the number of source contributions to an element of the source vector
+		\param i the zero-based index of the source vector element b[i]
+		\return the number of sources contributing to b[i]
+	**/
+	unsigned int getNumContributions(unsigned int i) const;
+
+	/**
+		\brief gets the sources contributing to an element of the source vector
+		\param i the zero-based index of the source vector element b[i]
+		\return the signed ids of the sources contributing to b[i]; source id s is held in
+		b_components[s-1] and is negated when b[i] is the negative node of the source
+	**/
+	const std::vector<long>& getContributions(unsigned int i) const;
+
 	/**
 		\brief gets the node indices for a source indicated by the source's id
 		\param source_id id of the source
@@ -205,6 +222,23 @@ public:
 	**/
 	std::string asCInlineCode() const;
 
+	/**
+		\brief generates compilable inlined C/C++ code to aggregate selected elements of the source vector b from source contributions
+		Same as asCInlineCode() except that only the elements b[i] for which rows[i] is true are computed.
+		\param rows flags of the source vector elements to compute; must have an element per source vector element
+		\return string that will store the source code that is inline-able.
+	**/
+	std::string asCInlineCode(const std::vector<bool>& rows) const;
+
+	/**
+		\brief appends the aggregation of the source vector b to an IR of code, for optimization before it is printed
+		Every element b[i] is assigned the signed sum of its source contributions, or zero if it has none, as by asCInlineCode().
+		\param ir the IR of code to append the assignments to
+		\param b_array index in ir of the array of the source vector b, of dimension elements
+		\param b_components_array index in ir of the array of the source contributions, of an element per source
+	**/
+	void generateCodeIR(CodeIR& ir, unsigned int b_array, unsigned int b_components_array) const;
+
 	/**
 	 * Generates the C/C++ source code for a function that aggregates/computes the source vector b from array of given source contributions
 	 * The generated function is created from the indices stored in this object.
@@ -30,6 +30,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include <stdexcept>
 
 #include "codegen/ResistiveCompanionElements.hpp"
+#include "codegen/CodeTemplate.hpp"
 
 namespace lblmc
 {
@@ -58,6 +59,8 @@ class Component
 protected:
 
 	std::string comp_name;
+	unsigned int rate_divisor; ///< generated component is updated every rate_divisor time steps
+	unsigned int rate_phase; ///< time step, modulo rate_divisor, on which generated component is updated
 
 public:
 
@@ -69,18 +72,33 @@ public:
 	const static std::string INTEGRATION_GEAR;
 	const static std::string INTEGRATION_RUNGE_KUTTA_4; //Runge Kutta 4th order
 
+	/**
+		\brief code generated by a component for a solver, before it is inserted into the solver
+		engine generator
+	**/
+	struct GeneratedCode
+	{
+		std::string parameters;
+		std::string fields;
+		std::string inputs;
+		std::vector<std::string> outputs; ///< code of each requested output
+		std::vector<std::string> outputs_update_bodies; ///< update body of each requested output
+		std::string update_body;
+	};
+
 	/**
 		\brief default constructor
 		\param comp_name name/label for the component generated.  Inheritors of this class should
 		throw error if comp_name is null ("").  This name should be unique for all components
 		generated.
 	**/
-	explicit Component(std::string comp_name = "") : comp_name(comp_name) {}
+	explicit Component(std::string comp_name = "") : comp_name(comp_name), rate_divisor(1), rate_phase(0) {}
 
 	/**
 		\brief copy constructor
 	**/
-	Component(const Component& base) : comp_name(base.comp_name) {}
+	Component(const Component& base) :
+		comp_name(base.comp_name), rate_divisor(base.rate_divisor), rate_phase(base.rate_phase) {}
 
 	/**
 		\return type of component
@@ -108,6 +126,37 @@ public:
 	**/
 	inline const std::string& getName() const { return comp_name; }
 
+	/**
+		\brief sets the rate of the updates of the generated component in the solver
+
+		A component updated every divisor time steps holds its source contributions in between, so
+		its companion model should be discretized with a time step of divisor times that of the
+		solver.  This suits slow components such as large capacitors and cable inductors in models
+		with fast switching converters.
+
+		\param divisor generated component is updated every divisor time steps
+		\param phase time step, modulo divisor, on which generated component is updated
+	**/
+	inline void setRate(unsigned int divisor, unsigned int phase = 0)
+	{
+		if(divisor == 0 || phase >= divisor)
+		{
+			throw std::invalid_argument("Component::setRate(): divisor must be positive nonzero and phase must be less than it");
+		}
+		rate_divisor = divisor;
+		rate_phase = phase;
+	}
+
+	/**
+		\return number of time steps between updates of the generated component
+	**/
+	inline unsigned int getRateDivisor() const { return rate_divisor; }
+
+	/**
+		\return time step, modulo the rate divisor, on which the generated component is updated
+	**/
+	inline unsigned int getRatePhase() const { return rate_phase; }
+
 	/**
 		\return number of terminals supported by generated component
 	**/
@@ -223,6 +272,26 @@ public:
 	**/
 	virtual void stampSystem(SolverEngineGenerator& gen, const std::vector<std::string>& outputs = {"ALL"});
 
+	/**
+		\brief generates the code of the generated component that stampSystem() inserts into the
+		solver engine generator
+
+		The code depends only on the component and the source ids given to it by stampSources(), so
+		components can generate their code concurrently once their sources are stamped.
+
+		\param outputs vector of supported outputs that generated component will have; default is ALL outputs supported
+		\return the generated code
+	**/
+	GeneratedCode generateCode(const std::vector<std::string>& outputs = {"ALL"});
+
+	/**
+		\brief inserts code generated by generateCode() into the simulation solver engine generator,
+		with the update rate of the generated component
+		\param gen the simulation solver engine generator that creates solver code for the system generated component resides
+		\param code the code generated by generateCode()
+	**/
+	void insertCode(SolverEngineGenerator& gen, GeneratedCode& code) const;
+
 	/**
 		\brief generates constant static parameters body code for generated component
 	**/
@@ -297,6 +366,14 @@ protected:
 	**/
 	std::string& appendNameToWords(std::string& body, const std::vector<std::string>& words) const;
 
+	/**
+		\brief sets substitutions appending component name to given words
+		\param subs substitutions of a code template to set
+		\param words words of the template that will have component name appended to
+		\return reference to subs
+	**/
+	CodeTemplate::Substitutions& appendNameToWords(CodeTemplate::Substitutions& subs, const std::vector<std::string>& words) const;
+
 	/**
 		\brief replaces source name in given code body with source contribution vector b_components[id]
 		\param body string the contains code body to modify
@@ -306,6 +383,15 @@ protected:
 	**/
 	std::string& replaceSourceNameWithSourceContributionVector(std::string& body, const std::string& src_name, unsigned int source_id );
 
+	/**
+		\brief sets substitution of source name with source contribution vector b_components[id]
+		\param subs substitutions of a code template to set
+		\param src_name name of the source that will be replaced, optionally dereferenced as *bout
+		\param source_id source contribution index of the source
+		\return reference to subs
+	**/
+	CodeTemplate::Substitutions& replaceSourceNameWithSourceContributionVector(CodeTemplate::Substitutions& subs, const std::string& src_name, unsigned int source_id ) const;
+
 	/**
 		\brief replaces terminal connection names with given id
 		\param body string the contains code body to modify
@@ -315,6 +401,15 @@ protected:
 	**/
 	std::string& replaceTerminalConnectionNameWithIndex(std::string& body, const std::string& term_name, unsigned int index);
 
+	/**
+		\brief sets substitution of terminal connection name with given id
+		\param subs substitutions of a code template to set
+		\param term_name name of the terminal connection that will be replaced with index
+		\param index index value to replace name of terminal connection
+		\return reference to subs
+	**/
+	CodeTemplate::Substitutions& replaceTerminalConnectionNameWithIndex(CodeTemplate::Substitutions& subs, const std::string& term_name, unsigned int index) const;
+
 	/**
 		\brief generates string for a parameter
 	**/
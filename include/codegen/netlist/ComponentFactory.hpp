@@ -158,6 +158,15 @@ public:
 	**/
 	ComponentPtr produceComponent(const ComponentListing& listing);
 
+	/**
+		\brief produces component code generator objects for given component listings concurrently
+		\param listings ComponentListing listings describing the components, such as those of a netlist
+		\param num_threads number of threads to use; 0 uses one per hardware thread
+		\return unique pointers that own the produced component code generators, in order of the listings
+		\throw error of the first listing, in order, whose producer doesn't exist or for which it is malformed
+	**/
+	std::vector<ComponentPtr> produceComponents(const std::vector<ComponentListing>& listings, unsigned int num_threads = 0);
+
 };
 
 } //namespace lblmc
@@ -49,6 +49,8 @@ private:
 	std::string label; ///< label of the component
 	std::vector<double> parameters; ///< list of parameters for component
 	std::vector<unsigned int> terminal_connections; ///< list of node network connections
+	unsigned int rate_divisor; ///< component is updated every rate_divisor time steps
+	unsigned int rate_phase; ///< time step, modulo rate_divisor, on which component is updated
 
 public:
 
@@ -112,12 +114,39 @@ public:
 		An example for a capacitor (DT=50ns, C=300mF; on nodes 1 and 2) is:\n
 		Capacitor cap_1(50e-9, 300e-3) { 1, 2 }
 
-		A future version of the component line syntax may support code generation options in
-		square brackets.
+		Code generation options of the component may follow the node indices in square brackets,
+		as comma separated name=value pairs:\n
+		<pre>
+		rate=k  -- component is updated every k time steps instead of every time step; default is 1
+		phase=p -- component is updated on time steps p, p+k, p+2k, ...; 0 to k-1, default is 0
+		</pre>
+
+		An example for a DC link capacitor updated every 20 time steps (its time step parameter
+		should be given as 20*DT=1us) is:\n
+		Capacitor cap_dc(1e-6, 5e-3) { 1, 2 } [rate=20, phase=3]
 
 	**/
 	void setFromNetlistLine(const std::string& listing);
 
+	/**
+		\brief sets this component listing from a netlist line given as a range of characters
+
+		Lines of the common form without options are tokenized in place, without copies; other
+		lines are parsed by setFromNetlistLine(const std::string&), with the same results and errors.
+
+		\param begin pointer to first character of the line
+		\param end pointer past the last character of the line
+		\throw invalid_argument if the line has invalid syntax
+	**/
+	void setFromNetlistLine(const char* begin, const char* end);
+
+	/**
+		\brief gets the component listing line of this listing for a plaintext netlist
+		\return listing line in the syntax of setFromNetlistLine(), with parameters given to 15
+		significant digits
+	**/
+	std::string toNetlistLine() const;
+
 	void setType(std::string t);
 
 	void setLabel(std::string l);
@@ -170,6 +199,24 @@ public:
 
 	void addTerminalConnection(unsigned int tc);
 
+	/**
+		\brief sets the rate of the component updates in generated solvers
+		\param divisor component is updated every divisor time steps; must be positive nonzero
+		\param phase time step, modulo divisor, on which component is updated; must be less than divisor
+		\throw invalid_argument if divisor or phase is invalid
+	**/
+	void setRate(unsigned int divisor, unsigned int phase = 0);
+
+	/**
+		\return number of time steps between updates of the component; 1 if updated every time step
+	**/
+	unsigned int getRateDivisor() const;
+
+	/**
+		\return time step, modulo the rate divisor, on which the component is updated
+	**/
+	unsigned int getRatePhase() const;
+
 	const std::string& getType() const;
 
 	const std::string& getLabel() const;
@@ -26,6 +26,8 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include <vector>
 #include <string>
 #include <utility>
+#include <stdexcept>
+#include <unordered_map>
 
 #include "codegen/netlist/ComponentListing.hpp"
 
@@ -47,6 +49,7 @@ private:
 
 	std::string model_name; ///< name of the system model taken from netlist
 	std::vector<ComponentListing> components; ///< netlist definitions of model components
+	std::unordered_map<std::string, unsigned int> component_indices; ///< index in components of each component label
 	unsigned int num_nodes; ///< number of nodes in system model
 
 public:
@@ -57,6 +60,7 @@ public:
 	Netlist() :
 		model_name(),
 		components(),
+		component_indices(),
 		num_nodes(0)
 	{}
 
@@ -66,6 +70,7 @@ public:
 	Netlist(const Netlist& base) :
 		model_name(base.model_name),
 		components(base.components),
+		component_indices(base.component_indices),
 		num_nodes(base.num_nodes)
 	{}
 
@@ -75,6 +80,7 @@ public:
 	Netlist(Netlist&& base) :
 		model_name(std::move(base.model_name)),
 		components(std::move(base.components)),
+		component_indices(std::move(base.component_indices)),
 		num_nodes(std::move(base.num_nodes))
 	{}
 
@@ -82,15 +88,17 @@ public:
 	{
 		model_name = base.model_name;
 		components = base.components;
+		component_indices = base.component_indices;
 		num_nodes  = base.num_nodes;
 
         return *this;
 	}
 
-	Netlist& operator=(const Netlist&& base)
+	Netlist& operator=(Netlist&& base)
 	{
 		model_name = std::move(base.model_name);
 		components = std::move(base.components);
+		component_indices = std::move(base.component_indices);
 		num_nodes  = std::move(base.num_nodes);
 
         return *this;
@@ -102,8 +110,14 @@ public:
 		model_name = mn;
 	}
 
+	/**
+		\brief adds a component to the netlist
+		\param comp the netlist component
+		\return true if the label of the component is new to the netlist, or false if a component
+		with the same label was already added
+	**/
 	inline
-	void addComponent(const ComponentListing& comp)
+	bool addComponent(const ComponentListing& comp)
 	{
 		for(const auto& term_conn : comp.getTerminalConnections())
 		{
@@ -113,11 +127,20 @@ public:
 			}
 		}
 
+		const bool is_new = component_indices.emplace(comp.getLabel(), components.size()).second;
 		components.push_back(comp);
+
+		return is_new;
 	}
 
+	/**
+		\brief adds a component to the netlist by moving it
+		\param comp the netlist component
+		\return true if the label of the component is new to the netlist, or false if a component
+		with the same label was already added
+	**/
 	inline
-	void addComponent(ComponentListing&& comp)
+	bool addComponent(ComponentListing&& comp)
 	{
 		for(const auto& term_conn : comp.getTerminalConnections())
 		{
@@ -127,7 +150,43 @@ public:
 			}
 		}
 
-		components.push_back(comp);
+		const bool is_new = component_indices.emplace(comp.getLabel(), components.size()).second;
+		components.push_back(std::move(comp));
+
+		return is_new;
+	}
+
+	/**
+		\brief reserves storage for a number of components, to add them without reallocation
+		\param n number of components to reserve storage for
+	**/
+	inline
+	void reserveComponents(unsigned int n)
+	{
+		components.reserve(n);
+		component_indices.reserve(n);
+	}
+
+	/**
+		\brief sets the number of nodes of the netlist, to count nodes that are not terminals of any component
+		\param n number of nodes; cannot be less than the largest terminal index of the components
+		\throw invalid_argument if n is less than the largest terminal index of the components
+	**/
+	inline
+	void setNumberOfNodes(unsigned int n)
+	{
+		for(const auto& comp : components)
+		{
+			for(const auto& term_conn : comp.getTerminalConnections())
+			{
+				if(term_conn > n)
+				{
+					throw std::invalid_argument("Netlist::setNumberOfNodes(): number of nodes is less than terminal index of component " + comp.getLabel());
+				}
+			}
+		}
+
+		num_nodes = n;
 	}
 
 	inline
@@ -172,15 +231,20 @@ public:
 	inline
 	bool hasComponent(const std::string& component_label) const
 	{
-		for (auto& comp : components)
-		{
-			if(comp.getLabel() == component_label)
-			{
-				return true;
-			}
-		}
+		return component_indices.find(component_label) != component_indices.end();
+	}
+
+	/**
+		\brief finds the netlist component of a label
+		\param component_label label of the component
+		\return pointer to the first netlist component added with the label, or nullptr if there is none
+	**/
+	inline
+	const ComponentListing* findComponent(const std::string& component_label) const
+	{
+		const auto iter = component_indices.find(component_label);
 
-		return false;
+		return (iter != component_indices.end()) ? &components[iter->second] : nullptr;
 	}
 };
 
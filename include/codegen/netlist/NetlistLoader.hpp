@@ -25,7 +25,8 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 #include <string>
 #include <vector>
-#include <map>
+#include <unordered_map>
+#include <utility>
 #include <istream>
 
 #include "codegen/netlist/Netlist.hpp"
@@ -34,6 +35,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 namespace lblmc
 {
 
+class ModelCache;
 
 /**
 	\brief Loads a LB-LMC Model Definition from a plain text netlist file or string
@@ -87,6 +89,11 @@ namespace lblmc
 	Indices must be positive from 0 onwards.  The index 0 indicates the system model's common/ground
 	point.
 
+	The netlist text is read into memory whole and scanned line by line in order, handling the
+	commands; the component lines are then parsed independently, optionally on several threads,
+	and added to the netlist in order, with labels checked for redefinition through the label index
+	of Netlist.  Errors are reported for the first offending line, as in a line by line load.
+
 **/
 class NetlistLoader
 {
@@ -96,6 +103,23 @@ public:
 	NetlistLoader();
 	NetlistLoader(const NetlistLoader& base) = delete;
 
+	/**
+		\brief parameter constructor
+		\param num_threads number of threads parsing component lines; 0 uses one per hardware thread
+	**/
+	explicit NetlistLoader(unsigned int num_threads);
+
+	/**
+		\brief sets the number of threads parsing component lines
+		\param n number of threads; 0 uses one per hardware thread; default is 1
+	**/
+	inline void setNumberOfThreads(unsigned int n) { num_threads = n; }
+
+	/**
+		\return number of threads parsing component lines; 0 if one per hardware thread
+	**/
+	inline unsigned int getNumberOfThreads() const { return num_threads; }
+
 	/**
 		\brief loads a netlist from input stream
 		\param strm input stream from where netlist is coming from;
@@ -121,8 +145,28 @@ public:
 	**/
 	Netlist loadFromFile(const std::string& filename);
 
+	/**
+		\brief loads a netlist from text file given by its filename, through a model cache
+
+		The netlist is taken from the cache if the cache holds the netlist of the same text, and is
+		otherwise loaded from the text and kept in the cache.
+
+		\param filename file name of the netlist file
+		\param cache the model cache
+		\return Netlist object defining the netlist
+		\throw throws error if file is malformed
+	**/
+	Netlist loadFromFile(const std::string& filename, ModelCache& cache);
+
 private:
 
+	/**
+		\brief value and definition order of each constant, by name
+	**/
+	typedef std::unordered_map< std::string, std::pair<std::string, unsigned int> > ConstantTable;
+
+	unsigned int num_threads;
+
 	const static std::string WHITESPACE_CHARS;
 	const static std::string BAD_START_CHARS;
 	const static std::string VALID_NAME_CHARS;
@@ -144,7 +188,24 @@ private:
 	LineType checkLineType(const std::string& line, size_t& line_pos);
 	std::string extractModelName(const std::string& line, const size_t& line_pos);
 	std::string extractConstantValue(const std::string& line, const size_t& line_pos, std::string& name);
-	ComponentListing extractComponent(const std::string& line, const std::map<std::string,std::string>& constants);
+	ComponentListing extractComponent(const char* begin, const char* end, const ConstantTable& constants, unsigned int num_constants) const;
+
+	/**
+		\brief loads a netlist from netlist text in memory
+		\param text the netlist text
+		\param size number of characters of text
+		\return Netlist object defining the netlist
+		\throw invalid_argument if netlist is malformed
+	**/
+	Netlist loadFromText(const char* text, std::size_t size);
+
+	/**
+		\brief reads the whole text of a netlist file
+		\param filename file name of the netlist file
+		\return the text of the file
+		\throw runtime_error if the file cannot be opened or read
+	**/
+	static std::string readFile(const std::string& filename);
 
 };
 
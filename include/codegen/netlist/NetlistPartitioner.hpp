@@ -0,0 +1,125 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef LBLMC_NETLISTPARTITIONER_HPP
+#define LBLMC_NETLISTPARTITIONER_HPP
+
+#include <string>
+#include <vector>
+#include <set>
+
+#include "codegen/netlist/Netlist.hpp"
+#include "codegen/netlist/ComponentListing.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief partitions a LB-LMC system model netlist into subsystems for nodal decomposition
+
+	The partitioner finds the latency-decoupling components of a netlist, which by default are
+	2-terminal Inductor and Capacitor components connected in series between two non-ground nodes.
+	The rest of the components tie their nodes together into clusters that cannot be split.  These
+	clusters are grouped into the requested number of subsystems of balanced node counts by
+	greedily growing each subsystem across the decoupling components, so that subsystems stay
+	connected and few decoupling components are cut.
+
+	A cut decoupling component is placed in one of the two subsystems it connects, which holds a
+	local copy of the component's terminal node owned by the other subsystem.  A port (with
+	ground as negative terminal) is then declared at the copy node in the holding subsystem and at
+	the original node in the owning subsystem, both sharing the same port id.  Each subsystem
+	netlist is renumbered to local node indices starting at 1.
+
+	Components that define solutions through their parameters (IdealVoltageSource and
+	IdealFunctionalVoltageSource) cannot be renumbered and are not supported.
+
+	\see DecomposedSolverEngineGenerator for generator that builds subsystem solvers from these
+	partitions
+**/
+class NetlistPartitioner
+{
+public:
+
+	/**
+		\brief port of a subsystem netlist between a local node and ground
+	**/
+	struct Port
+	{
+		unsigned int id;   ///< id of the port shared by the two subsystems it connects
+		unsigned int node; ///< local node index of the port's positive terminal
+		unsigned int other_subsystem; ///< index of the subsystem on the other side of the port
+	};
+
+	/**
+		\brief subsystem netlist produced by partitioning
+	**/
+	struct Subsystem
+	{
+		Netlist netlist; ///< netlist of the subsystem with local node indices
+		std::vector<unsigned int> global_nodes; ///< global node index of each local node; global_nodes[l-1] for local node l
+		unsigned int num_owned_nodes; ///< local nodes 1 to num_owned_nodes are owned; the rest are copies of nodes owned by other subsystems
+		std::vector<Port> ports; ///< ports of the subsystem
+	};
+
+private:
+
+	std::set<std::string> decoupling_types; ///< component types that can be cut between subsystems
+	unsigned int num_cut_components; ///< number of decoupling components cut by last partitioning
+
+	bool isDecoupling(const ComponentListing& comp) const;
+
+public:
+
+	/**
+		\brief default constructor; decoupling component types are Inductor and Capacitor
+	**/
+	NetlistPartitioner();
+
+	/**
+		\brief sets the component types that can be cut between subsystems
+		\param types names of component types; only 2-terminal components of these types are cut
+	**/
+	void setDecouplingComponentTypes(const std::set<std::string>& types);
+
+	inline const std::set<std::string>& getDecouplingComponentTypes() const { return decoupling_types; }
+
+	/**
+		\return number of decoupling components cut by the last call to partition()
+	**/
+	inline unsigned int getNumberOfCutComponents() const { return num_cut_components; }
+
+	/**
+		\brief partitions the given netlist into subsystems
+		\param netlist the netlist of the system model to partition
+		\param num_subsystems number of subsystems to partition into; must be 1 or greater
+		\return the subsystems, named <model_name>_sub<index>
+		\throw invalid_argument if num_subsystems is 0
+		\throw runtime_error if netlist has unsupported components, cannot be split into the
+		number of subsystems, or a node would have to be shared with more than one other subsystem
+	**/
+	std::vector<Subsystem> partition(const Netlist& netlist, unsigned int num_subsystems);
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_NETLISTPARTITIONER_HPP
@@ -0,0 +1,122 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef LBLMC_NETLISTRENUMBERER_HPP
+#define LBLMC_NETLISTRENUMBERER_HPP
+
+#include <string>
+#include <vector>
+
+#include "codegen/netlist/Netlist.hpp"
+#include "codegen/netlist/ComponentListing.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief renumbers the nodes of a LB-LMC system model netlist for structure of its conductance matrix
+
+	Node indices given in a netlist follow however its author numbered the nodes, so the structure
+	of the conductance matrix G and the order in which the generated solver accesses the solution
+	and source vectors follow it too.  The renumberer permutes the nodes of a netlist by a
+	fill-reducing and locality-improving ordering of the graph of G, in which two nodes are adjacent
+	if they are terminals of the same component.  The orderings are:\n
+	<pre>
+	NATURAL -- nodes are kept as numbered in the netlist
+	RCM     -- reverse Cuthill-McKee; minimizes the bandwidth of G, placing coupled nodes at near
+	           indices, so blocks of G^-1 and accesses to x and b in the generated code are
+	           contiguous
+	AMD     -- approximate minimum degree; minimizes the fill-in of the factors of G
+	</pre>
+	The solution ids given by the parameters of IdealVoltageSource and IdealFunctionalVoltageSource
+	components are renumbered with the nodes.  The netlist node of each renumbered node is kept
+	by getNetlistNodes(), which SolverEngineGeneratorParameters::io_solution_netlist_nodes takes to
+	map the solutions back to the netlist node order at the interface of the generated solver.
+**/
+class NetlistRenumberer
+{
+public:
+
+	/**
+		\brief orderings of renumbered nodes
+	**/
+	enum Ordering
+	{
+		NATURAL,
+		RCM,
+		AMD
+	};
+
+private:
+
+	std::vector<unsigned int> netlist_nodes; ///< netlist node of each renumbered node; netlist_nodes[k-1] for renumbered node k
+	unsigned int bandwidth_before; ///< bandwidth of graph of G before last renumbering
+	unsigned int bandwidth_after; ///< bandwidth of graph of G after last renumbering
+
+	static std::vector< std::vector<unsigned int> > buildAdjacency(const Netlist& netlist);
+	static std::vector<unsigned int> orderRCM(const std::vector< std::vector<unsigned int> >& adjacency);
+	static std::vector<unsigned int> orderAMD(const std::vector< std::vector<unsigned int> >& adjacency);
+	static unsigned int computeBandwidth(const std::vector< std::vector<unsigned int> >& adjacency, const std::vector<unsigned int>& new_nodes);
+
+public:
+
+	NetlistRenumberer();
+
+	/**
+		\brief renumbers the nodes of the given netlist
+		\param netlist the netlist of the system model to renumber
+		\param ordering the ordering of the renumbered nodes
+		\return the netlist with renumbered nodes; its components are in the same order as in
+		the given netlist
+	**/
+	Netlist renumber(const Netlist& netlist, Ordering ordering);
+
+	/**
+		\return netlist node of each node renumbered by the last call to renumber(); element k-1
+		for renumbered node k
+	**/
+	inline const std::vector<unsigned int>& getNetlistNodes() const { return netlist_nodes; }
+
+	/**
+		\return bandwidth of G before the last call to renumber(), as largest difference of the
+		indices of two adjacent nodes
+	**/
+	inline unsigned int getBandwidthBefore() const { return bandwidth_before; }
+
+	/**
+		\return bandwidth of G after the last call to renumber()
+	**/
+	inline unsigned int getBandwidthAfter() const { return bandwidth_after; }
+
+	/**
+		\brief gets the ordering named by a string
+		\param name name of the ordering: natural, rcm or amd
+		\return the ordering
+		\throw invalid_argument if name is not of an ordering
+	**/
+	static Ordering getOrdering(const std::string& name);
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_NETLISTRENUMBERER_HPP
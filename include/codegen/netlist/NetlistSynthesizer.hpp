@@ -0,0 +1,220 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef LBLMC_NETLISTSYNTHESIZER_HPP
+#define LBLMC_NETLISTSYNTHESIZER_HPP
+
+#include <string>
+#include <vector>
+
+#include "codegen/netlist/Netlist.hpp"
+#include "codegen/netlist/ComponentListing.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief parameters of the components of synthesized netlists
+**/
+struct NetlistSynthesizerParameters
+{
+	double dt;                    ///< time step of the model (s)
+	double source_voltage;        ///< voltage of the DC sources (V)
+	double source_resistance;     ///< internal resistance of the DC sources (ohm)
+	double line_resistance;       ///< series resistance of a line or cable segment (ohm)
+	double line_inductance;       ///< series inductance of a line or cable segment (H)
+	double shunt_capacitance;     ///< capacitance from a bus node to ground (F)
+	double load_resistance;       ///< resistance of a load from a bus node to ground (ohm)
+	double converter_capacitance; ///< DC side capacitance of a converter (F)
+	double converter_inductance;  ///< AC side leg inductance of a converter (H)
+	double converter_resistance;  ///< AC side leg resistance of a converter (ohm)
+	unsigned int slow_rate_divisor; ///< line inductors and shunt capacitors are updated every slow_rate_divisor time steps
+
+	NetlistSynthesizerParameters() :
+		dt(50.0e-9),
+		source_voltage(1000.0),
+		source_resistance(0.01),
+		line_resistance(0.01),
+		line_inductance(1.0e-6),
+		shunt_capacitance(1.0e-6),
+		load_resistance(10.0),
+		converter_capacitance(1.0e-3),
+		converter_inductance(1.0e-4),
+		converter_resistance(1.0e-4),
+		slow_rate_divisor(1)
+	{}
+};
+
+/**
+	\brief synthesizes netlists of parametric system models of arbitrary size for scaling studies
+
+	The synthesizer builds netlists of regular topologies from the existing component types, so that
+	code generation time, memory and generated solver step cost can be profiled as functions of
+	system size.  The topologies and their node counts are:\n
+	<pre>
+	LADDER     -- source feeding a chain of sections, each a series R-L line segment with a
+	              shunt C and load R at its end; 2*size+1 nodes
+	MESH       -- rows x cols grid of buses with R branches along rows and L branches along
+	              columns, a shunt C and load R at each bus, and a source at the first bus;
+	              rows*cols nodes
+	FEEDER     -- radial distribution feeder of size buses in a tree with branching children
+	              per bus, each lateral a series R-L line segment, a shunt C and load R at each
+	              bus, and a source at the root bus; 2*size-1 nodes
+	MICROGRID  -- bipolar DC bus from two sources daisy-chained through R-L cable segments to
+	              size BridgeConverter3LegIdealSwitches converters, each with a 3-phase shunt C
+	              and load R on its AC side; 7*size+2 nodes
+	</pre>
+	The converters of the microgrid have their switching inputs exposed by the generated solver;
+	with all switches disabled they behave as diode bridges.
+
+	With a slow_rate_divisor k above 1, the line inductors and shunt capacitors are listed with
+	rate k and a time step of k*dt, and their phases are staggered so each time step updates about
+	1/k of them, giving multirate models of slow networks around fast sources and converters.
+
+	\see NetlistSynthesizerParameters for the component parameters
+**/
+class NetlistSynthesizer
+{
+public:
+
+	/**
+		\brief topologies of synthesized netlists
+	**/
+	enum Topology
+	{
+		LADDER,
+		MESH,
+		FEEDER,
+		MICROGRID
+	};
+
+private:
+
+	NetlistSynthesizerParameters params;
+
+	void addComponent
+	(
+		Netlist& netlist,
+		std::string type,
+		std::string label,
+		std::vector<double> parameters,
+		std::vector<unsigned int> terminals
+	) const;
+
+	void addSlowComponent
+	(
+		Netlist& netlist,
+		std::string type,
+		std::string label,
+		double value,
+		std::vector<unsigned int> terminals
+	) const;
+
+	void addBusShunts(Netlist& netlist, const std::string& suffix, unsigned int node) const;
+
+public:
+
+	NetlistSynthesizer();
+	NetlistSynthesizer(const NetlistSynthesizerParameters& params);
+
+	inline void setParameters(const NetlistSynthesizerParameters& p) { params = p; }
+	inline const NetlistSynthesizerParameters& getParameters() const { return params; }
+
+	/**
+		\brief synthesizes a ladder netlist
+		\param model_name name of the model of the netlist
+		\param sections number of line sections; must be 1 or greater
+		\return the netlist with 2*sections+1 nodes
+		\throw invalid_argument if sections is 0
+	**/
+	Netlist synthesizeLadder(std::string model_name, unsigned int sections) const;
+
+	/**
+		\brief synthesizes a mesh netlist
+		\param model_name name of the model of the netlist
+		\param rows number of rows of buses; must be 1 or greater
+		\param cols number of columns of buses; must be 1 or greater
+		\return the netlist with rows*cols nodes
+		\throw invalid_argument if rows or cols is 0
+	**/
+	Netlist synthesizeMesh(std::string model_name, unsigned int rows, unsigned int cols) const;
+
+	/**
+		\brief synthesizes a radial distribution feeder netlist
+		\param model_name name of the model of the netlist
+		\param buses number of buses including the root bus of the source; must be 2 or greater
+		\param branching number of laterals leaving each bus; must be 1 or greater
+		\return the netlist with 2*buses-1 nodes
+		\throw invalid_argument if buses is less than 2 or branching is 0
+	**/
+	Netlist synthesizeFeeder(std::string model_name, unsigned int buses, unsigned int branching) const;
+
+	/**
+		\brief synthesizes a DC microgrid netlist of converters on a bipolar DC bus
+		\param model_name name of the model of the netlist
+		\param converters number of converters; must be 1 or greater
+		\return the netlist with 7*converters+2 nodes
+		\throw invalid_argument if converters is 0
+	**/
+	Netlist synthesizeMicrogrid(std::string model_name, unsigned int converters) const;
+
+	/**
+		\brief synthesizes a netlist of a topology with approximately a given number of nodes
+		\param model_name name of the model of the netlist
+		\param topology the topology of the netlist
+		\param num_nodes approximate number of nodes; the size of the topology is the one with
+		node count nearest to it
+		\param branching number of laterals leaving each bus for FEEDER topology
+		\return the netlist; meshes are nearly square
+		\throw invalid_argument if branching is 0 for FEEDER topology
+	**/
+	Netlist synthesize(std::string model_name, Topology topology, unsigned int num_nodes, unsigned int branching = 2) const;
+
+	/**
+		\brief gets the topology named by a string
+		\param name name of the topology: ladder, mesh, feeder or microgrid
+		\return the topology
+		\throw invalid_argument if name is not of a topology
+	**/
+	static Topology getTopology(const std::string& name);
+
+	/**
+		\brief generates the plaintext of a netlist that NetlistLoader can load
+		\param netlist the netlist
+		\param comment comment placed at the head of the netlist text; lines are prefixed with %
+		\return the netlist text
+	**/
+	static std::string generateNetlistText(const Netlist& netlist, const std::string& comment = std::string());
+
+	/**
+		\brief generates the plaintext of a netlist and exports it to a file
+		\param netlist the netlist
+		\param filename name of the file to export to
+		\param comment comment placed at the head of the netlist text; lines are prefixed with %
+		\throw runtime_error if file cannot be written
+	**/
+	static void generateNetlistTextAndExport(const Netlist& netlist, std::string filename, const std::string& comment = std::string());
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_NETLISTSYNTHESIZER_HPP
@@ -0,0 +1,92 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef LBLMC_COREAFFINITY_HPP
+#define LBLMC_COREAFFINITY_HPP
+
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace lblmc
+{
+
+/**
+	\brief hints to the processor that the calling thread is in a spin-wait loop
+
+	Lowers power use and the penalty of leaving the loop on x86 processors, and does nothing on
+	other targets.
+**/
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield");
+#endif
+}
+
+/**
+	\brief pins a thread to a single processor core
+	\param thread native handle of the thread to pin
+	\param core index of the core to pin the thread to
+	\return true if the thread was pinned; false if pinning failed or is not supported on the platform
+**/
+inline bool pinThreadToCore(std::thread::native_handle_type thread, int core)
+{
+#if defined(__linux__)
+	if(core < 0 || core >= CPU_SETSIZE) return false;
+
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	CPU_SET(core, &cpus);
+
+	return pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpus) == 0;
+#else
+	(void)thread;
+	(void)core;
+	return false;
+#endif
+}
+
+/**
+	\brief pins the calling thread to a single processor core
+	\param core index of the core to pin the thread to
+	\return true if the thread was pinned; false if pinning failed or is not supported on the platform
+**/
+inline bool pinThisThreadToCore(int core)
+{
+#if defined(__linux__)
+	return pinThreadToCore(pthread_self(), core);
+#else
+	(void)core;
+	return false;
+#endif
+}
+
+} //namespace lblmc
+
+#endif // LBLMC_COREAFFINITY_HPP
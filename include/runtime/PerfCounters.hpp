@@ -0,0 +1,223 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef LBLMC_PERFCOUNTERS_HPP
+#define LBLMC_PERFCOUNTERS_HPP
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace lblmc
+{
+
+/**
+	\brief hardware performance counters of the calling thread, read through Linux perf_event_open
+
+	Each event is opened as its own counter of user space execution of the calling thread, so
+	events the processor or kernel do not support are unavailable while the others still count.
+	When there are more counters than hardware counters of the processor, the kernel multiplexes
+	them, and each counts only part of the time it is enabled; counts read are then scaled by
+	the time enabled over the time counted, estimating the counts of the whole measurement.
+	Counters are unavailable on other platforms, or when the kernel does not permit access to them,
+	such as when /proc/sys/kernel/perf_event_paranoid is too restrictive or in some containers and
+	virtual machines.
+
+	\code
+	lblmc::PerfCounters counters;
+	counters.start();
+	// code to measure
+	counters.stop();
+	long long instructions = counters.read(lblmc::PerfCounters::INSTRUCTIONS);
+	\endcode
+**/
+class PerfCounters
+{
+public:
+
+	/**
+		\brief events counted by the counters
+	**/
+	enum Event
+	{
+		INSTRUCTIONS = 0, ///< retired instructions
+		CYCLES,           ///< processor cycles
+		CACHE_MISSES,     ///< last level cache misses
+		L1D_READ_MISSES,  ///< level 1 data cache read misses
+		BRANCH_MISSES,    ///< mispredicted branches
+		NUM_EVENTS
+	};
+
+private:
+
+	int fds[NUM_EVENTS]; ///< file descriptors of the counters; -1 if unavailable
+
+#if defined(__linux__)
+	static int open(unsigned int type, unsigned long long config)
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = type;
+		attr.config = config;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		return int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+#endif
+
+public:
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	/**
+		\brief default constructor; opens the counters, stopped
+	**/
+	PerfCounters()
+	{
+#if defined(__linux__)
+		fds[INSTRUCTIONS] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+		fds[CYCLES] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+		fds[CACHE_MISSES] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+		fds[L1D_READ_MISSES] = open(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+		                                                (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+		                                                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+		fds[BRANCH_MISSES] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#else
+		for(int e = 0; e < NUM_EVENTS; e++)
+			fds[e] = -1;
+#endif
+	}
+
+	~PerfCounters()
+	{
+#if defined(__linux__)
+		for(int e = 0; e < NUM_EVENTS; e++)
+		{
+			if(fds[e] >= 0)
+				close(fds[e]);
+		}
+#endif
+	}
+
+	/**
+		\param event the event of the counter
+		\return true if the counter of the event is available
+	**/
+	bool isAvailable(Event event) const
+	{
+		return fds[event] >= 0;
+	}
+
+	/**
+		\return true if any counter is available
+	**/
+	bool isAnyAvailable() const
+	{
+		for(int e = 0; e < NUM_EVENTS; e++)
+		{
+			if(fds[e] >= 0)
+				return true;
+		}
+
+		return false;
+	}
+
+	/**
+		\brief resets the available counters to zero and starts them
+	**/
+	void start()
+	{
+#if defined(__linux__)
+		for(int e = 0; e < NUM_EVENTS; e++)
+		{
+			if(fds[e] < 0) continue;
+			ioctl(fds[e], PERF_EVENT_IOC_RESET, 0);
+			ioctl(fds[e], PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+
+	/**
+		\brief stops the available counters
+	**/
+	void stop()
+	{
+#if defined(__linux__)
+		for(int e = 0; e < NUM_EVENTS; e++)
+		{
+			if(fds[e] >= 0)
+				ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+		}
+#endif
+	}
+
+	/**
+		\param event the event of the counter
+		\return count of the event since the last start(), scaled by the time the counter was enabled
+		over the time it counted if it was multiplexed, or -1 if the counter is unavailable or never counted
+	**/
+	long long read(Event event) const
+	{
+#if defined(__linux__)
+		unsigned long long values[3] = {0, 0, 0}; // count, time enabled, time running
+
+		if(fds[event] < 0 || ::read(fds[event], values, sizeof(values)) != sizeof(values) || values[2] == 0)
+			return -1;
+
+		if(values[2] == values[1])
+			return (long long)(values[0]);
+
+		return (long long)(double(values[0])*double(values[1])/double(values[2]) + 0.5);
+#else
+		(void)event;
+		return -1;
+#endif
+	}
+
+	/**
+		\param event the event of the counter
+		\return name of the event
+	**/
+	static const char* getEventName(Event event)
+	{
+		static const char* const names[NUM_EVENTS] =
+		{
+			"instructions", "cycles", "cache misses", "L1D read misses", "branch misses"
+		};
+
+		return names[event];
+	}
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_PERFCOUNTERS_HPP
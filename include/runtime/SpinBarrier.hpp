@@ -0,0 +1,131 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef LBLMC_SPINBARRIER_HPP
+#define LBLMC_SPINBARRIER_HPP
+
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+
+#include "runtime/CoreAffinity.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief reusable barrier whose waiting threads busy-wait instead of blocking
+
+	All threads taking part in a time step call wait() at the end of the step; the last thread to
+	arrive starts a new generation which releases the others.  Waiting threads spin on the
+	generation counter, so there is no call into the operating system on the step path when each
+	thread has its own core.
+
+	Waiting threads yield their core after spinning for spins_before_yield iterations, which keeps
+	the barrier usable when there are more threads than free cores, at the cost of latency.  By
+	default, threads spin without yielding for a long while unless there are more participating
+	threads than hardware threads, in which case they yield right away.
+
+	\note the number of participating threads is fixed at construction; every participant must
+	call wait() exactly once per generation.
+**/
+class SpinBarrier
+{
+private:
+
+	const unsigned int num_threads; ///< number of threads that must arrive to release the barrier
+	const unsigned int spins_before_yield; ///< number of spin iterations before a waiting thread yields its core
+	alignas(64) std::atomic<unsigned int> num_arrived; ///< number of threads arrived in current generation
+	alignas(64) std::atomic<unsigned int> generation; ///< incremented each time the barrier is released
+
+	static const unsigned int DEFAULT_SPINS = ~0u;
+
+	static unsigned int defaultSpinsBeforeYield(unsigned int num_threads)
+	{
+		const unsigned int num_hw_threads = std::thread::hardware_concurrency();
+
+		if(num_hw_threads != 0 && num_threads > num_hw_threads)
+			return 0;
+
+		return 1u<<16;
+	}
+
+public:
+
+	SpinBarrier() = delete;
+	SpinBarrier(const SpinBarrier&) = delete;
+	SpinBarrier& operator=(const SpinBarrier&) = delete;
+
+	/**
+		\brief parameter constructor
+		\param num_threads number of threads that must call wait() to release the barrier
+		\param spins_before_yield number of spin iterations before a waiting thread yields its core;
+		chosen from the number of hardware threads if not given
+	**/
+	explicit SpinBarrier(unsigned int num_threads, unsigned int spins_before_yield = DEFAULT_SPINS) :
+		num_threads(num_threads),
+		spins_before_yield(spins_before_yield != DEFAULT_SPINS ? spins_before_yield : defaultSpinsBeforeYield(num_threads)),
+		num_arrived(0),
+		generation(0)
+	{
+		if(num_threads == 0)
+			throw std::invalid_argument("SpinBarrier::constructor(): number of threads must be nonzero");
+	}
+
+	inline unsigned int getNumberOfThreads() const { return num_threads; }
+
+	/**
+		\brief blocks calling thread until all participating threads have called wait()
+
+		Memory writes made by any participant before its call are visible to all participants
+		after they return.
+	**/
+	inline void wait()
+	{
+		const unsigned int gen = generation.load(std::memory_order_acquire);
+
+		if(num_arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == num_threads)
+		{
+			num_arrived.store(0, std::memory_order_relaxed);
+			generation.store(gen + 1, std::memory_order_release);
+			return;
+		}
+
+		unsigned int spins = 0;
+		while(generation.load(std::memory_order_acquire) == gen)
+		{
+			if(++spins < spins_before_yield)
+			{
+				cpuRelax();
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_SPINBARRIER_HPP
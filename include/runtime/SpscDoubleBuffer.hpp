@@ -0,0 +1,100 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef LBLMC_SPSCDOUBLEBUFFER_HPP
+#define LBLMC_SPSCDOUBLEBUFFER_HPP
+
+#include <atomic>
+#include <thread>
+
+#include "runtime/CoreAffinity.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief lock-free single-producer/single-consumer double buffer for exchanging a value every time step
+
+	The producer writes the value of time step n into slot n%2 and then publishes n.  The consumer
+	reads the value of time step n-1 during time step n, so it reads from the other slot than the
+	producer is writing into, and neither side ever waits on a lock.  The consumer only spins when
+	the producer has not yet published the previous time step.
+
+	A producer may run at most one time step ahead of its consumer; the step barrier of the
+	runtime guarantees this.  Before the first time step is published, read(0) returns the
+	initial value given at construction.
+
+	\tparam T type of the exchanged value; must be trivially copyable
+**/
+template<typename T>
+class SpscDoubleBuffer
+{
+private:
+
+	alignas(64) T slots[2]; ///< values of the even and odd time steps
+	alignas(64) std::atomic<unsigned long> num_published; ///< number of time steps published by the producer
+
+public:
+
+	SpscDoubleBuffer(const SpscDoubleBuffer&) = delete;
+	SpscDoubleBuffer& operator=(const SpscDoubleBuffer&) = delete;
+
+	/**
+		\brief parameter constructor
+		\param initial value read by the consumer before any time step is published
+	**/
+	explicit SpscDoubleBuffer(const T& initial = T()) :
+		slots{initial, initial},
+		num_published(0)
+	{}
+
+	/**
+		\brief stores the value of a time step; called only by the producer
+		\param step index of the time step, starting from zero and incrementing by one each call
+		\param value value of the time step
+	**/
+	inline void write(unsigned long step, const T& value)
+	{
+		slots[step & 1] = value;
+		num_published.store(step + 1, std::memory_order_release);
+	}
+
+	/**
+		\brief loads the value of the previous time step; called only by the consumer
+		\param step index of the consumer's current time step
+		\return value written by the producer at time step step-1, or the initial value when step is 0
+	**/
+	inline T read(unsigned long step) const
+	{
+		while(num_published.load(std::memory_order_acquire) < step)
+		{
+			cpuRelax();
+		}
+
+		return slots[(step + 1) & 1];
+	}
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_SPSCDOUBLEBUFFER_HPP
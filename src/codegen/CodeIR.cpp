@@ -0,0 +1,580 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include "codegen/CodeIR.hpp"
+
+#include <stdexcept>
+#include <utility>
+#include <unordered_map>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+
+namespace lblmc
+{
+
+namespace
+{
+
+/**
+	\brief key of a product of a coefficient magnitude and an operand, for finding repeated products
+**/
+struct ProductKey
+{
+	std::uint64_t magnitude; ///< bits of the magnitude of the coefficient
+	std::size_t operand; ///< index of the operand among all operands
+
+	bool operator==(const ProductKey& other) const
+	{
+		return magnitude == other.magnitude && operand == other.operand;
+	}
+};
+
+struct ProductKeyHash
+{
+	std::size_t operator()(const ProductKey& key) const
+	{
+		return std::size_t(key.magnitude * 0x9E3779B97F4A7C15ULL) ^ (key.operand * 0xC2B2AE3D27D4EB4FULL);
+	}
+};
+
+std::uint64_t bitsOf(double value)
+{
+	std::uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	return bits;
+}
+
+} //namespace
+
+CodeIR::CodeIR(std::string temporary_type, std::string temporary_prefix) :
+	arrays(),
+	statements(),
+	num_elements(0),
+	temporary_type(std::move(temporary_type)),
+	temporary_prefix(std::move(temporary_prefix)),
+	num_temporaries(0),
+	assigned()
+{
+	if(this->temporary_type.empty())
+		throw std::invalid_argument("CodeIR::constructor(): temporary_type cannot be empty");
+
+	if(this->temporary_prefix.empty())
+		throw std::invalid_argument("CodeIR::constructor(): temporary_prefix cannot be empty");
+}
+
+const CodeIR::Array& CodeIR::getArray(unsigned int array, const char* caller) const
+{
+	if(array >= arrays.size())
+		throw std::out_of_range(std::string("CodeIR::") + caller + "(): array " + std::to_string(array) + " does not exist");
+
+	return arrays[array];
+}
+
+void CodeIR::checkOperand(const Operand& operand, const char* caller) const
+{
+	if(isTemporary(operand))
+	{
+		if(operand.index >= num_temporaries)
+			throw std::out_of_range(std::string("CodeIR::") + caller + "(): temporary " + std::to_string(operand.index) + " does not exist");
+
+		return;
+	}
+
+	if(operand.index >= getArray(operand.array, caller).size)
+		throw std::out_of_range(std::string("CodeIR::") + caller + "(): element " + std::to_string(operand.index) +
+		                        " is out of bounds of array \'" + arrays[operand.array].object.getLabel() + "\'");
+}
+
+double CodeIR::getCoefficientValue(const Term& term) const
+{
+	return term.has_coefficient ? arrays[term.coefficient.array].values[term.coefficient.index] : 1.0;
+}
+
+unsigned int CodeIR::insertArray(const ArrayObject& array, Storage storage, const double* values)
+{
+	std::size_t size = 1;
+
+	for(const unsigned int d : array.getDimensions())
+		size *= d;
+
+	if(array.getDimensions().empty() || size == 0)
+		throw std::invalid_argument("CodeIR::insertArray(): array \'" + array.getLabel() + "\' must have elements");
+
+	if(storage == Storage::CONSTANT && values == nullptr)
+		throw std::invalid_argument("CodeIR::insertArray(): constant array \'" + array.getLabel() + "\' must have values");
+
+	Array entry{array, storage, size, num_elements, std::vector<double>()};
+
+	if(storage == Storage::CONSTANT)
+	{
+		entry.offset = 0;
+		entry.values.assign(values, values+size);
+	}
+	else
+	{
+		num_elements += size;
+	}
+
+	arrays.push_back(std::move(entry));
+
+	const bool assignable = (storage == Storage::OUTPUT || storage == Storage::TEMPORARY);
+	assigned.push_back(std::vector<bool>(assignable ? size : 0, false));
+
+	return arrays.size()-1;
+}
+
+unsigned int CodeIR::findArray(const std::string& label) const
+{
+	for(unsigned int a = 0; a < arrays.size(); a++)
+	{
+		if(arrays[a].object.getLabel() == label)
+			return a;
+	}
+
+	throw std::out_of_range("CodeIR::findArray(): array \'" + label + "\' does not exist");
+}
+
+CodeIR::Operand CodeIR::getElement(unsigned int array, unsigned int i) const
+{
+	const Array& a = getArray(array, "getElement");
+
+	if(a.object.getDimensionSize() != 1 || i >= a.size)
+		throw std::out_of_range("CodeIR::getElement(): element [" + std::to_string(i) + "] is out of bounds of array \'" + a.object.getLabel() + "\'");
+
+	return Operand{array, i};
+}
+
+CodeIR::Operand CodeIR::getElement(unsigned int array, unsigned int i, unsigned int j) const
+{
+	const Array& a = getArray(array, "getElement");
+
+	if(a.object.getDimensionSize() != 2 || i >= a.object.getDimensions()[0] || j >= a.object.getDimensions()[1])
+		throw std::out_of_range("CodeIR::getElement(): element [" + std::to_string(i) + "][" + std::to_string(j) +
+		                        "] is out of bounds of array \'" + a.object.getLabel() + "\'");
+
+	return Operand{array, i*a.object.getDimensions()[1] + j};
+}
+
+void CodeIR::insertAssignment(Operand target, std::vector<Term> terms)
+{
+	if(isTemporary(target))
+		throw std::invalid_argument("CodeIR::insertAssignment(): temporaries are assigned only by the passes");
+
+	checkOperand(target, "insertAssignment");
+
+	const Array& a = arrays[target.array];
+
+	if(a.storage != Storage::OUTPUT && a.storage != Storage::TEMPORARY)
+		throw std::invalid_argument("CodeIR::insertAssignment(): array \'" + a.object.getLabel() + "\' is not assigned by the code");
+
+	if(assigned[target.array][target.index])
+		throw std::invalid_argument("CodeIR::insertAssignment(): element " + printElement(target) + " is already assigned");
+
+	for(const Term& term : terms)
+	{
+		checkOperand(term.operand, "insertAssignment");
+
+		if(term.has_coefficient)
+		{
+			checkOperand(term.coefficient, "insertAssignment");
+
+			if(isTemporary(term.coefficient) || arrays[term.coefficient.array].storage != Storage::CONSTANT)
+				throw std::invalid_argument("CodeIR::insertAssignment(): coefficient " + printElement(term.coefficient) + " is not of a constant array");
+		}
+
+		if(isTemporary(term.operand))
+			continue;
+
+		const Storage storage = arrays[term.operand.array].storage;
+
+		if(storage == Storage::CONSTANT)
+			throw std::invalid_argument("CodeIR::insertAssignment(): operand " + printElement(term.operand) + " is of a constant array");
+
+		if((storage == Storage::OUTPUT || storage == Storage::TEMPORARY) && !assigned[term.operand.array][term.operand.index])
+			throw std::invalid_argument("CodeIR::insertAssignment(): operand " + printElement(term.operand) + " is read before it is assigned");
+	}
+
+	assigned[target.array][target.index] = true;
+	statements.push_back(Statement{target, std::move(terms), target.array});
+}
+
+unsigned int CodeIR::foldConstants()
+{
+	unsigned int changes = 0;
+
+	std::vector<bool> zero(getNumberOfElements(), false); // operands assigned an empty sum
+
+	for(Statement& statement : statements)
+	{
+		std::vector<Term> terms;
+		terms.reserve(statement.terms.size());
+
+		for(Term term : statement.terms)
+		{
+			if(zero[getElementIndex(term.operand)])
+			{
+				changes++;
+				continue;
+			}
+
+			if(term.has_coefficient)
+			{
+				const double c = getCoefficientValue(term);
+
+				if(c == 0.0)
+				{
+					changes++;
+					continue;
+				}
+
+				if(c == 1.0 || c == -1.0)
+				{
+					term.has_coefficient = false;
+					term.negative = (term.negative != (c < 0.0));
+					changes++;
+				}
+			}
+
+			terms.push_back(term);
+		}
+
+		statement.terms.swap(terms);
+
+		if(statement.terms.empty())
+			zero[getElementIndex(statement.target)] = true;
+	}
+
+	return changes;
+}
+
+unsigned int CodeIR::propagateCopies()
+{
+	unsigned int changes = 0;
+
+		// operand and sign of the single term of each copy; elements of no copy are their own copies
+
+	std::vector<Term> copies(getNumberOfElements(), Term{false, Operand{0, 0}, Operand{0, 0}, false});
+	std::vector<bool> is_copy(getNumberOfElements(), false);
+
+	for(Statement& statement : statements)
+	{
+		for(Term& term : statement.terms)
+		{
+			const std::size_t e = getElementIndex(term.operand);
+
+			if(!is_copy[e])
+				continue;
+
+			term.operand = copies[e].operand;
+			term.negative = (term.negative != copies[e].negative);
+			changes++;
+		}
+
+		if(statement.terms.size() == 1 && !statement.terms[0].has_coefficient)
+		{
+			const std::size_t e = getElementIndex(statement.target);
+
+			copies[e] = statement.terms[0];
+			is_copy[e] = true;
+		}
+	}
+
+	return changes;
+}
+
+unsigned int CodeIR::eliminateCommonSubexpressions()
+{
+	unsigned int changes = 0;
+
+		// sums: keyed by the signed value of the coefficient and the operand of each of their terms,
+		// in order, so an equal sum adds the same products in the same order
+
+	auto makeKey = [this](const std::vector<Term>& terms, bool negated)
+	{
+		std::string key;
+		key.reserve(terms.size()*(sizeof(double)+sizeof(std::size_t)));
+
+		for(const Term& term : terms)
+		{
+			const double c = ((term.negative != negated) ? -1.0 : 1.0) * getCoefficientValue(term);
+			const std::size_t e = getElementIndex(term.operand);
+
+			key.append(reinterpret_cast<const char*>(&c), sizeof(c));
+			key.append(reinterpret_cast<const char*>(&e), sizeof(e));
+		}
+
+		return key;
+	};
+
+	std::unordered_map<std::string, Operand> sums;
+
+	for(Statement& statement : statements)
+	{
+		if(statement.terms.empty() || (statement.terms.size() == 1 && !statement.terms[0].has_coefficient))
+			continue; // nothing is computed
+
+		std::string key = makeKey(statement.terms, false);
+
+		auto found = sums.find(key);
+
+		if(found != sums.end())
+		{
+			statement.terms = {Term::of(found->second)};
+			changes++;
+			continue;
+		}
+
+		found = sums.find(makeKey(statement.terms, true));
+
+		if(found != sums.end())
+		{
+			statement.terms = {Term::of(found->second, true)};
+			changes++;
+			continue;
+		}
+
+		sums.emplace(std::move(key), statement.target);
+	}
+
+		// products: those of the same operand and coefficient magnitude are computed once, by the
+		// coefficient of their first occurrence, into a temporary assigned before its first reader
+
+	std::unordered_map<ProductKey, unsigned int, ProductKeyHash> counts;
+
+	for(const Statement& statement : statements)
+	{
+		for(const Term& term : statement.terms)
+		{
+			if(term.has_coefficient)
+				counts[ProductKey{bitsOf(std::fabs(getCoefficientValue(term))), getElementIndex(term.operand)}]++;
+		}
+	}
+
+	struct Product
+	{
+		Operand temporary;
+		bool negative_coefficient; ///< sign of the coefficient the temporary is computed with
+	};
+
+	std::unordered_map<ProductKey, Product, ProductKeyHash> products;
+	std::vector<Statement> optimized;
+	optimized.reserve(statements.size());
+
+	for(Statement& statement : statements)
+	{
+		for(Term& term : statement.terms)
+		{
+			if(!term.has_coefficient)
+				continue;
+
+			const double c = getCoefficientValue(term);
+			const ProductKey key{bitsOf(std::fabs(c)), getElementIndex(term.operand)};
+
+			if(counts[key] < 2)
+				continue;
+
+			auto found = products.find(key);
+
+			if(found == products.end())
+			{
+				const Operand temporary{TEMPORARIES, num_temporaries++};
+
+				optimized.push_back(Statement{temporary, {Term::of(term.coefficient, term.operand)}, statement.section});
+				found = products.emplace(key, Product{temporary, c < 0.0}).first;
+			}
+			else
+			{
+				changes++;
+			}
+
+			term = Term::of(found->second.temporary, term.negative != ((c < 0.0) != found->second.negative_coefficient));
+		}
+
+		optimized.push_back(std::move(statement));
+	}
+
+	statements.swap(optimized);
+
+	return changes;
+}
+
+unsigned int CodeIR::eliminateDeadStores()
+{
+	unsigned int changes = 0;
+
+	std::vector<bool> read(getNumberOfElements(), false);
+	std::vector<bool> live(statements.size(), false);
+
+	for(std::size_t s = statements.size(); s-- > 0; )
+	{
+		const Statement& statement = statements[s];
+
+		live[s] = (!isTemporary(statement.target) && arrays[statement.target.array].storage == Storage::OUTPUT) ||
+		          read[getElementIndex(statement.target)];
+
+		if(!live[s])
+		{
+			changes++;
+			continue;
+		}
+
+		for(const Term& term : statement.terms)
+			read[getElementIndex(term.operand)] = true;
+	}
+
+	std::vector<Statement> optimized;
+	optimized.reserve(statements.size()-changes);
+
+	for(std::size_t s = 0; s < statements.size(); s++)
+	{
+		if(live[s])
+			optimized.push_back(std::move(statements[s]));
+		else if(!isTemporary(statements[s].target))
+			assigned[statements[s].target.array][statements[s].target.index] = false;
+	}
+
+	statements.swap(optimized);
+
+	return changes;
+}
+
+void CodeIR::optimize()
+{
+		// copies are propagated after constants are folded, as folding makes multiplications by
+		// 1 into copies, and again after common subexpressions are eliminated, which makes copies
+
+	foldConstants();
+	propagateCopies();
+	eliminateCommonSubexpressions();
+	propagateCopies();
+	eliminateDeadStores();
+}
+
+std::size_t CodeIR::countMultiplies() const
+{
+	std::size_t count = 0;
+
+	for(const Statement& statement : statements)
+	{
+		for(const Term& term : statement.terms)
+			count += term.has_coefficient;
+	}
+
+	return count;
+}
+
+std::size_t CodeIR::countAdditions() const
+{
+	std::size_t count = 0;
+
+	for(const Statement& statement : statements)
+	{
+		if(!statement.terms.empty())
+			count += statement.terms.size()-1;
+	}
+
+	return count;
+}
+
+std::string CodeIR::printElement(const Operand& operand) const
+{
+	if(isTemporary(operand))
+		return temporary_prefix + std::to_string(operand.index);
+
+	const ArrayObject& object = arrays[operand.array].object;
+	const std::vector<unsigned int>& dimensions = object.getDimensions();
+
+	std::vector<unsigned int> indices(dimensions.size());
+	std::size_t index = operand.index;
+
+	for(std::size_t d = dimensions.size(); d-- > 0; )
+	{
+		indices[d] = index % dimensions[d];
+		index /= dimensions[d];
+	}
+
+	std::string code = object.getLabel();
+
+	for(const unsigned int i : indices)
+		code += "[" + std::to_string(i) + "]";
+
+	return code;
+}
+
+std::string CodeIR::printStatement(const Statement& statement) const
+{
+	std::string code;
+
+	if(isTemporary(statement.target))
+		code = "const " + temporary_type + " ";
+
+	code += printElement(statement.target) + " = ";
+
+	if(statement.terms.empty())
+		code += "0.0";
+
+	for(std::size_t t = 0; t < statement.terms.size(); t++)
+	{
+		const Term& term = statement.terms[t];
+
+		if(t == 0)
+			code += term.negative ? "-" : "";
+		else
+			code += term.negative ? " - " : " + ";
+
+		if(term.has_coefficient)
+			code += printElement(term.coefficient) + "*";
+
+		code += printElement(term.operand);
+	}
+
+	return code + ";\n";
+}
+
+std::string CodeIR::generateCInlineCode(unsigned int array) const
+{
+	getArray(array, "generateCInlineCode");
+
+	std::string code;
+
+	for(const Statement& statement : statements)
+	{
+		if(statement.section == array)
+			code += printStatement(statement);
+	}
+
+	return code;
+}
+
+std::string CodeIR::generateCInlineCode() const
+{
+	std::string code;
+
+	for(const Statement& statement : statements)
+		code += printStatement(statement);
+
+	return code;
+}
+
+} //namespace lblmc
@@ -0,0 +1,169 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include "codegen/CodeTemplate.hpp"
+
+#include <stdexcept>
+#include <utility>
+#include <cctype>
+
+namespace lblmc
+{
+
+namespace
+{
+
+/**
+	\brief determines if a character is a word delimiter, as StringProcessor::isWordDelimiter()
+**/
+inline bool isWordDelimiter(unsigned char c)
+{
+	return (std::ispunct(c) || std::isspace(c) || c == '\0') && (c != '_');
+}
+
+} //namespace
+
+void CodeTemplate::Substitutions::set(const std::string& word, std::string replacement)
+{
+	std::size_t prefix_length = 0;
+
+	while(prefix_length < word.size() && isWordDelimiter(word[prefix_length]))
+		prefix_length++;
+
+	bool valid = prefix_length < word.size();
+
+	for(std::size_t i = prefix_length; i < word.size() && valid; i++)
+		valid = !isWordDelimiter(word[i]);
+
+	if(!valid)
+		throw std::invalid_argument("CodeTemplate::Substitutions::set(): word \'" + word + "\' must be a word, optionally preceded by word delimiters");
+
+	std::vector<Replacement>& word_replacements = replacements[word.substr(prefix_length)];
+	std::string prefix = word.substr(0, prefix_length);
+
+	auto it = word_replacements.begin();
+
+	while(it != word_replacements.end() && it->prefix.size() > prefix_length)
+		++it;
+
+	if(it != word_replacements.end() && it->prefix == prefix)
+	{
+		it->replacement = std::move(replacement);
+		return;
+	}
+
+	word_replacements.insert(it, Replacement{std::move(prefix), std::move(replacement)});
+}
+
+CodeTemplate::CodeTemplate(std::string code) :
+	code(std::move(code)),
+	words(),
+	vocabulary()
+{
+	std::unordered_map<std::string, unsigned int> word_ids;
+
+	const std::size_t size = this->code.size();
+	std::size_t pos = 0;
+
+	while(pos < size)
+	{
+		if(isWordDelimiter(this->code[pos]))
+		{
+			pos++;
+			continue;
+		}
+
+		Word word;
+		word.begin = pos;
+
+		while(pos < size && !isWordDelimiter(this->code[pos]))
+			pos++;
+
+		word.end = pos;
+
+		auto inserted = word_ids.emplace(this->code.substr(word.begin, word.end-word.begin), vocabulary.size());
+
+		if(inserted.second)
+			vocabulary.push_back(inserted.first->first);
+
+		word.id = inserted.first->second;
+
+		words.push_back(word);
+	}
+}
+
+std::string CodeTemplate::substitute(const Substitutions& subs) const
+{
+		// look up each distinct word once, so the pass over the words only indexes
+
+	std::vector<const std::vector<Substitutions::Replacement>*> word_replacements(vocabulary.size(), nullptr);
+
+	for(unsigned int id = 0; id < vocabulary.size(); id++)
+	{
+		auto it = subs.replacements.find(vocabulary[id]);
+
+		if(it != subs.replacements.end())
+			word_replacements[id] = &it->second;
+	}
+
+	std::string result;
+	result.reserve(code.size() + code.size()/2);
+
+	std::size_t pos = 0; // position in code after the last replaced word
+
+	for(const Word& word : words)
+	{
+		if(!word_replacements[word.id])
+			continue;
+
+		for(const Substitutions::Replacement& rep : *word_replacements[word.id])
+		{
+			const std::size_t prefix_length = rep.prefix.size();
+
+			if(prefix_length > 0)
+			{
+				if(prefix_length > word.begin-pos)
+					continue;
+
+				const std::size_t prefix_begin = word.begin-prefix_length;
+
+				if(code.compare(prefix_begin, prefix_length, rep.prefix) != 0)
+					continue;
+
+				if(prefix_begin > 0 && !isWordDelimiter(code[prefix_begin-1]))
+					continue;
+			}
+
+			result.append(code, pos, word.begin-prefix_length-pos);
+			result += rep.replacement;
+			pos = word.end;
+
+			break;
+		}
+	}
+
+	result.append(code, pos, std::string::npos);
+
+	return result;
+}
+
+} //namespace lblmc
@@ -0,0 +1,863 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/CppDataflow.hpp"
+
+#include <cctype>
+#include <algorithm>
+#include <unordered_map>
+
+namespace lblmc
+{
+
+namespace
+{
+
+/**
+	\brief token of C++ code
+**/
+struct Token
+{
+	enum Kind { NAME, NUMBER, PUNCTUATOR } kind;
+	std::string text;
+};
+
+/**
+	splits code into tokens, discarding comments and preprocessor lines, such as pragmas
+**/
+std::vector<Token> tokenize(const std::string& code)
+{
+	static const char* const PUNCTUATORS[] =
+	{
+		"<<=", ">>=",
+		"==", "!=", "<=", ">=", "&&", "||", "++", "--", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=",
+		"->", "<<", ">>"
+	};
+
+	auto isNameStart = [](char c) { return std::isalpha((unsigned char)c) || c == '_'; };
+	auto isNameChar = [](char c) { return std::isalnum((unsigned char)c) || c == '_'; };
+
+	std::vector<Token> tokens;
+	const std::size_t size = code.size();
+	std::size_t pos = 0;
+	bool line_start = true;
+
+	while(pos < size)
+	{
+		const char c = code[pos];
+
+		if(c == '\n')
+		{
+			line_start = true;
+			pos++;
+			continue;
+		}
+
+		if(std::isspace((unsigned char)c))
+		{
+			pos++;
+			continue;
+		}
+
+		if((c == '#' && line_start) || code.compare(pos, 2, "//") == 0)
+		{
+			pos = code.find('\n', pos);
+			if(pos == std::string::npos) pos = size;
+			continue;
+		}
+
+		line_start = false;
+
+		if(code.compare(pos, 2, "/*") == 0)
+		{
+			pos = code.find("*/", pos+2);
+			pos = (pos == std::string::npos) ? size : pos+2;
+			continue;
+		}
+
+		const std::size_t begin = pos;
+
+		if(isNameStart(c))
+		{
+			while(pos < size && (isNameChar(code[pos]) || code.compare(pos, 2, "::") == 0))
+				pos += (code[pos] == ':') ? 2 : 1;
+
+			tokens.push_back(Token{Token::NAME, code.substr(begin, pos-begin)});
+		}
+		else if(std::isdigit((unsigned char)c) || (c == '.' && pos+1 < size && std::isdigit((unsigned char)code[pos+1])))
+		{
+			while(pos < size && (isNameChar(code[pos]) || code[pos] == '.'))
+			{
+				pos++;
+
+				if((code[pos-1] == 'e' || code[pos-1] == 'E') && pos < size && (code[pos] == '+' || code[pos] == '-'))
+					pos++;
+			}
+
+			tokens.push_back(Token{Token::NUMBER, code.substr(begin, pos-begin)});
+		}
+		else if(c == '\"' || c == '\'')
+		{
+			pos++;
+
+			while(pos < size && code[pos] != c)
+				pos += (code[pos] == '\\') ? 2 : 1;
+
+			pos = std::min(pos+1, size);
+			tokens.push_back(Token{Token::NUMBER, code.substr(begin, pos-begin)});
+		}
+		else
+		{
+			std::size_t length = 1;
+
+			for(const char* punctuator : PUNCTUATORS)
+			{
+				const std::size_t n = std::char_traits<char>::length(punctuator);
+
+				if(code.compare(pos, n, punctuator) == 0)
+				{
+					length = n;
+					break;
+				}
+			}
+
+			pos += length;
+			tokens.push_back(Token{Token::PUNCTUATOR, code.substr(begin, length)});
+		}
+	}
+
+	return tokens;
+}
+
+/**
+	precedence of a binary operator, higher binding tighter, or -1 if text is not a binary operator
+**/
+int findBinaryPrecedence(const std::string& text)
+{
+	static const std::unordered_map<std::string, int> PRECEDENCES =
+	{
+		{"||", 1}, {"&&", 2}, {"|", 3}, {"^", 4}, {"&", 5},
+		{"==", 6}, {"!=", 6}, {"<", 7}, {"<=", 7}, {">", 7}, {">=", 7},
+		{"<<", 8}, {">>", 8}, {"+", 9}, {"-", 9}, {"*", 10}, {"/", 10}, {"%", 10}
+	};
+
+	auto it = PRECEDENCES.find(text);
+
+	return (it == PRECEDENCES.end()) ? -1 : it->second;
+}
+
+bool isAssignmentOperator(const std::string& text)
+{
+	return text == "=" || text == "+=" || text == "-=" || text == "*=" || text == "/=" || text == "%=" ||
+	       text == "&=" || text == "|=" || text == "^=" || text == "<<=" || text == ">>=";
+}
+
+/**
+	determines if a name is that of a type, used in casts, or a qualifier of declarations
+**/
+bool isTypeName(const std::string& name)
+{
+	static const std::set<std::string> TYPES =
+	{
+		"real", "double", "float", "int", "unsigned", "signed", "long", "short", "bool", "char",
+		"static", "const", "volatile", "constexpr", "register", "auto"
+	};
+
+	return TYPES.count(name) != 0 || (name.size() > 2 && name.compare(name.size()-2, 2, "_t") == 0);
+}
+
+bool isConstantName(const std::string& name)
+{
+	return name == "true" || name == "false" || name == "nullptr" || name == "NULL";
+}
+
+/**
+	\brief recursive descent parser of code, finding the depth of its assignments as it goes
+**/
+class Parser
+{
+private:
+
+	const std::vector<Token>& tokens;
+	std::size_t pos;
+	std::map<std::string, unsigned int>& ready;
+	CppDataflow::Access& access;
+	unsigned int& critical_path_length;
+	unsigned int& num_operations;
+	std::vector<unsigned int> controls; ///< depths of the conditions the current statement is under, nondecreasing
+
+	bool at(const char* text) const
+	{
+		return pos < tokens.size() && tokens[pos].kind == Token::PUNCTUATOR && tokens[pos].text == text;
+	}
+
+	bool atName(const char* text) const
+	{
+		return pos < tokens.size() && tokens[pos].kind == Token::NAME && tokens[pos].text == text;
+	}
+
+	bool atTerminator() const
+	{
+		return pos >= tokens.size() ||
+		       (tokens[pos].kind == Token::PUNCTUATOR &&
+		        (tokens[pos].text == ")" || tokens[pos].text == "]" || tokens[pos].text == "}" ||
+		         tokens[pos].text == "," || tokens[pos].text == ";" || tokens[pos].text == ":"));
+	}
+
+	unsigned int getControlDepth() const
+	{
+		return controls.empty() ? 0 : controls.back();
+	}
+
+	void pushControl(unsigned int depth)
+	{
+		controls.push_back(std::max(depth, getControlDepth()));
+	}
+
+	unsigned int getReadyDepth(const std::string& name) const
+	{
+		unsigned int depth = 0;
+		const std::size_t bracket = name.find('[');
+
+		auto it = ready.find(name);
+		if(it != ready.end()) depth = it->second;
+
+		if(bracket != std::string::npos)
+		{
+			it = ready.find(name.substr(0, bracket));
+			if(it != ready.end()) depth = std::max(depth, it->second);
+		}
+		else
+		{
+			const std::string prefix = name + "[";
+
+			for(it = ready.lower_bound(prefix); it != ready.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+				depth = std::max(depth, it->second);
+		}
+
+		return depth;
+	}
+
+	unsigned int read(const std::string& name)
+	{
+		access.reads.insert(name);
+		return getReadyDepth(name);
+	}
+
+	void write(const std::string& name, unsigned int depth)
+	{
+		access.writes.insert(name);
+		ready[name] = depth;
+		critical_path_length = std::max(critical_path_length, depth);
+	}
+
+	/**
+		finds the position of the first of the tokens from pos that is text, or closes a bracket
+		opened before pos, outside of brackets opened from pos
+	**/
+	std::size_t findEnd(const char* text) const
+	{
+		int nesting = 0;
+
+		for(std::size_t i = pos; i < tokens.size(); i++)
+		{
+			if(tokens[i].kind != Token::PUNCTUATOR)
+				continue;
+
+			const std::string& t = tokens[i].text;
+
+			if(nesting == 0 && t == text)
+				return i;
+
+			if(t == "(" || t == "[" || t == "{")
+				nesting++;
+			else if(t == ")" || t == "]" || t == "}")
+			{
+				if(nesting == 0)
+					return i;
+
+				nesting--;
+			}
+		}
+
+		return tokens.size();
+	}
+
+	/**
+		parses the subscripts following a name; returns the name of the element if all are
+		constants, else the name of the array
+	**/
+	std::string parseSubscripts(const std::string& array)
+	{
+		std::string name = array;
+		bool whole = false;
+
+		while(at("["))
+		{
+			pos++;
+
+			if(pos+1 < tokens.size() && tokens[pos].kind == Token::NUMBER && tokens[pos+1].text == "]")
+			{
+				name += "[" + tokens[pos].text + "]";
+				pos += 2;
+				continue;
+			}
+
+			whole = true;
+			parseRange(findEnd("]"));
+
+			if(at("]")) pos++;
+		}
+
+		return whole ? array : name;
+	}
+
+	unsigned int parseArguments()
+	{
+		unsigned int depth = parseRange(findEnd(")"));
+
+		if(at(")")) pos++;
+
+		return depth;
+	}
+
+	unsigned int parsePostfix(unsigned int depth)
+	{
+		for(;;)
+		{
+			if((at(".") || at("->")) && pos+1 < tokens.size() && tokens[pos+1].kind == Token::NAME)
+			{
+				pos += 2;
+
+				if(at("("))
+				{
+					pos++;
+					depth = std::max(depth, parseArguments()) + 1;
+					num_operations++;
+				}
+			}
+			else if(at("++") || at("--"))
+			{
+				pos++;
+			}
+			else
+			{
+				return depth;
+			}
+		}
+	}
+
+	unsigned int parsePrimary()
+	{
+		if(atTerminator())
+			return 0;
+
+		const Token& token = tokens[pos++];
+
+		if(token.kind == Token::NAME)
+		{
+			if(isConstantName(token.text))
+				return 0;
+
+			if(at("("))
+			{
+				pos++;
+				unsigned int depth = parseArguments();
+
+				if(!isTypeName(token.text))
+				{
+					depth++;
+					num_operations++;
+				}
+
+				return depth;
+			}
+
+			return read(parseSubscripts(token.text));
+		}
+
+		if(token.kind == Token::PUNCTUATOR && token.text == "{")
+		{
+			const unsigned int depth = parseRange(findEnd("}"));
+
+			if(at("}")) pos++;
+
+			return depth;
+		}
+
+		return 0;
+	}
+
+	unsigned int parseUnary()
+	{
+		if(at("-") || at("+") || at("!") || at("~") || at("*") || at("&") || at("++") || at("--"))
+		{
+			pos++;
+			return parseUnary();
+		}
+
+		if(at("("))
+		{
+			if(pos+2 < tokens.size() && tokens[pos+1].kind == Token::NAME && isTypeName(tokens[pos+1].text) && tokens[pos+2].text == ")")
+			{
+				pos += 3; // cast
+				return parseUnary();
+			}
+
+			pos++;
+			const unsigned int depth = parseRange(findEnd(")"));
+
+			if(at(")")) pos++;
+
+			return parsePostfix(depth);
+		}
+
+		return parsePostfix(parsePrimary());
+	}
+
+	unsigned int parseExpression(int min_precedence)
+	{
+		unsigned int depth = parseUnary();
+
+		while(pos < tokens.size() && tokens[pos].kind == Token::PUNCTUATOR)
+		{
+			const std::string& op = tokens[pos].text;
+
+			if(op == "?")
+			{
+				if(min_precedence > 0)
+					break;
+
+				pos++;
+				const unsigned int if_true = parseExpression(0);
+
+				if(at(":")) pos++;
+
+				const unsigned int if_false = parseExpression(0);
+
+				depth = std::max(depth, std::max(if_true, if_false)) + 1;
+				num_operations++;
+				continue;
+			}
+
+			const int precedence = findBinaryPrecedence(op);
+
+			if(precedence < 0 || precedence < min_precedence)
+				break;
+
+			pos++;
+			depth = std::max(depth, parseExpression(precedence+1)) + 1;
+			num_operations++;
+		}
+
+		return depth;
+	}
+
+	/**
+		parses the expressions of the tokens from pos up to end, skipping separators between them
+	**/
+	unsigned int parseRange(std::size_t end)
+	{
+		unsigned int depth = 0;
+
+		while(pos < end)
+		{
+			if(atTerminator())
+				pos++;
+			else
+				depth = std::max(depth, parseExpression(0));
+		}
+
+		pos = end;
+
+		return depth;
+	}
+
+	/**
+		determines if the tokens from begin are a declaration: a type name followed by another
+		name, optionally with a pointer or reference specifier between them
+	**/
+	bool isDeclaration(std::size_t begin, std::size_t end) const
+	{
+		if(begin+1 >= end || tokens[begin].kind != Token::NAME)
+			return false;
+
+		if(isTypeName(tokens[begin].text))
+			return true;
+
+		std::size_t next = begin+1;
+
+		while(next < end && (tokens[next].text == "*" || tokens[next].text == "&"))
+			next++;
+
+		return next < end && tokens[next].kind == Token::NAME && next == begin+1;
+	}
+
+	/**
+		parses an assignment, a declarator, or an expression of the tokens from begin up to end
+	**/
+	void parseAssignment(std::size_t begin, std::size_t end, bool declaration)
+	{
+		std::size_t assignment = end;
+		std::size_t target_begin = end;
+		int nesting = 0;
+
+		for(std::size_t i = begin; i < end && assignment == end; i++)
+		{
+			const std::string& t = tokens[i].text;
+
+			if(tokens[i].kind == Token::NAME && nesting == 0)
+				target_begin = i;
+			else if(tokens[i].kind != Token::PUNCTUATOR)
+				continue;
+			else if(t == "(" || t == "[" || t == "{")
+				nesting++;
+			else if(t == ")" || t == "]" || t == "}")
+				nesting--;
+			else if(nesting == 0 && isAssignmentOperator(t))
+				assignment = i;
+		}
+
+		std::string target;
+
+		if(target_begin != end)
+		{
+			pos = target_begin+1;
+			target = parseSubscripts(tokens[target_begin].text);
+
+			if(declaration)
+				target = tokens[target_begin].text;
+		}
+
+		if(assignment != end)
+		{
+			pos = assignment+1;
+			unsigned int depth = parseRange(end);
+
+			if(tokens[assignment].text != "=")
+			{
+				depth = std::max(depth, read(target)) + 1;
+				num_operations++;
+			}
+
+			if(!target.empty())
+				write(target, std::max(depth, getControlDepth()));
+		}
+		else if(declaration && !target.empty())
+		{
+			write(target, getControlDepth());
+		}
+		else
+		{
+			bool increment = false;
+
+			for(std::size_t i = begin; i < end; i++)
+				increment = increment || tokens[i].text == "++" || tokens[i].text == "--";
+
+			if(increment && !target.empty())
+			{
+				write(target, std::max(read(target)+1, getControlDepth()));
+				num_operations++;
+			}
+			else
+			{
+				pos = begin;
+				parseRange(end);
+			}
+		}
+
+		pos = end;
+	}
+
+	/**
+		parses a statement without control flow, of the tokens from pos up to end
+	**/
+	void parseSimpleStatement(std::size_t end)
+	{
+		const std::size_t begin = pos;
+
+		if(!isDeclaration(begin, end))
+		{
+			parseAssignment(begin, end, false);
+			return;
+		}
+
+		std::size_t declarator = begin;
+
+		while(declarator < end)
+		{
+			pos = declarator;
+			std::size_t next = std::min(findEnd(","), end);
+
+			parseAssignment(declarator, next, true);
+
+			declarator = next+1;
+		}
+
+		pos = end;
+	}
+
+	unsigned int parseCondition()
+	{
+		if(!at("("))
+			return getControlDepth();
+
+		pos++;
+		const unsigned int depth = parseRange(findEnd(")"));
+
+		if(at(")")) pos++;
+
+		return depth;
+	}
+
+public:
+
+	Parser(const std::vector<Token>& tokens, std::map<std::string, unsigned int>& ready, CppDataflow::Access& access,
+	       unsigned int& critical_path_length, unsigned int& num_operations) :
+		tokens(tokens),
+		pos(0),
+		ready(ready),
+		access(access),
+		critical_path_length(critical_path_length),
+		num_operations(num_operations),
+		controls()
+	{}
+
+	bool done() const
+	{
+		return pos >= tokens.size();
+	}
+
+	void parseStatement()
+	{
+		if(done())
+			return;
+
+		if(at("{"))
+		{
+			pos++;
+
+			while(!done() && !at("}"))
+				parseStatement();
+
+			if(!done()) pos++;
+
+			return;
+		}
+
+		if(at(";") || at("}") || atName("else") || atName("break") || atName("continue"))
+		{
+			pos++;
+			return;
+		}
+
+		if(atName("if") || atName("while") || atName("switch"))
+		{
+			const bool branch = atName("if");
+
+			pos++;
+			const unsigned int depth = parseCondition();
+
+			pushControl(depth);
+			parseStatement();
+
+			if(branch && atName("else"))
+			{
+				pos++;
+				parseStatement();
+			}
+
+			controls.pop_back();
+			return;
+		}
+
+		if(atName("for"))
+		{
+			pos++;
+			unsigned int depth = getControlDepth();
+
+			if(at("("))
+			{
+				pos++;
+				const std::size_t close = findEnd(")");
+
+				parseSimpleStatement(std::min(findEnd(";"), close));
+				if(at(";")) pos++;
+
+				depth = std::max(depth, parseRange(std::min(findEnd(";"), close)));
+				if(at(";")) pos++;
+
+				parseSimpleStatement(close);
+				if(at(")")) pos++;
+			}
+
+			pushControl(depth);
+			parseStatement();
+			controls.pop_back();
+			return;
+		}
+
+		if(atName("do"))
+		{
+			pos++;
+			parseStatement();
+
+			if(atName("while"))
+			{
+				pos++;
+				parseCondition();
+			}
+
+			return;
+		}
+
+		if(atName("case") || atName("default"))
+		{
+			pos = findEnd(":");
+			if(!done()) pos++;
+			return;
+		}
+
+		if(atName("return"))
+			pos++;
+
+		parseSimpleStatement(findEnd(";"));
+
+		if(at(";")) pos++;
+	}
+};
+
+} //namespace
+
+CppDataflow::CppDataflow() :
+	ready(),
+	critical_path_length(0),
+	num_operations(0)
+{}
+
+CppDataflow::Access CppDataflow::analyze(const std::string& code)
+{
+	const std::vector<Token> tokens = tokenize(code);
+
+	Access access;
+	Parser parser(tokens, ready, access, critical_path_length, num_operations);
+
+	while(!parser.done())
+		parser.parseStatement();
+
+	return access;
+}
+
+CppDataflow::Access CppDataflow::findAccess(const std::string& code)
+{
+	return CppDataflow().analyze(code);
+}
+
+std::vector< std::vector<unsigned int> > CppDataflow::findDependencies(const std::vector<Access>& accesses)
+{
+		// an array accessed as a whole anywhere is matched as a whole everywhere, so accesses of its
+		// elements meet those of the array under the name of the array
+
+	std::set<std::string> wholes;
+
+	for(const Access& access : accesses)
+	{
+		for(const std::set<std::string>* names : {&access.reads, &access.writes})
+			for(const std::string& name : *names)
+				if(name.find('[') == std::string::npos)
+					wholes.insert(name);
+	}
+
+	auto normalize = [&wholes](const std::string& name) -> const std::string
+	{
+		const std::size_t bracket = name.find('[');
+
+		if(bracket != std::string::npos && wholes.count(name.substr(0, bracket)))
+			return name.substr(0, bracket);
+
+		return name;
+	};
+
+	struct NameUse
+	{
+		int writer; ///< last piece assigning the name, or -1 if none
+		std::vector<unsigned int> readers; ///< pieces reading the name since it was last assigned
+	};
+
+	std::unordered_map<std::string, NameUse> uses;
+	std::vector< std::vector<unsigned int> > dependencies(accesses.size());
+
+	for(unsigned int p = 0; p < accesses.size(); p++)
+	{
+		std::set<std::string> reads;
+		std::set<std::string> writes;
+		std::set<unsigned int> depends;
+
+		for(const std::string& name : accesses[p].reads)
+			reads.insert(normalize(name));
+
+		for(const std::string& name : accesses[p].writes)
+			writes.insert(normalize(name));
+
+		for(const std::string& name : reads)
+		{
+			auto it = uses.find(name);
+
+			if(it != uses.end() && it->second.writer >= 0)
+				depends.insert(it->second.writer);
+		}
+
+		for(const std::string& name : writes)
+		{
+			NameUse& use = uses.emplace(name, NameUse{-1, {}}).first->second;
+
+			if(use.writer >= 0)
+				depends.insert(use.writer);
+
+			depends.insert(use.readers.begin(), use.readers.end());
+
+			use.writer = p;
+			use.readers.clear();
+		}
+
+		for(const std::string& name : reads)
+		{
+			if(!writes.count(name))
+				uses.emplace(name, NameUse{-1, {}}).first->second.readers.push_back(p);
+		}
+
+		depends.erase(p);
+		dependencies[p].assign(depends.begin(), depends.end());
+	}
+
+	return dependencies;
+}
+
+void CppDataflow::reset()
+{
+	ready.clear();
+	critical_path_length = 0;
+	num_operations = 0;
+}
+
+} //namespace lblmc
@@ -0,0 +1,211 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/CppDeclaration.hpp"
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "codegen/Cpp.hpp"
+
+namespace lblmc
+{
+
+namespace
+{
+
+std::string trim(const std::string& str)
+{
+	std::size_t b = str.find_first_not_of(Cpp::WHITESPACE_CHARS);
+	if(b == std::string::npos)
+		return std::string();
+
+	std::size_t e = str.find_last_not_of(Cpp::WHITESPACE_CHARS);
+	return str.substr(b, e-b+1);
+}
+
+bool isNameChar(char c)
+{
+	return Cpp::VALID_NAME_CHARS.find(c) != std::string::npos;
+}
+
+} //anonymous namespace
+
+std::vector<std::string> CppDeclaration::split(const std::string& code, char delimiter)
+{
+	std::vector<std::string> items;
+	std::string item;
+	int depth = 0;
+
+	for(std::size_t i = 0; i < code.size(); i++)
+	{
+		const char c = code[i];
+
+		if(c == '/' && i+1 < code.size() && code[i+1] == '/')
+		{
+			while(i < code.size() && code[i] != '\n') i++;
+			item += '\n';
+			continue;
+		}
+
+		if(c == '<' || c == '(' || c == '[' || c == '{') depth++;
+		if(c == '>' || c == ')' || c == ']' || c == '}') depth--;
+
+		if(c == delimiter && depth == 0)
+		{
+			item = trim(item);
+			if(!item.empty()) items.push_back(item);
+			item.clear();
+			continue;
+		}
+
+		item += c;
+	}
+
+	item = trim(item);
+	if(!item.empty()) items.push_back(item);
+
+	return items;
+}
+
+CppDeclaration CppDeclaration::parse(const std::string& decl)
+{
+	CppDeclaration result;
+
+	std::string text = trim(decl);
+
+	std::size_t eq = text.find('=');
+	if(eq != std::string::npos)
+	{
+		result.initializer = trim(text.substr(eq+1));
+		text = trim(text.substr(0, eq));
+	}
+
+		// array dimensions follow the name
+
+	std::size_t bracket = text.find('[');
+	if(bracket != std::string::npos)
+	{
+		std::string dims = text.substr(bracket);
+		text = trim(text.substr(0, bracket));
+
+		std::size_t pos = 0;
+		while((pos = dims.find('[', pos)) != std::string::npos)
+		{
+			std::size_t end = dims.find(']', pos);
+			if(end == std::string::npos)
+				throw std::invalid_argument("CppDeclaration::parse(): unterminated array dimension in declaration \'" + decl + "\'");
+
+			result.dimensions.push_back(trim(dims.substr(pos+1, end-pos-1)));
+			pos = end+1;
+		}
+	}
+
+		// name is the last word
+
+	std::size_t end = text.size();
+	std::size_t begin = end;
+	while(begin > 0 && isNameChar(text[begin-1]))
+		begin--;
+
+	result.name = text.substr(begin, end-begin);
+	text = text.substr(0, begin);
+
+		// pointer and reference specifiers precede the name
+
+	std::string type;
+	for(char c : text)
+	{
+		if(c == '*') result.is_pointer = true;
+		else if(c == '&') result.is_reference = true;
+		else type += c;
+	}
+
+		// leading qualifiers
+
+	type = trim(type);
+	while(true)
+	{
+		if(type.compare(0, Cpp::STATIC.size()+1, Cpp::STATIC + " ") == 0)
+		{
+			result.is_static = true;
+			type = trim(type.substr(Cpp::STATIC.size()));
+		}
+		else if(type.compare(0, Cpp::CONST.size()+1, Cpp::CONST + " ") == 0)
+		{
+			result.is_const = true;
+			type = trim(type.substr(Cpp::CONST.size()));
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	result.type = type;
+
+	if(result.name.empty() || result.type.empty())
+		throw std::invalid_argument("CppDeclaration::parse(): declaration \'" + decl + "\' must have a type and name");
+
+	return result;
+}
+
+std::vector<CppDeclaration> CppDeclaration::parseAll(const std::string& code, char delimiter)
+{
+	std::vector<CppDeclaration> decls;
+
+	for(const auto& item : split(code, delimiter))
+	{
+		decls.push_back(parse(item));
+	}
+
+	return decls;
+}
+
+std::string CppDeclaration::generateArrayDimensions() const
+{
+	std::string dims;
+
+	for(const auto& dim : dimensions)
+	{
+		dims += "[" + dim + "]";
+	}
+
+	return dims;
+}
+
+std::vector<std::string> CppDeclaration::getInitializerValues() const
+{
+	std::string values = initializer;
+
+	if(!values.empty() && values.front() == '{')
+	{
+		std::size_t end = values.rfind('}');
+		values = values.substr(1, (end == std::string::npos ? values.size() : end) - 1);
+	}
+
+	return split(values, ',');
+}
+
+} //namespace lblmc
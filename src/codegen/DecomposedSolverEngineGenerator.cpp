@@ -0,0 +1,674 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/DecomposedSolverEngineGenerator.hpp"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <stdexcept>
+#include <sstream>
+#include <fstream>
+#include <cctype>
+
+#include "codegen/ArrayObject.hpp"
+#include "codegen/CppDeclaration.hpp"
+
+namespace lblmc
+{
+
+namespace
+{
+
+/**
+	gets id of port injection parameter named port_inject_<id>_<suffix>; returns false if name is not such parameter
+**/
+bool portInjectionId(const std::string& name, const std::string& suffix, unsigned int& id)
+{
+	const std::string prefix = "port_inject_";
+	const std::string end = "_" + suffix;
+
+	if(name.size() <= prefix.size() + end.size() ||
+	   name.compare(0, prefix.size(), prefix) != 0 ||
+	   name.compare(name.size()-end.size(), end.size(), end) != 0)
+		return false;
+
+	std::string digits = name.substr(prefix.size(), name.size()-prefix.size()-end.size());
+	for(char c : digits)
+	{
+		if(!std::isdigit(c))
+			return false;
+	}
+
+	id = std::stoul(digits);
+	return true;
+}
+
+/**
+	converts a C++ parameter declaration such as "real * y" or "bool z[3]" into a value-initialized member declaration
+**/
+std::string memberDeclaration(const CppDeclaration& decl)
+{
+	return decl.type + " " + decl.name + decl.generateArrayDimensions() + "{}";
+}
+
+/**
+	generates the argument that passes a member to a parameter declared as decl, taking its address for pointer parameters
+**/
+std::string memberArgument(const CppDeclaration& decl)
+{
+	return (decl.is_pointer ? "&" : "") + decl.name;
+}
+
+} //anonymous namespace
+
+DecomposedSolverEngineGenerator::DecomposedSolverEngineGenerator
+(
+	const Netlist& netlist,
+	ComponentFactory& factory,
+	unsigned int num_subsystems,
+	const SolverEngineGeneratorParameters& parameters,
+	NetlistPartitioner partitioner
+) :
+	model_name(netlist.getModelName()),
+	num_solutions(netlist.getNumberOfNodes()),
+	subsystems(),
+	subsystem_gens(),
+	comp_outputs(),
+	comp_inputs(),
+	num_ports(0),
+	num_cut_components(0),
+	parameters(parameters)
+{
+	if(model_name == "")
+		throw std::runtime_error("DecomposedSolverEngineGenerator::constructor(): netlist must have a model name");
+
+	this->parameters.io_source_vector_output_enable = false;
+	this->parameters.io_component_sources_output_enable = false;
+
+	subsystems = partitioner.partition(netlist, num_subsystems);
+	num_cut_components = partitioner.getNumberOfCutComponents();
+
+		// signals of the whole system, in same order as monolithic solver
+
+	for(const auto& comp_listing : netlist.getComponents())
+	{
+		ComponentFactory::ComponentPtr comp = factory.produceComponent(comp_listing);
+
+		std::string buf = comp->generateOutputs("ALL");
+		if(!buf.empty()) comp_outputs.push_back(buf);
+
+		buf = comp->generateInputs();
+		if(!buf.empty()) comp_inputs.push_back(buf);
+	}
+
+		// build the subsystems from their own components
+
+	for(const auto& subsystem : subsystems)
+	{
+		SubsystemSolverEngineGenerator gen(subsystem.netlist.getModelName(), subsystem.global_nodes.size());
+		gen.setParameters(this->parameters);
+
+		for(const auto& comp_listing : subsystem.netlist.getComponents())
+		{
+			factory.produceComponent(comp_listing)->stampSystem(gen);
+		}
+
+		for(const auto& port : subsystem.ports)
+		{
+			gen.addPort( SubsystemSolverEngineGenerator::Port(port.id, port.node, 0) );
+		}
+
+		subsystem_gens.push_back(gen);
+		num_ports += subsystem.ports.size();
+	}
+
+	num_ports /= 2; // each port is shared by two subsystems
+
+		// exchange port models; each subsystem's models are computed before any other model is stamped into it
+
+	std::vector< std::vector<SubsystemSolverEngineGenerator::PortModel> > port_models;
+
+	for(const auto& gen : subsystem_gens)
+	{
+		if(gen.getPorts().empty())
+			port_models.push_back( std::vector<SubsystemSolverEngineGenerator::PortModel>() );
+		else
+			port_models.push_back( gen.computePortModels() );
+	}
+
+	for(unsigned int s = 0; s < subsystems.size(); s++)
+	{
+		for(const auto& port : subsystems[s].ports)
+		{
+			for(const auto& model : port_models[port.other_subsystem])
+			{
+				if(model.id == port.id)
+				{
+					subsystem_gens[s].stampOthersPortModel(model);
+				}
+			}
+		}
+
+		std::map<unsigned int, unsigned int> other_of_port;
+		for(const auto& port : subsystems[s].ports)
+			other_of_port[port.id] = port.other_subsystem;
+
+		for(const auto& model : port_models[s])
+		{
+			if(!model.source_gains.empty())
+			{
+				subsystem_gens[s].addOwnSourceGains(model);
+
+					// couplings from ports to other subsystems than the receiver are fed back through the injection
+
+				for(const auto& xconduct_pair : model.transconductances)
+				{
+					if(other_of_port.at(xconduct_pair.first) != other_of_port.at(model.id))
+						subsystem_gens[s].addOwnPortCoupling(model.id, xconduct_pair.first, xconduct_pair.second);
+				}
+			}
+		}
+	}
+}
+
+void DecomposedSolverEngineGenerator::generateTemplateParameters(std::string& params, std::string& args) const
+{
+	params.clear();
+	args.clear();
+
+	if(parameters.codegen_solver_templated_function_enable == true)
+	{
+		params = "< int instance";
+		args = "<instance";
+
+		if(parameters.codegen_solver_templated_real_type_enable == true)
+		{
+			params += ", typename real";
+			args += ", real";
+		}
+
+		params += " >";
+		args += ">";
+	}
+}
+
+std::string DecomposedSolverEngineGenerator::exportSubsystems(const std::string& filename, double zero_bound) const
+{
+	std::string directory;
+	std::size_t slash = filename.find_last_of("/\\");
+	if(slash != std::string::npos)
+		directory = filename.substr(0, slash+1);
+
+	for(const auto& gen : subsystem_gens)
+	{
+		gen.generateCFunctionAndExport(directory + gen.getModelName() + ".hpp", zero_bound);
+	}
+
+	return directory;
+}
+
+std::string DecomposedSolverEngineGenerator::generateCFunctionParameterList() const
+{
+	std::stringstream sstrm;
+
+	lblmc::ArrayObject x_out("real", "x_out", "", {num_solutions});
+	sstrm << x_out.generateArgument();
+
+	if(parameters.io_signal_output_enable)
+	{
+		for(const auto& outputs : comp_outputs)
+		{
+			sstrm << ",\n" << outputs;
+		}
+	}
+
+	for(const auto& inputs : comp_inputs)
+	{
+		sstrm << ",\n" << inputs;
+	}
+
+	return sstrm.str();
+}
+
+std::string DecomposedSolverEngineGenerator::generateCFunction() const
+{
+	std::stringstream sstrm;
+
+	std::string template_params;
+	std::string template_args;
+	generateTemplateParameters(template_params, template_args);
+
+	if(!template_params.empty())
+	{
+		sstrm << "template" << template_params << "\n";
+	}
+
+	sstrm
+	<< "void "<<model_name<<"_solver\n"
+	<< "(\n"
+	<< generateCFunctionParameterList()
+	<< "\n)\n"
+	<< "{\n";
+
+	sstrm << "//SUBSYSTEM SOLUTIONS\n\n";
+
+	for(unsigned int s = 0; s < subsystems.size(); s++)
+	{
+		sstrm << "static real x_sub" << s << "[" << subsystems[s].global_nodes.size() << "];\n";
+	}
+	sstrm << "\n";
+
+	std::vector< std::vector<std::string> > args(subsystems.size());
+	std::stringstream injections;
+	std::stringstream reads;
+
+	for(unsigned int s = 0; s < subsystems.size(); s++)
+	{
+		std::map<unsigned int, unsigned int> other_of_port;
+		for(const auto& port : subsystems[s].ports)
+			other_of_port[port.id] = port.other_subsystem;
+
+		for(const auto& decl : CppDeclaration::parseAll(subsystem_gens[s].generateCFunctionParameterList(), ','))
+		{
+			const std::string& name = decl.name;
+			unsigned int id;
+
+			if(name == "x_out")
+			{
+				args[s].push_back("x_sub" + std::to_string(s));
+			}
+			else if(portInjectionId(name, "out", id))
+			{
+				std::string var = "port_inject_" + std::to_string(id) + "_sub" + std::to_string(s);
+				injections << "static real " << var << " = 0.0;\n";
+				args[s].push_back(var);
+			}
+			else if(portInjectionId(name, "in", id))
+			{
+				std::string var = "port_inject_" + std::to_string(id) + "_sub" + std::to_string(s) + "_in";
+				reads << "const real " << var << " = port_inject_" << id << "_sub" << other_of_port.at(id) << ";\n";
+				args[s].push_back(var);
+			}
+			else
+			{
+				args[s].push_back(name);
+			}
+		}
+	}
+
+	sstrm << "//PORT INJECTIONS OF SUBSYSTEMS H(n-1)\n\n";
+	sstrm << injections.str() << "\n";
+	sstrm << reads.str() << "\n";
+
+	sstrm << "//SUBSYSTEM SOLVERS\n\n";
+
+	for(unsigned int s = 0; s < subsystems.size(); s++)
+	{
+		sstrm << subsystem_gens[s].getModelName() << "_solver" << template_args << "\n(\n";
+
+		for(unsigned int a = 0; a < args[s].size(); a++)
+		{
+			sstrm << "\t" << args[s][a] << (a+1 < args[s].size() ? ",\n" : "\n");
+		}
+
+		sstrm << ");\n\n";
+	}
+
+	sstrm << "//UPDATE OUTPUTS\n\n";
+
+	for(unsigned int s = 0; s < subsystems.size(); s++)
+	{
+		for(unsigned int l = 0; l < subsystems[s].num_owned_nodes; l++)
+		{
+			sstrm << "x_out[" << subsystems[s].global_nodes[l]-1 << "] = x_sub" << s << "[" << l << "];\n";
+		}
+	}
+
+	sstrm << "\n}";
+
+	return sstrm.str();
+}
+
+void DecomposedSolverEngineGenerator::generateCFunctionAndExport(std::string filename, double zero_bound) const
+{
+	if(filename == "")
+		throw std::invalid_argument("DecomposedSolverEngineGenerator::generateCFunctionAndExport(): filename cannot be null or empty");
+
+	exportSubsystems(filename, zero_bound);
+
+	std::fstream file;
+
+	try
+	{
+		file.open(filename.c_str(), std::fstream::out | std::fstream::trunc);
+	}
+	catch(...)
+	{
+		throw std::runtime_error("DecomposedSolverEngineGenerator::generateCFunctionAndExport(): failed to open or create source files");
+	}
+
+	file <<
+			"/**\n"
+			" *\n"
+			" * LBLMC Vivado HLS Simulation Engine for FPGA Designs\n"
+			" *\n"
+			" * Auto-generated by DecomposedSolverEngineGenerator Object\n"
+			" *\n"
+			" */\n\n";
+
+	file << "#ifndef " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
+	file << "#define " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
+
+	file << "\n";
+
+	for(const auto& gen : subsystem_gens)
+	{
+		file << "#include \"" << gen.getModelName() << ".hpp\"\n";
+	}
+
+	file << "\n\n";
+
+	if(parameters.codegen_solver_templated_function_enable == false)
+	{
+		file << "inline\n";
+	}
+
+	file << generateCFunction() << "\n\n";
+
+	file << "\n#endif";
+
+	file.close();
+}
+
+std::string DecomposedSolverEngineGenerator::generateMulticoreSolverClass() const
+{
+	std::stringstream sstrm;
+
+	std::string template_params;
+	std::string template_args;
+	generateTemplateParameters(template_params, template_args);
+
+	const std::string class_name = model_name + "_multicore_solver";
+	const unsigned int num_subs = subsystems.size();
+
+	if(!template_params.empty())
+	{
+		sstrm << "template" << template_params << "\n";
+	}
+
+	sstrm
+	<< "class " << class_name << "\n"
+	<< "{\n"
+	<< "public:\n\n";
+
+		// solutions and signals of whole system
+
+	sstrm << "\t//SYSTEM SOLUTIONS AND COMPONENT SIGNALS\n\n";
+
+	std::vector<std::string> signals;
+	if(parameters.io_signal_output_enable)
+	{
+		signals.insert(signals.end(), comp_outputs.begin(), comp_outputs.end());
+	}
+	signals.insert(signals.end(), comp_inputs.begin(), comp_inputs.end());
+
+	sstrm << "\treal x_out[" << num_solutions << "]{};\n";
+
+	for(const auto& list : signals)
+	{
+		for(const auto& decl : CppDeclaration::parseAll(list, ','))
+		{
+			sstrm << "\t" << memberDeclaration(decl) << ";\n";
+		}
+	}
+
+	sstrm << "\n\tstatic const unsigned int NUM_SUBSYSTEMS = " << num_subs << ";\n\n";
+
+		// constructor and destructor
+
+	sstrm
+	<< "\t/**\n"
+	<< "\t\tstarts a worker thread per subsystem other than subsystem 0, which is stepped by the calling thread;\n"
+	<< "\t\tif cores is given, thread of subsystem s (including calling thread) is pinned to core cores[s];\n"
+	<< "\t\tthrows logic_error if another object of this class is alive, as the subsystem solvers it steps keep\n"
+	<< "\t\ttheir state in static variables shared by all objects of the class\n"
+	<< "\t**/\n"
+	<< "\texplicit " << class_name << "(const int* cores = nullptr) :\n"
+	<< "\t\tbarrier(NUM_SUBSYSTEMS),\n"
+	<< "\t\trunning(true),\n"
+	<< "\t\tnum_batch_steps(0),\n"
+	<< "\t\tstep_index(0),\n"
+	<< "\t\tworkers()\n"
+	<< "\t{\n"
+	<< "\t\tif(isAlive().exchange(true))\n"
+	<< "\t\t\tthrow std::logic_error(\"" << class_name << ": only one object of the class may be alive at a time\");\n\n"
+	<< "\t\tif(cores != nullptr) lblmc::pinThisThreadToCore(cores[0]);\n\n"
+	<< "\t\tfor(unsigned int s = 1; s < NUM_SUBSYSTEMS; s++)\n"
+	<< "\t\t{\n"
+	<< "\t\t\tworkers.emplace_back(&" << class_name << "::workerLoop, this, s);\n"
+	<< "\t\t\tif(cores != nullptr) lblmc::pinThreadToCore(workers.back().native_handle(), cores[s]);\n"
+	<< "\t\t}\n"
+	<< "\t}\n\n"
+	<< "\t" << class_name << "(const " << class_name << "&) = delete;\n"
+	<< "\t" << class_name << "& operator=(const " << class_name << "&) = delete;\n\n"
+	<< "\t~" << class_name << "()\n"
+	<< "\t{\n"
+	<< "\t\trunning.store(false, std::memory_order_relaxed);\n"
+	<< "\t\tbarrier.wait();\n\n"
+	<< "\t\tfor(auto& worker : workers) worker.join();\n\n"
+	<< "\t\tisAlive().store(false);\n"
+	<< "\t}\n\n";
+
+		// stepping
+
+	sstrm
+	<< "\t///advances whole system by one time step\n"
+	<< "\tvoid step() { run(1); }\n\n"
+	<< "\t///advances whole system by steps time steps, synchronizing subsystems only by the step barrier\n"
+	<< "\tvoid run(unsigned long steps)\n"
+	<< "\t{\n"
+	<< "\t\tif(steps == 0) return;\n\n"
+	<< "\t\tnum_batch_steps = steps;\n"
+	<< "\t\tbarrier.wait();\n\n"
+	<< "\t\tfor(unsigned long i = 0; i < steps; i++)\n"
+	<< "\t\t{\n"
+	<< "\t\t\tstepSubsystem(0, step_index++);\n"
+	<< "\t\t\tbarrier.wait();\n"
+	<< "\t\t}\n"
+	<< "\t}\n\n"
+	<< "private:\n\n"
+	<< "\tlblmc::SpinBarrier barrier;\n"
+	<< "\tstd::atomic<bool> running;\n"
+	<< "\tunsigned long num_batch_steps;\n"
+	<< "\tunsigned long step_index;\n"
+	<< "\tstd::vector<std::thread> workers;\n\n"
+	<< "\t///whether an object of the class is alive; one flag per instantiation, as is the state of the subsystem solvers\n"
+	<< "\tstatic std::atomic<bool>& isAlive()\n"
+	<< "\t{\n"
+	<< "\t\tstatic std::atomic<bool> alive(false);\n"
+	<< "\t\treturn alive;\n"
+	<< "\t}\n\n";
+
+		// exchanges, subsystem solutions, and step of each subsystem
+
+	std::stringstream cases;
+
+	sstrm << "\t//PORT INJECTION EXCHANGES H(n-1)\n\n";
+
+	for(unsigned int s = 0; s < num_subs; s++)
+	{
+		std::map<unsigned int, unsigned int> other_of_port;
+		for(const auto& port : subsystems[s].ports)
+			other_of_port[port.id] = port.other_subsystem;
+
+		std::stringstream reads;
+		std::stringstream injections;
+		std::stringstream writes;
+		std::vector<std::string> args;
+
+		for(const auto& decl : CppDeclaration::parseAll(subsystem_gens[s].generateCFunctionParameterList(), ','))
+		{
+			const std::string& name = decl.name;
+			unsigned int id;
+
+			if(name == "x_out")
+			{
+				args.push_back("x_sub" + std::to_string(s));
+			}
+			else if(portInjectionId(name, "out", id))
+			{
+				std::string var = "port_inject_" + std::to_string(id) + "_sub" + std::to_string(s);
+				sstrm << "\tlblmc::SpscDoubleBuffer<real> " << var << ";\n";
+				injections << "\t\t\t\treal " << var << "_out;\n";
+				writes << "\t\t\t\t" << var << ".write(n, " << var << "_out);\n";
+				args.push_back(var + "_out");
+			}
+			else if(portInjectionId(name, "in", id))
+			{
+				std::string var = "port_inject_" + std::to_string(id) + "_sub" + std::to_string(s) + "_in";
+				reads << "\t\t\t\tconst real " << var << " = port_inject_" << id << "_sub" << other_of_port.at(id) << ".read(n);\n";
+				args.push_back(var);
+			}
+			else
+			{
+				args.push_back(memberArgument(decl));
+			}
+		}
+
+		cases
+		<< "\t\t\tcase " << s << ":\n"
+		<< "\t\t\t{\n"
+		<< reads.str()
+		<< injections.str()
+		<< "\n\t\t\t\t" << subsystem_gens[s].getModelName() << "_solver" << template_args << "\n\t\t\t\t(\n";
+
+		for(unsigned int a = 0; a < args.size(); a++)
+		{
+			cases << "\t\t\t\t\t" << args[a] << (a+1 < args.size() ? ",\n" : "\n");
+		}
+
+		cases << "\t\t\t\t);\n\n" << writes.str();
+
+		for(unsigned int l = 0; l < subsystems[s].num_owned_nodes; l++)
+		{
+			cases << "\t\t\t\tx_out[" << subsystems[s].global_nodes[l]-1 << "] = x_sub" << s << "[" << l << "];\n";
+		}
+
+		cases
+		<< "\t\t\t\tbreak;\n"
+		<< "\t\t\t}\n";
+	}
+
+	sstrm << "\n\t//SUBSYSTEM SOLUTIONS\n\n";
+
+	for(unsigned int s = 0; s < num_subs; s++)
+	{
+		sstrm << "\treal x_sub" << s << "[" << subsystems[s].global_nodes.size() << "]{};\n";
+	}
+
+	sstrm
+	<< "\n"
+	<< "\tvoid workerLoop(unsigned int s)\n"
+	<< "\t{\n"
+	<< "\t\tunsigned long n = 0;\n\n"
+	<< "\t\twhile(true)\n"
+	<< "\t\t{\n"
+	<< "\t\t\tbarrier.wait();\n\n"
+	<< "\t\t\tif(!running.load(std::memory_order_relaxed)) return;\n\n"
+	<< "\t\t\tconst unsigned long steps = num_batch_steps;\n\n"
+	<< "\t\t\tfor(unsigned long i = 0; i < steps; i++)\n"
+	<< "\t\t\t{\n"
+	<< "\t\t\t\tstepSubsystem(s, n++);\n"
+	<< "\t\t\t\tbarrier.wait();\n"
+	<< "\t\t\t}\n"
+	<< "\t\t}\n"
+	<< "\t}\n\n"
+	<< "\tvoid stepSubsystem(unsigned int s, unsigned long n)\n"
+	<< "\t{\n"
+	<< "\t\tswitch(s)\n"
+	<< "\t\t{\n"
+	<< cases.str()
+	<< "\t\t}\n"
+	<< "\t}\n"
+	<< "};";
+
+	return sstrm.str();
+}
+
+void DecomposedSolverEngineGenerator::generateMulticoreSolverAndExport(std::string filename, double zero_bound) const
+{
+	if(filename == "")
+		throw std::invalid_argument("DecomposedSolverEngineGenerator::generateMulticoreSolverAndExport(): filename cannot be null or empty");
+
+	exportSubsystems(filename, zero_bound);
+
+	std::fstream file;
+
+	try
+	{
+		file.open(filename.c_str(), std::fstream::out | std::fstream::trunc);
+	}
+	catch(...)
+	{
+		throw std::runtime_error("DecomposedSolverEngineGenerator::generateMulticoreSolverAndExport(): failed to open or create source files");
+	}
+
+	file <<
+			"/**\n"
+			" *\n"
+			" * LBLMC Multicore CPU Simulation Engine\n"
+			" *\n"
+			" * Auto-generated by DecomposedSolverEngineGenerator Object\n"
+			" *\n"
+			" */\n\n";
+
+	file << "#ifndef " << model_name << "_MULTICORESOLVER_HPP" << "\n";
+	file << "#define " << model_name << "_MULTICORESOLVER_HPP" << "\n";
+
+	file << "\n";
+
+	file << "#include <atomic>\n";
+	file << "#include <stdexcept>\n";
+	file << "#include <thread>\n";
+	file << "#include <vector>\n\n";
+
+	file << "#include \"runtime/SpinBarrier.hpp\"\n";
+	file << "#include \"runtime/SpscDoubleBuffer.hpp\"\n";
+	file << "#include \"runtime/CoreAffinity.hpp\"\n\n";
+
+	for(const auto& gen : subsystem_gens)
+	{
+		file << "#include \"" << gen.getModelName() << ".hpp\"\n";
+	}
+
+	file << "\n\n";
+
+	file << generateMulticoreSolverClass() << "\n\n";
+
+	file << "\n#endif";
+
+	file.close();
+}
+
+} //namespace lblmc
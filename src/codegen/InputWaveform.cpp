@@ -0,0 +1,189 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/InputWaveform.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace lblmc
+{
+
+InputWaveform InputWaveform::parse(const std::string& spec)
+{
+	InputWaveform wave;
+
+	const std::size_t eq = spec.find('=');
+
+	if(eq == std::string::npos || eq == 0)
+		throw std::invalid_argument("InputWaveform::parse(): waveform \'" + spec + "\' must be given as name=type:parameters");
+
+	wave.name = spec.substr(0, eq);
+
+	const std::size_t bracket = wave.name.find('[');
+
+	if(bracket != std::string::npos)
+	{
+		if(wave.name.back() != ']' || bracket == 0)
+			throw std::invalid_argument("InputWaveform::parse(): malformed element index in waveform \'" + spec + "\'");
+
+		try
+		{
+			wave.index = std::stoi(wave.name.substr(bracket+1, wave.name.size()-bracket-2));
+		}
+		catch(...)
+		{
+			throw std::invalid_argument("InputWaveform::parse(): malformed element index in waveform \'" + spec + "\'");
+		}
+
+		if(wave.index < 0)
+			throw std::invalid_argument("InputWaveform::parse(): element index cannot be negative in waveform \'" + spec + "\'");
+
+		wave.name = wave.name.substr(0, bracket);
+	}
+
+		// type and parameters separated by ':'
+
+	std::vector<std::string> fields;
+	std::stringstream fstrm(spec.substr(eq+1));
+	std::string field;
+
+	while(std::getline(fstrm, field, ':'))
+		fields.push_back(field);
+
+	if(fields.empty())
+		throw std::invalid_argument("InputWaveform::parse(): waveform \'" + spec + "\' has no type");
+
+	std::vector<double> values;
+
+	for(unsigned int i = 1; i < fields.size(); i++)
+	{
+		try
+		{
+			values.push_back(std::stod(fields[i]));
+		}
+		catch(...)
+		{
+			throw std::invalid_argument("InputWaveform::parse(): parameter \'" + fields[i] + "\' of waveform \'" + spec + "\' is not a number");
+		}
+	}
+
+	auto checkCount = [&](unsigned int min, unsigned int max)
+	{
+		if(values.size() < min || values.size() > max)
+			throw std::invalid_argument("InputWaveform::parse(): wrong number of parameters in waveform \'" + spec + "\'");
+	};
+
+	auto value = [&](unsigned int i, double default_value)
+	{
+		return i < values.size() ? values[i] : default_value;
+	};
+
+	const std::string& type = fields[0];
+
+	if(type == "const")
+	{
+		checkCount(1, 1);
+		wave.type = CONSTANT;
+		wave.amplitude = values[0];
+	}
+	else if(type == "sine")
+	{
+		checkCount(2, 4);
+		wave.type = SINE;
+		wave.amplitude = values[0];
+		wave.frequency = values[1];
+		wave.offset = value(2, 0.0);
+		wave.phase = value(3, 0.0);
+	}
+	else if(type == "square")
+	{
+		checkCount(1, 4);
+		wave.type = SQUARE;
+		wave.frequency = values[0];
+		wave.phase = value(1, 0.5);
+		wave.amplitude = value(2, 1.0);
+		wave.offset = value(3, 0.0);
+	}
+	else if(type == "step")
+	{
+		checkCount(1, 3);
+		wave.type = STEP;
+		wave.phase = values[0];
+		wave.amplitude = value(1, 1.0);
+		wave.offset = value(2, 0.0);
+	}
+	else
+	{
+		throw std::invalid_argument("InputWaveform::parse(): unknown type \'" + type + "\' of waveform \'" + spec + "\'");
+	}
+
+	return wave;
+}
+
+std::string InputWaveform::generateCExpression(const std::string& time_name, bool is_bool) const
+{
+	std::stringstream sstrm;
+
+	sstrm << std::setprecision(17);
+
+	switch(type)
+	{
+		case CONSTANT:
+			if(is_bool)
+				sstrm << (amplitude != 0.0 ? "true" : "false");
+			else
+				sstrm << amplitude;
+			break;
+
+		case SINE:
+			sstrm << "(" << offset << " + " << amplitude << "*std::sin(" << 2.0*3.14159265358979323846*frequency << "*" << time_name
+			      << " + " << phase*3.14159265358979323846/180.0 << "))";
+			if(is_bool)
+				sstrm << " > 0.0";
+			break;
+
+		case SQUARE:
+			sstrm << "(std::fmod(" << frequency << "*" << time_name << ", 1.0) < " << phase << ") ? ";
+			if(is_bool)
+				sstrm << (amplitude != 0.0 ? "true" : "false") << " : " << (offset != 0.0 ? "true" : "false");
+			else
+				sstrm << amplitude << " : " << offset;
+			break;
+
+		case STEP:
+			if(is_bool)
+				sstrm << "(" << time_name << " >= " << phase << ") ? " << (amplitude != 0.0 ? "true" : "false")
+				      << " : " << (offset != 0.0 ? "true" : "false");
+			else
+				sstrm << "(" << time_name << " >= " << phase << ") ? " << amplitude << " : " << offset;
+			break;
+	}
+
+	return sstrm.str();
+}
+
+} //namespace lblmc
@@ -0,0 +1,558 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include "codegen/ModelCache.hpp"
+
+#include <stdexcept>
+#include <fstream>
+#include <algorithm>
+#include <utility>
+#include <cstring>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "codegen/netlist/ComponentListing.hpp"
+
+namespace lblmc
+{
+
+namespace
+{
+
+	// layout of a cache file, all in the byte order of the machine that wrote it:
+	//   header:    magic, format version, byte order mark, netlist text hash, netlist size in
+	//              bytes (0 if none), number of inverses
+	//   netlist:   model name, number of nodes, number of components, and of each component its
+	//              type, label, parameters, terminals, rate divisor and phase
+	//   inverses:  conductance hash, dimension, nonzeros, compressed row arrays of G, symmetric
+	//              flag and condition number of the inversion, and G^-1 in row major order
+	// strings and arrays are preceded by their uint32 lengths
+
+const char CACHE_MAGIC[8] = {'L','B','L','M','C','I','R','\0'};
+const std::uint32_t CACHE_FORMAT_VERSION = 1;
+const std::uint32_t CACHE_BYTE_ORDER_MARK = 0x01020304;
+const std::size_t CACHE_MIN_COMPONENT_SIZE = 6*sizeof(std::uint32_t); ///< bytes of a component of empty strings and arrays
+
+/**
+	read-only view of the contents of a file, mapped into memory where the platform supports it
+	and read into a buffer otherwise; empty if the file cannot be opened or is empty
+**/
+class MappedFile
+{
+private:
+
+	const char* data;
+	std::size_t size;
+	std::vector<char> buffer;
+
+public:
+
+	explicit MappedFile(const std::string& filename) :
+		data(nullptr),
+		size(0),
+		buffer()
+	{
+#if defined(__linux__)
+		const int fd = ::open(filename.c_str(), O_RDONLY);
+
+		if(fd < 0)
+			return;
+
+		struct stat file_stat;
+
+		if(::fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+		{
+			void* mapping = ::mmap(nullptr, std::size_t(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+			if(mapping != MAP_FAILED)
+			{
+				data = static_cast<const char*>(mapping);
+				size = std::size_t(file_stat.st_size);
+			}
+		}
+
+		::close(fd);
+#else
+		std::ifstream file(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+
+		if(!file)
+			return;
+
+		buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		data = buffer.data();
+		size = buffer.size();
+#endif
+	}
+
+	~MappedFile()
+	{
+#if defined(__linux__)
+		if(data)
+			::munmap(const_cast<char*>(data), size);
+#endif
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	inline const char* getData() const { return data; }
+	inline std::size_t getSize() const { return size; }
+};
+
+/**
+	reads values from the contents of a cache file, failing instead of reading past its end
+**/
+class CacheReader
+{
+private:
+
+	const char* pos;
+	const char* end;
+	bool failed;
+
+public:
+
+	CacheReader(const char* data, std::size_t size) :
+		pos(data),
+		end(data+size),
+		failed(data == nullptr)
+	{}
+
+	template<typename T>
+	void readArray(T* values, std::size_t count)
+	{
+		if(failed || count > std::size_t(end-pos)/sizeof(T))
+		{
+			failed = true;
+			return;
+		}
+
+		if(count != 0)
+			std::memcpy(values, pos, count*sizeof(T));
+
+		pos += count*sizeof(T);
+	}
+
+	template<typename T>
+	T read()
+	{
+		T value = T();
+		readArray(&value, 1);
+		return value;
+	}
+
+	std::string readString()
+	{
+		const std::uint32_t length = read<std::uint32_t>();
+
+		if(failed || length > std::size_t(end-pos))
+		{
+			failed = true;
+			return std::string();
+		}
+
+		std::string str(pos, length);
+		pos += length;
+		return str;
+	}
+
+	template<typename T>
+	std::vector<T> readVector()
+	{
+		const std::uint32_t count = read<std::uint32_t>();
+
+		if(failed || count > std::size_t(end-pos)/sizeof(T))
+		{
+			failed = true;
+			return std::vector<T>();
+		}
+
+		std::vector<T> values(count);
+		readArray(values.data(), count);
+		return values;
+	}
+
+	void readBytes(std::string& bytes, std::uint64_t count)
+	{
+		if(failed || count > std::uint64_t(end-pos))
+		{
+			failed = true;
+			return;
+		}
+
+		bytes.assign(pos, std::size_t(count));
+		pos += count;
+	}
+
+	inline void fail() { failed = true; }
+
+	inline bool hasFailed() const { return failed; }
+};
+
+template<typename T>
+void appendArray(std::string& data, const T* values, std::size_t count)
+{
+	data.append(reinterpret_cast<const char*>(values), count*sizeof(T));
+}
+
+template<typename T>
+void appendValue(std::string& data, const T& value)
+{
+	appendArray(data, &value, 1);
+}
+
+void appendString(std::string& data, const std::string& str)
+{
+	appendValue(data, std::uint32_t(str.size()));
+	data.append(str);
+}
+
+template<typename T>
+void appendVector(std::string& data, const std::vector<T>& values)
+{
+	appendValue(data, std::uint32_t(values.size()));
+	appendArray(data, values.data(), values.size());
+}
+
+} //namespace
+
+ModelCache::ModelCache() :
+	netlist_hash(0),
+	netlist_data(),
+	inverses(),
+	modified(false)
+{}
+
+std::uint64_t ModelCache::hash(const void* data, std::size_t size, std::uint64_t seed)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	std::uint64_t h = seed;
+
+	for(std::size_t i = 0; i < size; i++)
+	{
+		h ^= bytes[i];
+		h *= 1099511628211ULL;
+	}
+
+	return h;
+}
+
+std::string ModelCache::getCacheFilename(const std::string& netlist_filename)
+{
+	return netlist_filename + ".ir";
+}
+
+std::uint64_t ModelCache::hashConductance(const SparseMatrixRMXd& conductance)
+{
+	std::uint64_t h = hash(conductance.outerIndexPtr(), (conductance.outerSize()+1)*sizeof(*conductance.outerIndexPtr()));
+	h = hash(conductance.innerIndexPtr(), conductance.nonZeros()*sizeof(*conductance.innerIndexPtr()), h);
+	h = hash(conductance.valuePtr(), conductance.nonZeros()*sizeof(*conductance.valuePtr()), h);
+
+	return h;
+}
+
+bool ModelCache::loadFromFile(const std::string& filename)
+{
+	clear();
+
+	const MappedFile file(filename);
+	CacheReader reader(file.getData(), file.getSize());
+
+	char magic[sizeof(CACHE_MAGIC)];
+	reader.readArray(magic, sizeof(magic));
+
+	if( reader.hasFailed() ||
+	    std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0 ||
+	    reader.read<std::uint32_t>() != CACHE_FORMAT_VERSION ||
+	    reader.read<std::uint32_t>() != CACHE_BYTE_ORDER_MARK )
+	{
+		return false;
+	}
+
+	netlist_hash = reader.read<std::uint64_t>();
+	const std::uint64_t netlist_size = reader.read<std::uint64_t>();
+	const std::uint32_t num_inverses = reader.read<std::uint32_t>();
+
+		// the netlist is kept serialized and is only deserialized by loadNetlist()
+
+	reader.readBytes(netlist_data, netlist_size);
+
+	try
+	{
+		for(std::uint32_t i = 0; i < num_inverses && !reader.hasFailed(); i++)
+		{
+			InverseEntry entry;
+			entry.conductance_hash = reader.read<std::uint64_t>();
+			entry.used = false;
+
+			const std::uint32_t dimension = reader.read<std::uint32_t>();
+			const std::uint32_t nonzeros = reader.read<std::uint32_t>();
+
+				// bound the sizes by the file before allocating, as a truncated or corrupted file
+				// could give any sizes
+
+			if( reader.hasFailed() || dimension == 0 ||
+			    std::uint64_t(dimension)*dimension > file.getSize()/sizeof(double) ||
+			    nonzeros > file.getSize()/sizeof(double) )
+			{
+				reader.fail();
+				break;
+			}
+
+			SparseMatrixRMXd& g = entry.conductance;
+			g.resize(dimension, dimension);
+			g.resizeNonZeros(nonzeros);
+			reader.readArray(g.outerIndexPtr(), std::size_t(dimension)+1);
+			reader.readArray(g.innerIndexPtr(), nonzeros);
+			reader.readArray(g.valuePtr(), nonzeros);
+
+			const bool inverted_symmetric = reader.read<std::uint8_t>() != 0;
+			const double condition_number = reader.read<double>();
+
+			MatrixRMXd inverse(dimension, dimension);
+			reader.readArray(inverse.data(), std::size_t(dimension)*dimension);
+
+			if(reader.hasFailed() || hashConductance(g) != entry.conductance_hash)
+			{
+				reader.fail();
+				break;
+			}
+
+			std::shared_ptr<SystemConductanceGenerator> inverse_gen = std::make_shared<SystemConductanceGenerator>(dimension);
+			inverse_gen->resetToInverse(std::move(inverse), condition_number, inverted_symmetric);
+			entry.inverse = inverse_gen;
+
+			inverses.push_back(std::move(entry));
+		}
+	}
+	catch(const std::exception&)
+	{
+		clear();
+		return false;
+	}
+
+	if(reader.hasFailed())
+	{
+		clear();
+		return false;
+	}
+
+	return true;
+}
+
+void ModelCache::exportToFile(const std::string& filename) const
+{
+	std::ofstream file(filename.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+
+	if(!file)
+		throw std::runtime_error("ModelCache::exportToFile(): failed to open or create file \'" + filename + "\'");
+
+	std::uint32_t num_inverses = 0;
+
+	for(const InverseEntry& entry : inverses)
+		num_inverses += entry.used;
+
+	std::string data;
+
+	appendArray(data, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	appendValue(data, CACHE_FORMAT_VERSION);
+	appendValue(data, CACHE_BYTE_ORDER_MARK);
+	appendValue(data, netlist_hash);
+	appendValue(data, std::uint64_t(netlist_data.size()));
+	appendValue(data, num_inverses);
+
+	file.write(data.data(), data.size());
+	file.write(netlist_data.data(), netlist_data.size());
+
+	for(const InverseEntry& entry : inverses)
+	{
+		if(!entry.used)
+			continue;
+
+		const SparseMatrixRMXd& g = entry.conductance;
+		const std::size_t dimension = g.rows();
+
+		data.clear();
+		appendValue(data, entry.conductance_hash);
+		appendValue(data, std::uint32_t(dimension));
+		appendValue(data, std::uint32_t(g.nonZeros()));
+		appendArray(data, g.outerIndexPtr(), dimension+1);
+		appendArray(data, g.innerIndexPtr(), g.nonZeros());
+		appendArray(data, g.valuePtr(), g.nonZeros());
+		appendValue(data, std::uint8_t(entry.inverse->isInvertedSymmetric()));
+		appendValue(data, entry.inverse->getInverseConditionNumber());
+
+		file.write(data.data(), data.size());
+		file.write(reinterpret_cast<const char*>(entry.inverse->asEigen3Matrix().data()), dimension*dimension*sizeof(double));
+	}
+
+	if(!file)
+		throw std::runtime_error("ModelCache::exportToFile(): failed to write file \'" + filename + "\'");
+}
+
+bool ModelCache::isModified() const
+{
+	if(modified)
+		return true;
+
+		// inverses not used since the cache was loaded are dropped from the exported cache
+
+	for(const InverseEntry& entry : inverses)
+	{
+		if(!entry.used)
+			return true;
+	}
+
+	return false;
+}
+
+void ModelCache::clear()
+{
+	netlist_hash = 0;
+	netlist_data.clear();
+	inverses.clear();
+	modified = false;
+}
+
+void ModelCache::setNetlist(std::uint64_t text_hash, const Netlist& netlist)
+{
+	netlist_hash = text_hash;
+	netlist_data.clear();
+
+	appendString(netlist_data, netlist.getModelName());
+	appendValue(netlist_data, std::uint32_t(netlist.getNumberOfNodes()));
+	appendValue(netlist_data, std::uint32_t(netlist.getComponentsCount()));
+
+	for(const ComponentListing& listing : netlist.getComponents())
+	{
+		appendString(netlist_data, listing.getType());
+		appendString(netlist_data, listing.getLabel());
+		appendVector(netlist_data, listing.getParameters());
+		appendVector(netlist_data, listing.getTerminalConnections());
+		appendValue(netlist_data, std::uint32_t(listing.getRateDivisor()));
+		appendValue(netlist_data, std::uint32_t(listing.getRatePhase()));
+	}
+
+	modified = true;
+}
+
+bool ModelCache::loadNetlist(std::uint64_t text_hash, Netlist& netlist) const
+{
+	if(netlist_data.empty() || netlist_hash != text_hash)
+		return false;
+
+	CacheReader reader(netlist_data.data(), netlist_data.size());
+	Netlist loaded;
+
+	try
+	{
+		loaded.setModelName(reader.readString());
+
+		const std::uint32_t num_nodes = reader.read<std::uint32_t>();
+		const std::uint32_t num_components = reader.read<std::uint32_t>();
+
+		if(!reader.hasFailed())
+			loaded.reserveComponents(std::min<std::size_t>(num_components, netlist_data.size()/CACHE_MIN_COMPONENT_SIZE));
+
+		for(std::uint32_t c = 0; c < num_components && !reader.hasFailed(); c++)
+		{
+			std::string type = reader.readString();
+			std::string label = reader.readString();
+			std::vector<double> parameters = reader.readVector<double>();
+			std::vector<unsigned int> terminals = reader.readVector<unsigned int>();
+			const std::uint32_t rate_divisor = reader.read<std::uint32_t>();
+			const std::uint32_t rate_phase = reader.read<std::uint32_t>();
+
+			if(reader.hasFailed())
+				break;
+
+			ComponentListing listing(std::move(type), std::move(label), std::move(parameters), std::move(terminals));
+			listing.setRate(rate_divisor, rate_phase);
+
+			loaded.addComponent(std::move(listing));
+		}
+
+		if(reader.hasFailed())
+			return false;
+
+		loaded.setNumberOfNodes(num_nodes);
+	}
+	catch(const std::exception&)
+	{
+		return false;
+	}
+
+	netlist = std::move(loaded);
+	return true;
+}
+
+void ModelCache::addInverse(const SparseMatrixRMXd& conductance, std::shared_ptr<const SystemConductanceGenerator> inverse)
+{
+	if(!inverse || inverse->getDimension() != conductance.rows() || conductance.rows() != conductance.cols())
+		throw std::invalid_argument("ModelCache::addInverse(): inverse must be given and of the dimension of the conductance matrix");
+
+	InverseEntry entry;
+	entry.conductance = conductance;
+	entry.conductance.makeCompressed();
+	entry.conductance_hash = hashConductance(entry.conductance);
+	entry.inverse = std::move(inverse);
+	entry.used = true;
+
+	inverses.push_back(std::move(entry));
+	modified = true;
+}
+
+std::shared_ptr<const SystemConductanceGenerator> ModelCache::findInverse(const SparseMatrixRMXd& conductance) const
+{
+	if(inverses.empty() || !conductance.isCompressed())
+		return nullptr;
+
+	const std::uint64_t conductance_hash = hashConductance(conductance);
+
+	for(const InverseEntry& entry : inverses)
+	{
+		const SparseMatrixRMXd& g = entry.conductance;
+
+		const bool identical =
+			entry.conductance_hash == conductance_hash &&
+			g.rows() == conductance.rows() &&
+			g.nonZeros() == conductance.nonZeros() &&
+			std::equal(g.outerIndexPtr(), g.outerIndexPtr()+g.outerSize()+1, conductance.outerIndexPtr()) &&
+			std::equal(g.innerIndexPtr(), g.innerIndexPtr()+g.nonZeros(), conductance.innerIndexPtr()) &&
+			std::equal(g.valuePtr(), g.valuePtr()+g.nonZeros(), conductance.valuePtr());
+
+		if(identical)
+		{
+			entry.used = true;
+			return entry.inverse;
+		}
+	}
+
+	return nullptr;
+}
+
+} //namespace lblmc
@@ -25,12 +25,446 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include <stdexcept>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <set>
+#include <utility>
 
 #include "codegen/ArrayObject.hpp"
+#include "codegen/CppDeclaration.hpp"
+#include "codegen/CppDataflow.hpp"
+#include "codegen/ParallelFor.hpp"
+#include "codegen/components/Component.hpp"
+#include "codegen/ModelCache.hpp"
 
 namespace lblmc
 {
 
+namespace
+{
+
+/**
+	flags the solutions read by code as x[<node>] in demanded (element i is x[i+1]); returns false if
+	the code refers to x in any other way, such as with a computed index, so its reads are unknown
+**/
+bool markSolutionReads(const std::string& code, std::vector<bool>& demanded)
+{
+	auto isIdentifierChar = [](char c) { return std::isalnum((unsigned char)c) || c == '_'; };
+
+	for(std::size_t pos = code.find('x'); pos != std::string::npos; pos = code.find('x', pos+1))
+	{
+		if(pos > 0 && (isIdentifierChar(code[pos-1]) || code[pos-1] == '.' || code[pos-1] == ':'))
+			continue; // part of another name or a member x
+
+		if(pos > 1 && code[pos-1] == '>' && code[pos-2] == '-')
+			continue; // member x through a pointer
+
+		if(pos+1 < code.size() && isIdentifierChar(code[pos+1]))
+			continue; // part of another name
+
+		std::size_t i = pos+1;
+
+		while(i < code.size() && std::isspace((unsigned char)code[i])) i++;
+
+		if(i >= code.size() || code[i] != '[')
+			return false;
+
+		i++;
+		while(i < code.size() && std::isspace((unsigned char)code[i])) i++;
+
+		const std::size_t digits = i;
+		while(i < code.size() && std::isdigit((unsigned char)code[i])) i++;
+
+		const std::size_t num_digits = i-digits;
+
+		while(i < code.size() && std::isspace((unsigned char)code[i])) i++;
+
+		if(num_digits == 0 || i >= code.size() || code[i] != ']')
+			return false;
+
+		const unsigned long node = std::stoul(code.substr(digits, num_digits));
+
+		if(node > 0 && node <= demanded.size())
+			demanded[node-1] = true;
+	}
+
+	return true;
+}
+
+/**
+	collects the elements of b_components assigned by code as b_components[<index>] = ...; returns
+	false if the code refers to b_components in any other way, so its assignments are unknown
+**/
+bool findSourceContributionWrites(const std::string& code, std::set<unsigned int>& writes)
+{
+	const static std::string NAME = "b_components";
+
+	auto isIdentifierChar = [](char c) { return std::isalnum((unsigned char)c) || c == '_'; };
+
+	for(std::size_t pos = code.find(NAME); pos != std::string::npos; pos = code.find(NAME, pos+1))
+	{
+		if(pos > 0 && isIdentifierChar(code[pos-1]))
+			continue; // part of another name
+
+		std::size_t i = pos+NAME.size();
+
+		if(i < code.size() && isIdentifierChar(code[i]))
+			continue; // part of another name
+
+		while(i < code.size() && std::isspace((unsigned char)code[i])) i++;
+
+		if(i >= code.size() || code[i] != '[')
+			return false;
+
+		i++;
+		while(i < code.size() && std::isspace((unsigned char)code[i])) i++;
+
+		const std::size_t digits = i;
+		while(i < code.size() && std::isdigit((unsigned char)code[i])) i++;
+
+		const std::size_t num_digits = i-digits;
+
+		while(i < code.size() && std::isspace((unsigned char)code[i])) i++;
+
+		if(num_digits == 0 || i >= code.size() || code[i] != ']')
+			return false;
+
+		i++;
+		while(i < code.size() && std::isspace((unsigned char)code[i])) i++;
+
+		if(i+1 < code.size() && code[i] == '=' && code[i+1] != '=')
+			writes.insert(std::stoul(code.substr(digits, num_digits)));
+	}
+
+	return true;
+}
+
+/**
+	zeroes the rows of row major matrix A of dimension n whose solutions are not demanded
+**/
+void zeroUndemandedRows(double* A, unsigned int n, const std::vector<bool>& demanded)
+{
+	for(unsigned int r = 0; r < n; r++)
+	{
+		if(!demanded[r])
+			std::fill(A+std::size_t(n)*r, A+std::size_t(n)*(r+1), 0.0);
+	}
+}
+
+/**
+	generates the Xilinx HLS directive binding the implementation of the operation op ('*' for
+	multiplications, '+' for additions, '-' for subtractions) assigned to the scalar variable, of
+	double real values or of ap_fixed values if fixed_point; a BIND_OP directive of Vitis HLS if
+	bind_op, otherwise a RESOURCE directive of Vivado HLS, whose core implements both additions and
+	subtractions
+**/
+std::string generateHlsBindDirective(const std::string& variable, char op, XilinxHlsOperatorImpl impl, bool fixed_point, bool bind_op)
+{
+	const bool fabric = (impl == XilinxHlsOperatorImpl::FABRIC);
+	const bool dsp_adder = (impl == XilinxHlsOperatorImpl::FULLDSP || impl == XilinxHlsOperatorImpl::MAXDSP);
+
+	std::string mul_impl;
+
+	switch(impl)
+	{
+		case XilinxHlsOperatorImpl::FABRIC:  mul_impl = "fabric"; break;
+		case XilinxHlsOperatorImpl::MEDDSP:  mul_impl = "meddsp"; break;
+		case XilinxHlsOperatorImpl::FULLDSP: mul_impl = "fulldsp"; break;
+		case XilinxHlsOperatorImpl::MAXDSP:  mul_impl = "maxdsp"; break;
+		default: return "";
+	}
+
+	if(bind_op)
+	{
+		const std::string add_impl = fixed_point ? (fabric ? "fabric" : "dsp") : (dsp_adder ? "fulldsp" : "fabric");
+
+		switch(op)
+		{
+			case '*': return "#pragma HLS bind_op variable="+variable+" op="+(fixed_point ? "mul" : "dmul")+" impl="+(fixed_point ? add_impl : mul_impl)+"\n";
+			case '+': return "#pragma HLS bind_op variable="+variable+" op="+(fixed_point ? "add" : "dadd")+" impl="+add_impl+"\n";
+			default:  return "#pragma HLS bind_op variable="+variable+" op="+(fixed_point ? "sub" : "dsub")+" impl="+add_impl+"\n";
+		}
+	}
+
+	const std::string mul_core = fixed_point ? (fabric ? "Mul_LUT" : "DSP48") : "DMul_" + (fabric ? std::string("nodsp") : mul_impl);
+	const std::string add_core = fixed_point ? (fabric ? "AddSub" : "AddSub_DSP") : (dsp_adder ? "DAddSub_fulldsp" : "DAddSub_nodsp");
+
+	return "#pragma HLS resource variable="+variable+" core="+(op == '*' ? mul_core : add_core)+"\n";
+}
+
+/**
+	trims the blanks at the ends of str
+**/
+std::string trimBlanks(const std::string& str)
+{
+	const std::size_t first = str.find_first_not_of(" \t\r");
+
+	if(first == std::string::npos)
+		return "";
+
+	return str.substr(first, str.find_last_not_of(" \t\r") - first + 1);
+}
+
+/**
+	finds the position of the parenthesis closing the one opened at position open of expr, or npos
+**/
+std::size_t findClosingParenthesis(const std::string& expr, std::size_t open)
+{
+	int depth = 0;
+
+	for(std::size_t i = open; i < expr.size(); i++)
+	{
+		if(expr[i] == '(')
+			depth++;
+		else if(expr[i] == ')' && --depth == 0)
+			return i;
+	}
+
+	return std::string::npos;
+}
+
+/**
+	finds whether expr has the character c outside of parentheses and brackets
+**/
+bool hasTopLevelChar(const std::string& expr, char c)
+{
+	int depth = 0;
+
+	for(const char e : expr)
+	{
+		if(e == '(' || e == '[')
+			depth++;
+		else if(e == ')' || e == ']')
+			depth--;
+		else if(e == c && depth == 0)
+			return true;
+	}
+
+	return false;
+}
+
+/**
+	\brief binds the Xilinx HLS implementations of the operations of the statements of generated code
+
+	Binding directives name the scalar variable an operation is assigned to, so each statement
+	assigning a sum of products, such as x[r] = a*b + c*d, is emitted through scalar temporaries
+	holding each product and each sum of the statement, including the sums in parentheses of adder
+	trees, with one directive per operation of each temporary.  Temporaries are declared auto so they
+	hold the exact type of their operations, which for ap_fixed values keeps the full precision the
+	statement would have before its assignment.  Lines that are not such statements, such as
+	declarations without operations, compound assignments, comments and directives, are left as is.
+**/
+class HlsOperationBinder
+{
+private:
+
+	XilinxHlsOperatorImpl impl;
+	bool fixed_point;
+	bool bind_op;
+	std::map<std::string, unsigned int> num_temporaries; ///< number of temporaries of each statement name
+
+	struct Term
+	{
+		bool subtracted;
+		std::string operand;
+	};
+
+		// splits expr at its additions and subtractions outside of parentheses; a sign that does not
+		// follow an operand, such as a unary minus, or the sign of an exponent of a literal, is kept in
+		// its operand
+
+	static std::vector<Term> splitTerms(const std::string& expr)
+	{
+		std::vector<Term> terms(1, Term{false, ""});
+		int depth = 0;
+		char prev = '\0';
+
+		for(std::size_t i = 0; i < expr.size(); i++)
+		{
+			const char c = expr[i];
+
+			if(c == '(' || c == '[')
+				depth++;
+			else if(c == ')' || c == ']')
+				depth--;
+
+			const bool follows_operand = std::isalnum((unsigned char)prev) || prev == '_' || prev == '.' || prev == ')' || prev == ']';
+
+			if(depth == 0 && (c == '+' || c == '-') && follows_operand && !isExponentSign(terms.back().operand))
+			{
+				terms.push_back(Term{c == '-', ""});
+				prev = c;
+				continue;
+			}
+
+			terms.back().operand += c;
+
+			if(c != ' ' && c != '\t')
+				prev = c;
+		}
+
+		for(Term& term : terms)
+			term.operand = trimBlanks(term.operand);
+
+		return terms;
+	}
+
+		// whether a sign following operand is the sign of the exponent of a literal such as 1.0e-3
+
+	static bool isExponentSign(const std::string& operand)
+	{
+		const std::string text = trimBlanks(operand);
+
+		if(text.empty() || (text.back() != 'e' && text.back() != 'E'))
+			return false;
+
+		std::size_t begin = text.size()-1;
+
+		while(begin > 0 && (std::isalnum((unsigned char)text[begin-1]) || text[begin-1] == '_' || text[begin-1] == '.'))
+			begin--;
+
+		return std::isdigit((unsigned char)text[begin]) || text[begin] == '.';
+	}
+
+	std::string declareTemporary(const std::string& name, const std::string& value, const std::string& ops,
+	                             const std::string& indent, std::ostream& out)
+	{
+		const std::string temporary = name + "_" + std::to_string(num_temporaries[name]++);
+
+		out << indent << "const auto " << temporary << " = " << value << ";\n";
+
+		for(const char op : ops)
+			out << indent << generateHlsBindDirective(temporary, op, impl, fixed_point, bind_op);
+
+		return temporary;
+	}
+
+	std::string bindOperand(const std::string& operand, const std::string& name, const std::string& indent, std::ostream& out)
+	{
+		if(operand.empty())
+			return operand;
+
+		const std::size_t open = operand.find('(');
+
+		if(open != std::string::npos && findClosingParenthesis(operand, open) == operand.size()-1)
+		{
+			const std::string inner = operand.substr(open+1, operand.size()-open-2);
+
+				// a sum in parentheses, or the single argument of a cast or call wrapping the operand
+
+			if(open == 0)
+				return bindSum(inner, name, indent, out);
+
+			const std::string callee = trimBlanks(operand.substr(0, open));
+
+			if(callee.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_:<>") == std::string::npos &&
+			   !hasTopLevelChar(inner, ','))
+				return callee + "(" + bindSum(inner, name, indent, out) + ")";
+		}
+
+		if(hasTopLevelChar(operand, '*'))
+			return declareTemporary(name + "_mul", operand, "*", indent, out);
+
+		return operand;
+	}
+
+	std::string bindSum(const std::string& expr, const std::string& name, const std::string& indent, std::ostream& out)
+	{
+		const std::vector<Term> terms = splitTerms(expr);
+
+		if(terms.size() == 1)
+			return bindOperand(terms[0].operand, name, indent, out);
+
+		std::string sum;
+		std::string ops;
+
+		for(std::size_t t = 0; t < terms.size(); t++)
+		{
+			const std::string operand = bindOperand(terms[t].operand, name, indent, out);
+			const char op = terms[t].subtracted ? '-' : '+';
+
+			if(t != 0)
+			{
+				sum += std::string(" ") + op + " ";
+
+				if(ops.find(op) == std::string::npos)
+					ops += op;
+			}
+
+			sum += operand;
+		}
+
+			// a RESOURCE core implements both additions and subtractions, so it is named once
+
+		if(!bind_op && ops.size() > 1)
+			ops.resize(1);
+
+		return declareTemporary(name + "_sum", sum, ops, indent, out);
+	}
+
+public:
+
+	HlsOperationBinder(XilinxHlsOperatorImpl impl, bool fixed_point, bool bind_op) :
+		impl(impl),
+		fixed_point(fixed_point),
+		bind_op(bind_op),
+		num_temporaries()
+	{}
+
+	std::string bind(const std::string& code)
+	{
+		std::stringstream sstrm;
+		std::istringstream lines(code);
+
+		for(std::string line; std::getline(lines, line); )
+		{
+			const std::string statement = trimBlanks(line);
+			const std::size_t assign = statement.find('=');
+
+			if(statement.empty() || statement[0] == '/' || statement[0] == '#' || statement.back() != ';' ||
+			   assign == std::string::npos || assign == 0 || statement.find('=', assign+1) != std::string::npos ||
+			   statement.find(';') != statement.size()-1 ||
+			   std::string("+-*/%&|^<>!").find(statement[assign-1]) != std::string::npos)
+			{
+				sstrm << line << "\n";
+				continue;
+			}
+
+			const std::string lhs = trimBlanks(statement.substr(0, assign));
+			const std::string rhs = trimBlanks(statement.substr(assign+1, statement.size()-assign-2));
+			const std::string indent = line.substr(0, line.find_first_not_of(" \t"));
+
+				// temporaries are named after the assigned variable, such as x_3 for x[3]
+
+			std::string name;
+
+			for(std::size_t i = lhs.find_last_of(" \t*&")+1; i < lhs.size(); i++)
+			{
+				if(std::isalnum((unsigned char)lhs[i]) || lhs[i] == '_')
+					name += lhs[i];
+				else if(lhs[i] == '[' && !name.empty())
+					name += '_';
+			}
+
+			std::stringstream temporaries;
+			const std::string value = bindSum(rhs, name, indent, temporaries);
+
+			if(temporaries.tellp() > 0)
+				sstrm << temporaries.str() << indent << lhs << " = " << value << ";\n";
+			else
+				sstrm << line << "\n";
+		}
+
+		return sstrm.str();
+	}
+};
+
+} //anonymous namespace
+
 SolverEngineGenerator::SolverEngineGenerator
 (
 	std::string model_name,
@@ -44,9 +478,14 @@ SolverEngineGenerator::SolverEngineGenerator
 	comp_outputs(),
 	comp_outputs_update_bodies(),
 	comp_update_bodies(),
-	conductance_matrix_gen(num_solutions),
+	comp_update_rate_divisors(),
+	comp_update_rate_phases(),
+	conductance_matrix_gen(num_solutions, true),
 	source_vector_gen(num_solutions),
-	parameters()
+	parameters(),
+	inverse_source(),
+	inverse_cache(),
+	model_cache(nullptr)
 {
 	if(model_name == "")
 		throw std::runtime_error("SimulationEngineGenerator::constructor(): model_name cannot be null or empty");
@@ -64,9 +503,14 @@ SolverEngineGenerator::SolverEngineGenerator(const SolverEngineGenerator& base)
 	comp_outputs(base.comp_outputs),
 	comp_outputs_update_bodies(base.comp_outputs_update_bodies),
 	comp_update_bodies(base.comp_update_bodies),
+	comp_update_rate_divisors(base.comp_update_rate_divisors),
+	comp_update_rate_phases(base.comp_update_rate_phases),
 	conductance_matrix_gen(base.conductance_matrix_gen),
 	source_vector_gen(base.source_vector_gen),
-	parameters(base.parameters)
+	parameters(base.parameters),
+	inverse_source(base.inverse_source),
+	inverse_cache(base.inverse_cache),
+	model_cache(base.model_cache)
 {}
 
 void SolverEngineGenerator::reset(std::string model_name, unsigned int num_solutions)
@@ -85,8 +529,12 @@ void SolverEngineGenerator::reset(std::string model_name, unsigned int num_solut
 	this->comp_outputs.clear();
 	this->comp_outputs_update_bodies.clear();
 	this->comp_update_bodies.clear();
-	this->conductance_matrix_gen = SystemConductanceGenerator(num_solutions);
+	this->comp_update_rate_divisors.clear();
+	this->comp_update_rate_phases.clear();
+	this->conductance_matrix_gen = SystemConductanceGenerator(num_solutions, true);
 	this->source_vector_gen = SystemSourceVectorGenerator(num_solutions);
+	this->inverse_source = SparseMatrixRMXd();
+	this->inverse_cache.reset();
 }
 
 void SolverEngineGenerator::setModelName(std::string model_name)
@@ -107,6 +555,41 @@ SystemConductanceGenerator&  SolverEngineGenerator::getConductanceGenerator()
 	return conductance_matrix_gen;
 }
 
+const SystemConductanceGenerator& SolverEngineGenerator::getInverseConductanceGenerator() const
+{
+	SparseMatrixRMXd g = conductance_matrix_gen.asEigen3SparseMatrix();
+	g.makeCompressed();
+
+	const bool unchanged =
+		inverse_cache &&
+		g.rows() == inverse_source.rows() &&
+		g.nonZeros() == inverse_source.nonZeros() &&
+		std::equal(g.outerIndexPtr(), g.outerIndexPtr()+g.outerSize()+1, inverse_source.outerIndexPtr()) &&
+		std::equal(g.innerIndexPtr(), g.innerIndexPtr()+g.nonZeros(), inverse_source.innerIndexPtr()) &&
+		std::equal(g.valuePtr(), g.valuePtr()+g.nonZeros(), inverse_source.valuePtr());
+
+	if(!unchanged)
+	{
+		std::shared_ptr<const SystemConductanceGenerator> inverse = model_cache ? model_cache->findInverse(g) : nullptr;
+
+		if(!inverse)
+		{
+			std::shared_ptr<SystemConductanceGenerator> computed = std::make_shared<SystemConductanceGenerator>(conductance_matrix_gen);
+			computed->invertSelf();
+
+			if(model_cache)
+				model_cache->addInverse(g, computed);
+
+			inverse = computed;
+		}
+
+		inverse_cache = inverse;
+		inverse_source.swap(g);
+	}
+
+	return *inverse_cache;
+}
+
 SystemSourceVectorGenerator& SolverEngineGenerator::getSourceVectorGenerator()
 {
 	return source_vector_gen;
@@ -144,8 +627,70 @@ void SolverEngineGenerator::insertComponentOutputsUpdateBody(std::string& code)
 
 void SolverEngineGenerator::insertComponentUpdateBody(std::string& code)
 {
+	insertComponentUpdateBody(code, 1, 0);
+}
+
+void SolverEngineGenerator::insertComponentUpdateBody(std::string& code, unsigned int rate_divisor, unsigned int rate_phase)
+{
+	if(rate_divisor == 0 || rate_phase >= rate_divisor)
+		throw std::invalid_argument("SolverEngineGenerator::insertComponentUpdateBody(): rate_divisor must be positive nonzero and rate_phase must be less than it");
+
 	if(code.empty()) return;
 	comp_update_bodies.push_back(code);
+	comp_update_rate_divisors.push_back(rate_divisor);
+	comp_update_rate_phases.push_back(rate_phase);
+}
+
+void SolverEngineGenerator::stampComponents
+(
+	const std::vector< std::unique_ptr<Component> >& components,
+	unsigned int num_threads,
+	const std::vector<std::string>& outputs
+)
+{
+	const unsigned int num_components = components.size();
+	const unsigned int num_shares = getParallelForBlocks(num_components, num_threads);
+
+	if(num_shares <= 1)
+	{
+		for(const auto& component : components)
+			component->stampSystem(*this, outputs);
+
+		return;
+	}
+
+		// conductances into partial generators, reduced in order of the shares
+
+	std::vector<SystemConductanceGenerator> partials(num_shares, SystemConductanceGenerator(num_solutions, true));
+
+	parallelFor(num_components, num_shares, [&](unsigned int share, unsigned int begin, unsigned int end)
+	{
+		for(unsigned int c = begin; c < end; c++)
+			components[c]->stampConductance(partials[share]);
+	});
+
+	for(const auto& partial : partials)
+		conductance_matrix_gen.accumulate(partial);
+
+	partials.clear();
+
+		// sources in component order, as their ids are the order they are stamped in
+
+	for(const auto& component : components)
+		component->stampSources(source_vector_gen);
+
+		// code of each component, which depends on its source ids
+
+	std::vector<Component::GeneratedCode> codes(num_components);
+
+	parallelFor(num_components, num_shares, [&](unsigned int, unsigned int begin, unsigned int end)
+	{
+		for(unsigned int c = begin; c < end; c++)
+			codes[c] = components[c]->generateCode(outputs);
+	});
+
+	for(unsigned int c = 0; c < num_components; c++)
+		components[c]->insertCode(*this, codes[c]);
 }
 
 std::string SolverEngineGenerator::generateCFunctionParameterList() const
@@ -205,154 +750,1488 @@ std::string SolverEngineGenerator::generateCFunctionParameterList() const
 	return sstrm.str();
 }
 
-std::string SolverEngineGenerator::generateCInlineCode(double zero_bound) const
+void SolverEngineGenerator::generateSolveCode(std::string& solve_constants_code, std::string& aggregation_code, std::string& solve_code,
+                                              std::vector<std::string>& source_fold_codes, double zero_bound) const
 {
-	std::stringstream sstrm;
+	aggregation_code = source_vector_gen.asCInlineCode();
+	source_fold_codes.clear();
 
-	SystemConductanceGenerator invg_gen(conductance_matrix_gen);
-	invg_gen.invertSelf();
-	const double * invg = invg_gen.asArray();
+	const std::vector<bool> demanded = findDemandedSolutions();
+	const bool demand_driven = std::find(demanded.begin(), demanded.end(), false) != demanded.end();
 
-	unsigned int num_components = source_vector_gen.getNumSources();
-
-	SystemSolverGenerator solver_gen(invg, num_solutions, num_components, zero_bound);
-
-	std::string buf;
+	if(parameters.conduct_matrix_factorization_enable)
+	{
+		SystemFactorizedSolverGenerator factor_gen(conductance_matrix_gen, zero_bound);
 
-	//codegen xilinx HLS features
-	if(parameters.xilinx_hls_enable)
+		solve_constants_code = "//FACTORIZED CONDUCTANCE MATRIX P*G*Q = L*D*U\n\n" + factor_gen.generateCFactorsLiteral("lu");
+		solve_code = factor_gen.generateCInlineCode("lu");
+	}
+	else
 	{
-		sstrm << "//clock period=" << parameters.xilinx_hls_clock_period << "\n";
+		SystemConductanceGenerator invg_gen(getInverseConductanceGenerator());
 
-		if(parameters.xilinx_hls_inline)
+		if(demand_driven)
 		{
-			sstrm << "#pragma HLS inline\n";
-		}
+				// rows of undemanded solutions are zeroed so that the solves, their tables, and the
+				// source aggregation below do not keep terms for them
 
-		if(parameters.xilinx_hls_latency_enable)
-		{
-			sstrm << "#pragma HLS latency min="<<parameters.xilinx_hls_latency_min<<
-			         " max="<<parameters.xilinx_hls_latency_max<<"\n";
-		}
+			zeroUndemandedRows(invg_gen.asArray(), num_solutions, demanded);
 
-		sstrm << "\n";
-	}
+			if(!parameters.io_source_vector_output_enable)
+			{
+				std::vector<bool> b_used(num_solutions, false);
 
-	sstrm << "//MODEL PARAMETERS\n\n";
+				for(unsigned int r = 0; r < num_solutions; r++)
+				{
+					for(unsigned int c = 0; c < num_solutions; c++)
+					{
+						const double a = invg_gen.asArray()[std::size_t(num_solutions)*r+c];
 
-	for(auto i : comp_parameters)
-	{
-		sstrm << i << "\n";
-	}
-	sstrm << "\n";
+						if(a >= zero_bound || a <= -zero_bound)
+							b_used[c] = true;
+					}
+				}
 
-	sstrm << "//COMPONENT FIELDS AND STATES\n\n";
+				aggregation_code = source_vector_gen.asCInlineCode(b_used);
+			}
+		}
 
-	for(auto i : comp_fields)
-	{
-		sstrm << i << "\n";
-	}
-	sstrm << "\n";
+		const double * invg = invg_gen.asArray();
 
-	sstrm << "//MODEL SOLUTIONS\n\n";
+		SystemSolverGenerator solver_gen(invg, num_solutions, source_vector_gen.getNumSources(), zero_bound);
 
-	sstrm
-	<< "static real b["<<num_solutions<<"];\n"
-	<< "static real x["<<num_solutions+1<<"];\n"
-	<< "real b_components["<<num_components<<"];\n\n";
+		if(demand_driven)
+			solver_gen.setSolvedRows(demanded);
 
-	sstrm << "//INVERTED CONDUCTANCE MATRIX\n\n";
+		solver_gen.setAdderTree(parameters.inv_conduct_matrix_tree_fan_in,
+		                        parameters.xilinx_hls_enable && parameters.xilinx_hls_tree_register_enable);
 
-	buf = invg_gen.asCLiteral("inv_g");
-	sstrm << buf << "\n\n";
+		if(parameters.inv_conduct_matrix_overlapped_enable)
+		{
+			if(parameters.fixed_point_enable)
+				throw std::runtime_error("SolverEngineGenerator::generateSolveCode(): overlapped solve of inverted conductance matrix needs floating point real type");
 
-	sstrm << "//COMPONENT SOURCE CONTRIBUTION UPDATES\n\n";
+			SystemOverlappedSolverGenerator overlapped_gen(invg, num_solutions, source_vector_gen, zero_bound,
+			                                               demand_driven ? demanded : std::vector<bool>());
+			overlapped_gen.setFolds(findSourceFolds());
 
-	for(auto i : comp_update_bodies)
-	{
-		sstrm << i << "\n";
-	}
-	sstrm << "\n";
+			solve_constants_code = "//SOURCE OPERATOR G^-1*S BY COLUMN, IN ORDER OF FOLDING INTO THE SOLUTIONS\n\n" +
+			                       overlapped_gen.generateCColumnsLiteral("inv_g_s");
 
-	if(parameters.io_signal_output_enable)
-	{
-		sstrm << "//MODEL OUTPUT SIGNAL UPDATES\n\n";
+			if(!parameters.io_source_vector_output_enable)
+				aggregation_code.clear();
 
-		for(auto i : comp_outputs_update_bodies)
+			source_fold_codes = overlapped_gen.generateCFoldCode("inv_g_s", "x_sum_");
+			solve_code = overlapped_gen.generateCInlineCode("inv_g_s", "x_sum_");
+		}
+		else if(parameters.inv_conduct_matrix_simd_enable)
 		{
-			sstrm << i << "\n";
+			if(parameters.fixed_point_enable)
+				throw std::runtime_error("SolverEngineGenerator::generateSolveCode(): SIMD solve of inverted conductance matrix needs floating point real type");
+
+			solve_constants_code = "//INVERTED CONDUCTANCE MATRIX IN SIMD VECTORS OF ROWS\n\n" +
+			                       solver_gen.generateCSimdLiteral(parameters.inv_conduct_matrix_simd_width, "inv_g_simd");
+			solver_gen.generateCInlineCodeSimd(solve_code, parameters.inv_conduct_matrix_simd_width, "inv_g_simd");
 		}
-		sstrm << "\n";
-	}
+		else if(parameters.fixed_point_enable)
+		{
+			SystemFixedPointSolverGenerator fixed_gen = createFixedPointSolverGenerator(invg, zero_bound);
 
-	sstrm << "//AGGREGRATE COMPONENT SOURCE CONTRIBUTIONS\n\n";
+			solve_constants_code = "//FIXED POINT FORMATS OF INVERTED CONDUCTANCE MATRIX SOLVE\n\n" + fixed_gen.generateCTypesLiteral("inv_g");
+			solve_code = fixed_gen.generateCInlineCode("inv_g");
+		}
+		else if(parameters.inv_conduct_matrix_fused_enable)
+		{
+			SystemFusedSolverGenerator fused_gen(invg, num_solutions, source_vector_gen, zero_bound,
+			                                     demand_driven ? demanded : std::vector<bool>());
 
-	source_vector_gen.asCInlineCode(buf);
-	sstrm << buf << "\n\n";
+			solve_constants_code = "//FUSED SOURCE OPERATOR G^-1*S OF FUSED ROWS\n\n" + fused_gen.generateCFusedLiteral("inv_g_s");
+
+			if(fused_gen.getNumberOfFusedRows() != num_solutions)
+				solve_constants_code += "\n//INVERTED CONDUCTANCE MATRIX\n\n" + invg_gen.asCLiteral("inv_g");
+
+			if(!parameters.io_source_vector_output_enable)
+				aggregation_code = source_vector_gen.asCInlineCode(fused_gen.getUsedSourceVectorElements());
+
+			solve_code = fused_gen.generateCInlineCode("inv_g", "inv_g_s");
+		}
+		else
+		{
+			solve_constants_code = "//INVERTED CONDUCTANCE MATRIX\n\n" + invg_gen.asCLiteral("inv_g");
+			solve_code.clear();
+
+			if(parameters.inv_conduct_matrix_block_sparse_enable)
+			{
+				solver_gen.generateCInlineCodeBlockSparse(solve_code, "inv_g");
+			}
+			else if(parameters.codegen_ir_optimization_enable && solver_gen.getAdderTreeFanIn() == 0)
+			{
+				CodeIR ir = generateSolveCodeIR(zero_bound);
+				ir.optimize();
+
+				aggregation_code = ir.generateCInlineCode(ir.findArray("b"));
+				solve_code = ir.generateCInlineCode(ir.findArray("x"));
+			}
+			else
+			{
+				solver_gen.generateCInlineCode(solve_code, "inv_g");
+			}
+		}
+	}
+}
+
+SolverStepDataflow SolverEngineGenerator::analyzeStepDataflow(double zero_bound) const
+{
+	std::string solve_constants_code;
+	std::string aggregation_code;
+	std::string solve_code;
+	std::vector<std::string> source_fold_codes;
+	generateSolveCode(solve_constants_code, aggregation_code, solve_code, source_fold_codes, zero_bound);
+
+	std::vector<std::string> tasks;
+	std::vector<unsigned int> regions;
+	scheduleStepTasks(aggregation_code, source_fold_codes, tasks, regions);
+
+	CppDataflow dataflow;
+
+	for(const std::string& task : tasks)
+		dataflow.analyze(task);
+
+	dataflow.analyze(solve_code);
+
+	SolverStepDataflow summary;
+	summary.num_tasks = tasks.size();
+	summary.num_regions = (regions.empty() ? 0 : *std::max_element(regions.begin(), regions.end())+1) + 1;
+	summary.critical_path_length = dataflow.getCriticalPathLength();
+	summary.num_operations = dataflow.getNumberOfOperations();
+
+	return summary;
+}
+
+CodeIR SolverEngineGenerator::generateSolveCodeIR(double zero_bound) const
+{
+	const std::vector<bool> demanded = findDemandedSolutions();
+	const bool demand_driven = std::find(demanded.begin(), demanded.end(), false) != demanded.end();
+
+	SystemConductanceGenerator invg_gen(getInverseConductanceGenerator());
+
+	if(demand_driven)
+		zeroUndemandedRows(invg_gen.asArray(), num_solutions, demanded);
+
+	const unsigned int num_components = source_vector_gen.getNumSources();
+
+	CodeIR ir("real", "inv_g_product");
+
+	const unsigned int invg = ir.insertArray(ArrayObject("real", "inv_g", "", {num_solutions, num_solutions}),
+	                                         CodeIR::Storage::CONSTANT, invg_gen.asArray());
+	const unsigned int b_components = ir.insertArray(ArrayObject("real", "b_components", "", {std::max(num_components, 1u)}),
+	                                                 CodeIR::Storage::INPUT);
+	const unsigned int b = ir.insertArray(ArrayObject("real", "b", "", {num_solutions}),
+	                                      parameters.io_source_vector_output_enable ? CodeIR::Storage::OUTPUT : CodeIR::Storage::TEMPORARY);
+	const unsigned int x = ir.insertArray(ArrayObject("real", "x", "", {num_solutions+1}), CodeIR::Storage::OUTPUT);
+
+	source_vector_gen.generateCodeIR(ir, b, b_components);
+
+	SystemSolverGenerator solver_gen(invg_gen.asArray(), num_solutions, num_components, zero_bound);
+
+	if(demand_driven)
+		solver_gen.setSolvedRows(demanded);
+
+	solver_gen.generateCodeIR(ir, invg, b, x);
+
+	return ir;
+}
+
+SystemFixedPointSolverGenerator SolverEngineGenerator::createFixedPointSolverGenerator(const double* invg, double zero_bound) const
+{
+	const SystemFixedPointSolverGenerator::Format real_format =
+		{int(parameters.fixed_point_word_width), int(parameters.fixed_point_int_width)};
+
+	const double source_bound = (parameters.fixed_point_source_bound > 0.0) ?
+	                            parameters.fixed_point_source_bound :
+	                            std::ldexp(1.0, real_format.int_width-1);
+
+	std::vector<double> source_bounds(num_solutions);
+
+	for(unsigned int i = 0; i < num_solutions; i++)
+		source_bounds[i] = source_vector_gen.getNumContributions(i) * source_bound;
+
+	return SystemFixedPointSolverGenerator(invg, num_solutions, source_bounds, real_format, !parameters.xilinx_hls_enable,
+	                                       parameters.inv_conduct_matrix_rescale_enable, zero_bound);
+}
+
+std::string SolverEngineGenerator::generateRealTypeDefinition() const
+{
+	std::stringstream sstrm;
+
+	if(parameters.fixed_point_enable)
+	{
+		if(parameters.xilinx_hls_enable)
+			sstrm << "#include <ap_fixed.h>\n";
+		else
+			sstrm << "#include <cstdint>\n#include <cmath>\n";
+	}
+
+	if( !( parameters.codegen_solver_templated_real_type_enable == true &&
+		parameters.codegen_solver_templated_function_enable == true ) )
+	{
+		if(parameters.fixed_point_enable)
+		{
+			if(parameters.xilinx_hls_enable)
+			{
+				sstrm <<
+				"typedef ap_fixed<"<<parameters.fixed_point_word_width<<", "<<
+				parameters.fixed_point_int_width<<", AP_RND> real;\n\n";
+
+			}
+			else
+			{
+				sstrm << "//fixed point solve in portable integer arithmetic; other operations use double real values\n"<<
+				"typedef double real;\n\n";
+			}
+		}
+		else
+		{
+			sstrm << "typedef double real;\n\n";
+		}
+	}
+	else if(parameters.fixed_point_enable)
+	{
+		sstrm << "\n";
+	}
+
+	if(parameters.xilinx_hls_enable && parameters.xilinx_hls_tree_register_enable && parameters.inv_conduct_matrix_tree_fan_in >= 2)
+	{
+		sstrm << SystemSolverGenerator::generateCHlsRegisterDefinition() << "\n";
+	}
+
+	return sstrm.str();
+}
+
+std::string SolverEngineGenerator::generateHlsFunctionDirectives() const
+{
+	std::stringstream sstrm;
+
+	sstrm << "//clock period=" << parameters.xilinx_hls_clock_period << "\n";
+
+	if(parameters.xilinx_hls_inline)
+	{
+		sstrm << "#pragma HLS inline\n";
+	}
+
+	if(parameters.xilinx_hls_latency_enable)
+	{
+		sstrm << "#pragma HLS latency min="<<parameters.xilinx_hls_latency_min<<
+		         " max="<<parameters.xilinx_hls_latency_max<<"\n";
+	}
+
+	if(parameters.xilinx_hls_pipeline_enable)
+	{
+		if(parameters.xilinx_hls_pipeline_ii == 0)
+			throw std::invalid_argument("SolverEngineGenerator::generateHlsFunctionDirectives(): xilinx_hls_pipeline_ii must be 1 or more clock cycles");
+
+		sstrm << "#pragma HLS pipeline II="<<parameters.xilinx_hls_pipeline_ii<<"\n";
+	}
+
+	if(parameters.xilinx_hls_interface != XilinxHlsInterface::DEFAULT)
+	{
+		for(const CppDeclaration& port : CppDeclaration::parseAll(generateCFunctionParameterList(), ','))
+		{
+			switch(parameters.xilinx_hls_interface)
+			{
+				case XilinxHlsInterface::AP_NONE:
+					if(!port.dimensions.empty())
+						sstrm << "#pragma HLS array_partition variable="<<port.name<<" complete dim=0\n";
+
+					sstrm << "#pragma HLS interface ap_none port="<<port.name<<"\n";
+					break;
+
+				case XilinxHlsInterface::S_AXILITE:
+					sstrm << "#pragma HLS interface s_axilite port="<<port.name<<" bundle=control\n";
+					break;
+
+				case XilinxHlsInterface::AXIS:
+					sstrm << "#pragma HLS interface axis port="<<port.name<<"\n";
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		if(parameters.xilinx_hls_interface == XilinxHlsInterface::S_AXILITE)
+			sstrm << "#pragma HLS interface s_axilite port=return bundle=control\n";
+		else if(parameters.xilinx_hls_interface == XilinxHlsInterface::AXIS)
+			sstrm << "#pragma HLS interface ap_ctrl_none port=return\n";
+	}
+
+	sstrm << "\n";
+
+	return sstrm.str();
+}
+
+std::string SolverEngineGenerator::generateHlsArrayDirectives(const std::string& declarations_code) const
+{
+	std::stringstream sstrm;
+
+	if(parameters.xilinx_hls_array_partition_enable)
+	{
+		for(const std::string& item : CppDeclaration::split(declarations_code, ';'))
+		{
+				// type definitions, such as of SIMD vectors or fixed point formats, declare no arrays
+
+			if(item.compare(0, 8, "typedef ") == 0)
+				continue;
+
+			const CppDeclaration decl = CppDeclaration::parse(item);
+
+			if(!decl.dimensions.empty())
+				sstrm << "#pragma HLS array_partition variable="<<decl.name<<" complete dim=0\n";
+		}
+	}
+
+	if(sstrm.tellp() > 0)
+		sstrm << "\n";
+
+	return sstrm.str();
+}
+
+std::string SolverEngineGenerator::generateHlsBoundCode(const std::string& code) const
+{
+	if(!parameters.xilinx_hls_enable || parameters.xilinx_hls_mac_impl == XilinxHlsOperatorImpl::DEFAULT)
+		return code;
+
+	HlsOperationBinder binder(parameters.xilinx_hls_mac_impl, parameters.fixed_point_enable, parameters.xilinx_hls_bind_op_enable);
+
+	return binder.bind(code);
+}
+
+std::string SolverEngineGenerator::generateMultirateFieldsCode() const
+{
+	std::stringstream sstrm;
+
+	std::set<unsigned int> divisors;
+	std::set<unsigned int> held;
+
+	for(unsigned int c = 0; c < comp_update_bodies.size(); c++)
+	{
+		if(comp_update_rate_divisors[c] == 1)
+			continue;
+
+		divisors.insert(comp_update_rate_divisors[c]);
+
+		if(!findSourceContributionWrites(comp_update_bodies[c], held))
+			throw std::invalid_argument("SolverEngineGenerator::generateMultirateFieldsCode(): update body of a component with rate divisor " +
+			                            std::to_string(comp_update_rate_divisors[c]) + " indexes b_components other than by constant");
+	}
+
+	for(const unsigned int k : divisors)
+		sstrm << "static unsigned int multirate_step_" << k << " = 0;\n";
+
+	for(const unsigned int i : held)
+		sstrm << "static real b_components_held_" << i << " = 0.0;\n";
+
+	return sstrm.str();
+}
+
+std::vector<std::string> SolverEngineGenerator::generateComponentUpdateTasks(const std::vector<std::string>& source_fold_codes) const
+{
+	std::vector<std::string> tasks;
+
+		// updates of slow components are grouped by the time step they fall on, so a group costs one
+		// branch; their source contributions are held between updates
+
+	std::map< std::pair<unsigned int, unsigned int>, std::vector<unsigned int> > slow_groups;
+	std::set<unsigned int> divisors;
+
+	for(unsigned int c = 0; c < comp_update_bodies.size(); c++)
+	{
+		if(comp_update_rate_divisors[c] == 1)
+		{
+			tasks.push_back(comp_update_bodies[c] + "\n");
+		}
+		else
+		{
+			slow_groups[std::make_pair(comp_update_rate_divisors[c], comp_update_rate_phases[c])].push_back(c);
+			divisors.insert(comp_update_rate_divisors[c]);
+		}
+	}
+
+	for(const auto& group : slow_groups)
+	{
+		std::stringstream sstrm;
+
+		const std::string step = "multirate_step_" + std::to_string(group.first.first);
+		std::set<unsigned int> held;
+
+		sstrm << "\n//COMPONENTS UPDATED EVERY " << group.first.first << " TIME STEPS AT PHASE " << group.first.second << "\n\n";
+		sstrm << "if(" << step << " == " << group.first.second << ")\n{\n";
+
+		for(const unsigned int c : group.second)
+		{
+			sstrm << comp_update_bodies[c] << "\n";
+			findSourceContributionWrites(comp_update_bodies[c], held);
+		}
+
+		for(const unsigned int i : held)
+			sstrm << "b_components_held_" << i << " = b_components[" << i << "];\n";
+
+		sstrm << "}\n";
+
+		for(const unsigned int i : held)
+			sstrm << "b_components[" << i << "] = b_components_held_" << i << ";\n";
+
+		tasks.push_back(sstrm.str());
+	}
+
+	if(!divisors.empty())
+	{
+		std::stringstream sstrm;
+
+		sstrm << "\n";
+
+		for(const unsigned int k : divisors)
+		{
+			const std::string step = "multirate_step_" + std::to_string(k);
+			sstrm << step << " = (" << step << " == " << k-1 << ") ? 0 : " << step << "+1;\n";
+		}
+
+		tasks.push_back(sstrm.str());
+	}
+
+	for(unsigned int t = 0; t < tasks.size() && t < source_fold_codes.size(); t++)
+	{
+		if(!source_fold_codes[t].empty())
+			tasks[t] += source_fold_codes[t] + "\n";
+	}
+
+	return tasks;
+}
+
+std::vector< std::vector<unsigned int> > SolverEngineGenerator::findSourceFolds() const
+{
+	const std::vector<std::string> tasks = generateComponentUpdateTasks();
+
+	std::vector< std::vector<unsigned int> > folds(tasks.size());
+
+		// a source is folded after its last assignment, and after any code that may assign it
+		// through a computed index
+
+	std::vector<int> last_tasks(source_vector_gen.getNumSources(), -1);
+	int last_unknown_task = -1;
+
+	for(unsigned int t = 0; t < tasks.size(); t++)
+	{
+		std::set<unsigned int> writes;
+
+		if(!findSourceContributionWrites(tasks[t], writes))
+			last_unknown_task = t;
+
+		for(const unsigned int s : writes)
+		{
+			if(s < last_tasks.size())
+				last_tasks[s] = t;
+		}
+	}
+
+	if(parameters.io_signal_output_enable)
+	{
+		for(const auto& body : comp_outputs_update_bodies)
+		{
+			std::set<unsigned int> writes;
+
+			if(!findSourceContributionWrites(body, writes) || !writes.empty())
+				return std::vector< std::vector<unsigned int> >(tasks.size()); // sources may change after the updates
+		}
+	}
+
+	for(unsigned int s = 0; s < last_tasks.size(); s++)
+	{
+		if(last_tasks[s] >= 0 && last_tasks[s] >= last_unknown_task)
+			folds[last_tasks[s]].push_back(s);
+	}
+
+	return folds;
+}
+
+std::string SolverEngineGenerator::generateComponentUpdatesCode() const
+{
+	std::string code;
+
+	for(const std::string& task : generateComponentUpdateTasks())
+		code += task;
+
+	return code;
+}
+
+void SolverEngineGenerator::scheduleStepTasks(const std::string& aggregation_code, const std::vector<std::string>& source_fold_codes,
+                                              std::vector<std::string>& tasks, std::vector<unsigned int>& regions) const
+{
+	tasks = generateComponentUpdateTasks(source_fold_codes);
+
+	const unsigned int num_updates = tasks.size();
+
+	if(parameters.io_signal_output_enable)
+	{
+		for(const auto& body : comp_outputs_update_bodies)
+			tasks.push_back(body + "\n");
+	}
+
+	const unsigned int num_unaggregated = tasks.size();
+
+	std::istringstream lines(aggregation_code);
+
+	for(std::string line; std::getline(lines, line); )
+	{
+		if(line.find_first_not_of(" \t\r") != std::string::npos)
+			tasks.push_back(line + "\n");
+	}
+
+	const unsigned int num_tasks = tasks.size();
+
+	std::vector<CppDataflow::Access> accesses;
+	accesses.reserve(num_tasks);
+
+	for(const std::string& task : tasks)
+		accesses.push_back(CppDataflow::findAccess(task));
+
+		// aggregations are bound after their accesses are found, so the temporaries of their
+		// bound operations are not taken for accesses of the time step
+
+	for(unsigned int t = num_unaggregated; t < num_tasks; t++)
+		tasks[t] = generateHlsBoundCode(tasks[t]);
+
+	const std::vector< std::vector<unsigned int> > dependencies = CppDataflow::findDependencies(accesses);
+
+	std::vector<unsigned int> levels(num_tasks, 0);
+	std::vector< std::vector<unsigned int> > dependents(num_tasks);
+
+	for(unsigned int t = 0; t < num_tasks; t++)
+	{
+		for(const unsigned int d : dependencies[t])
+		{
+			levels[t] = std::max(levels[t], levels[d]+1);
+			dependents[d].push_back(t);
+		}
+	}
+
+	std::vector<unsigned int> order;
+	order.reserve(num_tasks);
+
+	if(parameters.xilinx_hls_enable)
+	{
+		for(unsigned int t = 0; t < num_tasks; t++)
+			order.push_back(t);
+
+		std::stable_sort(order.begin(), order.end(), [&levels](unsigned int a, unsigned int b) { return levels[a] < levels[b]; });
+	}
+	else
+	{
+			// list scheduling: consumers of updates, the output signal updates and aggregations, are
+			// scheduled as soon as they are ready, so each follows the updates it reads and their
+			// operations overlap those of the next updates; of the ready updates, the one that leaves
+			// a consumer the fewest updates from ready is scheduled first
+
+		std::vector<unsigned int> pending(num_tasks);
+		std::set<unsigned int> ready_updates;
+		std::set<unsigned int> ready_consumers;
+
+		auto release = [&](unsigned int t)
+		{
+			if(t < num_updates)
+				ready_updates.insert(t);
+			else
+				ready_consumers.insert(t);
+		};
+
+		for(unsigned int t = 0; t < num_tasks; t++)
+		{
+			pending[t] = dependencies[t].size();
+
+			if(pending[t] == 0)
+				release(t);
+		}
+
+		while(order.size() < num_tasks)
+		{
+			unsigned int next;
+
+			if(!ready_consumers.empty())
+			{
+				next = *ready_consumers.begin();
+				ready_consumers.erase(ready_consumers.begin());
+			}
+			else
+			{
+				unsigned int best_remaining = ~0u;
+				next = *ready_updates.begin();
+
+				for(const unsigned int t : ready_updates)
+				{
+					unsigned int remaining = ~0u;
+
+					for(const unsigned int d : dependents[t])
+						remaining = std::min(remaining, pending[d]);
+
+					if(remaining < best_remaining)
+					{
+						best_remaining = remaining;
+						next = t;
+
+						if(remaining == 1)
+							break;
+					}
+				}
+
+				ready_updates.erase(next);
+			}
+
+			order.push_back(next);
+
+			for(const unsigned int d : dependents[next])
+			{
+				if(--pending[d] == 0)
+					release(d);
+			}
+		}
+	}
+
+	std::vector<std::string> scheduled(num_tasks);
+	regions.resize(num_tasks);
+
+	for(unsigned int i = 0; i < num_tasks; i++)
+	{
+		scheduled[i] = std::move(tasks[order[i]]);
+		regions[i] = levels[order[i]];
+	}
+
+	tasks = std::move(scheduled);
+}
+
+std::string SolverEngineGenerator::generateUpdateAndSolveCode(const std::string& aggregation_code, const std::string& solve_code,
+                                                              const std::vector<std::string>& source_fold_codes) const
+{
+	std::stringstream sstrm;
+
+	if(parameters.codegen_dataflow_schedule_enable)
+	{
+		std::vector<std::string> tasks;
+		std::vector<unsigned int> regions;
+		scheduleStepTasks(aggregation_code, source_fold_codes, tasks, regions);
+
+		if(parameters.xilinx_hls_enable)
+		{
+			sstrm << "//COMPONENT UPDATES, OUTPUT SIGNAL UPDATES, AND SOURCE AGGREGATION IN DATAFLOW REGIONS;\n"
+			         "//THE TASKS OF A REGION ARE INDEPENDENT AND READ ONLY RESULTS OF EARLIER REGIONS\n";
+
+			for(unsigned int i = 0; i < tasks.size(); i++)
+			{
+				if(i == 0 || regions[i] != regions[i-1])
+				{
+					sstrm << "\n//DATAFLOW REGION " << regions[i]+1 << ": "
+					      << std::count(regions.begin(), regions.end(), regions[i]) << " tasks\n\n";
+				}
+
+				sstrm << tasks[i];
+			}
+		}
+		else
+		{
+			sstrm << "//COMPONENT UPDATES, OUTPUT SIGNAL UPDATES, AND SOURCE AGGREGATION INTERLEAVED BY DATAFLOW\n\n";
+
+			for(const std::string& task : tasks)
+				sstrm << task;
+		}
+
+		sstrm << "\n//MODEL UPDATE SOLUTIONS\n\n";
+
+		sstrm << generateHlsBoundCode(solve_code) << "\n\n";
+
+		return sstrm.str();
+	}
+
+	sstrm << "//COMPONENT SOURCE CONTRIBUTION UPDATES\n\n";
+
+	for(const std::string& task : generateComponentUpdateTasks(source_fold_codes))
+		sstrm << task;
+
+	sstrm << "\n";
+
+	if(parameters.io_signal_output_enable)
+	{
+		sstrm << "//MODEL OUTPUT SIGNAL UPDATES\n\n";
+
+		for(auto i : comp_outputs_update_bodies)
+		{
+			sstrm << i << "\n";
+		}
+		sstrm << "\n";
+	}
+
+	sstrm << "//AGGREGRATE COMPONENT SOURCE CONTRIBUTIONS\n\n";
+
+	sstrm << generateHlsBoundCode(aggregation_code) << "\n\n";
 
 	sstrm << "//MODEL UPDATE SOLUTIONS\n\n";
 
-	solver_gen.generateCInlineCode(buf, "inv_g");
-	sstrm << buf << "\n\n";
+	sstrm << generateHlsBoundCode(solve_code) << "\n\n";
+
+	return sstrm.str();
+}
+
+void SolverEngineGenerator::parseComponentFields(std::vector<CppDeclaration>& fields, std::vector<std::string>& temporaries) const
+{
+	fields.clear();
+	temporaries.clear();
+
+	std::vector<std::string> codes(comp_fields);
+	codes.push_back(generateMultirateFieldsCode());
+
+	for(const auto& code : codes)
+	{
+		for(const auto& item : CppDeclaration::split(code, ';'))
+		{
+			CppDeclaration decl = CppDeclaration::parse(item);
+
+			if(decl.is_static && !decl.is_const)
+				fields.push_back(decl);
+			else
+				temporaries.push_back(item + ";");
+		}
+	}
+}
+
+std::string SolverEngineGenerator::generateCInlineCode(double zero_bound) const
+{
+	std::stringstream sstrm;
+
+	unsigned int num_components = source_vector_gen.getNumSources();
+
+	std::string solve_constants_code;
+	std::string aggregation_code;
+	std::string solve_code;
+	std::vector<std::string> source_fold_codes;
+	generateSolveCode(solve_constants_code, aggregation_code, solve_code, source_fold_codes, zero_bound);
+
+	std::string buf;
+
+	//codegen xilinx HLS features
+	if(parameters.xilinx_hls_enable)
+	{
+		sstrm << generateHlsFunctionDirectives();
+	}
+
+	sstrm << "//MODEL PARAMETERS\n\n";
+
+	for(auto i : comp_parameters)
+	{
+		sstrm << i << "\n";
+	}
+	sstrm << "\n";
+
+	sstrm << "//COMPONENT FIELDS AND STATES\n\n";
+
+	for(auto i : comp_fields)
+	{
+		sstrm << i << "\n";
+	}
+	sstrm << generateMultirateFieldsCode();
+	sstrm << "\n";
+
+	sstrm << "//MODEL SOLUTIONS\n\n";
+
+	std::stringstream solutions_sstrm;
+
+	solutions_sstrm
+	<< "static real b["<<num_solutions<<"];\n"
+	<< "static real x["<<num_solutions+1<<"];\n"
+	<< "real b_components["<<num_components<<"];\n\n";
+
+	solutions_sstrm << solve_constants_code << "\n\n";
+
+	sstrm << solutions_sstrm.str();
+
+	if(parameters.xilinx_hls_enable)
+	{
+		sstrm << generateHlsArrayDirectives(solutions_sstrm.str());
+	}
+
+	sstrm << generateUpdateAndSolveCode(aggregation_code, solve_code, source_fold_codes);
+
+	return sstrm.str();
+}
+
+std::string SolverEngineGenerator::generateCFunction(double zero_bound) const
+{
+	std::stringstream sstrm;
+
+	if(parameters.codegen_solver_templated_function_enable == true)
+	{
+        sstrm
+        << "template< int instance";
+
+        if(parameters.codegen_solver_templated_real_type_enable == true)
+		{
+			sstrm
+			<< ", typename real";
+		}
+
+		sstrm
+		<< " >\n";
+	}
+
+	sstrm
+	<< "void "<<model_name<<"_solver\n"
+	<< "(\n";
+
+	sstrm
+	<< generateCFunctionParameterList()
+	<< "\n)\n"
+	<< "{\n";
+
+	std::string buf;
+	buf = generateCInlineCode(zero_bound);
+	sstrm << buf;
+
+	const std::vector<unsigned int> node_solutions = findNetlistNodeSolutions();
+
+	if(parameters.io_source_vector_output_enable == true)
+	{
+		for(unsigned int i = 0; i < num_solutions; i++)
+		{
+			sstrm << "b_out["<<i<<"] = b["<<node_solutions[i]-1<<"];\n";
+		}
+	}
+
+	sstrm << "\n";
+
+	if(parameters.io_component_sources_output_enable == true)
+	{
+		for(unsigned int i = 0; i < source_vector_gen.getNumSources(); i++)
+		{
+			sstrm << "sources_out["<<i<<"] = b_components["<<i<<"];\n";
+		}
+	}
+
+	sstrm << "\n";
+
+	const std::vector<bool> demanded = findDemandedSolutions();
+
+	for(unsigned int i = 0; i < num_solutions; i++)
+	{
+		if(demanded[node_solutions[i]-1])
+			sstrm << "x_out["<<i<<"] = x["<<node_solutions[i]<<"];\n";
+	}
+
+	sstrm
+	<< "\n}";
+
+	return sstrm.str();
+}
+
+void SolverEngineGenerator::generateCFunctionAndExport(std::string filename, double zero_bound) const
+{
+	if(filename == "")
+		throw std::invalid_argument("SimulationEngineGenerator::generateCFunctionAndExport(): filename cannot be null or empty");
+
+	std::fstream file;
+
+	std::string fname = filename;
+
+	try
+	{
+		file.open(fname.c_str(), std::fstream::out | std::fstream::trunc);
+	}
+	catch(...)
+	{
+		throw std::runtime_error("SimulationEngineGenerator::generateCFunctionAndExport(): failed to open or create source files");
+	}
+
+	file <<
+			"/**\n"
+			" *\n"
+			" * LBLMC Vivado HLS Simulation Engine for FPGA Designs\n"
+			" *\n"
+			" * Auto-generated by SimulationEngineGenerator Object\n"
+			" *\n"
+			" */\n\n";
+
+	file << "#ifndef " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
+	file << "#define " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
+
+	file << "\n\n";
+
+	file << generateRealTypeDefinition();
+
+	if(parameters.codegen_solver_templated_function_enable == false)
+	{
+		file << "inline\n";
+	}
+
+    std::string buf;
+    buf = generateCFunction(zero_bound);
+    file << buf << "\n\n";
+
+	file << "\n#endif";
+
+	file.close();
+
+}
+
+std::string SolverEngineGenerator::generateFixedPointReport(double zero_bound) const
+{
+	SystemConductanceGenerator invg_gen(getInverseConductanceGenerator());
+
+	zeroUndemandedRows(invg_gen.asArray(), num_solutions, findDemandedSolutions());
+
+	return createFixedPointSolverGenerator(invg_gen.asArray(), zero_bound).generateReport(parameters.io_solution_netlist_nodes);
+}
+
+std::vector<unsigned int> SolverEngineGenerator::findNetlistNodeSolutions() const
+{
+	std::vector<unsigned int> node_solutions(num_solutions);
+
+	if(parameters.io_solution_netlist_nodes.empty())
+	{
+		for(unsigned int i = 0; i < num_solutions; i++)
+			node_solutions[i] = i+1;
+
+		return node_solutions;
+	}
+
+	if(parameters.io_solution_netlist_nodes.size() != num_solutions)
+		throw std::invalid_argument("SolverEngineGenerator::findNetlistNodeSolutions(): io_solution_netlist_nodes must have a netlist node for each of the " +
+		                            std::to_string(num_solutions) + " solutions");
+
+	std::vector<bool> mapped(num_solutions, false);
+
+	for(unsigned int i = 0; i < num_solutions; i++)
+	{
+		const unsigned int node = parameters.io_solution_netlist_nodes[i];
+
+		if(node == 0 || node > num_solutions || mapped[node-1])
+			throw std::invalid_argument("SolverEngineGenerator::findNetlistNodeSolutions(): io_solution_netlist_nodes is not a permutation of nodes 1 to " +
+			                            std::to_string(num_solutions));
+
+		mapped[node-1] = true;
+		node_solutions[node-1] = i+1;
+	}
+
+	return node_solutions;
+}
+
+std::vector<bool> SolverEngineGenerator::findDemandedSolutions() const
+{
+	if(!parameters.solve_demand_driven_enable || parameters.conduct_matrix_factorization_enable)
+		return std::vector<bool>(num_solutions, true);
+
+	std::vector<bool> demanded(num_solutions, false);
+	const std::vector<unsigned int> node_solutions = findNetlistNodeSolutions();
+
+	for(const unsigned int node : parameters.solve_demanded_solutions)
+	{
+		if(node == 0 || node > num_solutions)
+			throw std::invalid_argument("SolverEngineGenerator::findDemandedSolutions(): demanded solution node " +
+			                            std::to_string(node) + " is not in 1 to " + std::to_string(num_solutions));
+
+		demanded[node_solutions[node-1]-1] = true;
+	}
+
+	std::vector<const std::vector<std::string>*> codes = {&comp_fields, &comp_update_bodies};
+
+	if(parameters.io_signal_output_enable)
+		codes.push_back(&comp_outputs_update_bodies);
+
+	for(const auto* code : codes)
+	{
+		for(const auto& body : *code)
+		{
+			if(!markSolutionReads(body, demanded))
+				return std::vector<bool>(num_solutions, true);
+		}
+	}
+
+	return demanded;
+}
+
+std::string SolverEngineGenerator::generateBatchedCCode(double zero_bound) const
+{
+	std::stringstream sstrm;
+
+	const unsigned int num_components = source_vector_gen.getNumSources();
+	const bool templated_real = parameters.codegen_solver_templated_function_enable &&
+	                            parameters.codegen_solver_templated_real_type_enable;
+
+	const std::string template_params = templated_real ? "template< int N, typename real >\n" : "template< int N >\n";
+	const std::string batch_type = model_name + "_batch" + (templated_real ? "<N, real>" : "<N>");
+
+	std::string solve_constants_code;
+	std::string aggregation_code;
+	std::string solve_code;
+	std::vector<std::string> source_fold_codes;
+	generateSolveCode(solve_constants_code, aggregation_code, solve_code, source_fold_codes, zero_bound);
+
+		// signals and fields of a scenario, re-declared as per-scenario arrays
+
+	std::vector<CppDeclaration> outputs;
+	std::vector<CppDeclaration> inputs;
+	std::vector<CppDeclaration> fields;
+	std::vector<std::string> temporaries;
+
+	if(parameters.io_signal_output_enable)
+	{
+		for(const auto& code : comp_outputs)
+		{
+			for(const auto& decl : CppDeclaration::parseAll(code, ','))
+				outputs.push_back(decl);
+		}
+	}
+
+	for(const auto& code : comp_inputs)
+	{
+		for(const auto& decl : CppDeclaration::parseAll(code, ','))
+			inputs.push_back(decl);
+	}
+
+	parseComponentFields(fields, temporaries);
+
+		// copies between scenario k of the batch and the local objects of the solver; unrolled, as
+		// inner loops keep compilers from vectorizing the loop over the scenarios
+
+	auto arraySize = [](const CppDeclaration& decl) -> unsigned long
+	{
+		try
+		{
+			return std::stoul(decl.dimensions[0]);
+		}
+		catch(...)
+		{
+			throw std::runtime_error("SolverEngineGenerator::generateBatchedCCode(): array \'" + decl.name + "\' must have a literal size in batched solvers");
+		}
+	};
+
+	auto load = [&arraySize](std::stringstream& strm, const CppDeclaration& decl)
+	{
+		if(decl.dimensions.empty())
+		{
+			strm << "\t" << decl.type << " " << decl.name << " = batch->" << decl.name << "[k];\n";
+		}
+		else
+		{
+			strm << "\t" << decl.type << " " << decl.name << decl.generateArrayDimensions() << ";\n";
+			for(unsigned long i = 0; i < arraySize(decl); i++)
+				strm << "\t" << decl.name << "[" << i << "] = batch->" << decl.name << "[" << i << "][k];\n";
+		}
+	};
+
+	auto store = [&arraySize](std::stringstream& strm, const CppDeclaration& decl)
+	{
+		if(decl.dimensions.empty())
+		{
+			strm << "\tbatch->" << decl.name << "[k] = " << decl.name << ";\n";
+		}
+		else
+		{
+			for(unsigned long i = 0; i < arraySize(decl); i++)
+				strm << "\tbatch->" << decl.name << "[" << i << "][k] = " << decl.name << "[" << i << "];\n";
+		}
+	};
+
+	for(const auto& decls : {outputs, inputs, fields})
+	{
+		for(const auto& decl : decls)
+		{
+			if(decl.dimensions.size() > 1)
+				throw std::runtime_error("SolverEngineGenerator::generateBatchedCCode(): multidimensional array \'" + decl.name + "\' is not supported in batched solvers");
+		}
+	}
+
+		// batch structure; booleans are stored as int, as compilers do not vectorize loops that load
+		// bool arrays alongside real arrays
+
+	auto batchType = [](const CppDeclaration& decl)
+	{
+		return decl.type == "bool" ? std::string("int") : decl.type;
+	};
+
+
+	sstrm
+	<< template_params
+	<< "struct " << model_name << "_batch\n"
+	<< "{\n"
+	<< "\t//MODEL SOLUTIONS OF EACH SCENARIO\n\n"
+	<< "\treal x_out[" << num_solutions << "][N];\n\n";
+
+	if(!outputs.empty())
+	{
+		sstrm << "\t//COMPONENT OUTPUT SIGNALS OF EACH SCENARIO\n\n";
+		for(const auto& decl : outputs)
+			sstrm << "\t" << batchType(decl) << " " << decl.name << decl.generateArrayDimensions() << "[N];\n";
+		sstrm << "\n";
+	}
+
+	if(!inputs.empty())
+	{
+		sstrm << "\t//COMPONENT INPUT SIGNALS OF EACH SCENARIO\n\n";
+		for(const auto& decl : inputs)
+			sstrm << "\t" << batchType(decl) << " " << decl.name << decl.generateArrayDimensions() << "[N];\n";
+		sstrm << "\n";
+	}
+
+	sstrm << "\t//COMPONENT FIELDS AND STATES OF EACH SCENARIO\n\n";
+	for(const auto& decl : fields)
+		sstrm << "\t" << batchType(decl) << " " << decl.name << decl.generateArrayDimensions() << "[N];\n";
+
+	if(parameters.io_source_vector_output_enable)
+		sstrm << "\n\treal b_out[" << num_solutions << "][N];\n";
+
+	if(parameters.io_component_sources_output_enable)
+		sstrm << "\n\treal sources_out[" << num_components << "][N];\n";
+
+	sstrm << "};\n\n";
+
+		// initializer
+
+	sstrm
+	<< template_params
+	<< "void " << model_name << "_batch_init(" << batch_type << "* batch)\n"
+	<< "{\n"
+	<< "\tfor(int k = 0; k < N; k++)\n"
+	<< "\t{\n"
+	<< "\t\tfor(int i = 0; i < " << num_solutions << "; i++) batch->x_out[i][k] = real(0.0);\n";
+
+	for(const auto& decls : {outputs, inputs})
+	{
+		for(const auto& decl : decls)
+		{
+			if(decl.dimensions.empty())
+				sstrm << "\t\tbatch->" << decl.name << "[k] = " << decl.type << "();\n";
+			else
+				sstrm << "\t\tfor(int i = 0; i < " << decl.dimensions[0] << "; i++) batch->" << decl.name << "[i][k] = " << decl.type << "();\n";
+		}
+	}
+
+	for(const auto& decl : fields)
+	{
+		std::vector<std::string> values = decl.getInitializerValues();
+
+		if(decl.dimensions.empty())
+		{
+			sstrm << "\t\tbatch->" << decl.name << "[k] = " << (values.empty() ? decl.type + "()" : values[0]) << ";\n";
+		}
+		else if(values.size() <= 1)
+		{
+			sstrm << "\t\tfor(int i = 0; i < " << decl.dimensions[0] << "; i++) batch->" << decl.name << "[i][k] = "
+			      << (values.empty() ? decl.type + "()" : values[0]) << ";\n";
+		}
+		else
+		{
+			for(unsigned int i = 0; i < values.size(); i++)
+				sstrm << "\t\tbatch->" << decl.name << "[" << i << "][k] = " << values[i] << ";\n";
+		}
+	}
+
+	sstrm
+	<< "\t}\n"
+	<< "}\n\n";
+
+		// solver
+
+	sstrm
+	<< template_params
+	<< "void " << model_name << "_batch_solver(" << batch_type << "* batch)\n"
+	<< "{\n";
+
+	sstrm << "//MODEL PARAMETERS\n\n";
+
+	for(const auto& i : comp_parameters)
+	{
+		sstrm << i << "\n";
+	}
+	sstrm << "\n";
+
+	sstrm << solve_constants_code << "\n\n";
+
+	sstrm
+	<< "#pragma omp simd\n"
+	<< "for(int k = 0; k < N; k++)\n"
+	<< "{\n";
+
+	sstrm << "\t//LOAD COMPONENT FIELDS AND STATES OF SCENARIO k\n\n";
+
+	for(const auto& decl : fields)
+		load(sstrm, decl);
+	sstrm << "\n";
+
+	for(const auto& temp : temporaries)
+		sstrm << "\t" << temp << "\n";
+	sstrm << "\n";
+
+	if(!inputs.empty())
+	{
+		sstrm << "\t//LOAD COMPONENT INPUT SIGNALS OF SCENARIO k\n\n";
+
+		for(const auto& decl : inputs)
+			load(sstrm, decl);
+		sstrm << "\n";
+	}
+
+	if(!outputs.empty())
+	{
+		sstrm << "\t//COMPONENT OUTPUT SIGNALS OF SCENARIO k\n\n";
+
+		for(const auto& decl : outputs)
+		{
+			if(!decl.dimensions.empty())
+				sstrm << "\t" << decl.type << " " << decl.name << decl.generateArrayDimensions() << ";\n";
+			else if(decl.type != batchType(decl))
+				sstrm << "\t" << decl.type << " " << decl.name << "_value = " << decl.type << "();\n"
+				      << "\t" << decl.type << (decl.is_pointer ? "* const " : "& ") << decl.name << " = "
+				      << (decl.is_pointer ? "&" : "") << decl.name << "_value;\n";
+			else if(decl.is_pointer)
+				sstrm << "\t" << decl.type << "* const " << decl.name << " = &batch->" << decl.name << "[k];\n";
+			else
+				sstrm << "\t" << decl.type << "& " << decl.name << " = batch->" << decl.name << "[k];\n";
+		}
+		sstrm << "\n";
+	}
+
+	sstrm
+	<< "\t//MODEL SOLUTIONS OF SCENARIO k\n\n"
+	<< "\treal b[" << num_solutions << "];\n"
+	<< "\treal x[" << num_solutions+1 << "];\n"
+	<< "\treal b_components[" << num_components << "];\n\n"
+	<< "\tx[0] = real(0.0);\n";
+
+	const std::vector<bool> demanded = findDemandedSolutions();
+	const std::vector<unsigned int> node_solutions = findNetlistNodeSolutions();
+
+	for(unsigned int i = 0; i < num_solutions; i++)
+	{
+		if(demanded[node_solutions[i]-1])
+			sstrm << "\tx[" << node_solutions[i] << "] = batch->x_out[" << i << "][k];\n";
+	}
+	sstrm << "\n";
+
+	sstrm << generateUpdateAndSolveCode(aggregation_code, solve_code, source_fold_codes);
+
+	sstrm << "\t//STORE SOLUTIONS, SIGNALS, FIELDS AND STATES OF SCENARIO k\n\n";
+
+	for(unsigned int i = 0; i < num_solutions; i++)
+	{
+		if(demanded[node_solutions[i]-1])
+			sstrm << "\tbatch->x_out[" << i << "][k] = x[" << node_solutions[i] << "];\n";
+	}
+
+	for(const auto& decl : outputs)
+	{
+		if(!decl.dimensions.empty())
+			store(sstrm, decl);
+		else if(decl.type != batchType(decl))
+			sstrm << "\tbatch->" << decl.name << "[k] = " << decl.name << "_value;\n";
+	}
+
+	for(const auto& decl : fields)
+		store(sstrm, decl);
+
+	if(parameters.io_source_vector_output_enable)
+	{
+		for(unsigned int i = 0; i < num_solutions; i++)
+			sstrm << "\tbatch->b_out[" << i << "][k] = b[" << node_solutions[i]-1 << "];\n";
+	}
+
+	if(parameters.io_component_sources_output_enable)
+	{
+		for(unsigned int i = 0; i < num_components; i++)
+			sstrm << "\tbatch->sources_out[" << i << "][k] = b_components[" << i << "];\n";
+	}
+
+	sstrm
+	<< "}\n"
+	<< "\n}";
 
 	return sstrm.str();
 }
 
-std::string SolverEngineGenerator::generateCFunction(double zero_bound) const
+void SolverEngineGenerator::generateBatchedCCodeAndExport(std::string filename, double zero_bound) const
+{
+	if(filename == "")
+		throw std::invalid_argument("SolverEngineGenerator::generateBatchedCCodeAndExport(): filename cannot be null or empty");
+
+	std::fstream file;
+
+	try
+	{
+		file.open(filename.c_str(), std::fstream::out | std::fstream::trunc);
+	}
+	catch(...)
+	{
+		throw std::runtime_error("SolverEngineGenerator::generateBatchedCCodeAndExport(): failed to open or create source files");
+	}
+
+	file <<
+			"/**\n"
+			" *\n"
+			" * LBLMC Batched Simulation Engine for CPU Designs\n"
+			" *\n"
+			" * Auto-generated by SimulationEngineGenerator Object\n"
+			" *\n"
+			" */\n\n";
+
+	file << "#ifndef " << model_name << "_BATCHSOLVER_HPP" << "\n";
+	file << "#define " << model_name << "_BATCHSOLVER_HPP" << "\n";
+
+	file << "\n\n";
+
+	file << generateRealTypeDefinition();
+
+	file << generateBatchedCCode(zero_bound) << "\n\n";
+
+	file << "\n#endif";
+
+	file.close();
+}
+
+std::string SolverEngineGenerator::generateReentrantCCode(double zero_bound) const
 {
 	std::stringstream sstrm;
 
-	if(parameters.codegen_solver_templated_function_enable == true)
+	const unsigned int num_components = source_vector_gen.getNumSources();
+	const bool templated_real = parameters.codegen_solver_templated_function_enable &&
+	                            parameters.codegen_solver_templated_real_type_enable;
+
+	const std::string template_params = templated_real ? "template< typename real >\n" : "inline\n";
+	const std::string state_type = model_name + "_state" + (templated_real ? "<real>" : "");
+
+	std::string solve_constants_code;
+	std::string aggregation_code;
+	std::string solve_code;
+	std::vector<std::string> source_fold_codes;
+	generateSolveCode(solve_constants_code, aggregation_code, solve_code, source_fold_codes, zero_bound);
+
+	std::vector<CppDeclaration> fields;
+	std::vector<std::string> temporaries;
+
+	parseComponentFields(fields, temporaries);
+
+		// state structure
+
+	if(templated_real)
+		sstrm << "template< typename real >\n";
+
+	sstrm
+	<< "struct " << model_name << "_state\n"
+	<< "{\n"
+	<< "\t//MODEL SOLUTIONS\n\n"
+	<< "\treal x[" << num_solutions+1 << "];\n\n"
+	<< "\t//COMPONENT FIELDS AND STATES\n\n";
+
+	for(const auto& decl : fields)
+		sstrm << "\t" << decl.type << " " << decl.name << decl.generateArrayDimensions() << ";\n";
+
+	sstrm << "};\n\n";
+
+		// initializer
+
+	sstrm
+	<< template_params
+	<< "void " << model_name << "_init(" << state_type << "* state)\n"
+	<< "{\n"
+	<< "\tfor(int i = 0; i < " << num_solutions+1 << "; i++) state->x[i] = real(0.0);\n";
+
+	for(const auto& decl : fields)
 	{
-        sstrm
-        << "template< int instance";
+		std::vector<std::string> values = decl.getInitializerValues();
 
-        if(parameters.codegen_solver_templated_real_type_enable == true)
+		if(decl.dimensions.empty())
 		{
-			sstrm
-			<< ", typename real";
+			sstrm << "\tstate->" << decl.name << " = " << (values.empty() ? decl.type + "()" : values[0]) << ";\n";
+		}
+		else if(decl.dimensions.size() > 1)
+		{
+			throw std::runtime_error("SolverEngineGenerator::generateReentrantCCode(): multidimensional array \'" + decl.name + "\' is not supported in reentrant solvers");
+		}
+		else if(values.size() <= 1)
+		{
+			sstrm << "\tfor(int i = 0; i < " << decl.dimensions[0] << "; i++) state->" << decl.name << "[i] = "
+			      << (values.empty() ? decl.type + "()" : values[0]) << ";\n";
+		}
+		else
+		{
+			for(unsigned int i = 0; i < values.size(); i++)
+				sstrm << "\tstate->" << decl.name << "[" << i << "] = " << values[i] << ";\n";
 		}
-
-		sstrm
-		<< " >\n";
 	}
 
-	sstrm
-	<< "void "<<model_name<<"_solver\n"
-	<< "(\n";
+	sstrm << "}\n\n";
+
+		// solver; the fields and solutions of the state are bound to references of the same names,
+		// so the component code is emitted unchanged
 
 	sstrm
+	<< template_params
+	<< "void " << model_name << "_step\n"
+	<< "(\n"
+	<< state_type << "* state,\n"
 	<< generateCFunctionParameterList()
 	<< "\n)\n"
 	<< "{\n";
 
-	std::string buf;
-	buf = generateCInlineCode(zero_bound);
-	sstrm << buf;
+	sstrm << "//MODEL PARAMETERS\n\n";
 
-	if(parameters.io_source_vector_output_enable == true)
+	for(const auto& i : comp_parameters)
 	{
-		for(unsigned int i = 0; i < num_solutions; i++)
-		{
-			sstrm << "b_out["<<i<<"] = b["<<i<<"];\n";
-		}
+		sstrm << i << "\n";
+	}
+	sstrm << "\n";
+
+	sstrm << "//COMPONENT FIELDS AND STATES\n\n";
+
+	for(const auto& decl : fields)
+	{
+		if(decl.dimensions.empty())
+			sstrm << decl.type << "& " << decl.name << " = state->" << decl.name << ";\n";
+		else
+			sstrm << decl.type << " (&" << decl.name << ")" << decl.generateArrayDimensions() << " = state->" << decl.name << ";\n";
 	}
 
+	for(const auto& temp : temporaries)
+		sstrm << temp << "\n";
 	sstrm << "\n";
 
-	if(parameters.io_component_sources_output_enable == true)
+	sstrm << "//MODEL SOLUTIONS\n\n";
+
+	sstrm
+	<< "real b["<<num_solutions<<"];\n"
+	<< "real (&x)["<<num_solutions+1<<"] = state->x;\n"
+	<< "real b_components["<<num_components<<"];\n\n";
+
+	sstrm << solve_constants_code << "\n\n";
+
+	sstrm << generateUpdateAndSolveCode(aggregation_code, solve_code, source_fold_codes);
+
+	const std::vector<unsigned int> node_solutions = findNetlistNodeSolutions();
+
+	if(parameters.io_source_vector_output_enable)
 	{
-		for(unsigned int i = 0; i < source_vector_gen.getNumSources(); i++)
-		{
+		for(unsigned int i = 0; i < num_solutions; i++)
+			sstrm << "b_out["<<i<<"] = b["<<node_solutions[i]-1<<"];\n";
+		sstrm << "\n";
+	}
+
+	if(parameters.io_component_sources_output_enable)
+	{
+		for(unsigned int i = 0; i < num_components; i++)
 			sstrm << "sources_out["<<i<<"] = b_components["<<i<<"];\n";
-		}
+		sstrm << "\n";
 	}
 
-	sstrm << "\n";
+	const std::vector<bool> demanded = findDemandedSolutions();
 
 	for(unsigned int i = 0; i < num_solutions; i++)
 	{
-		sstrm << "x_out["<<i<<"] = x["<<i+1<<"];\n";
+		if(demanded[node_solutions[i]-1])
+			sstrm << "x_out["<<i<<"] = x["<<node_solutions[i]<<"];\n";
 	}
 
 	sstrm
@@ -361,76 +2240,358 @@ std::string SolverEngineGenerator::generateCFunction(double zero_bound) const
 	return sstrm.str();
 }
 
-void SolverEngineGenerator::generateCFunctionAndExport(std::string filename, double zero_bound) const
+void SolverEngineGenerator::generateReentrantCCodeAndExport(std::string filename, double zero_bound) const
 {
 	if(filename == "")
-		throw std::invalid_argument("SimulationEngineGenerator::generateCFunctionAndExport(): filename cannot be null or empty");
+		throw std::invalid_argument("SolverEngineGenerator::generateReentrantCCodeAndExport(): filename cannot be null or empty");
 
 	std::fstream file;
 
-	std::string fname = filename;
-
 	try
 	{
-		file.open(fname.c_str(), std::fstream::out | std::fstream::trunc);
+		file.open(filename.c_str(), std::fstream::out | std::fstream::trunc);
 	}
 	catch(...)
 	{
-		throw std::runtime_error("SimulationEngineGenerator::generateCFunctionAndExport(): failed to open or create source files");
+		throw std::runtime_error("SolverEngineGenerator::generateReentrantCCodeAndExport(): failed to open or create source files");
 	}
 
 	file <<
 			"/**\n"
 			" *\n"
-			" * LBLMC Vivado HLS Simulation Engine for FPGA Designs\n"
+			" * LBLMC Reentrant Simulation Engine for CPU Designs\n"
 			" *\n"
 			" * Auto-generated by SimulationEngineGenerator Object\n"
 			" *\n"
 			" */\n\n";
 
-	file << "#ifndef " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
-	file << "#define " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
+	file << "#ifndef " << model_name << "_REENTRANTSOLVER_HPP" << "\n";
+	file << "#define " << model_name << "_REENTRANTSOLVER_HPP" << "\n";
 
 	file << "\n\n";
 
-	if( !( parameters.codegen_solver_templated_real_type_enable == true &&
-		parameters.codegen_solver_templated_function_enable == true ) )
+	file << generateRealTypeDefinition();
+
+	file << generateReentrantCCode(zero_bound) << "\n\n";
+
+	file << "\n#endif";
+
+	file.close();
+}
+
+std::string SolverEngineGenerator::generateBenchmarkDriver(std::string solver_filename, const std::vector<InputWaveform>& waveforms,
+                                                           unsigned long num_steps, double time_step,
+                                                           std::string reference_model_name, double reference_tolerance,
+                                                           unsigned int reference_delay) const
+{
+	if(solver_filename == "")
+		throw std::invalid_argument("SolverEngineGenerator::generateBenchmarkDriver(): solver filename cannot be null or empty");
+
+	const bool reference_enable = (reference_model_name != "");
+
+	if(reference_enable && !parameters.codegen_solver_templated_function_enable)
+		throw std::invalid_argument("SolverEngineGenerator::generateBenchmarkDriver(): comparison with a reference solver requires templated solver functions");
+
+	std::stringstream sstrm;
+
+	const bool templated_real = parameters.codegen_solver_templated_function_enable &&
+	                            parameters.codegen_solver_templated_real_type_enable;
+
+	std::vector<CppDeclaration> outputs;
+	std::vector<CppDeclaration> inputs;
+
+	if(parameters.io_signal_output_enable)
 	{
-		if(parameters.fixed_point_enable)
+		for(const auto& code : comp_outputs)
 		{
-			if(parameters.xilinx_hls_enable)
-			{
-				file <<
-				"#include <ap_fixed.h>\n" <<
-				"typedef ap_fixed<"<<parameters.fixed_point_word_width<<", "<<
-				parameters.fixed_point_int_width<<", AP_RND> real;\n\n";
+			for(const auto& decl : CppDeclaration::parseAll(code, ','))
+				outputs.push_back(decl);
+		}
+	}
 
-			}
-			else
-			{
-				file << "//platform-agnostic fixed point not supported yet. Using double real values\n"<<
-				"typedef double real;\n\n";
-			}
+	for(const auto& code : comp_inputs)
+	{
+		for(const auto& decl : CppDeclaration::parseAll(code, ','))
+			inputs.push_back(decl);
+	}
+
+		// check waveforms refer to existing inputs
+
+	for(const auto& wave : waveforms)
+	{
+		auto input = std::find_if(inputs.begin(), inputs.end(), [&wave](const CppDeclaration& decl) { return decl.name == wave.name; });
+
+		if(input == inputs.end())
+			throw std::invalid_argument("SolverEngineGenerator::generateBenchmarkDriver(): solver has no input named \'" + wave.name + "\'");
+
+		if(input->dimensions.size() > 1)
+			throw std::invalid_argument("SolverEngineGenerator::generateBenchmarkDriver(): multidimensional input \'" + wave.name + "\' cannot be driven by waveforms");
+
+		if(wave.index >= 0 && (input->dimensions.empty() || (unsigned long)(wave.index) >= std::stoul(input->dimensions[0])))
+			throw std::invalid_argument("SolverEngineGenerator::generateBenchmarkDriver(): element index of input \'" + wave.name + "\' out of bounds");
+	}
+
+	sstrm <<
+			"/**\n"
+			" *\n"
+			" * LBLMC Benchmark Driver of Simulation Engine\n"
+			" *\n"
+			" * Auto-generated by SimulationEngineGenerator Object\n"
+			" *\n"
+			" */\n\n";
+
+	sstrm
+	<< "#include <cstdio>\n"
+	<< "#include <cstdlib>\n"
+	<< "#include <cmath>\n"
+	<< "#include <chrono>\n\n"
+	<< "#include \"runtime/PerfCounters.hpp\"\n\n";
+
+	if(templated_real)
+		sstrm << "typedef double real;\n\n";
+
+	sstrm << "#include \"" << solver_filename << "\"\n";
+
+	if(reference_enable)
+		sstrm << "#include \"" << reference_model_name << ".hpp\"\n";
+
+	sstrm << "\n";
+
+		// signals of the solver; with a reference, the outputs of the compared instance and the reference have their own copies
+
+	std::vector<std::string> output_sets = {""};
+
+	if(reference_enable)
+	{
+		output_sets.push_back("_check");
+		output_sets.push_back("_ref");
+	}
+
+	for(const auto& suffix : output_sets)
+	{
+		sstrm << "static real x_out" << suffix << "[" << num_solutions << "];\n";
+
+		for(const auto& decl : outputs)
+			sstrm << "static " << decl.type << " " << decl.name << suffix << decl.generateArrayDimensions() << ";\n";
+
+		if(parameters.io_source_vector_output_enable)
+			sstrm << "static real b_out" << suffix << "[" << num_solutions << "];\n";
+
+		if(parameters.io_component_sources_output_enable)
+			sstrm << "static real sources_out" << suffix << "[" << source_vector_gen.getNumSources() << "];\n";
+	}
+
+	for(const auto& decl : inputs)
+		sstrm << "static " << decl.type << " " << decl.name << decl.generateArrayDimensions() << ";\n";
+
+	sstrm << "\n";
+
+		// elements of x_out assigned by the solver; a demand-driven solver leaves the others unassigned,
+		// so only these are checksummed and compared with the reference
+
+	const std::vector<bool> demanded = findDemandedSolutions();
+	const std::vector<unsigned int> node_solutions = findNetlistNodeSolutions();
+
+	std::vector<unsigned int> assigned_outputs;
+
+	for(unsigned int i = 0; i < num_solutions; i++)
+	{
+		if(demanded[node_solutions[i]-1])
+			assigned_outputs.push_back(i);
+	}
+
+	sstrm << "static const int x_out_assigned[" << std::max<std::size_t>(assigned_outputs.size(), 1) << "] = {";
+
+	for(std::size_t j = 0; j < assigned_outputs.size(); j++)
+		sstrm << (j ? ", " : "") << assigned_outputs[j];
+
+	if(assigned_outputs.empty())
+		sstrm << "0";
+
+	sstrm
+	<< "};\n"
+	<< "static const int num_x_out_assigned = " << assigned_outputs.size() << ";\n\n";
+
+	auto generateCall = [&](const std::string& solver_name, int instance, const std::string& suffix)
+	{
+		std::stringstream call;
+
+		call << "\t" << solver_name << "_solver";
+
+		if(parameters.codegen_solver_templated_function_enable)
+			call << "<" << instance << (templated_real ? ", real>" : ">");
+
+		call << "(x_out" << suffix;
+
+		for(const auto& decl : outputs)
+			call << ", " << ((decl.is_pointer && decl.dimensions.empty()) ? "&" : "") << decl.name << suffix;
+
+		for(const auto& decl : inputs)
+			call << ", " << decl.name;
+
+		if(parameters.io_source_vector_output_enable)
+			call << ", b_out" << suffix;
+
+		if(parameters.io_component_sources_output_enable)
+			call << ", sources_out" << suffix;
+
+		call << ");\n";
+
+		return call.str();
+	};
+
+		// waveforms of the inputs at time step k
+
+	sstrm
+	<< "static void drive(unsigned long k)\n"
+	<< "{\n"
+	<< "\tconst double t = double(k)*" << std::setprecision(17) << time_step << ";\n"
+	<< "\t(void)t;\n\n";
+
+	for(const auto& wave : waveforms)
+	{
+		auto input = std::find_if(inputs.begin(), inputs.end(), [&wave](const CppDeclaration& decl) { return decl.name == wave.name; });
+		const bool is_bool = (input->type == "bool");
+		const std::string value = wave.generateCExpression("t", is_bool);
+
+		if(input->dimensions.empty())
+			sstrm << "\t" << wave.name << " = " << value << ";\n";
+		else if(wave.index >= 0)
+			sstrm << "\t" << wave.name << "[" << wave.index << "] = " << value << ";\n";
+		else
+			sstrm << "\tfor(int i = 0; i < " << input->dimensions[0] << "; i++) " << wave.name << "[i] = " << value << ";\n";
+	}
+
+	sstrm << "}\n\n";
+
+		// time step of the solver
+
+	sstrm
+	<< "static void step(unsigned long k)\n"
+	<< "{\n"
+	<< "\tdrive(k);\n"
+	<< generateCall(model_name, 0, "")
+	<< "}\n\n";
+
+		// time step of another instance of the solver and of the reference, outside of the measurement; the
+		// reference lags reference_delay steps behind so the solutions of both are of the same time step
+
+	if(reference_enable)
+	{
+		sstrm
+		<< "static void check_step(unsigned long k)\n"
+		<< "{\n"
+		<< "\tdrive(k);\n"
+		<< generateCall(model_name, 1, "_check");
+
+		if(reference_delay == 0)
+		{
+			sstrm << generateCall(reference_model_name, 0, "_ref");
 		}
 		else
 		{
-			file << "typedef double real;\n\n";
+			sstrm
+			<< "\n\tif(k < " << reference_delay << "UL) return;\n\n"
+			<< "\tdrive(k-" << reference_delay << "UL);\n"
+			<< generateCall(reference_model_name, 0, "_ref");
 		}
+
+		sstrm << "}\n\n";
 	}
 
-	if(parameters.codegen_solver_templated_function_enable == false)
+		// measurement
+
+	sstrm
+	<< "int main(int argc, char* argv[])\n"
+	<< "{\n"
+	<< "\tconst unsigned long num_steps = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : " << num_steps << "UL;\n"
+	<< "\tconst unsigned long num_warmup_steps = num_steps/10;\n\n"
+	<< "\tif(num_steps == 0)\n"
+	<< "\t{\n"
+	<< "\t\tstd::fprintf(stderr, \"number of steps must be positive\\n\");\n"
+	<< "\t\treturn 1;\n"
+	<< "\t}\n\n"
+	<< "\tfor(unsigned long k = 0; k < num_warmup_steps; k++)\n"
+	<< "\t\tstep(k);\n\n"
+	<< "\tlblmc::PerfCounters counters;\n\n"
+	<< "\tconst auto t0 = std::chrono::steady_clock::now();\n"
+	<< "\tcounters.start();\n\n"
+	<< "\tfor(unsigned long k = num_warmup_steps; k < num_warmup_steps+num_steps; k++)\n"
+	<< "\t\tstep(k);\n\n"
+	<< "\tcounters.stop();\n"
+	<< "\tconst auto t1 = std::chrono::steady_clock::now();\n\n"
+	<< "\tdouble checksum = 0.0;\n"
+	<< "\tfor(int j = 0; j < num_x_out_assigned; j++)\n"
+	<< "\t\tchecksum += double(x_out[x_out_assigned[j]])*(1.0 + 1.0e-3*x_out_assigned[j]);\n\n"
+	<< "\tstd::printf(\"model " << model_name << "\\n\");\n"
+	<< "\tstd::printf(\"nodes " << num_solutions << "\\n\");\n"
+	<< "\tstd::printf(\"steps %lu\\n\", num_steps);\n"
+	<< "\tstd::printf(\"ns/step %.3f\\n\", std::chrono::duration<double, std::nano>(t1-t0).count()/double(num_steps));\n\n"
+	<< "\tfor(int e = 0; e < lblmc::PerfCounters::NUM_EVENTS; e++)\n"
+	<< "\t{\n"
+	<< "\t\tconst lblmc::PerfCounters::Event event = lblmc::PerfCounters::Event(e);\n"
+	<< "\t\tconst long long count = counters.read(event);\n\n"
+	<< "\t\tif(count >= 0)\n"
+	<< "\t\t\tstd::printf(\"%s/step %.3f\\n\", lblmc::PerfCounters::getEventName(event), double(count)/double(num_steps));\n"
+	<< "\t\telse\n"
+	<< "\t\t\tstd::printf(\"%s/step unavailable\\n\", lblmc::PerfCounters::getEventName(event));\n"
+	<< "\t}\n\n"
+	<< "\tstd::printf(\"checksum %.12e\\n\", checksum);\n\n";
+
+	if(reference_enable)
 	{
-		file << "inline\n";
+		sstrm
+		<< "\tdouble deviation = 0.0;\n"
+		<< "\tdouble magnitude = 0.0;\n\n"
+		<< "\tfor(unsigned long k = 0; k < num_warmup_steps+num_steps; k++)\n"
+		<< "\t{\n"
+		<< "\t\tcheck_step(k);\n\n"
+		<< "\t\tif(k < " << reference_delay << "UL) continue;\n\n"
+		<< "\t\tfor(int j = 0; j < num_x_out_assigned; j++)\n"
+		<< "\t\t{\n"
+		<< "\t\t\tconst int i = x_out_assigned[j];\n"
+		<< "\t\t\tconst double d = std::fabs(double(x_out_check[i]) - double(x_out_ref[i]));\n"
+		<< "\t\t\tif(d > deviation || d != d) deviation = d; // NaN solutions fail the check\n"
+		<< "\t\t\tmagnitude = std::fmax(magnitude, std::fabs(double(x_out_ref[i])));\n"
+		<< "\t\t}\n"
+		<< "\t}\n\n"
+		<< "\tstd::printf(\"reference deviation %.6e of max |x| %.6e\\n\", deviation, magnitude);\n\n"
+		<< "\tif( !(deviation <= " << std::setprecision(17) << reference_tolerance << "*(1.0 + magnitude)) )\n"
+		<< "\t{\n"
+		<< "\t\tstd::fprintf(stderr, \"solutions deviate from reference " << reference_model_name << "\\n\");\n"
+		<< "\t\treturn 2;\n"
+		<< "\t}\n\n";
 	}
 
-    std::string buf;
-    buf = generateCFunction(zero_bound);
-    file << buf << "\n\n";
+	sstrm
+	<< "\treturn 0;\n"
+	<< "}\n";
 
-	file << "\n#endif";
+	return sstrm.str();
+}
 
-	file.close();
+void SolverEngineGenerator::generateBenchmarkDriverAndExport(std::string filename, std::string solver_filename, const std::vector<InputWaveform>& waveforms,
+                                                             unsigned long num_steps, double time_step,
+                                                             std::string reference_model_name, double reference_tolerance,
+                                                             unsigned int reference_delay) const
+{
+	if(filename == "")
+		throw std::invalid_argument("SolverEngineGenerator::generateBenchmarkDriverAndExport(): filename cannot be null or empty");
+
+	std::fstream file;
+
+	try
+	{
+		file.open(filename.c_str(), std::fstream::out | std::fstream::trunc);
+	}
+	catch(...)
+	{
+		throw std::runtime_error("SolverEngineGenerator::generateBenchmarkDriverAndExport(): failed to open or create source files");
+	}
 
+	file << generateBenchmarkDriver(solver_filename, waveforms, num_steps, time_step, reference_model_name, reference_tolerance, reference_delay);
+
+	file.close();
 }
 
 } //namespace lblmc
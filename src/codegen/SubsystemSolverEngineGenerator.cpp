@@ -48,7 +48,8 @@ SubsystemSolverEngineGenerator::SubsystemSolverEngineGenerator
 	SolverEngineGenerator(model_name, num_solutions),
 	ports(),
 	source_gains(),
-	port_source_ids()
+	port_source_ids(),
+	port_couplings()
 {
 	if(model_name == "")
 		throw std::runtime_error("SubsystemSimulationEngineGenerator::constructor(): model_name cannot be null or empty");
@@ -61,7 +62,8 @@ SubsystemSolverEngineGenerator::SubsystemSolverEngineGenerator(const SubsystemSo
 	SolverEngineGenerator(base),
 	ports(base.ports),
 	source_gains(base.source_gains),
-	port_source_ids(base.port_source_ids)
+	port_source_ids(base.port_source_ids),
+	port_couplings(base.port_couplings)
 {}
 
 void SubsystemSolverEngineGenerator::reset(std::string model_name, unsigned int num_solutions)
@@ -80,11 +82,16 @@ void SubsystemSolverEngineGenerator::reset(std::string model_name, unsigned int
 	this->comp_outputs.clear();
 	this->comp_outputs_update_bodies.clear();
 	this->comp_update_bodies.clear();
-	this->conductance_matrix_gen = SystemConductanceGenerator(num_solutions);
+	this->comp_update_rate_divisors.clear();
+	this->comp_update_rate_phases.clear();
+	this->conductance_matrix_gen = SystemConductanceGenerator(num_solutions, true);
 	this->source_vector_gen = SystemSourceVectorGenerator(num_solutions);
 	this->ports.clear();
 	this->source_gains.clear();
 	this->port_source_ids.clear();
+	this->port_couplings.clear();
+	this->inverse_source = SparseMatrixRMXd();
+	this->inverse_cache.reset();
 }
 
 void SubsystemSolverEngineGenerator::addPort(const Port& port)
@@ -137,6 +144,19 @@ const SubsystemSolverEngineGenerator::Port& SubsystemSolverEngineGenerator::getP
 	throw std::out_of_range("SubsystemSimulationEngineGenerator::getPort(id) -- port does not exist for given id");
 }
 
+bool SubsystemSolverEngineGenerator::hasPort(unsigned int id) const
+{
+	for(const auto& p : ports)
+	{
+		if(p.id == id)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 std::vector<SubsystemSolverEngineGenerator::PortModel> SubsystemSolverEngineGenerator::computePortModels() const
 {
 	if(ports.empty())
@@ -201,25 +221,32 @@ std::vector<SubsystemSolverEngineGenerator::PortModel> SubsystemSolverEngineGene
 	VectorRMXd bprobe = vzeroed;
 	VectorRMXd xprobe = vzeroed;
 
+		//factorize gprobe once with partial pivot LU for all the probe solves below
+
+	const Eigen::PartialPivLU<MatrixRMXd> gprobe_lu(gprobe);
+
 		//compute conductances and transconductances
 
 	for(unsigned int i = 0; i < num_ports; i++) // iterate probes
 	{
 		bprobe(dimension+i) = 1.0;
 
-		xprobe = gprobe.fullPivLu().solve(bprobe); // x = G\b with full pivot LU factorization
+		xprobe = gprobe_lu.solve(bprobe); // x = G\b
 
 		for(unsigned int j = 0; j < num_ports; j++) // iterate port models
 		{
 			auto& mdl = port_models[j];
 
+			// the probe currents are those drawn from the ports, so the current at port j due to the
+			// voltage at port i is -xprobe(dimension+j)
+
 			if(mdl.id == ports[i].id)
 			{
 				mdl.conductance = xprobe(dimension+i);
 			}
 			else
 			{
-                mdl.transconductances[i] = xprobe(dimension+i);
+                mdl.transconductances[ports[i].id] = -xprobe(dimension+j);
 			}
 
 		}
@@ -241,24 +268,19 @@ std::vector<SubsystemSolverEngineGenerator::PortModel> SubsystemSolverEngineGene
 
 			const auto& source_nodes = source_vector_gen.getSourceNodesById(s+1);
 
+				// same signs as the source vector aggregation: + at the positive and - at the negative node
+
 			if(source_nodes[0] != 0)
 			{
 				bprobe(source_nodes[0]-1) += 1.0;
-
-				if(source_nodes[1] != 0)
-				{
-					bprobe(source_nodes[1]-1) += -1.0;
-				}
 			}
-			else
+
+			if(source_nodes[1] != 0)
 			{
-				if(source_nodes[1] != 0)
-				{
-					bprobe(source_nodes[1]-1) += 1.0;
-				}
+				bprobe(source_nodes[1]-1) += -1.0;
 			}
 
-			xprobe = gprobe.fullPivLu().solve(bprobe); // x = G\b with full pivot LU factorization
+			xprobe = gprobe_lu.solve(bprobe); // x = G\b
 			mdl.source_gains[s] = xprobe(dimension+i);
 
 			bprobe = vzeroed;
@@ -284,6 +306,9 @@ void SubsystemSolverEngineGenerator::stampOthersPortModel(const PortModel& port_
 
             for(const auto& xconduct_pair : port_model.transconductances)
 			{
+				if( !hasPort(xconduct_pair.first) )
+					continue; // coupling from a port this subsystem does not share is not representable here
+
                 const auto& other_port = getPort( xconduct_pair.first );
                 conductance_matrix_gen.stampTransconductance
                 (
@@ -340,6 +365,14 @@ void SubsystemSolverEngineGenerator::addOwnSourceGains(const std::vector<PortMod
 	}
 }
 
+void SubsystemSolverEngineGenerator::addOwnPortCoupling(unsigned int port_id, unsigned int other_port_id, double transconductance)
+{
+	if( !hasPort(port_id) || !hasPort(other_port_id) )
+		throw std::invalid_argument("SubsystemSimulationEngineGenerator::addOwnPortCoupling() -- given port ids do not correspond to ports of this subsystem");
+
+	port_couplings[port_id][other_port_id] = transconductance;
+}
+
 std::string SubsystemSolverEngineGenerator::generatePortSourceEquation(unsigned int port_id) const
 {
 	std::stringstream sstrm;
@@ -368,6 +401,25 @@ std::string SubsystemSolverEngineGenerator::generatePortSourceEquation(unsigned
             "b_components["<<(gain_pair_iter->first)<<"]*real("<<(gain_pair_iter->second)<<")";
 		}
 
+			// couplings the receiving subsystem cannot stamp, drawing current T*v of the other port
+
+		auto couplings_iter = port_couplings.find(port_id);
+
+		if(couplings_iter != port_couplings.end())
+		{
+			for(const auto& coupling_pair : couplings_iter->second)
+			{
+				const auto& other_port = getPort(coupling_pair.first);
+
+				sstrm << " + " << "(x["<<other_port.p<<"]";
+
+				if(other_port.n != 0)
+					sstrm << " - x["<<other_port.n<<"]";
+
+				sstrm << ")*real("<<(-coupling_pair.second)<<")";
+			}
+		}
+
 		sstrm << ";\n\n";
 
 		return sstrm.str();
@@ -514,33 +566,73 @@ std::string SubsystemSolverEngineGenerator::generateCInlineCode(double zero_boun
 {
 	std::stringstream sstrm;
 
-	SystemConductanceGenerator invg_gen(conductance_matrix_gen);
-	invg_gen.invertSelf();
-	const double * invg = invg_gen.asArray();
-
 	unsigned int num_components = source_vector_gen.getNumSources();
 
-	SystemSolverGenerator solver_gen(invg, num_solutions, num_components, zero_bound);
+	std::string solve_constants_code;
+	std::string aggregation_code = source_vector_gen.asCInlineCode();
+	std::string solve_code;
 
-	std::string buf;
+	if(parameters.conduct_matrix_factorization_enable)
+	{
+		SystemFactorizedSolverGenerator factor_gen(conductance_matrix_gen, zero_bound);
 
-	//codegen xilinx HLS features
-	if(parameters.xilinx_hls_enable)
+		solve_constants_code = "//FACTORIZED CONDUCTANCE MATRIX P*G*Q = L*D*U\n\n" + factor_gen.generateCFactorsLiteral("lu");
+		solve_code = factor_gen.generateCInlineCode("lu");
+	}
+	else
 	{
-		sstrm << "//clock period=" << parameters.xilinx_hls_clock_period << "\n";
+		SystemConductanceGenerator invg_gen(getInverseConductanceGenerator());
+		const double * invg = invg_gen.asArray();
+
+		SystemSolverGenerator solver_gen(invg, num_solutions, num_components, zero_bound);
+		solver_gen.setAdderTree(parameters.inv_conduct_matrix_tree_fan_in,
+		                        parameters.xilinx_hls_enable && parameters.xilinx_hls_tree_register_enable);
 
-		if(parameters.xilinx_hls_inline)
+		if(parameters.inv_conduct_matrix_simd_enable)
 		{
-			sstrm << "#pragma HLS inline\n";
+			if(parameters.fixed_point_enable)
+				throw std::runtime_error("SubsystemSolverEngineGenerator::generateCInlineCode(): SIMD solve of inverted conductance matrix needs floating point real type");
+
+			solve_constants_code = "//INVERTED CONDUCTANCE MATRIX G^-1 IN SIMD VECTORS OF ROWS\n\n" +
+			                       solver_gen.generateCSimdLiteral(parameters.inv_conduct_matrix_simd_width, "inv_g_simd");
+			solver_gen.generateCInlineCodeSimd(solve_code, parameters.inv_conduct_matrix_simd_width, "inv_g_simd");
 		}
+		else if(parameters.fixed_point_enable)
+		{
+			SystemFixedPointSolverGenerator fixed_gen = createFixedPointSolverGenerator(invg, zero_bound);
 
-		if(parameters.xilinx_hls_latency_enable)
+			solve_constants_code = "//FIXED POINT FORMATS OF INVERTED CONDUCTANCE MATRIX G^-1 SOLVE\n\n" + fixed_gen.generateCTypesLiteral("inv_g");
+			solve_code = fixed_gen.generateCInlineCode("inv_g");
+		}
+		else if(parameters.inv_conduct_matrix_fused_enable)
 		{
-			sstrm << "#pragma HLS latency min="<<parameters.xilinx_hls_latency_min<<
-			         " max="<<parameters.xilinx_hls_latency_max<<"\n";
+			SystemFusedSolverGenerator fused_gen(invg, num_solutions, source_vector_gen, zero_bound);
+
+			solve_constants_code = "//FUSED SOURCE OPERATOR G^-1*S OF FUSED ROWS\n\n" + fused_gen.generateCFusedLiteral("inv_g_s");
+
+			if(fused_gen.getNumberOfFusedRows() != num_solutions)
+				solve_constants_code += "\n//INVERTED CONDUCTANCE MATRIX G^-1\n\n" + invg_gen.asCLiteral("inv_g");
+
+			if(!parameters.io_source_vector_output_enable)
+				aggregation_code = source_vector_gen.asCInlineCode(fused_gen.getUsedSourceVectorElements());
+
+			solve_code = fused_gen.generateCInlineCode("inv_g", "inv_g_s");
 		}
+		else
+		{
+			solve_constants_code = "//INVERTED CONDUCTANCE MATRIX G^-1\n\n" + invg_gen.asCLiteral("inv_g");
 
-		sstrm << "\n";
+			if(parameters.inv_conduct_matrix_block_sparse_enable)
+				solver_gen.generateCInlineCodeBlockSparse(solve_code, "inv_g");
+			else
+				solver_gen.generateCInlineCode(solve_code, "inv_g");
+		}
+	}
+
+	//codegen xilinx HLS features
+	if(parameters.xilinx_hls_enable)
+	{
+		sstrm << generateHlsFunctionDirectives();
 	}
 
 	sstrm << "//MODEL PARAMETERS\n\n";
@@ -557,19 +649,26 @@ std::string SubsystemSolverEngineGenerator::generateCInlineCode(double zero_boun
 	{
 		sstrm << i << "\n";
 	}
+	sstrm << generateMultirateFieldsCode();
 	sstrm << "\n";
 
 	sstrm << "//MODEL SOLUTIONS\n\n";
 
-	sstrm
+	std::stringstream solutions_sstrm;
+
+	solutions_sstrm
 	<< "static real b["<<num_solutions<<"];\n"
 	<< "static real x["<<num_solutions+1<<"];\n"
 	<< "static real b_components["<<num_components<<"];\n\n";
 
-	sstrm << "//INVERTED CONDUCTANCE MATRIX G^-1\n\n";
+	solutions_sstrm << solve_constants_code << "\n\n";
 
-	buf = invg_gen.asCLiteral("inv_g");
-	sstrm << buf << "\n\n";
+	sstrm << solutions_sstrm.str();
+
+	if(parameters.xilinx_hls_enable)
+	{
+		sstrm << generateHlsArrayDirectives(solutions_sstrm.str());
+	}
 
 	sstrm << "//READ PORT INJECTIONS FROM OTHER SUBSYSTEMS H(n-1)\n\n";
 
@@ -582,20 +681,15 @@ std::string SubsystemSolverEngineGenerator::generateCInlineCode(double zero_boun
 
 	sstrm << "//AGGREGRATE COMPONENT SOURCE CONTRIBUTIONS b(n-1)\n\n";
 
-	source_vector_gen.asCInlineCode(buf);
-	sstrm << buf << "\n\n";
+	sstrm << generateHlsBoundCode(aggregation_code) << "\n\n";
 
 	sstrm << "//MODEL UPDATE SOLUTIONS x(n)=G^-1 * b(n-1)\n\n";
 
-	solver_gen.generateCInlineCode(buf, "inv_g");
-	sstrm << buf << "\n\n";
+	sstrm << generateHlsBoundCode(solve_code) << "\n\n";
 
 	sstrm << "//COMPONENT SOURCE CONTRIBUTION UPDATES b_comp(n)\n\n";
 
-	for(auto i : comp_update_bodies)
-	{
-		sstrm << i << "\n";
-	}
+	sstrm << generateComponentUpdatesCode();
 	sstrm << "\n";
 
 	if(parameters.io_signal_output_enable)
@@ -713,30 +807,7 @@ void SubsystemSolverEngineGenerator::generateCFunctionAndExport(std::string file
 
 	file << "\n\n";
 
-	if( !( parameters.codegen_solver_templated_real_type_enable == true &&
-		parameters.codegen_solver_templated_function_enable == true ) )
-	{
-		if(parameters.fixed_point_enable)
-		{
-			if(parameters.xilinx_hls_enable)
-			{
-				file <<
-				"#include <ap_fixed.h>\n" <<
-				"typedef ap_fixed<"<<parameters.fixed_point_word_width<<", "<<
-				parameters.fixed_point_int_width<<", AP_RND> real;\n\n";
-
-			}
-			else
-			{
-				file << "//platform-agnostic fixed point not supported yet. Using double real values\n"<<
-				"typedef double real;\n\n";
-			}
-		}
-		else
-		{
-			file << "typedef double real;\n\n";
-		}
-	}
+	file << generateRealTypeDefinition();
 
 	if(parameters.codegen_solver_templated_function_enable == false)
 	{
@@ -25,10 +25,15 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 #include <vector>
 #include <fstream>
+#include <sstream>
 #include <iomanip>
 #include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <utility>
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 
 namespace lblmc
 {
@@ -36,21 +41,39 @@ namespace lblmc
 //SystemConductanceGenerator::SystemConductanceGenerator() {}
 
 SystemConductanceGenerator::SystemConductanceGenerator(unsigned int dimension):
-	matrix(MatrixRMXd::Zero(dimension,dimension)), dimension(dimension)
+	matrix(MatrixRMXd::Zero(dimension,dimension)), dimension(dimension), sparse(false),
+	entries(), sparse_matrix(), compressed(false), dense_cached(false),
+	inverse_rcond(0.0), inverse_symmetric(false)
 {
 	if(dimension == 0)
 		throw std::invalid_argument("SystemConductanceGenerator constructor(): dimension must be nonzero");
 }
 
+SystemConductanceGenerator::SystemConductanceGenerator(unsigned int dimension, bool sparse):
+	matrix(), dimension(dimension), sparse(sparse),
+	entries(), sparse_matrix(), compressed(false), dense_cached(false),
+	inverse_rcond(0.0), inverse_symmetric(false)
+{
+	if(dimension == 0)
+		throw std::invalid_argument("SystemConductanceGenerator constructor(): dimension must be nonzero");
+
+	if(!sparse)
+		matrix = MatrixRMXd::Zero(dimension,dimension);
+}
+
 SystemConductanceGenerator::SystemConductanceGenerator(unsigned int dimension, const MatrixRMXd& base):
-		matrix(base), dimension(dimension)
+		matrix(base), dimension(dimension), sparse(false),
+		entries(), sparse_matrix(), compressed(false), dense_cached(false),
+		inverse_rcond(0.0), inverse_symmetric(false)
 {
 	if(dimension == 0)
 		throw std::invalid_argument("SystemConductanceGenerator constructor(): dimension must be nonzero");
 }
 
 SystemConductanceGenerator::SystemConductanceGenerator(const SystemConductanceGenerator& base) :
-		matrix(base.matrix), dimension(base.dimension)
+		matrix(base.matrix), dimension(base.dimension), sparse(base.sparse),
+		entries(base.entries), sparse_matrix(base.sparse_matrix), compressed(base.compressed), dense_cached(base.dense_cached),
+		inverse_rcond(base.inverse_rcond), inverse_symmetric(base.inverse_symmetric)
 {
 	//do nothing else
 }
@@ -61,7 +84,15 @@ void SystemConductanceGenerator::reset(unsigned int dimension)
 		throw std::invalid_argument("SystemConductanceGenerator::reset(): dimension must be nonzero");
 
 	this->dimension = dimension;
-	this->matrix.setZero();
+	this->entries.clear();
+	this->sparse_matrix = SparseMatrixRMXd();
+	this->compressed = false;
+	this->dense_cached = false;
+
+	if(sparse)
+		this->matrix = MatrixRMXd();
+	else
+		this->matrix = MatrixRMXd::Zero(dimension,dimension);
 }
 
 void SystemConductanceGenerator::reset(unsigned int dimension, const MatrixRMXd& base)
@@ -71,32 +102,217 @@ void SystemConductanceGenerator::reset(unsigned int dimension, const MatrixRMXd&
 
 	this->dimension = dimension;
 	this->matrix = base;
+	this->entries.clear();
+	this->sparse_matrix = SparseMatrixRMXd();
+	this->compressed = false;
+	this->dense_cached = false;
+
+	if(sparse)
+	{
+		sparse = false;
+		setSparse(true);
+	}
 }
 
 void SystemConductanceGenerator::reset(const SystemConductanceGenerator& base)
 {
 	dimension = base.dimension;
 	matrix = base.matrix;
+	sparse = base.sparse;
+	entries = base.entries;
+	sparse_matrix = base.sparse_matrix;
+	compressed = base.compressed;
+	dense_cached = base.dense_cached;
+	inverse_rcond = base.inverse_rcond;
+	inverse_symmetric = base.inverse_symmetric;
+}
+
+void SystemConductanceGenerator::add(unsigned int r, unsigned int c, double value)
+{
+	if(!sparse)
+	{
+		matrix(r,c) += value;
+		return;
+	}
+
+	Entry e;
+	e.row = r;
+	e.col = c;
+	e.value = value;
+	e.assign = false;
+	entries.push_back(e);
+
+	compressed = false;
+	dense_cached = false;
+}
+
+void SystemConductanceGenerator::assign(unsigned int r, unsigned int c, double value)
+{
+	if(!sparse)
+	{
+		matrix(r,c) = value;
+		return;
+	}
+
+	Entry e;
+	e.row = r;
+	e.col = c;
+	e.value = value;
+	e.assign = true;
+	entries.push_back(e);
+
+	compressed = false;
+	dense_cached = false;
+}
+
+void SystemConductanceGenerator::compress() const
+{
+	if(compressed)
+		return;
+
+		// sum the entries of each element in stamp order, as the dense matrix would
+
+	std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b)
+	{
+		return (a.row != b.row) ? (a.row < b.row) : (a.col < b.col);
+	});
+
+	std::vector<Entry> summed;
+	std::vector< Eigen::Triplet<double> > triplets;
+
+	for(std::size_t i = 0; i < entries.size(); )
+	{
+		Entry e = entries[i];
+		double value = 0.0;
+
+		for( ; i < entries.size() && entries[i].row == e.row && entries[i].col == e.col; i++)
+		{
+			if(entries[i].assign)
+				value = entries[i].value;
+			else
+				value += entries[i].value;
+		}
+
+		if(value == 0.0)
+			continue;
+
+		e.value = value;
+		e.assign = false;
+		summed.push_back(e);
+		triplets.push_back(Eigen::Triplet<double>(e.row, e.col, value));
+	}
+
+	entries.swap(summed);
+
+	sparse_matrix.resize(dimension, dimension);
+	sparse_matrix.setFromTriplets(triplets.begin(), triplets.end());
+	sparse_matrix.makeCompressed();
+
+	compressed = true;
+}
+
+const MatrixRMXd& SystemConductanceGenerator::denseView() const
+{
+	if(!sparse || dense_cached)
+		return matrix;
+
+	compress();
+
+	matrix = MatrixRMXd(sparse_matrix);
+	dense_cached = true;
+
+	return matrix;
+}
+
+MatrixRMXd& SystemConductanceGenerator::denseStorage()
+{
+	setSparse(false);
+	return matrix;
+}
+
+void SystemConductanceGenerator::setSparse(bool sparse)
+{
+	if(sparse == this->sparse)
+		return;
+
+	if(sparse)
+	{
+		entries.clear();
+
+		for(unsigned int r = 0; r < dimension; r++)
+		{
+			for(unsigned int c = 0; c < dimension; c++)
+			{
+				if(matrix(r,c) == 0.0)
+					continue;
+
+				Entry e;
+				e.row = r;
+				e.col = c;
+				e.value = matrix(r,c);
+				e.assign = false;
+				entries.push_back(e);
+			}
+		}
+
+		matrix = MatrixRMXd();
+		compressed = false;
+		dense_cached = false;
+	}
+	else
+	{
+		denseView();
+
+		entries.clear();
+		sparse_matrix = SparseMatrixRMXd();
+		compressed = false;
+		dense_cached = false;
+	}
+
+	this->sparse = sparse;
+}
+
+bool SystemConductanceGenerator::isSparse() const
+{
+	return sparse;
 }
 
 double* SystemConductanceGenerator::asPointer()
 {
-	return matrix.data();
+	return denseStorage().data();
 }
 
 double* SystemConductanceGenerator::asArray()
 {
-	return matrix.data();
+	return denseStorage().data();
 }
 
 MatrixRMXd& SystemConductanceGenerator::asEigen3Matrix()
 {
-	return matrix;
+	return denseStorage();
 }
 
 const MatrixRMXd& SystemConductanceGenerator::asEigen3Matrix() const
 {
-	return matrix;
+	return denseView();
+}
+
+SparseMatrixRMXd SystemConductanceGenerator::asEigen3SparseMatrix() const
+{
+	if(!sparse)
+		return matrix.sparseView(0.0, 0.0);
+
+	compress();
+	return sparse_matrix;
+}
+
+unsigned int SystemConductanceGenerator::getNumberOfNonzeros() const
+{
+	if(!sparse)
+		return (matrix.array() != 0.0).count();
+
+	compress();
+	return sparse_matrix.nonZeros();
 }
 
 unsigned int SystemConductanceGenerator::getDimension() const
@@ -115,15 +331,15 @@ void SystemConductanceGenerator::stampConductance(double conductance, unsigned i
 
 	if( p != 0 && n != 0)
 	{
-		matrix(p-1,p-1) +=  conductance;
-		matrix(p-1,n-1) += -conductance;
-		matrix(n-1,p-1) += -conductance;
-		matrix(n-1,n-1) +=  conductance;
+		add(p-1,p-1, conductance);
+		add(p-1,n-1, -conductance);
+		add(n-1,p-1, -conductance);
+		add(n-1,n-1, conductance);
 	}
 	else if (p != 0)
-		matrix(p-1,p-1) += conductance;
+		add(p-1,p-1, conductance);
 	else if (n != 0)
-		matrix(n-1,n-1) += conductance;
+		add(n-1,n-1, conductance);
 }
 
 void SystemConductanceGenerator::stampTransconductance(double transconductance, unsigned int m, unsigned int n, unsigned int p, unsigned int q)
@@ -137,22 +353,22 @@ void SystemConductanceGenerator::stampTransconductance(double transconductance,
 
 	if( (m != 0) && (p != 0) )
 	{
-		matrix(p-1,m-1) += transconductance;
+		add(p-1,m-1, transconductance);
 	}
 
 	if( (m != 0) && (q != 0) )
 	{
-		matrix(q-1,m-1) -= transconductance;
+		add(q-1,m-1, -transconductance);
 	}
 
 	if( (n != 0) && (p != 0) )
 	{
-		matrix(p-1,n-1) -= transconductance;
+		add(p-1,n-1, -transconductance);
 	}
 
 	if( (n != 0) && (q != 0) )
 	{
-		matrix(q-1,n-1) += transconductance;
+		add(q-1,n-1, transconductance);
 	}
 
 }
@@ -168,26 +384,26 @@ void SystemConductanceGenerator::stampTransconductance2(double transconductance1
 
 	if( (m != 0) && (p != 0) )
 	{
-		matrix(m-1,p-1) += transconductance12;
-		matrix(p-1,m-1) += transconductance21;
+		add(m-1,p-1, transconductance12);
+		add(p-1,m-1, transconductance21);
 	}
 
 	if( (m != 0) && (q != 0) )
 	{
-		matrix(m-1,q-1) -= transconductance12;
-		matrix(q-1,m-1) -= transconductance21;
+		add(m-1,q-1, -transconductance12);
+		add(q-1,m-1, -transconductance21);
 	}
 
 	if( (n != 0) && (p != 0) )
 	{
-		matrix(n-1,p-1) -= transconductance12;
-		matrix(p-1,n-1) -= transconductance21;
+		add(n-1,p-1, -transconductance12);
+		add(p-1,n-1, -transconductance21);
 	}
 
 	if( (n != 0) && (q != 0) )
 	{
-		matrix(n-1,q-1) += transconductance12;
-		matrix(q-1,n-1) += transconductance21;
+		add(n-1,q-1, transconductance12);
+		add(q-1,n-1, transconductance21);
 	}
 }
 
@@ -199,7 +415,7 @@ void SystemConductanceGenerator::stampPartialConductance(double conductance, uns
 	}
 
 	if( r != 0 && c != 0)
-		matrix(r-1,c-1) += conductance;
+		add(r-1,c-1, conductance);
 }
 
 void SystemConductanceGenerator::stampIdealVoltageSourceIncidence(unsigned int s, unsigned int p, unsigned int n)
@@ -220,38 +436,132 @@ void SystemConductanceGenerator::stampIdealVoltageSourceIncidence(unsigned int s
 
 	if( p != 0 && n != 0)
 	{
-		matrix(s-1,p-1) =  1;
-		matrix(s-1,n-1) = -1;
-		matrix(n-1,s-1) = -1;
-		matrix(p-1,s-1) =  1;
+		assign(s-1,p-1, 1);
+		assign(s-1,n-1, -1);
+		assign(n-1,s-1, -1);
+		assign(p-1,s-1, 1);
 	}
 	else if (p != 0)
 	{
-		matrix(s-1,p-1) = 1;
-		matrix(p-1,s-1) = 1;
+		assign(s-1,p-1, 1);
+		assign(p-1,s-1, 1);
 	}
 	else if (n != 0)
 	{
-		matrix(s-1,n-1) = -1;
-		matrix(n-1,s-1) = -1;
+		assign(s-1,n-1, -1);
+		assign(n-1,s-1, -1);
+	}
+}
+
+void SystemConductanceGenerator::accumulate(const SystemConductanceGenerator& partial)
+{
+	if(partial.dimension != dimension)
+		throw std::invalid_argument("SystemConductanceGenerator::accumulate(): dimension of partial generator differs from this generator");
+
+	if(!partial.sparse)
+	{
+		for(unsigned int r = 0; r < dimension; r++)
+		{
+			for(unsigned int c = 0; c < dimension; c++)
+			{
+				if(partial.matrix(r,c) != 0.0)
+					add(r, c, partial.matrix(r,c));
+			}
+		}
+
+		return;
+	}
+
+	if(sparse)
+		entries.reserve(entries.size()+partial.entries.size());
+
+	for(const Entry& e : partial.entries)
+	{
+		if(e.assign)
+			assign(e.row, e.col, e.value);
+		else
+			add(e.row, e.col, e.value);
 	}
 }
 
 bool SystemConductanceGenerator::isInvertible() const
 {
-	return matrix.fullPivLu().isInvertible();
+	if(!sparse)
+		return matrix.partialPivLu().rcond() > std::numeric_limits<double>::epsilon();
+
+	compress();
+
+	Eigen::SparseMatrix<double> g(sparse_matrix);
+	Eigen::SparseLU< Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > lu;
+	lu.analyzePattern(g);
+	lu.factorize(g);
+
+	return lu.info() == Eigen::Success;
 }
 
 void SystemConductanceGenerator::invertSelf()
 {
-	if(!matrix.fullPivLu().isInvertible())
+	setSparse(false);
+
+		// factorize once and solve for the inverse with the same decomposition; a symmetric
+		// semidefinite G takes LDL^T, and anything else takes LU with partial pivoting
+
+	const MatrixRMXd identity = MatrixRMXd::Identity(dimension, dimension);
+
+	if(matrix == matrix.transpose())
 	{
-		throw std::runtime_error("SystemConductanceGenerator::invertSelf(): cannot invert conductance matrix as it is singular");
+		Eigen::LDLT<MatrixRMXd> ldlt(matrix);
+
+		if( ldlt.info() == Eigen::Success && (ldlt.isPositive() || ldlt.isNegative()) )
+		{
+			inverse_rcond = ldlt.rcond();
+
+			if( !(inverse_rcond > std::numeric_limits<double>::epsilon()) )
+				throw std::runtime_error("SystemConductanceGenerator::invertSelf(): cannot invert conductance matrix as it is singular");
+
+			matrix = ldlt.solve(identity);
+			inverse_symmetric = true;
+			return;
+		}
 	}
 
-	matrix = matrix.fullPivLu().inverse();
+	Eigen::PartialPivLU<MatrixRMXd> lu(matrix);
+
+	inverse_rcond = lu.rcond();
+
+	if( !(inverse_rcond > std::numeric_limits<double>::epsilon()) )
+		throw std::runtime_error("SystemConductanceGenerator::invertSelf(): cannot invert conductance matrix as it is singular");
+
+	matrix = lu.solve(identity);
+	inverse_symmetric = false;
+}
+
+double SystemConductanceGenerator::getInverseConditionNumber() const
+{
+	return (inverse_rcond > 0.0) ? 1.0/inverse_rcond : 0.0;
+}
+
+bool SystemConductanceGenerator::isInvertedSymmetric() const
+{
+	return inverse_symmetric;
 }
 
+void SystemConductanceGenerator::resetToInverse(MatrixRMXd inverse, double condition_number, bool inverted_symmetric)
+{
+	if(inverse.rows() == 0 || inverse.rows() != inverse.cols())
+		throw std::invalid_argument("SystemConductanceGenerator::resetToInverse(): inverse must be square and nonzero in dimension");
+
+	dimension = inverse.rows();
+	matrix = std::move(inverse);
+	sparse = false;
+	entries.clear();
+	sparse_matrix = SparseMatrixRMXd();
+	compressed = false;
+	dense_cached = false;
+	inverse_rcond = (condition_number > 0.0) ? 1.0/condition_number : 0.0;
+	inverse_symmetric = inverted_symmetric;
+}
+
 SystemConductanceGenerator SystemConductanceGenerator::invert() const
 {
 	SystemConductanceGenerator ret(*this);
@@ -261,17 +571,21 @@ SystemConductanceGenerator SystemConductanceGenerator::invert() const
 
 std::string SystemConductanceGenerator::spy() const
 {
+	const SparseMatrixRMXd g = asEigen3SparseMatrix();
+
 	std::string buffer;
 
 	for(unsigned int r = 0; r < dimension; r++)
 	{
+		std::string row(2*dimension, ' ');
+
 		for(unsigned int c = 0; c < dimension; c++)
-		{
-			if( matrix(r,c)  == 0.0 )
-				buffer += ". ";
-			else
-				buffer += "X ";
-		}
+			row[2*c] = '.';
+
+		for(SparseMatrixRMXd::InnerIterator it(g, r); it; ++it)
+			row[2*it.col()] = 'X';
+
+		buffer += row;
 		buffer += '\n';
 	}
 
@@ -291,16 +605,16 @@ void SystemConductanceGenerator::exportSpy(std::string filename) const
 		throw std::runtime_error("SystemConductanceGenerator::exportSpy(): failed to open or create file");
 	}
 
+	const SparseMatrixRMXd g = asEigen3SparseMatrix();
+
 	for(unsigned int r = 0; r < dimension; r++)
 	{
-		for(unsigned int c = 0; c < dimension; c++)
-		{
-			if( matrix(r,c)  == 0.0 )
-				file << '.';
-			else
-				file << 'X';
-		}
-		file << '\n';
+		std::string row(dimension, '.');
+
+		for(SparseMatrixRMXd::InnerIterator it(g, r); it; ++it)
+			row[it.col()] = 'X';
+
+		file << row << '\n';
 	}
 	file << std::flush;
 
@@ -309,6 +623,8 @@ void SystemConductanceGenerator::exportSpy(std::string filename) const
 
 std::string SystemConductanceGenerator::asString() const
 {
+	const MatrixRMXd& g = denseView();
+
 	std::stringstream str;
 
 	str << std::setprecision(16);
@@ -319,7 +635,7 @@ std::string SystemConductanceGenerator::asString() const
 	{
 		for(unsigned int c = 0; c < dimension; c++)
 		{
-			str << "   " << matrix(r,c);
+			str << "   " << g(r,c);
 		}
 		str << "\n";
 	}
@@ -330,6 +646,8 @@ std::string SystemConductanceGenerator::asString() const
 
 void SystemConductanceGenerator::exportAsASCIIMatlab(std::string filename) const
 {
+	const MatrixRMXd& g = denseView();
+
 	std::fstream file;
 
 	try
@@ -349,7 +667,7 @@ void SystemConductanceGenerator::exportAsASCIIMatlab(std::string filename) const
 	{
 		for(unsigned int c = 0; c < dimension; c++)
 		{
-			file << "   " << matrix(r,c);
+			file << "   " << g(r,c);
 		}
 		file << "\n";
 	}
@@ -361,6 +679,8 @@ void SystemConductanceGenerator::exportAsASCIIMatlab(std::string filename) const
 
 void SystemConductanceGenerator::exportAsCSV(std::string filename) const
 {
+	const MatrixRMXd& g = denseView();
+
 	std::fstream file;
 
 	try
@@ -378,11 +698,11 @@ void SystemConductanceGenerator::exportAsCSV(std::string filename) const
 
 	for(unsigned int r = 0; r < dimension; r++)
 	{
-		file << matrix(r,0);
+		file << g(r,0);
 
 		for(unsigned int c = 1; c < dimension; c++)
 		{
-			file << ", " << matrix(r,c);
+			file << ", " << g(r,c);
 		}
 		file << "\n";
 	}
@@ -391,8 +711,48 @@ void SystemConductanceGenerator::exportAsCSV(std::string filename) const
 	file.close();
 }
 
+void SystemConductanceGenerator::exportAsMatrixMarket(std::string filename, bool pattern_only) const
+{
+	if(filename.empty())
+		throw std::invalid_argument("SystemConductanceGenerator::exportAsMatrixMarket(): filename cannot be empty");
+
+	std::ofstream file(filename.c_str(), std::ofstream::out | std::ofstream::trunc);
+
+	if(!file)
+		throw std::runtime_error("SystemConductanceGenerator::exportAsMatrixMarket(): failed to open or create file \'" + filename + "\'");
+
+	const SparseMatrixRMXd g = asEigen3SparseMatrix();
+
+	file << "%%MatrixMarket matrix coordinate " << (pattern_only ? "pattern" : "real") << " general\n";
+	file << "% conductance matrix exported by SystemConductanceGenerator\n";
+	file << dimension << " " << dimension << " " << g.nonZeros() << "\n";
+
+	file << std::setprecision(16);
+	file << std::scientific;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		for(SparseMatrixRMXd::InnerIterator it(g, r); it; ++it)
+		{
+			file << (r+1) << " " << (it.col()+1);
+
+			if(!pattern_only)
+				file << " " << it.value();
+
+			file << "\n";
+		}
+	}
+
+	file << std::flush;
+
+	if(!file)
+		throw std::runtime_error("SystemConductanceGenerator::exportAsMatrixMarket(): failed to write file \'" + filename + "\'");
+}
+
 void SystemConductanceGenerator::exportAsCHeader(std::string filename, std::string mat_name) const
 {
+	const MatrixRMXd& g = denseView();
+
 	std::fstream file;
 
 	std::string fname = filename;
@@ -431,11 +791,11 @@ void SystemConductanceGenerator::exportAsCHeader(std::string filename, std::stri
 
 	for(unsigned int r = 0; r < dimension; r++)
 	{
-		file << "{" << matrix(r,0);
+		file << "{" << g(r,0);
 
 		for(unsigned int c = 1; c < dimension; c++)
 		{
-			file << "," << matrix(r,c);
+			file << "," << g(r,c);
 		}
 		file << "}";
 
@@ -458,6 +818,8 @@ std::string SystemConductanceGenerator::asCLiteral(std::string mat_name) const
 	if( mat_name.empty() )
 		throw std::invalid_argument("SystemConductanceGenerator::exportAsCCodeLiteral(): mat_name cannot be empty or null");
 
+	const MatrixRMXd& g = denseView();
+
 	std::stringstream mat;
 
 	mat << std::setprecision(16);
@@ -468,11 +830,11 @@ std::string SystemConductanceGenerator::asCLiteral(std::string mat_name) const
 
 	for(unsigned int r = 0; r < dimension; r++)
 	{
-		mat << "{" << matrix(r,0);
+		mat << "{" << g(r,0);
 
 		for(unsigned int c = 1; c < dimension; c++)
 		{
-			mat << "," << matrix(r,c);
+			mat << "," << g(r,c);
 		}
 		mat << "}";
 
@@ -502,11 +864,13 @@ void SystemConductanceGenerator::importFromASCIIMatlab(std::string filename)
 
 	reset(dimension);
 
+	double* data = asArray();
+
 	//in a lazy way, we are not checking the matlab file for proper formatting here, so beware!
 
 	for(unsigned int i = 0; i < dimension*dimension; i++)
 	{
-		file >> (matrix.data())[i];
+		file >> data[i];
 	}
 
 	file.close();
@@ -0,0 +1,418 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include "codegen/SystemFactorizedSolverGenerator.hpp"
+
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <utility>
+
+#include <Eigen/Sparse>
+#include <Eigen/OrderingMethods>
+
+namespace lblmc
+{
+
+SystemFactorizedSolverGenerator::SystemFactorizedSolverGenerator(const SystemConductanceGenerator& G, double zero_bound) :
+	dimension(G.getDimension()),
+	zero_bound(zero_bound),
+	symmetric(false),
+	row_order(),
+	col_order(),
+	lower(),
+	upper(),
+	inv_diagonal(),
+	num_lower(0),
+	num_upper(0)
+{
+	if(dimension == 0)
+		throw std::runtime_error("SystemFactorizedSolverGenerator::constructor(): cannot factorize conductance matrix without dimension set");
+
+	// fill-reducing ordering of G with AMD; AMD works on the pattern of G+G^T
+
+	const Eigen::SparseMatrix<double> gs(G.asEigen3SparseMatrix());
+
+	Eigen::AMDOrdering<int> amd;
+	Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> perm_inv;
+	amd(gs, perm_inv);
+
+	std::vector<unsigned int> order(dimension);
+	for(unsigned int k = 0; k < dimension; k++)
+		order[k] = perm_inv.indices()[k];
+
+	std::vector<unsigned int> position(dimension);
+	for(unsigned int k = 0; k < dimension; k++)
+		position[order[k]] = k;
+
+	std::vector< Eigen::Triplet<double> > triplets;
+	triplets.reserve(gs.nonZeros());
+	for(int c = 0; c < gs.outerSize(); c++)
+	{
+		for(Eigen::SparseMatrix<double>::InnerIterator it(gs, c); it; ++it)
+			triplets.push_back(Eigen::Triplet<double>(position[it.row()], position[it.col()], it.value()));
+	}
+
+	Eigen::SparseMatrix<double> gp(dimension, dimension);
+	gp.setFromTriplets(triplets.begin(), triplets.end());
+
+	symmetric = gs.isApprox(Eigen::SparseMatrix<double>(gs.transpose()), 1.0e-14);
+
+	col_order = order;
+	row_order = order;
+
+	if(symmetric)
+		factorizeLDLT(gp);
+
+	if(!symmetric)
+		factorizeLU(gp);
+}
+
+void SystemFactorizedSolverGenerator::factorizeLDLT(const Eigen::SparseMatrix<double>& gp)
+{
+	const Eigen::SparseMatrix<double> gs(gp.triangularView<Eigen::Lower>());
+
+	// already ordered by AMD, so no further permutation by the factorization
+
+	Eigen::SimplicialLDLT< Eigen::SparseMatrix<double>, Eigen::Lower, Eigen::NaturalOrdering<int> > ldlt(gs);
+
+	const Eigen::VectorXd d = ldlt.vectorD();
+
+	if( ldlt.info() != Eigen::Success || !d.allFinite() || (d.array() == 0.0).any() )
+	{
+		symmetric = false; // not factorizable without pivoting; let LU handle it
+		return;
+	}
+
+	const Eigen::SparseMatrix<double>& l = ldlt.matrixL().nestedExpression();
+
+	lower.assign(dimension, std::vector<Factor>());
+	upper.assign(dimension, std::vector<Factor>());
+	inv_diagonal.assign(dimension, 0.0);
+
+	for(unsigned int c = 0; c < dimension; c++)
+	{
+		for(Eigen::SparseMatrix<double>::InnerIterator it(l, c); it; ++it)
+		{
+			if( it.row() <= int(c) || std::fabs(it.value()) < zero_bound )
+				continue;
+
+			Factor f;
+			f.col = c;
+			f.value = it.value();
+			f.index = 0;
+			f.in_lower = true;
+			lower[it.row()].push_back(f);
+		}
+	}
+
+	// number the table of L in order of forward substitution; U = L^T reuses the same table
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		for(auto& f : lower[r])
+		{
+			f.index = num_lower++;
+
+			Factor u = f;
+			u.col = r;
+			upper[f.col].push_back(u);
+		}
+
+		inv_diagonal[r] = 1.0/d(r);
+	}
+
+	for(auto& row : upper)
+	{
+		std::sort(row.begin(), row.end(), [](const Factor& a, const Factor& b){ return a.col < b.col; });
+	}
+}
+
+void SystemFactorizedSolverGenerator::factorizeLU(const Eigen::SparseMatrix<double>& gp)
+{
+	// right-looking LU with threshold partial pivoting over the nonzeros of the AMD ordered G; the
+	// AMD ordered diagonal is kept as pivot unless it is much smaller than the largest candidate of
+	// its column
+
+	const double pivot_threshold = 0.1;
+
+	// the rows not yet eliminated keep their elements right of the eliminated columns, and each
+	// column keeps the rows not yet eliminated with an element in it; the multipliers of L stay with
+	// their row as it is swapped
+
+	std::vector< std::map<unsigned int, double> > active(dimension);
+	std::vector< std::set<unsigned int> > col_rows(dimension);
+	std::vector< std::vector< std::pair<unsigned int, double> > > multipliers(dimension);
+
+	double max_element = 0.0;
+
+	for(int c = 0; c < gp.outerSize(); c++)
+	{
+		for(Eigen::SparseMatrix<double>::InnerIterator it(gp, c); it; ++it)
+		{
+			active[it.row()][c] = it.value();
+			col_rows[c].insert(it.row());
+			max_element = std::max(max_element, std::fabs(it.value()));
+		}
+	}
+
+	std::vector<unsigned int> rows(dimension);
+	std::vector<unsigned int> position(dimension);
+	for(unsigned int k = 0; k < dimension; k++)
+	{
+		rows[k] = k;
+		position[k] = k;
+	}
+
+	const double singular_bound = std::numeric_limits<double>::epsilon()*dimension*max_element;
+
+	for(unsigned int k = 0; k < dimension; k++)
+	{
+		// the candidate of largest magnitude, the first in row order of those of equal magnitude
+
+		unsigned int piv = rows[k];
+		double piv_magnitude = active[piv].count(k) ? std::fabs(active[piv][k]) : 0.0;
+
+		for(unsigned int i : col_rows[k])
+		{
+			const double magnitude = std::fabs(active[i][k]);
+
+			if( magnitude > piv_magnitude || (magnitude == piv_magnitude && position[i] < position[piv]) )
+			{
+				piv = i;
+				piv_magnitude = magnitude;
+			}
+		}
+
+		if( !(piv_magnitude > singular_bound) )
+			throw std::runtime_error("SystemFactorizedSolverGenerator::factorizeLU(): cannot factorize conductance matrix as it is singular");
+
+		const double diagonal_magnitude = active[rows[k]].count(k) ? std::fabs(active[rows[k]][k]) : 0.0;
+
+		if( diagonal_magnitude < pivot_threshold*piv_magnitude )
+		{
+			std::swap(rows[k], rows[position[piv]]);
+			position[rows[position[piv]]] = position[piv];
+			position[piv] = k;
+		}
+
+		const unsigned int p = rows[k];
+		const double pivot = active[p][k];
+
+		for(const auto& element : active[p])
+			col_rows[element.first].erase(p);
+
+		for(unsigned int i : col_rows[k])
+		{
+			const double l = active[i][k]/pivot;
+
+			active[i].erase(k);
+			multipliers[i].push_back(std::make_pair(k, l));
+
+			if( l == 0.0 )
+				continue;
+
+			for(const auto& element : active[p])
+			{
+				if( element.first == k )
+					continue;
+
+				auto inserted = active[i].insert(std::make_pair(element.first, 0.0));
+				inserted.first->second -= l*element.second;
+
+				if( inserted.second )
+					col_rows[element.first].insert(i);
+			}
+		}
+
+		col_rows[k].clear();
+	}
+
+	lower.assign(dimension, std::vector<Factor>());
+	upper.assign(dimension, std::vector<Factor>());
+	inv_diagonal.assign(dimension, 0.0);
+
+	std::vector<unsigned int> order(row_order);
+
+	for(unsigned int k = 0; k < dimension; k++)
+	{
+		row_order[k] = order[rows[k]];
+		inv_diagonal[k] = 1.0/active[rows[k]][k];
+
+		for(const auto& m : multipliers[rows[k]])
+		{
+			if( std::fabs(m.second) < zero_bound )
+				continue;
+
+			Factor f;
+			f.col = m.first;
+			f.value = m.second;
+			f.index = num_lower++;
+			f.in_lower = true;
+			lower[k].push_back(f);
+		}
+	}
+
+	for(unsigned int k = dimension; k-- > 0; )
+	{
+		for(const auto& element : active[rows[k]])
+		{
+			if( element.first <= k )
+				continue;
+
+			const double u = element.second*inv_diagonal[k];
+
+			if( std::fabs(u) < zero_bound )
+				continue;
+
+			Factor f;
+			f.col = element.first;
+			f.value = u;
+			f.index = num_upper++;
+			f.in_lower = false;
+			upper[k].push_back(f);
+		}
+	}
+}
+
+unsigned int SystemFactorizedSolverGenerator::getNumberOfConstants() const
+{
+	return num_lower + num_upper + dimension;
+}
+
+unsigned int SystemFactorizedSolverGenerator::countMultiplies() const
+{
+	unsigned int count = dimension;
+
+	for(unsigned int k = 0; k < dimension; k++)
+		count += lower[k].size() + upper[k].size();
+
+	return count;
+}
+
+std::string SystemFactorizedSolverGenerator::generateCFactorsLiteral(std::string prefix) const
+{
+	if( prefix.empty() )
+		throw std::invalid_argument("SystemFactorizedSolverGenerator::generateCFactorsLiteral(): prefix cannot be empty or null");
+
+	std::stringstream sstrm;
+
+	sstrm << std::setprecision(16);
+	sstrm << std::fixed;
+	sstrm << std::scientific;
+
+	// tables are written in the order the substitution code reads them, one factor row per line
+
+	auto write_table = [&](const std::string& name, unsigned int size, bool from_lower)
+	{
+		sstrm << "const static real " << prefix << "_" << name << "[" << size << "] =\n{";
+
+		bool first = true;
+		for(unsigned int i = 0; i < dimension; i++)
+		{
+			const unsigned int k = from_lower ? i : dimension-1-i;
+			const std::vector<Factor>& row = from_lower ? lower[k] : upper[k];
+
+			if(row.empty())
+				continue;
+
+			if(!first) sstrm << ",\n";
+			first = false;
+
+			for(unsigned int j = 0; j < row.size(); j++)
+			{
+				if(j != 0) sstrm << ",";
+				sstrm << row[j].value;
+			}
+		}
+
+		sstrm << "\n};\n";
+	};
+
+	if(num_lower != 0)
+		write_table("l", num_lower, true);
+
+	if(num_upper != 0)
+		write_table("u", num_upper, false);
+
+	sstrm << "const static real " << prefix << "_inv_d[" << dimension << "] =\n{" << inv_diagonal[0];
+	for(unsigned int k = 1; k < dimension; k++)
+	{
+		sstrm << ((k % 8) ? "," : ",\n") << inv_diagonal[k];
+	}
+	sstrm << "\n};\n";
+
+	return sstrm.str();
+}
+
+std::string SystemFactorizedSolverGenerator::generateCInlineCode(std::string prefix) const
+{
+	if( prefix.empty() )
+		throw std::invalid_argument("SystemFactorizedSolverGenerator::generateCInlineCode(): prefix cannot be empty or null");
+
+	std::stringstream sstrm;
+
+	const std::string y = prefix + "_y";
+
+	sstrm << "x[0] = 0.0;\n";
+	sstrm << "real " << y << "[" << dimension << "];\n\n";
+
+	sstrm << "//forward substitution L*y = P*b\n";
+
+	for(unsigned int k = 0; k < dimension; k++)
+	{
+		sstrm << y << "[" << k << "] = b[" << row_order[k] << "] ";
+
+		for(const auto& f : lower[k])
+		{
+			sstrm << "- " << prefix << "_l[" << f.index << "]*" << y << "[" << f.col << "] ";
+		}
+
+		sstrm << ";\n";
+	}
+
+	sstrm << "\n//back substitution D*U*(Q^-1)*x = y\n";
+
+	for(unsigned int k = dimension; k-- > 0; )
+	{
+		sstrm << "x[" << col_order[k]+1 << "] = " << y << "[" << k << "]*" << prefix << "_inv_d[" << k << "] ";
+
+		for(const auto& f : upper[k])
+		{
+			sstrm << "- " << prefix << (f.in_lower ? "_l[" : "_u[") << f.index << "]*x[" << col_order[f.col]+1 << "] ";
+		}
+
+		sstrm << ";\n";
+	}
+
+	return sstrm.str();
+}
+
+} // namespace lblmc
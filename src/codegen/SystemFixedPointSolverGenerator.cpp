@@ -0,0 +1,467 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include "codegen/SystemFixedPointSolverGenerator.hpp"
+
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+
+namespace lblmc
+{
+
+std::string SystemFixedPointSolverGenerator::Format::asString() const
+{
+	std::stringstream sstrm;
+	sstrm << "Q" << int_width << "." << getFracWidth();
+	return sstrm.str();
+}
+
+int SystemFixedPointSolverGenerator::findIntWidth(double bound)
+{
+	// smallest number of integral bits I, including sign, such that bound < 2^(I-1)
+
+	if( !(bound > 0.0) )
+		return 1;
+
+	return int(std::floor(std::log2(bound))) + 2;
+}
+
+SystemFixedPointSolverGenerator::SystemFixedPointSolverGenerator
+(
+	const double* A,
+	unsigned int dimension,
+	const std::vector<double>& source_bounds,
+	Format real_format,
+	bool integer_arithmetic,
+	bool row_formats,
+	double zero_bound
+) :
+	dimension(dimension),
+	integer_arithmetic(integer_arithmetic),
+	real_format(real_format),
+	source_format({0,0}),
+	source_bound(0.0),
+	coeff_formats(),
+	solution_formats(),
+	rows(dimension),
+	used_sources(dimension, false),
+	solution_bounds(dimension, 0.0),
+	error_bounds(dimension, 0.0),
+	saturable_reads(dimension, false),
+	num_flushed(dimension, 0)
+{
+	if(A == nullptr)
+		throw std::invalid_argument("SystemFixedPointSolverGenerator::constructor(): inverted conductance matrix cannot be null");
+
+	if(dimension == 0)
+		throw std::invalid_argument("SystemFixedPointSolverGenerator::constructor(): dimension cannot be zero");
+
+	if(source_bounds.size() != dimension)
+		throw std::invalid_argument("SystemFixedPointSolverGenerator::constructor(): number of source bounds must equal dimension");
+
+	if(real_format.word_width < 2)
+		throw std::invalid_argument("SystemFixedPointSolverGenerator::constructor(): word width of real type must be at least 2 bits");
+
+	auto isZero = [zero_bound](double a) { return a < zero_bound && a > -zero_bound; };
+
+		// integer arithmetic keeps products of coefficients and sources within 64 bits
+
+	const int coeff_word = integer_arithmetic ? std::min(real_format.word_width, 32) : real_format.word_width;
+	const int source_word = coeff_word;
+	const int solution_word = integer_arithmetic ? std::min(real_format.word_width, 64) : real_format.word_width;
+
+		// range of the source vector; sources beyond the range of the real type saturate when quantized
+
+	std::vector<double> b_bounds(dimension);
+	std::vector<double> row_max(dimension, 0.0);
+	double coeff_max = 0.0;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		for(unsigned int j = 0; j < dimension; j++)
+		{
+			const double a = A[r*dimension+j];
+
+			if(isZero(a))
+				continue;
+
+			used_sources[j] = true;
+			row_max[r] = std::max(row_max[r], std::abs(a));
+		}
+
+		coeff_max = std::max(coeff_max, row_max[r]);
+	}
+
+	for(unsigned int j = 0; j < dimension; j++)
+	{
+		b_bounds[j] = std::abs(source_bounds[j]);
+
+		if(used_sources[j])
+			source_bound = std::max(source_bound, b_bounds[j]);
+	}
+
+	source_format = {source_word, std::min(findIntWidth(source_bound), real_format.int_width)};
+
+	const int source_frac = source_format.getFracWidth();
+	const double source_q_max = std::ldexp(1.0, source_word-1) - 1.0;
+	const double source_max = std::ldexp(1.0, source_format.int_width-1);
+
+		// formats of coefficients and solutions of each row
+
+	const double coeff_q_max = std::ldexp(1.0, coeff_word-1) - 1.0;
+	const double acc_max = std::ldexp(1.0, 62);
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		Format coeff_format = {coeff_word, findIntWidth(row_formats ? row_max[r] : coeff_max)};
+
+		double coeff_error = 0.0;
+		double source_error = 0.0;
+
+		while(true)
+		{
+			const double scale = std::ldexp(1.0, coeff_format.getFracWidth());
+
+			double acc_bound = 0.0;
+			coeff_error = 0.0;
+			source_error = 0.0;
+			num_flushed[r] = 0;
+			rows[r].clear();
+
+			for(unsigned int j = 0; j < dimension; j++)
+			{
+				const double a = A[r*dimension+j];
+
+				if(isZero(a))
+					continue;
+
+				const double q = std::max(-coeff_q_max, std::min(coeff_q_max, std::round(a*scale)));
+
+				coeff_error += std::abs(a - q/scale) * b_bounds[j];
+
+				if(q == 0.0)
+				{
+					num_flushed[r]++;
+					continue;
+				}
+
+				rows[r].push_back({j, q});
+
+				if(b_bounds[j] >= source_max)
+					saturable_reads[r] = true;
+
+				acc_bound += std::abs(q) * std::min(std::ceil(b_bounds[j]*std::ldexp(1.0, source_frac)), source_q_max);
+				source_error += std::abs(q/scale) * std::ldexp(1.0, -source_frac-1);
+			}
+
+			if(!integer_arithmetic || acc_bound < acc_max)
+				break;
+
+			coeff_format.int_width++; // fewer fractional bits so that the sums of the row fit in 64 bits
+		}
+
+		double bound = 0.0;
+		for(unsigned int j = 0; j < dimension; j++)
+		{
+			const double a = A[r*dimension+j];
+			if(!isZero(a))
+				bound += std::abs(a) * b_bounds[j];
+		}
+
+		const int acc_frac = coeff_format.getFracWidth() + source_frac;
+
+		Format solution_format = {solution_word, std::min(findIntWidth(bound), real_format.int_width)};
+
+		// solutions are not given more fractional bits than their sums, nor than the real type holds
+
+		if(solution_format.getFracWidth() > acc_frac)
+			solution_format.int_width = solution_word - acc_frac;
+
+		if(!integer_arithmetic && solution_format.getFracWidth() > real_format.getFracWidth())
+			solution_format.int_width = solution_word - real_format.getFracWidth();
+
+		const double rounding_error = (solution_format.getFracWidth() < acc_frac) ? std::ldexp(1.0, -solution_format.getFracWidth()-1) : 0.0;
+
+		coeff_formats.push_back(coeff_format);
+		solution_formats.push_back(solution_format);
+		solution_bounds[r] = bound;
+		error_bounds[r] = coeff_error + source_error + rounding_error;
+	}
+}
+
+SystemFixedPointSolverGenerator::Format SystemFixedPointSolverGenerator::getCoefficientFormat(unsigned int r) const
+{
+	if(r >= dimension)
+		throw std::out_of_range("SystemFixedPointSolverGenerator::getCoefficientFormat(): row index out of bounds");
+
+	return coeff_formats[r];
+}
+
+SystemFixedPointSolverGenerator::Format SystemFixedPointSolverGenerator::getSolutionFormat(unsigned int r) const
+{
+	if(r >= dimension)
+		throw std::out_of_range("SystemFixedPointSolverGenerator::getSolutionFormat(): row index out of bounds");
+
+	return solution_formats[r];
+}
+
+double SystemFixedPointSolverGenerator::getSolutionBound(unsigned int r) const
+{
+	if(r >= dimension)
+		throw std::out_of_range("SystemFixedPointSolverGenerator::getSolutionBound(): row index out of bounds");
+
+	return solution_bounds[r];
+}
+
+double SystemFixedPointSolverGenerator::getErrorBound(unsigned int r) const
+{
+	if(r >= dimension)
+		throw std::out_of_range("SystemFixedPointSolverGenerator::getErrorBound(): row index out of bounds");
+
+	return error_bounds[r];
+}
+
+bool SystemFixedPointSolverGenerator::isSaturable(unsigned int r) const
+{
+	if(r >= dimension)
+		throw std::out_of_range("SystemFixedPointSolverGenerator::isSaturable(): row index out of bounds");
+
+	return saturable_reads[r] || solution_bounds[r] >= std::ldexp(1.0, real_format.int_width-1);
+}
+
+unsigned int SystemFixedPointSolverGenerator::countMultiplies() const
+{
+	unsigned int count = 0;
+
+	for(const auto& row : rows)
+		count += row.size();
+
+	return count;
+}
+
+std::string SystemFixedPointSolverGenerator::generateReport(const std::vector<unsigned int>& netlist_nodes) const
+{
+	std::stringstream sstrm;
+
+	sstrm << std::setprecision(4);
+	sstrm << std::scientific;
+
+	sstrm
+	<< "fixed point solve x = G^-1 * b with " << (integer_arithmetic ? "portable integer" : "ap_fixed") << " arithmetic\n"
+	<< "real type " << real_format.asString() << ", source vector b " << source_format.asString()
+	<< " with |b| <= " << source_bound << "\n";
+
+	if(source_bound >= std::ldexp(1.0, source_format.int_width-1))
+	{
+		sstrm
+		<< "warning: |b| bound exceeds the range " << std::ldexp(1.0, source_format.int_width-1) << " of the source format; "
+		<< "sources saturate, and the nodes reading them are saturable\n";
+	}
+
+	sstrm << "\n";
+
+	sstrm << std::left
+	<< std::setw(8)  << "node"
+	<< std::setw(14) << "|x| bound"
+	<< std::setw(12) << "x format"
+	<< std::setw(14) << "G^-1 format"
+	<< std::setw(8)  << "terms"
+	<< std::setw(10) << "flushed"
+	<< "error bound"
+	<< "\n";
+
+	unsigned int num_saturable = 0;
+	unsigned int total_flushed = 0;
+	unsigned int worst_node = 0;
+
+	auto node = [&netlist_nodes](unsigned int r) { return r < netlist_nodes.size() ? netlist_nodes[r] : r+1; };
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		sstrm
+		<< std::setw(8)  << node(r)
+		<< std::setw(14) << solution_bounds[r]
+		<< std::setw(12) << solution_formats[r].asString()
+		<< std::setw(14) << coeff_formats[r].asString()
+		<< std::setw(8)  << rows[r].size()
+		<< std::setw(10) << num_flushed[r]
+		<< error_bounds[r];
+
+		if(isSaturable(r))
+		{
+			sstrm << "  saturable";
+			num_saturable++;
+		}
+
+		sstrm << "\n";
+
+		total_flushed += num_flushed[r];
+
+		if(error_bounds[r] > error_bounds[worst_node])
+			worst_node = r;
+	}
+
+	sstrm
+	<< "\n"
+	<< countMultiplies() << " multiplies, "
+	<< total_flushed << " nonzero coefficients flushed to zero, "
+	<< num_saturable << " saturable nodes, "
+	<< "largest error bound " << error_bounds[worst_node] << " at node " << node(worst_node) << "\n";
+
+	return sstrm.str();
+}
+
+std::string SystemFixedPointSolverGenerator::generateCTypesLiteral(const std::string& prefix) const
+{
+	if( prefix.empty() )
+		throw std::invalid_argument("SystemFixedPointSolverGenerator::generateCTypesLiteral(): prefix cannot be empty or null");
+
+	std::stringstream sstrm;
+
+	if(integer_arithmetic)
+		return sstrm.str();
+
+	sstrm << "typedef ap_fixed<" << source_format.word_width << ", " << source_format.int_width << ", AP_RND, AP_SAT> "
+	      << prefix << "_b_fixed;\n";
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(rows[r].empty())
+			continue;
+
+		sstrm
+		<< "typedef ap_fixed<" << coeff_formats[r].word_width << ", " << coeff_formats[r].int_width << "> "
+		<< prefix << "_r" << r << "_fixed;\n"
+		<< "typedef ap_fixed<" << solution_formats[r].word_width << ", " << solution_formats[r].int_width << ", AP_RND, AP_SAT> "
+		<< prefix << "_x" << r+1 << "_fixed;\n";
+	}
+
+	return sstrm.str();
+}
+
+std::string SystemFixedPointSolverGenerator::generateCInlineCode(const std::string& prefix) const
+{
+	if( prefix.empty() )
+		throw std::invalid_argument("SystemFixedPointSolverGenerator::generateCInlineCode(): prefix cannot be empty or null");
+
+	std::stringstream sstrm;
+
+	sstrm << std::setprecision(17);
+	sstrm << std::scientific;
+
+	const std::string b_q = prefix + "_b_q";
+	const std::string acc = prefix + "_acc";
+
+		// quantization of the source vector
+
+	if(integer_arithmetic)
+	{
+		const double q_max = std::ldexp(1.0, source_format.word_width-1) - 1.0;
+
+		sstrm << "std::int32_t " << b_q << "[" << dimension << "];\n";
+		sstrm << "std::int64_t " << acc << ";\n\n";
+
+		for(unsigned int j = 0; j < dimension; j++)
+		{
+			if(!used_sources[j])
+				continue;
+
+			sstrm << b_q << "[" << j << "] = std::int32_t(std::llrint(std::fmin(std::fmax(b[" << j << "]*"
+			      << std::ldexp(1.0, source_format.getFracWidth()) << ", " << -q_max << "), " << q_max << ")));\n";
+		}
+	}
+	else
+	{
+		sstrm << prefix << "_b_fixed " << b_q << "[" << dimension << "];\n\n";
+
+		for(unsigned int j = 0; j < dimension; j++)
+		{
+			if(!used_sources[j])
+				continue;
+
+			sstrm << b_q << "[" << j << "] = b[" << j << "];\n";
+		}
+	}
+
+	sstrm << "\n";
+
+		// solutions
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		const std::vector<Term>& row = rows[r];
+
+		if(row.empty())
+		{
+			sstrm << "x[" << r+1 << "] = 0.0;\n";
+			continue;
+		}
+
+		if(integer_arithmetic)
+		{
+			const int shift = coeff_formats[r].getFracWidth() + source_format.getFracWidth() - solution_formats[r].getFracWidth();
+
+			sstrm << acc << " = ";
+			for(unsigned int k = 0; k < row.size(); k++)
+			{
+				if(k != 0) sstrm << " + ";
+				sstrm << "std::int64_t(" << (long long)(row[k].value) << ")*" << b_q << "[" << row[k].col << "]";
+			}
+			sstrm << ";\n";
+
+			if(shift > 0)
+				sstrm << acc << " = (" << acc << " + (std::int64_t(1) << " << shift-1 << ")) >> " << shift << ";\n";
+
+			if(solution_formats[r].word_width < 64)
+			{
+				const long long limit = (1LL << (solution_formats[r].word_width-1)) - 1;
+
+				sstrm << acc << " = (" << acc << " > " << limit << "LL) ? " << limit << "LL : "
+				      << "((" << acc << " < -" << limit << "LL) ? -" << limit << "LL : " << acc << ");\n";
+			}
+
+			sstrm << "x[" << r+1 << "] = real(" << acc << ")*" << std::ldexp(1.0, -solution_formats[r].getFracWidth()) << ";\n";
+		}
+		else
+		{
+			const double scale = std::ldexp(1.0, -coeff_formats[r].getFracWidth());
+
+			sstrm << "x[" << r+1 << "] = " << prefix << "_x" << r+1 << "_fixed( ";
+			for(unsigned int k = 0; k < row.size(); k++)
+			{
+				if(k != 0) sstrm << " + ";
+				sstrm << prefix << "_r" << r << "_fixed(" << row[k].value*scale << ")*" << b_q << "[" << row[k].col << "]";
+			}
+			sstrm << " );\n";
+		}
+	}
+
+	return sstrm.str();
+}
+
+} //namespace lblmc
@@ -0,0 +1,266 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include "codegen/SystemFusedSolverGenerator.hpp"
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <cstdlib>
+
+namespace lblmc
+{
+
+SystemFusedSolverGenerator::SystemFusedSolverGenerator
+(
+	const double* A,
+	unsigned int dimension,
+	const SystemSourceVectorGenerator& sources,
+	double zero_bound,
+	const std::vector<bool>& solved_rows
+) :
+	dimension(dimension),
+	num_sources(sources.getNumSources()),
+	solved(solved_rows.empty() ? std::vector<bool>(dimension, true) : solved_rows),
+	fused(dimension, false),
+	fused_terms(dimension),
+	two_stage_terms(dimension),
+	b_used(dimension, false),
+	num_fused_coefficients(0),
+	num_two_stage_multiplies(0)
+{
+	if(A == nullptr)
+		throw std::invalid_argument("SystemFusedSolverGenerator::SystemFusedSolverGenerator(): inverted conductance matrix cannot be null");
+
+	if(dimension != sources.getDimension())
+		throw std::invalid_argument("SystemFusedSolverGenerator::SystemFusedSolverGenerator(): dimension does not match that of the source vector");
+
+	if(solved.size() != dimension)
+		throw std::invalid_argument("SystemFusedSolverGenerator::SystemFusedSolverGenerator(): number of solved row flags does not match dimension");
+
+	auto isZero = [zero_bound](double a) { return a < zero_bound && a > -zero_bound; };
+
+		// number of rows reading each element of b, to share the additions aggregating it among them
+
+	std::vector<unsigned int> readers(dimension, 0);
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(!solved[r])
+			continue;
+
+		for(unsigned int c = 0; c < dimension; c++)
+		{
+			if(!isZero(A[dimension*r+c]))
+				readers[c]++;
+		}
+	}
+
+		// row r of G^-1*S accumulated in a dense scratch row, clearing only the sources it touched
+
+	std::vector<double> row(num_sources, 0.0);
+	std::vector<bool> touched(num_sources, false);
+	std::vector<unsigned int> touched_sources;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(!solved[r])
+			continue;
+
+		double two_stage_cost = 0.0;
+
+		touched_sources.clear();
+
+		for(unsigned int c = 0; c < dimension; c++)
+		{
+			const double a = A[dimension*r+c];
+
+			if(isZero(a))
+				continue; // A[r,c] is close to zero, so ignore the term.
+
+			num_two_stage_multiplies++;
+
+			const std::vector<long>& contributions = sources.getContributions(c);
+
+			if(contributions.empty())
+				continue; // b[c] is always zero
+
+			two_stage_terms[r].push_back(c);
+			two_stage_cost += 1.0 + double(contributions.size()-1)/double(readers[c]);
+
+			for(const long id : contributions)
+			{
+				const unsigned int s = std::labs(id)-1;
+
+				row[s] += (id > 0) ? a : -a;
+
+				if(!touched[s])
+				{
+					touched[s] = true;
+					touched_sources.push_back(s);
+				}
+			}
+		}
+
+		std::vector< std::pair<unsigned int, double> > terms;
+
+		for(unsigned int s = 0; s < num_sources; s++)
+		{
+			if(!touched[s])
+				continue;
+
+			if(!isZero(row[s]))
+				terms.push_back( std::make_pair(s, row[s]) );
+		}
+
+		for(const unsigned int s : touched_sources)
+		{
+			row[s] = 0.0;
+			touched[s] = false;
+		}
+
+		if(double(terms.size()) <= two_stage_cost)
+		{
+			fused[r] = true;
+			num_fused_coefficients += terms.size();
+			fused_terms[r] = std::move(terms);
+			two_stage_terms[r].clear();
+		}
+		else
+		{
+			for(const unsigned int c : two_stage_terms[r])
+				b_used[c] = true;
+		}
+	}
+}
+
+unsigned int SystemFusedSolverGenerator::getNumberOfFusedRows() const
+{
+	unsigned int count = 0;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(fused[r])
+			count++;
+	}
+
+	return count;
+}
+
+unsigned int SystemFusedSolverGenerator::countMultiplies() const
+{
+	unsigned int count = num_fused_coefficients;
+
+	for(const auto& terms : two_stage_terms)
+		count += terms.size();
+
+	return count;
+}
+
+std::string SystemFusedSolverGenerator::generateCFusedLiteral(std::string table_name) const
+{
+	if( table_name.empty() )
+		throw std::invalid_argument("SystemFusedSolverGenerator::generateCFusedLiteral(): table_name cannot be empty or null");
+
+	if(num_fused_coefficients == 0)
+		return std::string();
+
+	std::stringstream sstrm;
+
+	sstrm << std::setprecision(16);
+	sstrm << std::fixed;
+	sstrm << std::scientific;
+
+	// table is written in the order the solve code reads it, one fused row per line
+
+	sstrm << "const static real " << table_name << "[" << num_fused_coefficients << "] =\n{";
+
+	bool first = true;
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(fused_terms[r].empty())
+			continue;
+
+		if(!first) sstrm << ",\n";
+		first = false;
+
+		for(unsigned int k = 0; k < fused_terms[r].size(); k++)
+		{
+			if(k != 0) sstrm << ",";
+			sstrm << fused_terms[r][k].second;
+		}
+	}
+
+	sstrm << "\n};\n";
+
+	return sstrm.str();
+}
+
+std::string SystemFusedSolverGenerator::generateCInlineCode(std::string invg_name, std::string table_name) const
+{
+	if( invg_name.empty() || table_name.empty() )
+		throw std::invalid_argument("SystemFusedSolverGenerator::generateCInlineCode(): invg_name and table_name cannot be empty or null");
+
+	std::stringstream sstrm;
+
+	unsigned int index = 0;
+
+	sstrm << "x[0] = 0.0;\n";
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(!solved[r])
+			continue;
+
+		sstrm << "x[" << r+1 << "] = ";
+
+		if(fused[r])
+		{
+			for(unsigned int k = 0; k < fused_terms[r].size(); k++)
+			{
+				sstrm << (k ? "+ " : "") << table_name << "[" << index++ << "]*b_components[" << fused_terms[r][k].first << "] ";
+			}
+
+			if(fused_terms[r].empty())
+				sstrm << "real(0.0) ";
+		}
+		else
+		{
+			for(unsigned int k = 0; k < two_stage_terms[r].size(); k++)
+			{
+				const unsigned int c = two_stage_terms[r][k];
+
+				sstrm << (k ? "+ " : "") << invg_name << "[" << r << "][" << c << "]*b[" << c << "] ";
+			}
+		}
+
+		sstrm << ";\n";
+	}
+
+	return sstrm.str();
+}
+
+} //namespace lblmc
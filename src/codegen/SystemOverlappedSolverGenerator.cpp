@@ -0,0 +1,272 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/SystemOverlappedSolverGenerator.hpp"
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <stdexcept>
+#include <cstdlib>
+
+namespace lblmc
+{
+
+SystemOverlappedSolverGenerator::SystemOverlappedSolverGenerator
+(
+	const double* A,
+	unsigned int dimension,
+	const SystemSourceVectorGenerator& sources,
+	double zero_bound,
+	const std::vector<bool>& solved_rows
+) :
+	dimension(dimension),
+	num_sources(sources.getNumSources()),
+	solved(solved_rows.empty() ? std::vector<bool>(dimension, true) : solved_rows),
+	columns(sources.getNumSources()),
+	folds(),
+	final_sources()
+{
+	if(A == nullptr)
+		throw std::invalid_argument("SystemOverlappedSolverGenerator::SystemOverlappedSolverGenerator(): inverted conductance matrix cannot be null");
+
+	if(dimension != sources.getDimension())
+		throw std::invalid_argument("SystemOverlappedSolverGenerator::SystemOverlappedSolverGenerator(): dimension does not match that of the source vector");
+
+	if(solved.size() != dimension)
+		throw std::invalid_argument("SystemOverlappedSolverGenerator::SystemOverlappedSolverGenerator(): number of solved row flags does not match dimension");
+
+	auto isZero = [zero_bound](double a) { return a < zero_bound && a > -zero_bound; };
+
+		// nodes each source is incident to, with the sign of its contribution
+
+	std::vector< std::vector< std::pair<unsigned int, bool> > > incidences(num_sources);
+
+	for(unsigned int c = 0; c < dimension; c++)
+	{
+		for(const long id : sources.getContributions(c))
+			incidences[std::labs(id)-1].push_back( std::make_pair(c, id < 0) );
+	}
+
+	for(unsigned int s = 0; s < num_sources; s++)
+	{
+		for(unsigned int r = 0; r < dimension; r++)
+		{
+			if(!solved[r])
+				continue;
+
+			double coefficient = 0.0;
+
+			for(const auto& incidence : incidences[s])
+			{
+				const double a = A[std::size_t(dimension)*r+incidence.first];
+
+				if(isZero(a))
+					continue; // A[r,c] is close to zero, so ignore the term.
+
+				coefficient += incidence.second ? -a : a;
+			}
+
+			if(!isZero(coefficient))
+				columns[s].push_back( std::make_pair(r, coefficient) );
+		}
+	}
+
+	for(unsigned int s = 0; s < num_sources; s++)
+		final_sources.push_back(s);
+}
+
+void SystemOverlappedSolverGenerator::setFolds(const std::vector< std::vector<unsigned int> >& source_folds)
+{
+	std::vector<bool> folded(num_sources, false);
+
+	for(const auto& fold : source_folds)
+	{
+		for(const unsigned int s : fold)
+		{
+			if(s >= num_sources)
+				throw std::invalid_argument("SystemOverlappedSolverGenerator::setFolds(): source " + std::to_string(s) + " is out of range");
+
+			if(folded[s])
+				throw std::invalid_argument("SystemOverlappedSolverGenerator::setFolds(): source " + std::to_string(s) + " is in more than one fold");
+
+			folded[s] = true;
+		}
+	}
+
+	folds = source_folds;
+	final_sources.clear();
+
+	for(unsigned int s = 0; s < num_sources; s++)
+	{
+		if(!folded[s])
+			final_sources.push_back(s);
+	}
+}
+
+unsigned int SystemOverlappedSolverGenerator::countMultiplies() const
+{
+	unsigned int count = 0;
+
+	for(const auto& column : columns)
+		count += column.size();
+
+	return count;
+}
+
+std::vector< std::pair< unsigned int, std::vector< std::pair<unsigned int, double> > > >
+SystemOverlappedSolverGenerator::collectFoldTerms(const std::vector<unsigned int>& sources) const
+{
+	std::map< unsigned int, std::vector< std::pair<unsigned int, double> > > rows;
+
+	for(const unsigned int s : sources)
+	{
+		for(const auto& nonzero : columns[s])
+			rows[nonzero.first].push_back( std::make_pair(s, nonzero.second) );
+	}
+
+	return std::vector< std::pair< unsigned int, std::vector< std::pair<unsigned int, double> > > >(rows.begin(), rows.end());
+}
+
+std::string SystemOverlappedSolverGenerator::generateCColumnsLiteral(std::string table_name) const
+{
+	if( table_name.empty() )
+		throw std::invalid_argument("SystemOverlappedSolverGenerator::generateCColumnsLiteral(): table_name cannot be empty or null");
+
+	const unsigned int num_coefficients = countMultiplies();
+
+	if(num_coefficients == 0)
+		return std::string();
+
+	std::stringstream sstrm;
+
+	sstrm << std::setprecision(16);
+	sstrm << std::fixed;
+	sstrm << std::scientific;
+
+	// table is written in the order the folds and the final code read it, one statement per line
+
+	sstrm << "const static real " << table_name << "[" << num_coefficients << "] =\n{";
+
+	bool first = true;
+
+	for(unsigned int f = 0; f <= folds.size(); f++)
+	{
+		for(const auto& row : collectFoldTerms(f < folds.size() ? folds[f] : final_sources))
+		{
+			if(!first) sstrm << ",\n";
+			first = false;
+
+			for(unsigned int k = 0; k < row.second.size(); k++)
+			{
+				if(k != 0) sstrm << ",";
+				sstrm << row.second[k].second;
+			}
+		}
+	}
+
+	sstrm << "\n};\n";
+
+	return sstrm.str();
+}
+
+std::string SystemOverlappedSolverGenerator::generateCFoldCode(const std::vector<unsigned int>& sources, const std::string& table_name,
+                                                               const std::string& sum_prefix, unsigned int& index, std::vector<bool>& summed) const
+{
+	std::stringstream sstrm;
+
+	for(const auto& row : collectFoldTerms(sources))
+	{
+		const unsigned int r = row.first;
+
+		if(summed[r])
+			sstrm << sum_prefix << r+1 << " += ";
+		else
+			sstrm << "real " << sum_prefix << r+1 << " = ";
+
+		summed[r] = true;
+
+		for(unsigned int k = 0; k < row.second.size(); k++)
+		{
+			sstrm << (k ? " + " : "") << table_name << "[" << index++ << "]*b_components[" << row.second[k].first << "]";
+		}
+
+		sstrm << ";\n";
+	}
+
+	return sstrm.str();
+}
+
+std::vector<std::string> SystemOverlappedSolverGenerator::generateCFoldCode(std::string table_name, std::string sum_prefix) const
+{
+	if( table_name.empty() || sum_prefix.empty() )
+		throw std::invalid_argument("SystemOverlappedSolverGenerator::generateCFoldCode(): table_name and sum_prefix cannot be empty or null");
+
+	std::vector<std::string> codes;
+	codes.reserve(folds.size());
+
+	unsigned int index = 0;
+	std::vector<bool> summed(dimension, false);
+
+	for(const auto& fold : folds)
+		codes.push_back(generateCFoldCode(fold, table_name, sum_prefix, index, summed));
+
+	return codes;
+}
+
+std::string SystemOverlappedSolverGenerator::generateCInlineCode(std::string table_name, std::string sum_prefix) const
+{
+	if( table_name.empty() || sum_prefix.empty() )
+		throw std::invalid_argument("SystemOverlappedSolverGenerator::generateCInlineCode(): table_name and sum_prefix cannot be empty or null");
+
+	std::stringstream sstrm;
+
+		// the folds are replayed to find the table index and running sums the final fold continues from
+
+	unsigned int index = 0;
+	std::vector<bool> summed(dimension, false);
+
+	for(const auto& fold : folds)
+		generateCFoldCode(fold, table_name, sum_prefix, index, summed);
+
+	sstrm << generateCFoldCode(final_sources, table_name, sum_prefix, index, summed);
+
+	sstrm << "x[0] = 0.0;\n";
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(!solved[r])
+			continue;
+
+		if(summed[r])
+			sstrm << "x[" << r+1 << "] = " << sum_prefix << r+1 << ";\n";
+		else
+			sstrm << "x[" << r+1 << "] = 0.0;\n";
+	}
+
+	return sstrm.str();
+}
+
+} //namespace lblmc
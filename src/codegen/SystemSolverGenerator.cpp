@@ -22,26 +22,32 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 
 #include "codegen/SystemSolverGenerator.hpp"
+#include "codegen/CodeIR.hpp"
 #include <string>
 #include <sstream>
 #include <fstream>
 #include <stdexcept>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <iomanip>
 
 namespace lblmc
 {
 
 SystemSolverGenerator::SystemSolverGenerator() :
-	A(nullptr), dimension(0), num_components(0), zero_bound(1.0e-12)
+	A(nullptr), dimension(0), num_components(0), zero_bound(1.0e-12), tree_fan_in(0), tree_registered(false)
 {}
 
 SystemSolverGenerator::SystemSolverGenerator(const double* A, unsigned int dimension, unsigned int num_components, double zero_bound) :
-	A(A), dimension(dimension), num_components(num_components), zero_bound(zero_bound)
+	A(A), dimension(dimension), num_components(num_components), zero_bound(zero_bound), tree_fan_in(0), tree_registered(false)
 {
 	//do nothing else
 }
 
 SystemSolverGenerator::SystemSolverGenerator(const SystemSolverGenerator& base) :
-	A(base.A), dimension(base.dimension), num_components(base.num_components), zero_bound(base.zero_bound)
+	A(base.A), dimension(base.dimension), num_components(base.num_components), zero_bound(base.zero_bound),
+	solved_rows(base.solved_rows), tree_fan_in(base.tree_fan_in), tree_registered(base.tree_registered)
 {
 	//do nothing else
 }
@@ -52,6 +58,9 @@ void SystemSolverGenerator::reset(const double* A, unsigned int dimension, unsig
 	this->dimension = dimension;
 	this->num_components = num_components;
 	this->zero_bound = zero_bound;
+	solved_rows.clear();
+	tree_fan_in = 0;
+	tree_registered = false;
 }
 
 void SystemSolverGenerator::reset(const SystemSolverGenerator& base)
@@ -60,6 +69,143 @@ void SystemSolverGenerator::reset(const SystemSolverGenerator& base)
 	dimension = base.dimension;
 	num_components = base.num_components;
 	zero_bound = base.zero_bound;
+	solved_rows = base.solved_rows;
+	tree_fan_in = base.tree_fan_in;
+	tree_registered = base.tree_registered;
+}
+
+void SystemSolverGenerator::setSolvedRows(const std::vector<bool>& rows)
+{
+	if(!rows.empty() && rows.size() != dimension)
+		throw std::invalid_argument("SystemSolverGenerator::setSolvedRows(): number of row flags does not match dimension");
+
+	solved_rows = rows;
+}
+
+void SystemSolverGenerator::setAdderTree(unsigned int fan_in, bool registered)
+{
+	tree_fan_in = (fan_in < 2) ? 0 : fan_in;
+	tree_registered = registered;
+}
+
+std::string SystemSolverGenerator::generateCHlsRegisterDefinition()
+{
+	return
+	"#ifndef LBLMC_HLS_REG\n"
+	"#define LBLMC_HLS_REG\n"
+	"template< typename T >\n"
+	"T lblmc_hls_reg(T d)\n"
+	"{\n"
+	"#pragma HLS pipeline II=1\n"
+	"#pragma HLS latency min=1 max=1\n"
+	"#pragma HLS inline off\n"
+	"\treturn d;\n"
+	"}\n"
+	"#endif\n";
+}
+
+std::string SystemSolverGenerator::generateTreeExpression(const std::vector<std::string>& operands) const
+{
+	auto join = [](const std::vector<std::string>& ops, unsigned int begin, unsigned int end)
+	{
+		std::string sum = ops[begin];
+
+		for(unsigned int j = begin+1; j < end; j++)
+			sum += (ops[j][0] == '-') ? " - " + ops[j].substr(1) : " + " + ops[j];
+
+		return sum;
+	};
+
+	std::vector<std::string> level(operands);
+
+	while(level.size() > tree_fan_in)
+	{
+		std::vector<std::string> sums;
+
+		for(unsigned int i = 0; i < level.size(); i += tree_fan_in)
+		{
+			const unsigned int end = std::min<unsigned int>(level.size(), i+tree_fan_in);
+
+			sums.push_back( (end-i == 1) ? level[i] : "(" + join(level, i, end) + ")" );
+		}
+
+		level.swap(sums);
+	}
+
+	return join(level, 0, level.size());
+}
+
+std::string SystemSolverGenerator::generateRowSum(unsigned int r, const std::vector<std::string>& terms, const char* A_name) const
+{
+	std::stringstream sstrm;
+
+	if(tree_fan_in == 0 || terms.size() <= 1)
+	{
+		sstrm << "x[" << r+1 << "] = ";
+
+		for(unsigned int t = 0; t < terms.size(); t++)
+			sstrm << (t ? "+ " : "") << terms[t] << " ";
+
+		if(terms.empty())
+			sstrm << "real(0.0) ";
+
+		sstrm << ";\n";
+
+		return sstrm.str();
+	}
+
+		// each level sums groups of fan_in operands of the level below; a group of 1 operand is
+		// passed up as is, and the single sum of the top level is assigned to the solution
+
+	std::vector<std::string> operands(terms);
+	unsigned int level = 0;
+
+	while(operands.size() > 1)
+	{
+		level++;
+
+		std::vector<std::string> sums;
+
+		for(unsigned int i = 0; i < operands.size(); i += tree_fan_in)
+		{
+			const unsigned int end = std::min<unsigned int>(operands.size(), i+tree_fan_in);
+
+			if(end-i == 1)
+			{
+				sums.push_back(operands[i]);
+				continue;
+			}
+
+			std::string sum = operands[i];
+			for(unsigned int j = i+1; j < end; j++)
+				sum += " + " + operands[j];
+
+			if(operands.size() <= tree_fan_in)
+			{
+				sstrm << "x[" << r+1 << "] = " << sum << ";\n";
+				return sstrm.str();
+			}
+
+			if(tree_registered)
+			{
+				const std::string name = std::string(A_name) + "_sum" + std::to_string(r) + "_" +
+				                         std::to_string(level) + "_" + std::to_string(sums.size());
+
+				sstrm << "const real " << name << " = lblmc_hls_reg<real>(" << sum << ");\n";
+				sums.push_back(name);
+			}
+			else
+			{
+				sums.push_back("(" + sum + ")");
+			}
+		}
+
+		operands.swap(sums);
+	}
+
+	sstrm << "x[" << r+1 << "] = " << operands[0] << ";\n";
+
+	return sstrm.str();
 }
 
 void SystemSolverGenerator::generateCInlineCode(std::string& buffer, const char* A_name)
@@ -73,24 +219,538 @@ void SystemSolverGenerator::generateCInlineCode(std::string& buffer, const char*
 
 	for(int r = 0; r < dimension; r++)
 	{
-		sstrm << "x[" << r+1 << "] = ";
-		if( !(A[dimension*r+0] < zero_bound && A[dimension*r+0] > -zero_bound) )
-			sstrm << A_name << "[" << r << "][" << int(0) <<"]*b[" << int(0) << "] ";
-		else
-			sstrm << "real(0.0) ";
-		for(int c = 1; c < dimension; c++)
+		if(!isSolvedRow(r))
+			continue;
+
+		std::vector<std::string> terms;
+
+		if(tree_fan_in == 0 && isZero(A[dimension*r+0]))
+			terms.push_back("real(0.0)");
+
+		for(int c = 0; c < dimension; c++)
 		{
 			if( A[dimension*r+c] < zero_bound && A[dimension*r+c] > -zero_bound )
 				continue; // A[r,c] is close to zero, so ignore the term.
 
-			sstrm << "+ " << A_name << "[" << r << "][" << c <<"]*b[" << c << "] ";
+			terms.push_back(std::string(A_name) + "[" + std::to_string(r) + "][" + std::to_string(c) + "]*b[" + std::to_string(c) + "]");
 		}
 
-		sstrm << ";\n";
+		sstrm << generateRowSum(r, terms, A_name);
 	}
 
 	buffer = sstrm.str();
 }
+
+void SystemSolverGenerator::generateCodeIR(CodeIR& ir, unsigned int invg_array, unsigned int b_array, unsigned int x_array) const
+{
+	if(A == nullptr || dimension == 0)
+		throw std::runtime_error("SystemSolverGenerator::generateCodeIR(): cannot generate code without conductance matrix and dimension set");
+
+	ir.insertAssignment(ir.getElement(x_array, 0), {});
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(!isSolvedRow(r))
+			continue;
+
+		std::vector<CodeIR::Term> terms;
+
+		for(unsigned int c = 0; c < dimension; c++)
+		{
+			if(isZero(A[std::size_t(dimension)*r+c]))
+				continue;
+
+			terms.push_back(CodeIR::Term::of(ir.getElement(invg_array, r, c), ir.getElement(b_array, c)));
+		}
+
+		ir.insertAssignment(ir.getElement(x_array, r+1), std::move(terms));
+	}
+}
+
+std::vector<SystemSolverGenerator::SharedTerm> SystemSolverGenerator::factorRow(unsigned int r, double share_tolerance) const
+{
+	std::vector<SharedTerm> terms;
+
+	for(unsigned int c = 0; c < dimension; c++)
+	{
+		const double a = A[dimension*r+c];
+
+		if( isZero(a) )
+			continue; // A[r,c] is close to zero, so ignore the term.
+
+		bool shared = false;
+
+		for(auto& term : terms)
+		{
+			const double t = A[dimension*r+term.coeff_col];
+			const double scale = std::max(std::fabs(a), std::fabs(t));
+
+			if( std::fabs(a - t) <= share_tolerance*scale )
+			{
+				term.sources.push_back(std::make_pair(c, false));
+				shared = true;
+				break;
+			}
+
+			if( std::fabs(a + t) <= share_tolerance*scale )
+			{
+				term.sources.push_back(std::make_pair(c, true));
+				shared = true;
+				break;
+			}
+		}
+
+		if(!shared)
+		{
+			SharedTerm term;
+			term.coeff_col = c;
+			term.sources.push_back(std::make_pair(c, false));
+			terms.push_back(term);
+		}
+	}
+
+	return terms;
+}
+
+bool SystemSolverGenerator::rowsEqual(unsigned int r1, unsigned int r2, double share_tolerance) const
+{
+	for(unsigned int c = 0; c < dimension; c++)
+	{
+		const double a1 = A[dimension*r1+c];
+		const double a2 = A[dimension*r2+c];
+
+		if( isZero(a1) != isZero(a2) )
+			return false;
+
+		if( isZero(a1) )
+			continue;
+
+		if( std::fabs(a1 - a2) > share_tolerance*std::max(std::fabs(a1), std::fabs(a2)) )
+			return false;
+	}
+
+	return true;
+}
+
+std::vector<SystemSolverGenerator::Block> SystemSolverGenerator::findBlocks() const
+{
+	if(A == nullptr || dimension == 0)
+		throw std::runtime_error("SystemSolverGenerator::findBlocks(): cannot find blocks without conductance matrix and dimension set");
+
+	// union-find over rows [0,dimension) and columns [dimension,2*dimension) of G^-1;
+	// each nonzero element joins its row and column into the same block
+
+	std::vector<unsigned int> parent(2*dimension);
+	for(unsigned int i = 0; i < 2*dimension; i++)
+		parent[i] = i;
+
+	auto find = [&parent](unsigned int i)
+	{
+		while(parent[i] != i)
+		{
+			parent[i] = parent[parent[i]];
+			i = parent[i];
+		}
+		return i;
+	};
+
+	std::vector<bool> row_used(dimension, false);
+	std::vector<bool> col_used(dimension, false);
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		for(unsigned int c = 0; c < dimension; c++)
+		{
+			if( isZero(A[dimension*r+c]) )
+				continue;
+
+			row_used[r] = true;
+			col_used[c] = true;
+
+			unsigned int rr = find(r);
+			unsigned int cc = find(dimension+c);
+			if(rr != cc)
+				parent[std::max(rr,cc)] = std::min(rr,cc);
+		}
+	}
+
+	std::vector<Block> blocks;
+	std::map<unsigned int, unsigned int> block_of_root;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(!row_used[r])
+			continue;
+
+		unsigned int root = find(r);
+
+		if(block_of_root.find(root) == block_of_root.end())
+		{
+			block_of_root[root] = blocks.size();
+			blocks.push_back(Block());
+		}
+
+		blocks[block_of_root[root]].rows.push_back(r);
+	}
+
+	for(unsigned int c = 0; c < dimension; c++)
+	{
+		if(!col_used[c])
+			continue;
+
+		blocks[block_of_root.at(find(dimension+c))].cols.push_back(c);
+	}
+
+	return blocks;
+}
+
+void SystemSolverGenerator::generateCInlineCodeBlockSparse(std::string& buffer, const char* A_name, double share_tolerance) const
+{
+	if(A == nullptr || dimension == 0)
+		throw std::runtime_error("SystemSolverGenerator::generateCInlineCodeBlockSparse(): cannot generate code without conductance matrix and dimension set");
+
+	std::stringstream sstrm;
+
+	std::vector<Block> blocks = findBlocks();
+
+	sstrm << "x[0] = 0.0;\n";
+
+	std::vector<bool> row_solved(dimension, false);
+
+	for(unsigned int k = 0; k < blocks.size(); k++)
+	{
+		const Block& block = blocks[k];
+
+		sstrm << "\n//solve block " << k+1 << " of " << blocks.size() << ": "
+		      << block.rows.size() << " solutions from " << block.cols.size() << " sources\n";
+
+		for(unsigned int i = 0; i < block.rows.size(); i++)
+		{
+			const unsigned int r = block.rows[i];
+			row_solved[r] = true;
+
+			if(!isSolvedRow(r))
+				continue;
+
+			bool copied = false;
+			for(unsigned int j = 0; j < i; j++)
+			{
+				if( isSolvedRow(block.rows[j]) && rowsEqual(block.rows[j], r, share_tolerance) )
+				{
+					sstrm << "x[" << r+1 << "] = x[" << block.rows[j]+1 << "];\n";
+					copied = true;
+					break;
+				}
+			}
+
+			if(copied)
+				continue;
+
+			std::vector<SharedTerm> terms = factorRow(r, share_tolerance);
+			std::vector<std::string> term_codes;
+
+			for(const SharedTerm& term : terms)
+			{
+				std::stringstream tstrm;
+
+				tstrm << A_name << "[" << r << "][" << term.coeff_col << "]*";
+
+				if(term.sources.size() == 1)
+				{
+					tstrm << "b[" << term.sources[0].first << "]";
+					term_codes.push_back(tstrm.str());
+					continue;
+				}
+
+				if(tree_fan_in != 0)
+				{
+					std::vector<std::string> operands;
+
+					for(const auto& source : term.sources)
+						operands.push_back( (source.second ? "-b[" : "b[") + std::to_string(source.first) + "]" );
+
+					tstrm << "(" << generateTreeExpression(operands) << ")";
+					term_codes.push_back(tstrm.str());
+					continue;
+				}
+
+				tstrm << "(b[" << term.sources[0].first << "]";
+				for(unsigned int s = 1; s < term.sources.size(); s++)
+				{
+					tstrm << (term.sources[s].second ? " - " : " + ") << "b[" << term.sources[s].first << "]";
+				}
+				tstrm << ")";
+
+				term_codes.push_back(tstrm.str());
+			}
+
+			sstrm << generateRowSum(r, term_codes, A_name);
+		}
+	}
+
+	bool any_unsolved = false;
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(row_solved[r] || !isSolvedRow(r))
+			continue;
+
+		if(!any_unsolved)
+		{
+			sstrm << "\n//solutions independent of all sources\n";
+			any_unsolved = true;
+		}
+
+		sstrm << "x[" << r+1 << "] = real(0.0);\n";
+	}
+
+	buffer = sstrm.str();
+}
+
+unsigned int SystemSolverGenerator::countDenseMultiplies() const
+{
+	if(A == nullptr || dimension == 0)
+		throw std::runtime_error("SystemSolverGenerator::countDenseMultiplies(): cannot count operations without conductance matrix and dimension set");
+
+	unsigned int count = 0;
+
+	for(unsigned int i = 0; i < dimension*dimension; i++)
+	{
+		if( isSolvedRow(i/dimension) && !isZero(A[i]) )
+			count++;
+	}
+
+	return count;
+}
+
+unsigned int SystemSolverGenerator::countBlockSparseMultiplies(double share_tolerance) const
+{
+	if(A == nullptr || dimension == 0)
+		throw std::runtime_error("SystemSolverGenerator::countBlockSparseMultiplies(): cannot count operations without conductance matrix and dimension set");
+
+	unsigned int count = 0;
+
+	for(const auto& block : findBlocks())
+	{
+		for(unsigned int i = 0; i < block.rows.size(); i++)
+		{
+			if(!isSolvedRow(block.rows[i]))
+				continue;
+
+			bool copied = false;
+			for(unsigned int j = 0; j < i && !copied; j++)
+				copied = isSolvedRow(block.rows[j]) && rowsEqual(block.rows[j], block.rows[i], share_tolerance);
+
+			if(!copied)
+				count += factorRow(block.rows[i], share_tolerance).size();
+		}
+	}
+
+	return count;
+}
+
+unsigned int SystemSolverGenerator::countCriticalPathDepth(bool block_sparse, double share_tolerance) const
+{
+	if(A == nullptr || dimension == 0)
+		throw std::runtime_error("SystemSolverGenerator::countCriticalPathDepth(): cannot count operations without conductance matrix and dimension set");
+
+		// sequential additions summing n operands
+
+	auto sumDepth = [this](unsigned int n)
+	{
+		if(n <= 1)
+			return 0u;
+
+		if(tree_fan_in == 0)
+			return n-1;
+
+		unsigned int levels = 0;
+		for(unsigned int width = 1; width < n; width *= tree_fan_in)
+			levels++;
+
+		return levels;
+	};
+
+	unsigned int depth = 0;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(!isSolvedRow(r))
+			continue;
+
+		unsigned int row_depth = 0;
+
+		if(block_sparse)
+		{
+				// a shared term adds its sources before its multiplication
+
+			const std::vector<SharedTerm> terms = factorRow(r, share_tolerance);
+			unsigned int term_depth = 0;
+
+			for(const SharedTerm& term : terms)
+				term_depth = std::max<unsigned int>(term_depth, 1 + sumDepth(term.sources.size()));
+
+			if(!terms.empty())
+				row_depth = term_depth + sumDepth(terms.size());
+		}
+		else
+		{
+			unsigned int num_terms = 0;
+
+			for(unsigned int c = 0; c < dimension; c++)
+			{
+				if(!isZero(A[dimension*r+c]))
+					num_terms++;
+			}
+
+			if(num_terms != 0)
+				row_depth = 1 + sumDepth(num_terms);
+		}
+
+		depth = std::max(depth, row_depth);
+	}
+
+	return depth;
+}
+
+std::vector<std::vector<unsigned int>> SystemSolverGenerator::findSimdColumns(unsigned int width) const
+{
+	if(width == 0 || (width & (width-1)) != 0)
+		throw std::invalid_argument("SystemSolverGenerator::findSimdColumns(): width must be a power of 2");
+
+	const unsigned int num_row_blocks = (dimension + width - 1) / width;
+
+	std::vector<std::vector<unsigned int>> columns(num_row_blocks);
+
+	for(unsigned int rb = 0; rb < num_row_blocks; rb++)
+	{
+		for(unsigned int c = 0; c < dimension; c++)
+		{
+			for(unsigned int r = rb*width; r < std::min((rb+1)*width, dimension); r++)
+			{
+				if(!isZero(A[dimension*r+c]))
+				{
+					columns[rb].push_back(c);
+					break;
+				}
+			}
+		}
+	}
+
+	return columns;
+}
+
+std::string SystemSolverGenerator::generateCSimdLiteral(unsigned int width, const std::string& table_name) const
+{
+	if(A == nullptr || dimension == 0)
+		throw std::runtime_error("SystemSolverGenerator::generateCSimdLiteral(): cannot generate code without conductance matrix and dimension set");
+
+	const std::vector<std::vector<unsigned int>> columns = findSimdColumns(width);
+
+	unsigned int num_vectors = 0;
+	for(const auto& cols : columns)
+		num_vectors += cols.size();
+
+	std::stringstream sstrm;
+
+	sstrm << std::setprecision(16);
+	sstrm << std::fixed;
+	sstrm << std::scientific;
+
+	sstrm << "typedef real " << table_name << "_vec __attribute__((vector_size(" << width << "*sizeof(real))));\n\n";
+
+	if(num_vectors == 0)
+		return sstrm.str();
+
+	sstrm << "const static " << table_name << "_vec " << table_name << "[" << num_vectors << "] =\n{";
+
+	unsigned int k = 0;
+	for(unsigned int rb = 0; rb < columns.size(); rb++)
+	{
+		for(unsigned int c : columns[rb])
+		{
+			sstrm << "{";
+			for(unsigned int r = rb*width; r < (rb+1)*width; r++)
+			{
+				sstrm << (r < dimension ? A[dimension*r+c] : 0.0) << (r+1 < (rb+1)*width ? "," : "");
+			}
+			sstrm << "}" << (++k < num_vectors ? "," : "") << "\n";
+		}
+	}
+
+	sstrm << "};\n";
+
+	return sstrm.str();
+}
+
+void SystemSolverGenerator::generateCInlineCodeSimd(std::string& buffer, unsigned int width, const std::string& table_name, unsigned int num_accumulators) const
+{
+	if(A == nullptr || dimension == 0)
+		throw std::runtime_error("SystemSolverGenerator::generateCInlineCodeSimd(): cannot generate code without conductance matrix and dimension set");
+
+	if(num_accumulators == 0)
+		throw std::invalid_argument("SystemSolverGenerator::generateCInlineCodeSimd(): num_accumulators must be nonzero");
+
+	const std::vector<std::vector<unsigned int>> columns = findSimdColumns(width);
+
+	std::stringstream sstrm;
+
+	sstrm << "x[0] = 0.0;\n";
+
+	unsigned int k = 0;
+	for(unsigned int rb = 0; rb < columns.size(); rb++)
+	{
+		const unsigned int row_end = std::min((rb+1)*width, dimension);
+
+		sstrm << "\n//solve rows " << rb*width << " to " << row_end-1 << "\n";
+
+		if(columns[rb].empty())
+		{
+			for(unsigned int r = rb*width; r < row_end; r++)
+				sstrm << "x[" << r+1 << "] = real(0.0);\n";
+			continue;
+		}
+
+		const unsigned int num_acc = std::min<unsigned int>(num_accumulators, columns[rb].size());
+
+		sstrm << "{\n";
+
+		for(unsigned int i = 0; i < columns[rb].size(); i++, k++)
+		{
+			const unsigned int c = columns[rb][i];
+
+			if(i < num_acc)
+				sstrm << "\t" << table_name << "_vec acc" << i << " = " << table_name << "[" << k << "]*b[" << c << "];\n";
+			else
+				sstrm << "\tacc" << i % num_acc << " += " << table_name << "[" << k << "]*b[" << c << "];\n";
+		}
+
+		for(unsigned int step = 1; step < num_acc; step *= 2)
+		{
+			for(unsigned int a = 0; a + step < num_acc; a += 2*step)
+				sstrm << "\tacc" << a << " += acc" << a+step << ";\n";
+		}
+
+		for(unsigned int r = rb*width; r < row_end; r++)
+			sstrm << "\tx[" << r+1 << "] = acc0[" << r - rb*width << "];\n";
+
+		sstrm << "}\n";
+	}
+
+	buffer = sstrm.str();
+}
+
+unsigned int SystemSolverGenerator::countSimdMultiplies(unsigned int width) const
+{
+	if(A == nullptr || dimension == 0)
+		throw std::runtime_error("SystemSolverGenerator::countSimdMultiplies(): cannot count operations without conductance matrix and dimension set");
+
+	unsigned int count = 0;
+
+	for(const auto& cols : findSimdColumns(width))
+		count += cols.size();
+
+	return count;
+}
 
 void SystemSolverGenerator::generateCFunction(std::string& buffer, const char* solver_name,const char* A_name, const char* b_func_name) const
 {
@@ -22,6 +22,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 
 #include "codegen/SystemSourceVectorGenerator.hpp"
+#include "codegen/CodeIR.hpp"
 
 #include <cstdlib>
 #include <vector>
@@ -88,6 +89,22 @@ unsigned int SystemSourceVectorGenerator::getNumSources() const
 {
 	return src_index;
 }
+
+unsigned int SystemSourceVectorGenerator::getNumContributions(unsigned int i) const
+{
+	if(i >= dimension)
+		throw std::out_of_range("SystemSourceVectorGenerator::getNumContributions(): index i is out of bounds in source vector");
+
+	return vector[i].size();
+}
+
+const std::vector<long>& SystemSourceVectorGenerator::getContributions(unsigned int i) const
+{
+	if(i >= dimension)
+		throw std::out_of_range("SystemSourceVectorGenerator::getContributions(): index i is out of bounds in source vector");
+
+	return vector[i];
+}
 
 const std::vector<long>& SystemSourceVectorGenerator::getSourceNodesById(long source_id) const
 {
@@ -113,7 +130,7 @@ unsigned int SystemSourceVectorGenerator::insertSource(unsigned int npos, unsign
 	}
 	if(nneg != 0)
 	{
-		vector[nneg-1].push_back(-src_index);
+		vector[nneg-1].push_back(-long(src_index));
 	}
 
 	source_nodes[src_index].push_back(npos);
@@ -315,6 +332,55 @@ std::string SystemSourceVectorGenerator::asCInlineCode() const
 	return sstrm.str();
 }
 
+std::string SystemSourceVectorGenerator::asCInlineCode(const std::vector<bool>& rows) const
+{
+	if(rows.size() != dimension)
+		throw std::invalid_argument("SystemSourceVectorGenerator::asCInlineCode(): rows must have an element per source vector element");
+
+	std::stringstream sstrm;
+
+	for(unsigned int i = 0; i < dimension; i++)
+	{
+		if(!rows[i])
+			continue;
+
+		if(vector[i].empty())
+		{
+			sstrm << "b[" << i << "] = 0.0;\n";
+			continue;
+		}
+
+		sstrm << "b[" << i << "] = ";
+
+		for(unsigned int k = 0; k < vector[i].size(); k++)
+		{
+			const long id = vector[i][k];
+
+			if(id >= 0)
+				sstrm << " b_components[" << id-1 << "] ";
+			else
+				sstrm << " -b_components[" << -id-1 << "] ";
+
+			sstrm << ((k+1 == vector[i].size()) ? ";\n" : "+");
+		}
+	}
+
+	return sstrm.str();
+}
+
+void SystemSourceVectorGenerator::generateCodeIR(CodeIR& ir, unsigned int b_array, unsigned int b_components_array) const
+{
+	for(unsigned int i = 0; i < dimension; i++)
+	{
+		std::vector<CodeIR::Term> terms;
+
+		for(const long id : vector[i])
+			terms.push_back(CodeIR::Term::of(ir.getElement(b_components_array, std::abs(id)-1), id < 0));
+
+		ir.insertAssignment(ir.getElement(b_array, i), std::move(terms));
+	}
+}
+
 void SystemSourceVectorGenerator::exportAsCFunctionSource(const char* filename, const char* func_name) const
 {
 	std::fstream file;
@@ -26,7 +26,6 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -131,8 +130,8 @@ void BridgeConverter3LegIdealSwitches::stampSources(SystemSourceVectorGenerator&
 
 std::string BridgeConverter3LegIdealSwitches::generateParameters()
 {
-	const static double HOC = DT/CAP;
-	const static double HOL = DT/IND;
+	const double HOC = DT/CAP;
+	const double HOL = DT/IND;
 
 	std::stringstream sstrm;
 	sstrm <<
@@ -512,120 +511,120 @@ std::string BridgeConverter3LegIdealSwitches::generateUpdateBody()
 
 		//specialize converter update body code for component instance
 
-	std::string body = HALFBRIDGECONVERTER3PHASE_GENERATEUPDATEBODY_BASE_STRING;
-	lblmc::StringProcessor str_proc(body);
+	static const CodeTemplate update_template(HALFBRIDGECONVERTER3PHASE_GENERATEUPDATEBODY_BASE_STRING);
+	CodeTemplate::Substitutions subs;
 
 		//specialize data type
 
-	str_proc.replaceWordAll("NumType", "real");
+	subs.set("NumType", "real");
 
 		//specialize constant parameters
 
-	str_proc.replaceWordAll("cap_conduct", appendName("CAP_CONDUCTANCE") );
-	str_proc.replaceWordAll("dt", appendName("DT") );
-	str_proc.replaceWordAll("cap", appendName("CAP") );
-	str_proc.replaceWordAll("ind", appendName("IND") );
-	str_proc.replaceWordAll("res", appendName("RES") );
-	str_proc.replaceWordAll("hol", appendName("HOL") );
-	str_proc.replaceWordAll("hoc", appendName("HOC") );
+	subs.set("cap_conduct", appendName("CAP_CONDUCTANCE") );
+	subs.set("dt", appendName("DT") );
+	subs.set("cap", appendName("CAP") );
+	subs.set("ind", appendName("IND") );
+	subs.set("res", appendName("RES") );
+	subs.set("hol", appendName("HOL") );
+	subs.set("hoc", appendName("HOC") );
 
 		//specialize internal temp parameters
-	str_proc.replaceWordAll("a1", appendName("a1") );
-	str_proc.replaceWordAll("a2", appendName("a2") );
-	str_proc.replaceWordAll("a3", appendName("a3") );
-	str_proc.replaceWordAll("b1", appendName("b1") );
-	str_proc.replaceWordAll("b2", appendName("b2") );
-	str_proc.replaceWordAll("b3", appendName("b3") );
-	str_proc.replaceWordAll("a", appendName("a") );
-	str_proc.replaceWordAll("b", appendName("b") );
-	str_proc.replaceWordAll("c", appendName("c") );
+	subs.set("a1", appendName("a1") );
+	subs.set("a2", appendName("a2") );
+	subs.set("a3", appendName("a3") );
+	subs.set("b1", appendName("b1") );
+	subs.set("b2", appendName("b2") );
+	subs.set("b3", appendName("b3") );
+	subs.set("a", appendName("a") );
+	subs.set("b", appendName("b") );
+	subs.set("c", appendName("c") );
 
 		//specialize states and fields
-	str_proc.replaceWordAll("vc1", appendName("vc1") );
-	str_proc.replaceWordAll("vc2", appendName("vc2") );
-	str_proc.replaceWordAll("il1", appendName("il1") );
-	str_proc.replaceWordAll("il2", appendName("il2") );
-	str_proc.replaceWordAll("il3", appendName("il3") );
-	str_proc.replaceWordAll("ipos", appendName("ipos") );
-	str_proc.replaceWordAll("ineg", appendName("ineg") );
-	str_proc.replaceWordAll("epos_past", appendName("epos_past") );
-	str_proc.replaceWordAll("eneu_past", appendName("eneu_past") );
-	str_proc.replaceWordAll("eneg_past", appendName("eneg_past") );
-	str_proc.replaceWordAll("eout1_past", appendName("eout1_past") );
-	str_proc.replaceWordAll("eout2_past", appendName("eout2_past") );
-	str_proc.replaceWordAll("eout3_past", appendName("eout3_past") );
-	str_proc.replaceWordAll("vc1_past", appendName("vc1_past") );
-	str_proc.replaceWordAll("vc2_past", appendName("vc2_past") );
-	str_proc.replaceWordAll("il1_past", appendName("il1_past") );
-	str_proc.replaceWordAll("il2_past", appendName("il2_past") );
-	str_proc.replaceWordAll("il3_past", appendName("il3_past") );
-	str_proc.replaceWordAll("sw1", appendName("sw1") );
-	str_proc.replaceWordAll("sw2", appendName("sw2") );
-	str_proc.replaceWordAll("sw3", appendName("sw3") );
+	subs.set("vc1", appendName("vc1") );
+	subs.set("vc2", appendName("vc2") );
+	subs.set("il1", appendName("il1") );
+	subs.set("il2", appendName("il2") );
+	subs.set("il3", appendName("il3") );
+	subs.set("ipos", appendName("ipos") );
+	subs.set("ineg", appendName("ineg") );
+	subs.set("epos_past", appendName("epos_past") );
+	subs.set("eneu_past", appendName("eneu_past") );
+	subs.set("eneg_past", appendName("eneg_past") );
+	subs.set("eout1_past", appendName("eout1_past") );
+	subs.set("eout2_past", appendName("eout2_past") );
+	subs.set("eout3_past", appendName("eout3_past") );
+	subs.set("vc1_past", appendName("vc1_past") );
+	subs.set("vc2_past", appendName("vc2_past") );
+	subs.set("il1_past", appendName("il1_past") );
+	subs.set("il2_past", appendName("il2_past") );
+	subs.set("il3_past", appendName("il3_past") );
+	subs.set("sw1", appendName("sw1") );
+	subs.set("sw2", appendName("sw2") );
+	subs.set("sw3", appendName("sw3") );
 
 		//specialize solution inputs and outputs
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<P<<"]";
-	str_proc.replaceWordAll("epos", sstrm.str());
+	subs.set("epos", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<G<<"]";
-	str_proc.replaceWordAll("eneu", sstrm.str());
+	subs.set("eneu", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<N<<"]";
-	str_proc.replaceWordAll("eneg", sstrm.str());
+	subs.set("eneg", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<A<<"]";
-	str_proc.replaceWordAll("eout1", sstrm.str());
+	subs.set("eout1", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<B<<"]";
-	str_proc.replaceWordAll("eout2", sstrm.str());
+	subs.set("eout2", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<C<<"]";
-	str_proc.replaceWordAll("eout3", sstrm.str());
+	subs.set("eout3", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_P-1<<"]";
-	str_proc.replaceWordAll("*bpos", sstrm.str());
+	subs.set("*bpos", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_N-1<<"]";
-	str_proc.replaceWordAll("*bneg", sstrm.str());
+	subs.set("*bneg", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_A-1<<"]";
-	str_proc.replaceWordAll("*bout1", sstrm.str());
+	subs.set("*bout1", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_B-1<<"]";
-	str_proc.replaceWordAll("*bout2", sstrm.str());
+	subs.set("*bout2", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_C-1<<"]";
-	str_proc.replaceWordAll("*bout3", sstrm.str());
+	subs.set("*bout3", sstrm.str());
 
 		//specialize signal inputs and outputs
-	str_proc.replaceWordAll("sw_ctrl1", appendName("sw_ctrl")+std::string("[0]"));
-	str_proc.replaceWordAll("sw_ctrl2", appendName("sw_ctrl")+std::string("[1]"));
-	str_proc.replaceWordAll("sw_ctrl3", appendName("sw_ctrl")+std::string("[2]"));
-	str_proc.replaceWordAll("sw_en", appendName("sw_en"));
+	subs.set("sw_ctrl1", appendName("sw_ctrl")+std::string("[0]"));
+	subs.set("sw_ctrl2", appendName("sw_ctrl")+std::string("[1]"));
+	subs.set("sw_ctrl3", appendName("sw_ctrl")+std::string("[2]"));
+	subs.set("sw_en", appendName("sw_en"));
 
-	return body;
+	return update_template.substitute(subs);
 }
 
 std::string BridgeConverter3LegIdealSwitches::generateCPVoltageOutputUpdateBody()
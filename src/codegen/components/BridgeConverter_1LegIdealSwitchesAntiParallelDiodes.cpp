@@ -26,7 +26,6 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -463,14 +462,14 @@ std::string BridgeConverter_1LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 
 		//specialize converter update body code for component instance
 
-	std::string body = BRIDGECONVERTER1LEGIDEALSWITCHESANTIPARALLELDIODES_GENERATEUPDATEBODY_BASE_STRING;
-	StringProcessor str_proc(body);
+	static const CodeTemplate update_template(BRIDGECONVERTER1LEGIDEALSWITCHESANTIPARALLELDIODES_GENERATEUPDATEBODY_BASE_STRING);
+	CodeTemplate::Substitutions subs;
 
 		//specialize constant parameters
 
 	appendNameToWords
 	(
-		body,
+		subs,
 		{
 			"DT"  ,
 			"RIN" ,
@@ -488,7 +487,7 @@ std::string BridgeConverter_1LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 
 	appendNameToWords
 	(
-		body,
+		subs,
 		{
 			"vcp_past",
 			"vcn_past",
@@ -529,20 +528,20 @@ std::string BridgeConverter_1LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 
 		//specialize solution and source contribution access
 
-    replaceTerminalConnectionNameWithIndex(body, "P", P);
-    replaceTerminalConnectionNameWithIndex(body, "G", G);
-    replaceTerminalConnectionNameWithIndex(body, "N", N);
-    replaceTerminalConnectionNameWithIndex(body, "A", A);
+    replaceTerminalConnectionNameWithIndex(subs, "P", P);
+    replaceTerminalConnectionNameWithIndex(subs, "G", G);
+    replaceTerminalConnectionNameWithIndex(subs, "N", N);
+    replaceTerminalConnectionNameWithIndex(subs, "A", A);
 
-	replaceSourceNameWithSourceContributionVector(body, "bpos", source_id_P);
-	replaceSourceNameWithSourceContributionVector(body, "bneg", source_id_N);
-	replaceSourceNameWithSourceContributionVector(body, "bouta", source_id_A);
+	replaceSourceNameWithSourceContributionVector(subs, "bpos", source_id_P);
+	replaceSourceNameWithSourceContributionVector(subs, "bneg", source_id_N);
+	replaceSourceNameWithSourceContributionVector(subs, "bouta", source_id_A);
 
 		//specialize signal inputs and outputs
 
 	appendNameToWords
 	(
-		body,
+		subs,
 		{
 			"switch_gates",
 			"positive_capacitor_voltage",
@@ -551,7 +550,7 @@ std::string BridgeConverter_1LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 		}
 	);
 
-	return body;
+	return update_template.substitute(subs);
 }
 
 } //namespace lblmc
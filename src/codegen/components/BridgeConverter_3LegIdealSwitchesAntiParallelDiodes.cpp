@@ -26,7 +26,6 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -693,14 +692,14 @@ std::string BridgeConverter_3LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 
 		//specialize converter update body code for component instance
 
-	std::string body = BRIDGECONVERTER3LEGIDEALSWITCHESANTIPARALLELDIODES_GENERATEUPDATEBODY_BASE_STRING;
-	StringProcessor str_proc(body);
+	static const CodeTemplate update_template(BRIDGECONVERTER3LEGIDEALSWITCHESANTIPARALLELDIODES_GENERATEUPDATEBODY_BASE_STRING);
+	CodeTemplate::Substitutions subs;
 
 		//specialize constant parameters
 
 	appendNameToWords
 	(
-		body,
+		subs,
 		{
 			"DT"  ,
 			"RIN" ,
@@ -718,7 +717,7 @@ std::string BridgeConverter_3LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 
 	appendNameToWords
 	(
-		body,
+		subs,
 		{
 			"vcp_past",
 			"vcn_past",
@@ -809,24 +808,24 @@ std::string BridgeConverter_3LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 
 		//specialize solution and source contribution access
 
-    replaceTerminalConnectionNameWithIndex(body, "P", P);
-    replaceTerminalConnectionNameWithIndex(body, "G", G);
-    replaceTerminalConnectionNameWithIndex(body, "N", N);
-    replaceTerminalConnectionNameWithIndex(body, "A", A);
-    replaceTerminalConnectionNameWithIndex(body, "B", B);
-    replaceTerminalConnectionNameWithIndex(body, "Ct", Ct);
+    replaceTerminalConnectionNameWithIndex(subs, "P", P);
+    replaceTerminalConnectionNameWithIndex(subs, "G", G);
+    replaceTerminalConnectionNameWithIndex(subs, "N", N);
+    replaceTerminalConnectionNameWithIndex(subs, "A", A);
+    replaceTerminalConnectionNameWithIndex(subs, "B", B);
+    replaceTerminalConnectionNameWithIndex(subs, "Ct", Ct);
 
-	replaceSourceNameWithSourceContributionVector(body, "bpos", source_id_P);
-	replaceSourceNameWithSourceContributionVector(body, "bneg", source_id_N);
-	replaceSourceNameWithSourceContributionVector(body, "bouta", source_id_A);
-	replaceSourceNameWithSourceContributionVector(body, "boutb", source_id_B);
-	replaceSourceNameWithSourceContributionVector(body, "boutc", source_id_C);
+	replaceSourceNameWithSourceContributionVector(subs, "bpos", source_id_P);
+	replaceSourceNameWithSourceContributionVector(subs, "bneg", source_id_N);
+	replaceSourceNameWithSourceContributionVector(subs, "bouta", source_id_A);
+	replaceSourceNameWithSourceContributionVector(subs, "boutb", source_id_B);
+	replaceSourceNameWithSourceContributionVector(subs, "boutc", source_id_C);
 
 		//specialize signal inputs and outputs
 
 	appendNameToWords
 	(
-		body,
+		subs,
 		{
 			"switch_gates",
 			"positive_capacitor_voltage",
@@ -837,7 +836,7 @@ std::string BridgeConverter_3LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 		}
 	);
 
-	return body;
+	return update_template.substitute(subs);
 }
 
 } //namespace lblmc
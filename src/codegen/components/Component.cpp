@@ -25,9 +25,9 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SystemConductanceGenerator.hpp"
 #include "codegen/SystemSolverGenerator.hpp"
 #include "codegen/SolverEngineGenerator.hpp"
-#include "codegen/StringProcessor.hpp"
 
 #include <sstream>
+#include <utility>
 
 namespace lblmc
 {
@@ -41,64 +41,106 @@ const std::string Component::INTEGRATION_RUNGE_KUTTA_4  = "runge_kutta_4";
 
 void Component::stampSystem(SolverEngineGenerator& gen, const std::vector<std::string>& outputs)
 {
-	std::string buf;
 	SystemConductanceGenerator& scg = gen.getConductanceGenerator();
 	SystemSourceVectorGenerator& ssvg = gen.getSourceVectorGenerator();
 
 	stampConductance(scg);
 	stampSources(ssvg);
-	buf = generateParameters();
-	gen.insertComponentParametersCode(buf);
 
-	buf = generateFields();
-	gen.insertComponentFieldsCode(buf);
+	GeneratedCode code = generateCode(outputs);
+	insertCode(gen, code);
+}
+
+Component::GeneratedCode Component::generateCode(const std::vector<std::string>& outputs)
+{
+	GeneratedCode code;
 
-	buf = generateInputs();
-	gen.insertComponentInputsCode(buf);
+	code.parameters = generateParameters();
+	code.fields = generateFields();
+	code.inputs = generateInputs();
 
 	for(auto output : outputs)
 	{
-		buf = generateOutputs(output);
-		gen.insertComponentOutputsCode(buf);
+		code.outputs.push_back( generateOutputs(output) );
+		code.outputs_update_bodies.push_back( generateOutputsUpdateBody(output) );
+	}
+
+	code.update_body = generateUpdateBody();
+
+	return code;
+}
 
-		buf = generateOutputsUpdateBody(output);
-		gen.insertComponentOutputsUpdateBody(buf);
+void Component::insertCode(SolverEngineGenerator& gen, GeneratedCode& code) const
+{
+	gen.insertComponentParametersCode(code.parameters);
+	gen.insertComponentFieldsCode(code.fields);
+	gen.insertComponentInputsCode(code.inputs);
+
+	for(unsigned int i = 0; i < code.outputs.size(); i++)
+	{
+		gen.insertComponentOutputsCode(code.outputs[i]);
+		gen.insertComponentOutputsUpdateBody(code.outputs_update_bodies[i]);
 	}
 
-	buf = generateUpdateBody();
-	gen.insertComponentUpdateBody(buf);
+	gen.insertComponentUpdateBody(code.update_body, rate_divisor, rate_phase);
 }
 
 std::string& Component::appendNameToWords(std::string& body, const std::vector<std::string>& words) const
 {
-	StringProcessor str_proc(body);
+	CodeTemplate::Substitutions subs;
+	appendNameToWords(subs, words);
+
+	body = CodeTemplate(std::move(body)).substitute(subs);
+
+	return body;
+}
 
+CodeTemplate::Substitutions& Component::appendNameToWords(CodeTemplate::Substitutions& subs, const std::vector<std::string>& words) const
+{
 	for(const auto& word : words)
 	{
-		str_proc.replaceWordAll(word, appendName(word));
+		subs.set(word, appendName(word));
 	}
 
-	return body;
+	return subs;
 }
 
 std::string& Component::replaceSourceNameWithSourceContributionVector(std::string& body, const std::string& src_name, unsigned int source_id )
 {
-	StringProcessor str_proc(body);
+	CodeTemplate::Substitutions subs;
+	replaceSourceNameWithSourceContributionVector(subs, src_name, source_id);
+
+	body = CodeTemplate(std::move(body)).substitute(subs);
+
+	return body;
+}
+
+CodeTemplate::Substitutions& Component::replaceSourceNameWithSourceContributionVector(CodeTemplate::Substitutions& subs, const std::string& src_name, unsigned int source_id ) const
+{
 	std::stringstream sstrm;
 	sstrm << "b_components["<<source_id-1<<"]";
-	str_proc.replaceWordAll(src_name, sstrm.str());
+	subs.set(src_name, sstrm.str());
 
-	return body;
+	return subs;
 }
 
 std::string& Component::replaceTerminalConnectionNameWithIndex(std::string& body, const std::string& term_name, unsigned int index)
 {
-	StringProcessor str_proc(body);
-	str_proc.replaceWordAll(term_name, std::to_string(index));
+	CodeTemplate::Substitutions subs;
+	replaceTerminalConnectionNameWithIndex(subs, term_name, index);
+
+	body = CodeTemplate(std::move(body)).substitute(subs);
 
 	return body;
 }
 
+CodeTemplate::Substitutions& Component::replaceTerminalConnectionNameWithIndex(CodeTemplate::Substitutions& subs, const std::string& term_name, unsigned int index) const
+{
+	subs.set(term_name, std::to_string(index));
+
+	return subs;
+}
+
 
 
 } //namespace lblmc
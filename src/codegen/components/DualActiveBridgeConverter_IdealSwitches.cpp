@@ -26,7 +26,6 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -517,13 +516,14 @@ R"(
 
 std::string DualActiveBridgeConverter_IdealSwitches::generateUpdateBody()
 {
-	std::string body = DUALACTIVEBRIDGECONVERTER_IDEALSWITCHES_GENERATEUPDATEBODY_BASE_STRING;
+	static const CodeTemplate update_template(DUALACTIVEBRIDGECONVERTER_IDEALSWITCHES_GENERATEUPDATEBODY_BASE_STRING);
+	CodeTemplate::Substitutions subs;
 
 	//specialize code for instance of this component
 
 	appendNameToWords
 	(
-		body,
+		subs,
 
 		{
 				//constants/parameters
@@ -593,16 +593,16 @@ std::string DualActiveBridgeConverter_IdealSwitches::generateUpdateBody()
 		}
 	);
 
-	replaceTerminalConnectionNameWithIndex(body, "P1", P1);
-	replaceTerminalConnectionNameWithIndex(body, "N1", N1);
-	replaceTerminalConnectionNameWithIndex(body, "P2", P2);
-	replaceTerminalConnectionNameWithIndex(body, "N2", N2);
+	replaceTerminalConnectionNameWithIndex(subs, "P1", P1);
+	replaceTerminalConnectionNameWithIndex(subs, "N1", N1);
+	replaceTerminalConnectionNameWithIndex(subs, "P2", P2);
+	replaceTerminalConnectionNameWithIndex(subs, "N2", N2);
 
-	replaceSourceNameWithSourceContributionVector(body, "b1", source_id1);
-	replaceSourceNameWithSourceContributionVector(body, "b2", source_id2);
+	replaceSourceNameWithSourceContributionVector(subs, "b1", source_id1);
+	replaceSourceNameWithSourceContributionVector(subs, "b2", source_id2);
 
 
-	return body;
+	return update_template.substitute(subs);
 }
 
 
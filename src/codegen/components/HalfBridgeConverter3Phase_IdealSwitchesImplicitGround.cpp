@@ -116,8 +116,8 @@ void HalfBridgeConverter3Phase_IdealSwitchesImplicitGround::stampSources(SystemS
 
 std::string HalfBridgeConverter3Phase_IdealSwitchesImplicitGround::generateParameters()
 {
-	const static double HOC = DT/CAP;
-	const static double HOL = DT/IND;
+	const double HOC = DT/CAP;
+	const double HOL = DT/IND;
 
 	std::stringstream sstrm;
 	sstrm <<
@@ -26,7 +26,6 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -602,18 +601,18 @@ std::string ModularMultilevelConverter_HalfBridgeModules::generateUpdateBody()
 
 		//specialize converter update body code for component instance
 
-	std::string body = MODULARMULTILEVELCONVERTER_HALFBRIDGEMODULES_GENERATEUPDATEBODY_BASE_STRING;
-	StringProcessor str_proc(body);
+	static const CodeTemplate update_template(MODULARMULTILEVELCONVERTER_HALFBRIDGEMODULES_GENERATEUPDATEBODY_BASE_STRING);
+	CodeTemplate::Substitutions subs;
 
 		//specialize data type
 
-	str_proc.replaceWordAll("real", "real");
+	subs.set("real", "real");
 
 		//specialize constant parameters
 
 	appendNameToWords
 	(
-		body,
+		subs,
 		{
 			"MMC_LEVELS",
 			"DT",
@@ -636,7 +635,7 @@ std::string ModularMultilevelConverter_HalfBridgeModules::generateUpdateBody()
 
 	appendNameToWords
 	(
-		body,
+		subs,
 		{
 			"upa",
 			"upb",
@@ -651,7 +650,7 @@ std::string ModularMultilevelConverter_HalfBridgeModules::generateUpdateBody()
 
 	appendNameToWords
 	(
-		body,
+		subs,
 		{
 			"Rpre",
 			"a",
@@ -689,42 +688,42 @@ std::string ModularMultilevelConverter_HalfBridgeModules::generateUpdateBody()
 
 		//specialize solution inputs and outputs
 
-	str_proc.replaceWordAll("P", std::to_string(P));
-	str_proc.replaceWordAll("N", std::to_string(N));
-	str_proc.replaceWordAll("A", std::to_string(A));
-	str_proc.replaceWordAll("B", std::to_string(B));
-	str_proc.replaceWordAll("C", std::to_string(C));
+	subs.set("P", std::to_string(P));
+	subs.set("N", std::to_string(N));
+	subs.set("A", std::to_string(A));
+	subs.set("B", std::to_string(B));
+	subs.set("C", std::to_string(C));
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_P-1<<"]";
-	str_proc.replaceWordAll("*bpos", sstrm.str());
+	subs.set("*bpos", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_N-1<<"]";
-	str_proc.replaceWordAll("*bneg", sstrm.str());
+	subs.set("*bneg", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_A-1<<"]";
-	str_proc.replaceWordAll("*bout1", sstrm.str());
+	subs.set("*bout1", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_B-1<<"]";
-	str_proc.replaceWordAll("*bout2", sstrm.str());
+	subs.set("*bout2", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_C-1<<"]";
-	str_proc.replaceWordAll("*bout3", sstrm.str());
+	subs.set("*bout3", sstrm.str());
 
 		//specialize signal inputs and outputs
 
 	appendNameToWords
 	(
-		body,
+		subs,
 		{
 			"swp",
 			"Sa",
@@ -733,7 +732,7 @@ std::string ModularMultilevelConverter_HalfBridgeModules::generateUpdateBody()
 		}
 	);
 
-	return body;
+	return update_template.substitute(subs);
 }
 
 } //namespace lblmc
@@ -26,7 +26,6 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -216,73 +215,73 @@ std::string MutualInductance3::generateUpdateBody()
 	std::fixed <<
 	std::scientific;
 
-	std::string body = MUTUALINDUCTANCE3_GENERATEUPDATEBODY_BASE_STRING;
-	lblmc::StringProcessor proc(body);
-
-	proc.replaceWordAll("D", appendName("D") );
-	proc.replaceWordAll("K1", appendName("K1") );
-	proc.replaceWordAll("K2", appendName("K2") );
-	proc.replaceWordAll("K3", appendName("K3") );
-	proc.replaceWordAll("K4", appendName("K4") );
-	proc.replaceWordAll("K5", appendName("K5") );
-	proc.replaceWordAll("K6", appendName("K6") );
-	proc.replaceWordAll("K7", appendName("K7") );
-	proc.replaceWordAll("K8", appendName("K8") );
-	proc.replaceWordAll("K9", appendName("K9") );
-
-	proc.replaceWordAll("current_comp1", appendName("current_comp1") );
-	proc.replaceWordAll("current_comp2", appendName("current_comp2") );
-	proc.replaceWordAll("current_comp3", appendName("current_comp3") );
-	proc.replaceWordAll("voltage1", appendName("voltage1") );
-	proc.replaceWordAll("voltage2", appendName("voltage2") );
-	proc.replaceWordAll("voltage3", appendName("voltage3") );
+	static const CodeTemplate update_template(MUTUALINDUCTANCE3_GENERATEUPDATEBODY_BASE_STRING);
+	CodeTemplate::Substitutions subs;
+
+	subs.set("D", appendName("D") );
+	subs.set("K1", appendName("K1") );
+	subs.set("K2", appendName("K2") );
+	subs.set("K3", appendName("K3") );
+	subs.set("K4", appendName("K4") );
+	subs.set("K5", appendName("K5") );
+	subs.set("K6", appendName("K6") );
+	subs.set("K7", appendName("K7") );
+	subs.set("K8", appendName("K8") );
+	subs.set("K9", appendName("K9") );
+
+	subs.set("current_comp1", appendName("current_comp1") );
+	subs.set("current_comp2", appendName("current_comp2") );
+	subs.set("current_comp3", appendName("current_comp3") );
+	subs.set("voltage1", appendName("voltage1") );
+	subs.set("voltage2", appendName("voltage2") );
+	subs.set("voltage3", appendName("voltage3") );
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<PA<<"]";
-	proc.replaceWordAll("epos1", sstrm.str());
+	subs.set("epos1", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<NA<<"]";
-	proc.replaceWordAll("eneg1", sstrm.str());
+	subs.set("eneg1", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<PB<<"]";
-	proc.replaceWordAll("epos2", sstrm.str());
+	subs.set("epos2", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<NB<<"]";
-	proc.replaceWordAll("eneg2", sstrm.str());
+	subs.set("eneg2", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<PC<<"]";
-	proc.replaceWordAll("epos3", sstrm.str());
+	subs.set("epos3", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<NC<<"]";
-	proc.replaceWordAll("eneg3", sstrm.str());
+	subs.set("eneg3", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_A-1<<"]";
-	proc.replaceWordAll("*bout1", sstrm.str());
+	subs.set("*bout1", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_B-1<<"]";
-	proc.replaceWordAll("*bout2", sstrm.str());
+	subs.set("*bout2", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_C-1<<"]";
-	proc.replaceWordAll("*bout3", sstrm.str());
+	subs.set("*bout3", sstrm.str());
 
-	return body;
+	return update_template.substitute(subs);
 }
 
 } //namespace lblmc
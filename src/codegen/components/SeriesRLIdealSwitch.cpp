@@ -26,7 +26,6 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -107,7 +106,7 @@ std::string SeriesRLIdealSwitch::generateParameters()
 
 			// dx/dt (t) = -R/L*x(t) + 1/L*u(t)
 			// x(t+dt) = x(t) + HOL*( u(t) - R*x(t) )
-		const static double HOL = DT/L;
+		const double HOL = DT/L;
 		generateParameter(sstrm, "DT", DT);
 		generateParameter(sstrm, "L", L);
 		generateParameter(sstrm, "R", R);
@@ -118,18 +117,18 @@ std::string SeriesRLIdealSwitch::generateParameters()
 
 			// dx/dt (t) = A0*x(t) + B0*u(t)
 			// x(t+dt) = ARK4*x(t) + BRK4*u(t)
-		const static double A0 = -R/L;
-		const static double B0 = 1.0/L;
-		const static double A1 = DT*A0;
-		const static double B1 = DT*B0;
-		const static double A2 = DT*A0 + 0.5*DT*A0*A1;
-		const static double A3 = DT*A0 + 0.5*DT*A0*A2;
-		const static double A4 = DT*A0 + 1.0*DT*A0*A3;
-		const static double B2 = DT*B0 + 0.5*DT*A0*B1;
-		const static double B3 = DT*B0 + 0.5*DT*A0*B2;
-		const static double B4 = DT*B0 + 1.0*DT*A0*B3;
-		const static double ARK4 = 1.0 + (1.0/6.0)*A1 + (1.0/3.0)*A2 + (1.0/3.0)*A3 + (1.0/6.0)*A4;
-		const static double BRK4 = 0.0 + (1.0/6.0)*B1 + (1.0/3.0)*B2 + (1.0/3.0)*B3 + (1.0/6.0)*B4;
+		const double A0 = -R/L;
+		const double B0 = 1.0/L;
+		const double A1 = DT*A0;
+		const double B1 = DT*B0;
+		const double A2 = DT*A0 + 0.5*DT*A0*A1;
+		const double A3 = DT*A0 + 0.5*DT*A0*A2;
+		const double A4 = DT*A0 + 1.0*DT*A0*A3;
+		const double B2 = DT*B0 + 0.5*DT*A0*B1;
+		const double B3 = DT*B0 + 0.5*DT*A0*B2;
+		const double B4 = DT*B0 + 1.0*DT*A0*B3;
+		const double ARK4 = 1.0 + (1.0/6.0)*A1 + (1.0/3.0)*A2 + (1.0/3.0)*A3 + (1.0/6.0)*A4;
+		const double BRK4 = 0.0 + (1.0/6.0)*B1 + (1.0/3.0)*B2 + (1.0/3.0)*B3 + (1.0/6.0)*B4;
 
 		generateParameter(sstrm, "DT", DT);
 		generateParameter(sstrm, "ARK4", ARK4);
@@ -261,37 +260,37 @@ std::string SeriesRLIdealSwitch::generateUpdateBodyEulerForward()
 	std::fixed <<
 	std::scientific;
 
-	std::string body = SERIESRLIDEALSWITCH_GENERATEUPDATEBODY_BASE_EF_STRING;
-	lblmc::StringProcessor str_proc(body);
+	static const CodeTemplate update_template(SERIESRLIDEALSWITCH_GENERATEUPDATEBODY_BASE_EF_STRING);
+	CodeTemplate::Substitutions subs;
 
-	str_proc.replaceWordAll("NumType", "real");
+	subs.set("NumType", "real");
 
-	str_proc.replaceWordAll("HOL", appendName("HOL"));
-	str_proc.replaceWordAll("R", appendName("R"));
-	str_proc.replaceWordAll("L", appendName("L"));
-	str_proc.replaceWordAll("DT", appendName("DT"));
+	subs.set("HOL", appendName("HOL"));
+	subs.set("R", appendName("R"));
+	subs.set("L", appendName("L"));
+	subs.set("DT", appendName("DT"));
 
-	str_proc.replaceWordAll("sw_past", appendName("sw_past"));
-	str_proc.replaceWordAll("current", appendName("current"));
-	str_proc.replaceWordAll("current_past", appendName("current_past"));
-	str_proc.replaceWordAll("sw", appendName("sw"));
+	subs.set("sw_past", appendName("sw_past"));
+	subs.set("current", appendName("current"));
+	subs.set("current_past", appendName("current_past"));
+	subs.set("sw", appendName("sw"));
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<P<<"]";
-	str_proc.replaceWordAll("epos", sstrm.str());
+	subs.set("epos", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<N<<"]";
-	str_proc.replaceWordAll("eneg", sstrm.str());
+	subs.set("eneg", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id-1<<"]";
-	str_proc.replaceWordAll("*bout", sstrm.str());
+	subs.set("*bout", sstrm.str());
 
-	return body;
+	return update_template.substitute(subs);
 }
 
 std::string SeriesRLIdealSwitch::generateUpdateBodyRungeKutta4()
@@ -302,35 +301,35 @@ std::string SeriesRLIdealSwitch::generateUpdateBodyRungeKutta4()
 	std::fixed <<
 	std::scientific;
 
-	std::string body = SERIESRLIDEALSWITCH_GENERATEUPDATEBODY_BASE_RK4_STRING;
-	lblmc::StringProcessor str_proc(body);
+	static const CodeTemplate update_template(SERIESRLIDEALSWITCH_GENERATEUPDATEBODY_BASE_RK4_STRING);
+	CodeTemplate::Substitutions subs;
 
-	str_proc.replaceWordAll("NumType", "real");
+	subs.set("NumType", "real");
 
-	str_proc.replaceWordAll("ARK4", appendName("ARK4"));
-	str_proc.replaceWordAll("BRK4", appendName("BRK4"));
+	subs.set("ARK4", appendName("ARK4"));
+	subs.set("BRK4", appendName("BRK4"));
 
-	str_proc.replaceWordAll("sw_past", appendName("sw_past"));
-	str_proc.replaceWordAll("current", appendName("current"));
-	str_proc.replaceWordAll("current_past", appendName("current_past"));
-	str_proc.replaceWordAll("sw", appendName("sw"));
+	subs.set("sw_past", appendName("sw_past"));
+	subs.set("current", appendName("current"));
+	subs.set("current_past", appendName("current_past"));
+	subs.set("sw", appendName("sw"));
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<P<<"]";
-	str_proc.replaceWordAll("epos", sstrm.str());
+	subs.set("epos", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<N<<"]";
-	str_proc.replaceWordAll("eneg", sstrm.str());
+	subs.set("eneg", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id-1<<"]";
-	str_proc.replaceWordAll("*bout", sstrm.str());
+	subs.set("*bout", sstrm.str());
 
-	return body;
+	return update_template.substitute(subs);
 }
 
 } //namespace lblmc
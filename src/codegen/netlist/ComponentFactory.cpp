@@ -21,6 +21,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 */
 
 #include "codegen/netlist/ComponentFactory.hpp"
+#include "codegen/ParallelFor.hpp"
 #include <stdexcept>
 
 namespace lblmc
@@ -83,7 +84,25 @@ ComponentFactory::ComponentPtr ComponentFactory::produceComponent(const Componen
 {
 	const auto& producer = *(getComponentProducer(listing.getType()));
 
-	return std::move(producer(listing));
+	ComponentPtr component = producer(listing);
+	component->setRate(listing.getRateDivisor(), listing.getRatePhase());
+
+	return component;
+}
+
+std::vector<ComponentFactory::ComponentPtr> ComponentFactory::produceComponents(const std::vector<ComponentListing>& listings, unsigned int num_threads)
+{
+	std::vector<ComponentPtr> components(listings.size());
+
+		// the producers and registry are only read, so components are produced concurrently
+
+	parallelFor(listings.size(), num_threads, [&](unsigned int, unsigned int begin, unsigned int end)
+	{
+		for(unsigned int c = begin; c < end; c++)
+			components[c] = produceComponent(listings[c]);
+	});
+
+	return components;
 }
 
 } //namespace lblmc
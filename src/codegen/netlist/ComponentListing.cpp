@@ -25,6 +25,8 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include <stdexcept>
 #include <algorithm>
 #include <utility>
+#include <cstdlib>
+#include <cerrno>
 #include "codegen/StringProcessor.hpp"
 #include "codegen/netlist/ComponentListing.hpp"
 
@@ -37,21 +39,27 @@ ComponentListing::ComponentListing() :
 	type(),
 	label(),
 	parameters(),
-	terminal_connections()
+	terminal_connections(),
+	rate_divisor(1),
+	rate_phase(0)
 {}
 
 ComponentListing::ComponentListing(const ComponentListing& base) :
 	type(base.type),
 	label(base.label),
 	parameters(base.parameters),
-	terminal_connections(base.terminal_connections)
+	terminal_connections(base.terminal_connections),
+	rate_divisor(base.rate_divisor),
+	rate_phase(base.rate_phase)
 {}
 
 ComponentListing::ComponentListing(ComponentListing&& base) :
 	type(std::move(base.type)),
 	label(std::move(base.label)),
 	parameters(std::move(base.parameters)),
-	terminal_connections(std::move(base.terminal_connections))
+	terminal_connections(std::move(base.terminal_connections)),
+	rate_divisor(base.rate_divisor),
+	rate_phase(base.rate_phase)
 {}
 
 ComponentListing::ComponentListing
@@ -64,7 +72,9 @@ ComponentListing::ComponentListing
 	type(type),
 	label(label),
 	parameters(parameters),
-	terminal_connections(terminal_connections)
+	terminal_connections(terminal_connections),
+	rate_divisor(1),
+	rate_phase(0)
 {}
 
 ComponentListing::ComponentListing
@@ -77,7 +87,9 @@ ComponentListing::ComponentListing
 	type(std::move(type)),
 	label(std::move(label)),
 	parameters(std::move(parameters)),
-	terminal_connections(std::move(terminal_connections))
+	terminal_connections(std::move(terminal_connections)),
+	rate_divisor(1),
+	rate_phase(0)
 {}
 
 ComponentListing::ComponentListing(const std::string& listing) :
@@ -92,6 +104,8 @@ ComponentListing& ComponentListing::operator=(const ComponentListing& base)
 	label = base.label;
 	parameters = base.parameters;
 	terminal_connections = base.terminal_connections;
+	rate_divisor = base.rate_divisor;
+	rate_phase = base.rate_phase;
 	return *this;
 }
 
@@ -100,6 +114,7 @@ void ComponentListing::setFromNetlistLine(const std::string& l)
 	const static std::string WHITESPACE_CHARS = std::string(" \n\r\t\f\v");
 	const static std::string NUMBER_CHARS = WHITESPACE_CHARS+std::string("+-.1234567890eE");
 	const static std::string INDEX_CHARS = WHITESPACE_CHARS+std::string("+1234567890");
+	const static std::string LABEL_END_CHARS = std::string("(")+WHITESPACE_CHARS;
 	int pos_begin = 0;
 	int pos_end = 0;
 	int pos_mid = 0;
@@ -108,6 +123,11 @@ void ComponentListing::setFromNetlistLine(const std::string& l)
 	std::string error_message;
 	std::vector<double> parsed_parameters;
 	std::vector<unsigned int> parsed_node_indices;
+	unsigned int parsed_rate_divisor = 1;
+	unsigned int parsed_rate_phase = 0;
+
+	parsed_parameters.reserve(4);
+	parsed_node_indices.reserve(4);
 
 	auto hasTwoSpacedWords = [] (std::string& str)
 	{
@@ -146,7 +166,7 @@ void ComponentListing::setFromNetlistLine(const std::string& l)
 		goto ERROR_THROW;
 	}
 
-	pos_end = l.find_first_of(std::string("(")+WHITESPACE_CHARS, pos_begin);
+	pos_end = l.find_first_of(LABEL_END_CHARS, pos_begin);
 	if(pos_end == std::string::npos)
 	{
 		error_message = "couldn't find end of component label";
@@ -158,7 +178,7 @@ void ComponentListing::setFromNetlistLine(const std::string& l)
 
 		//get component parameters
 
-    pos_begin = l.find_first_of(std::string("("), pos_begin);
+    pos_begin = l.find_first_of('(', pos_begin);
     if(pos_begin == std::string::npos)
 	{
 		error_message = "couldn't find start of parameters";
@@ -169,7 +189,7 @@ void ComponentListing::setFromNetlistLine(const std::string& l)
 	{
 		pos_begin++;
 
-		pos_end = l.find_first_of(std::string(",)"), pos_begin);
+		pos_end = l.find_first_of(",)", pos_begin);
 		if(pos_end == std::string::npos)
 		{
 			error_message = "couldn't find end of parameter(s)";
@@ -223,7 +243,7 @@ void ComponentListing::setFromNetlistLine(const std::string& l)
 
 	//get component node indices for terminal connections
 
-    pos_begin = l.find_first_of(std::string("{"), pos_begin);
+    pos_begin = l.find_first_of('{', pos_begin);
     if(pos_begin == std::string::npos)
 	{
 		error_message = "couldn't find start of node indices";
@@ -234,7 +254,7 @@ void ComponentListing::setFromNetlistLine(const std::string& l)
 	{
 		pos_begin++;
 
-		pos_end = l.find_first_of(std::string(",}"), pos_begin);
+		pos_end = l.find_first_of(",}", pos_begin);
 		if(pos_end == std::string::npos)
 		{
 			error_message = "couldn't find end of node index/indices";
@@ -285,10 +305,101 @@ void ComponentListing::setFromNetlistLine(const std::string& l)
 		}
 	}
 
-    type = type_str;
-    label = label_str;
+	//get code generation options, if any
+
+	pos_begin = l.find_first_not_of(WHITESPACE_CHARS, pos_end+1);
+	if(pos_begin != std::string::npos && l[pos_begin] == '[')
+	{
+		bool rate_given = false;
+		bool phase_given = false;
+
+		while(true)
+		{
+			pos_begin++;
+
+			pos_end = l.find_first_of(",]", pos_begin);
+			if(pos_end == std::string::npos)
+			{
+				error_message = "couldn't find end of option(s)";
+				goto ERROR_THROW;
+			}
+
+			std::string word = std::move( l.substr(pos_begin,pos_end-pos_begin) );
+			int word_pos = word.find_first_not_of(WHITESPACE_CHARS, 0);
+
+			if( (word_pos == std::string::npos) || word.empty() )
+			{
+				if(l[pos_begin-1] == ',' || l[pos_end] == ',')
+				{
+					error_message = "extra comma ',' found while parsing options";
+					goto ERROR_THROW;
+				}
+
+				break;
+			}
+
+			pos_mid = word.find_first_of('=');
+			if(pos_mid == std::string::npos)
+			{
+				error_message = "option is not given as name=value";
+				goto ERROR_THROW;
+			}
+
+			std::string name = word.substr(0, pos_mid);
+			std::string value = word.substr(pos_mid+1);
+			name.erase(0, name.find_first_not_of(WHITESPACE_CHARS));
+			name.erase(name.find_last_not_of(WHITESPACE_CHARS)+1);
+
+			if(value.find_first_not_of(INDEX_CHARS) != std::string::npos ||
+			   value.find_first_not_of(WHITESPACE_CHARS) == std::string::npos)
+			{
+				error_message = "value of option \'"+name+"\' is not a positive integer number";
+				goto ERROR_THROW;
+			}
+
+			if(hasTwoSpacedWords(value))
+			{
+				error_message = "there is a missing comma ',' in the options";
+				goto ERROR_THROW;
+			}
+
+			if(name == "rate" && !rate_given)
+			{
+				parsed_rate_divisor = std::stoul(value);
+				rate_given = true;
+			}
+			else if(name == "phase" && !phase_given)
+			{
+				parsed_rate_phase = std::stoul(value);
+				phase_given = true;
+			}
+			else
+			{
+				error_message = "unknown or repeated option \'"+name+"\'";
+				goto ERROR_THROW;
+			}
+
+			pos_begin = pos_end;
+
+			if(l[pos_end] == ']')
+			{
+				break;
+			}
+		}
+
+		if(parsed_rate_divisor == 0 || parsed_rate_phase >= parsed_rate_divisor)
+		{
+			error_message = "option rate must be positive nonzero and option phase must be less than it";
+			goto ERROR_THROW;
+		}
+	}
+
+    type = std::move(type_str);
+    label = std::move(label_str);
     parameters = std::move(parsed_parameters);
     terminal_connections = std::move(parsed_node_indices);
+    rate_divisor = parsed_rate_divisor;
+    rate_phase = parsed_rate_phase;
 
     return;
 
@@ -297,54 +408,215 @@ void ComponentListing::setFromNetlistLine(const std::string& l)
 	throw std::invalid_argument( std::string("ComponentListing::setFromNetlistLine(*) -- syntax error: ")+error_message );
 }
 
-inline
+void ComponentListing::setFromNetlistLine(const char* begin, const char* end)
+{
+	std::vector<double> parsed_parameters;
+	std::vector<unsigned int> parsed_node_indices;
+
+	parsed_parameters.reserve(4);
+	parsed_node_indices.reserve(4);
+
+	auto isSpace = [](char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+	};
+
+	auto isNumberChar = [](char c)
+	{
+		return (c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.' || c == 'e' || c == 'E';
+	};
+
+	auto skipSpaces = [&](const char* pos)
+	{
+		while(pos != end && isSpace(*pos)) ++pos;
+		return pos;
+	};
+
+		// accepts only "type label(number, ...) {index, ...}" with an optional trailing remainder
+		// that is not options, checking each number is wholly consumed as setFromNetlistLine(const
+		// std::string&) would parse it; anything else is left to that more thorough parser
+
+	const char* type_begin = skipSpaces(begin);
+	const char* type_end = type_begin;
+	while(type_end != end && !isSpace(*type_end)) ++type_end;
+
+	const char* label_begin = skipSpaces(type_end);
+	const char* label_end = label_begin;
+	while(label_end != end && *label_end != '(' && !isSpace(*label_end)) ++label_end;
+
+	auto tokenize = [&]() -> bool
+	{
+		if(type_begin == type_end || label_begin == label_end)
+			return false;
+
+		const char* pos = skipSpaces(label_end);
+
+		if(pos == end || *pos != '(')
+			return false;
+
+		do
+		{
+			const char* num_begin = skipSpaces(pos+1);
+			const char* num_end = num_begin;
+			while(num_end != end && isNumberChar(*num_end)) ++num_end;
+
+			pos = skipSpaces(num_end);
+
+			if(num_begin == num_end || pos == end || (*pos != ',' && *pos != ')'))
+				return false;
+
+			char* parsed_end = nullptr;
+			errno = 0;
+			const double value = std::strtod(num_begin, &parsed_end);
+
+			if(parsed_end != num_end || errno == ERANGE)
+				return false;
+
+			parsed_parameters.push_back(value);
+		}
+		while(*pos == ',');
+
+		pos = skipSpaces(pos+1);
+
+		if(pos == end || *pos != '{')
+			return false;
+
+		do
+		{
+			const char* index_begin = skipSpaces(pos+1);
+			const char* index_end = index_begin;
+			unsigned int index = 0;
+
+			for(; index_end != end && *index_end >= '0' && *index_end <= '9'; ++index_end)
+			{
+				index = 10*index + (unsigned int)(*index_end - '0');
+			}
+
+			pos = skipSpaces(index_end);
+
+			if(index_begin == index_end || index_end-index_begin > 9 || pos == end || (*pos != ',' && *pos != '}'))
+				return false;
+
+			parsed_node_indices.push_back(index);
+		}
+		while(*pos == ',');
+
+		pos = skipSpaces(pos+1);
+
+		return (pos == end || *pos != '[');
+	};
+
+	if(!tokenize())
+	{
+		setFromNetlistLine(std::string(begin, end));
+		return;
+	}
+
+	type.assign(type_begin, type_end);
+	label.assign(label_begin, label_end);
+	parameters = std::move(parsed_parameters);
+	terminal_connections = std::move(parsed_node_indices);
+	rate_divisor = 1;
+	rate_phase = 0;
+}
+
+std::string ComponentListing::toNetlistLine() const
+{
+	std::stringstream sstrm;
+
+	sstrm.precision(15);
+
+	sstrm << type << " " << label << "(";
+
+	for(unsigned int p = 0; p < parameters.size(); p++)
+	{
+		sstrm << (p ? ", " : "") << parameters[p];
+	}
+
+	sstrm << ") {";
+
+	for(unsigned int t = 0; t < terminal_connections.size(); t++)
+	{
+		sstrm << (t ? ", " : "") << terminal_connections[t];
+	}
+
+	sstrm << "}";
+
+	if(rate_divisor != 1)
+	{
+		sstrm << " [rate=" << rate_divisor;
+
+		if(rate_phase != 0)
+			sstrm << ", phase=" << rate_phase;
+
+		sstrm << "]";
+	}
+
+	return sstrm.str();
+}
+
 void ComponentListing::setType(std::string t)
 {
 	type = t;
 }
 
-inline
 void ComponentListing::setLabel(std::string l)
 {
 	label = l;
 }
 
-inline
 void ComponentListing::setParameters(const std::vector<double>& p)
 {
 	parameters = p;
 }
 
-inline
 void ComponentListing::setParameters(std::vector<double>&& p)
 {
-	parameters = p;
+	parameters = std::move(p);
 }
 
-inline
 void ComponentListing::addParameter(double p)
 {
 	parameters.push_back(p);
 }
 
-inline
 void ComponentListing::setTerminalConnections(const std::vector<unsigned int>& tc)
 {
 	terminal_connections = tc;
 }
 
-inline
 void ComponentListing::setTerminalConnections(std::vector<unsigned int>&& tc)
 {
-	terminal_connections = tc;
+	terminal_connections = std::move(tc);
 }
 
-inline
 void ComponentListing::addTerminalConnection(unsigned int tc)
 {
 	terminal_connections.push_back(tc);
 }
 
+void ComponentListing::setRate(unsigned int divisor, unsigned int phase)
+{
+	if(divisor == 0)
+		throw std::invalid_argument("ComponentListing::setRate(): divisor must be positive nonzero value");
+
+	if(phase >= divisor)
+		throw std::invalid_argument("ComponentListing::setRate(): phase must be less than divisor");
+
+	rate_divisor = divisor;
+	rate_phase = phase;
+}
+
+unsigned int ComponentListing::getRateDivisor() const
+{
+	return rate_divisor;
+}
+
+unsigned int ComponentListing::getRatePhase() const
+{
+	return rate_phase;
+}
+
 const std::string& ComponentListing::getType() const
 {
 	return type;
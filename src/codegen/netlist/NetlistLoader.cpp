@@ -25,12 +25,16 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include <fstream>
 #include <stdexcept>
 #include <utility>
-#include <map>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <cstdint>
 
 #include "codegen/netlist/Netlist.hpp"
 #include "codegen/netlist/ComponentListing.hpp"
 #include "codegen/netlist/NetlistLoader.hpp"
-#include "codegen/StringProcessor.hpp"
+#include "codegen/ParallelFor.hpp"
+#include "codegen/ModelCache.hpp"
 
 namespace lblmc
 {
@@ -40,77 +44,166 @@ const std::string NetlistLoader::BAD_START_CHARS  = std::string("1234567890.!@$^
 const std::string NetlistLoader::VALID_NAME_CHARS = std::string("1234567890_abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ");
 const std::string NetlistLoader::VALID_NUMBER_CHARS = std::string("1234567890.eE+-");
 
-NetlistLoader::NetlistLoader() {}
+NetlistLoader::NetlistLoader() :
+	num_threads(1)
+{}
 
-Netlist NetlistLoader::loadFromStream(std::istream& strm)
+NetlistLoader::NetlistLoader(unsigned int num_threads) :
+	num_threads(num_threads)
+{}
+
+Netlist NetlistLoader::loadFromText(const char* text, std::size_t size)
 {
+		// lines are scanned in order, handling commands, and the component lines are parsed
+		// afterward, concurrently; errors are thrown in line order as if loaded line by line
+
+	struct Item
+	{
+		LineType type;
+		int line_number;
+		std::size_t begin; ///< offset of line in text
+		std::size_t end;
+		unsigned int num_constants; ///< number of constants defined before line
+		std::string value; ///< model name of a NAME item, or error message of an ERROR item
+	};
+
+	std::vector<Item> items;
+	std::vector<unsigned int> component_items;
+	ConstantTable constants;
+	int line_count = 0;
+	int model_name_count = 0;
 	std::string line;
 	std::string constant_name;
 	std::string constant_value;
-	int line_count = 0;
-	int model_name_count = 0;
 	size_t line_pos = 0;
-	Netlist netlist;
-	ComponentListing component;
-	std::map<std::string, std::string> constants{};
 
-	while( std::getline(strm, line) )
+	auto fail = [&](std::string message)
+	{
+		Item item;
+		item.type = LineType::ERROR;
+		item.line_number = line_count;
+		item.value = std::move(message);
+		items.push_back(std::move(item));
+	};
+
+	for(std::size_t begin = 0; begin < size; )
 	{
+		const char* newline = static_cast<const char*>( std::memchr(text+begin, '\n', size-begin) );
+		const std::size_t end = newline ? std::size_t(newline-text) : size;
+
 		++line_count;
-		LineType line_type = checkLineType(line, line_pos);
+		line.assign(text+begin, end-begin);
+
+		Item item;
+		item.type = checkLineType(line, line_pos);
+		item.line_number = line_count;
+		item.begin = begin;
+		item.end = end;
+		item.num_constants = constants.size();
 
-		switch(line_type)
+		begin = end+1;
+
+		if(item.type == LineType::ERROR)
 		{
-			case LineType::ERROR :
+			fail(std::string("NetlistLoader::loadFromStream(*) -- unsupported syntax at line ")+std::to_string(line_count));
+			break;
+		}
+		else if(item.type == LineType::LINE_START_ERROR)
+		{
+			fail(std::string("NetlistLoader::loadFromStream(*) -- line starts with unsupported sequence, character, or command at line ")+std::to_string(line_count));
+			break;
+		}
+		else if(item.type == LineType::NAME)
+		{
+			++model_name_count;
+			if(model_name_count > 1)
 			{
-				throw std::invalid_argument(std::string("NetlistLoader::loadFromStream(*) -- unsupported syntax at line ")+std::to_string(line_count));
+				fail(std::string("NetlistLoader::loadFromStream(*) -- redefined model name at line ")+std::to_string(line_count));
 				break;
 			}
-			case LineType::LINE_START_ERROR :
+			try
 			{
-				throw std::invalid_argument(std::string("NetlistLoader::loadFromStream(*) -- line starts with unsupported sequence, character, or command at line ")+std::to_string(line_count));
+				item.value = extractModelName(line, line_pos);
+			}
+			catch(std::invalid_argument& e)
+			{
+				fail(std::string("NetlistLoader::loadFromStream(*) -- model name error at line ")
+				     +std::to_string(line_count)+std::string(": ")+e.what());
 				break;
 			}
-			case LineType::EMPTY :
+			items.push_back(std::move(item));
+		}
+		else if(item.type == LineType::CONSTANT)
+		{
+			try
+			{
+				constant_value = extractConstantValue(line, line_pos, constant_name);
+			}
+			catch(std::invalid_argument& e)
 			{
+				fail(e.what());
 				break;
 			}
-			case LineType::COMMENT :
+			if(constants.find(constant_name) != constants.end())
+			{
+				fail(std::string("NetlistLoader::loadFromStream(*) -- redefined constant at line ")+std::to_string(line_count));
 				break;
+			}
+			constants[constant_name] = std::make_pair(constant_value, (unsigned int)(constants.size()));
+		}
+		else if(item.type == LineType::COMPONENT)
+		{
+			component_items.push_back(items.size());
+			items.push_back(std::move(item));
+		}
+	}
+
+	std::vector<ComponentListing> components(component_items.size());
+	std::vector<std::string> errors(component_items.size());
+
+	parallelFor(component_items.size(), num_threads, [&](unsigned int, unsigned int begin, unsigned int end)
+	{
+		for(unsigned int c = begin; c < end; c++)
+		{
+			const Item& item = items[component_items[c]];
+
+			try
+			{
+				components[c] = extractComponent(text+item.begin, text+item.end, constants, item.num_constants);
+			}
+			catch(const std::invalid_argument& e)
+			{
+				errors[c] = e.what();
+			}
+		}
+	});
+
+	Netlist netlist;
+	netlist.reserveComponents(component_items.size());
+
+	unsigned int c = 0;
+
+	for(const Item& item : items)
+	{
+		switch(item.type)
+		{
+			case LineType::ERROR :
+				throw std::invalid_argument(item.value);
 
 			case LineType::NAME :
-				++model_name_count;
-				if(model_name_count > 1)
-				{
-					throw std::invalid_argument(std::string("NetlistLoader::loadFromStream(*) -- redefined model name at line ")+std::to_string(line_count));
-				}
-				try
-				{
-					netlist.setModelName(extractModelName(line, line_pos));
-				}
-				catch(std::invalid_argument& e)
-				{
-					throw std::invalid_argument(std::string("NetlistLoader::loadFromStream(*) -- model name error at line ")
-													+std::to_string(line_count)+std::string(": ")+e.what());
-				}
+				netlist.setModelName(item.value);
 				break;
 
-			case LineType::CONSTANT :
-				constant_value = extractConstantValue(line, line_pos, constant_name);
-				if(constants.find(constant_name) != constants.end())
+			case LineType::COMPONENT :
+				if(!errors[c].empty())
 				{
-					throw std::invalid_argument(std::string("NetlistLoader::loadFromStream(*) -- redefined constant at line ")+std::to_string(line_count));
+					throw std::invalid_argument(errors[c]);
 				}
-				constants[constant_name] = constant_value;
-				break;
-
-			case LineType::COMPONENT :
-				component = extractComponent(line, constants);
-				if(netlist.hasComponent(component.getLabel()))
+				if(!netlist.addComponent(std::move(components[c])))
 				{
-					throw std::invalid_argument(std::string("NetlistLoader::loadFromStream(*) -- redefined component with same label at line ")+std::to_string(line_count));
+					throw std::invalid_argument(std::string("NetlistLoader::loadFromStream(*) -- redefined component with same label at line ")+std::to_string(item.line_number));
 				}
-				netlist.addComponent(std::move(component));
+				++c;
 				break;
 
 			default:
@@ -126,13 +219,21 @@ Netlist NetlistLoader::loadFromStream(std::istream& strm)
 	return netlist;
 }
 
-Netlist NetlistLoader::loadFromString(const std::string& netlist_str)
+Netlist NetlistLoader::loadFromStream(std::istream& strm)
 {
-	std::stringstream sstrm(netlist_str, std::stringstream::in);
+	std::stringstream sstrm;
+	sstrm << strm.rdbuf();
 
+	const std::string text = sstrm.str();
+
+	return loadFromText(text.data(), text.size());
+}
+
+Netlist NetlistLoader::loadFromString(const std::string& netlist_str)
+{
 	try
 	{
-		return loadFromStream(sstrm);
+		return loadFromText(netlist_str.data(), netlist_str.size());
 	}
 	catch(const std::invalid_argument& e)
 	{
@@ -144,18 +245,73 @@ Netlist NetlistLoader::loadFromString(const std::string& netlist_str)
 	}
 }
 
-Netlist NetlistLoader::loadFromFile(const std::string& filename)
+std::string NetlistLoader::readFile(const std::string& filename)
 {
-	std::fstream file(filename, std::fstream::in);
+	std::ifstream file(filename, std::ifstream::in | std::ifstream::binary);
 
 	if(!file.is_open())
 	{
 		throw std::runtime_error("NetlistLoader::loadFromFile(*) -- failed to open given file");
 	}
 
+		// whole file is read with one read into memory, where it is tokenized in place
+
+	file.seekg(0, std::ifstream::end);
+	const std::streamoff size = file.tellg();
+	file.seekg(0, std::ifstream::beg);
+
+	std::string text;
+
+	if(size > 0)
+	{
+		text.resize(size);
+		file.read(&text[0], size);
+	}
+
+	if(size < 0 || !file)
+	{
+		throw std::runtime_error("NetlistLoader::loadFromFile(*) -- failed to read given file");
+	}
+
+	return text;
+}
+
+Netlist NetlistLoader::loadFromFile(const std::string& filename)
+{
+	const std::string text = readFile(filename);
+
+	try
+	{
+		return loadFromText(text.data(), text.size());
+	}
+	catch(const std::invalid_argument& e)
+	{
+		throw std::invalid_argument
+		(
+			std::string("NetlistLoader::loadFromFile(*) -- error occurred during netlist load: ")+
+			e.what()
+		);
+	}
+}
+
+Netlist NetlistLoader::loadFromFile(const std::string& filename, ModelCache& cache)
+{
+	const std::string text = readFile(filename);
+	const std::uint64_t text_hash = ModelCache::hash(text.data(), text.size());
+
+	Netlist netlist;
+
+	if(cache.loadNetlist(text_hash, netlist))
+	{
+		return netlist;
+	}
+
 	try
 	{
-		return loadFromStream(file);
+		netlist = loadFromText(text.data(), text.size());
+		cache.setNetlist(text_hash, netlist);
+
+		return netlist;
 	}
 	catch(const std::invalid_argument& e)
 	{
@@ -307,20 +463,71 @@ std::string NetlistLoader::extractConstantValue(const std::string& line, const s
 	return value;
 }
 
-ComponentListing NetlistLoader::extractComponent(const std::string& line, const std::map<std::string,std::string>& constants)
+ComponentListing NetlistLoader::extractComponent
+(
+	const char* begin,
+	const char* end,
+	const ConstantTable& constants,
+	unsigned int num_constants
+) const
 {
-	std::string str_listing = line;
-	size_t start_pos = str_listing.find_first_of("(",0);
-	lblmc::StringProcessor sproc(str_listing);
+		// constants are substituted for the words naming them from the parameters onward, in one
+		// pass; words are delimited as by StringProcessor, and numbers cannot be names.  The line is
+		// only copied once a substitution is made, so lines without constants are parsed in place
+
+	auto isWordChar = [](char c)
+	{
+		const int ch = (unsigned char)(c);
+		return c == '_' || !(std::ispunct(ch) || std::isspace(ch) || c == '\0');
+	};
 
-	for(const auto& name_value : constants)
+	std::string str_listing;
+	const char* copied_end = begin;
+
+	if(!constants.empty() && num_constants > 0)
 	{
-		sproc.replaceWordAll( name_value.first, name_value.second, start_pos );
+		for(const char* pos = std::find(begin, end, '('); pos != end; )
+		{
+			if(!isWordChar(*pos))
+			{
+				++pos;
+				continue;
+			}
+
+			const char* word_end = pos;
+			while(word_end != end && isWordChar(*word_end)) ++word_end;
+
+			if(!std::isdigit((unsigned char)(*pos)))
+			{
+				const auto iter = constants.find(std::string(pos, word_end));
+
+				if(iter != constants.end() && iter->second.second < num_constants)
+				{
+					str_listing.append(copied_end, pos);
+					str_listing += iter->second.first;
+					copied_end = word_end;
+				}
+			}
+
+			pos = word_end;
+		}
 	}
 
 	try
 	{
-		return ComponentListing(str_listing);
+		ComponentListing listing;
+
+		if(copied_end == begin)
+		{
+			listing.setFromNetlistLine(begin, end);
+		}
+		else
+		{
+			str_listing.append(copied_end, end);
+			listing.setFromNetlistLine(str_listing.data(), str_listing.data()+str_listing.size());
+		}
+
+		return listing;
 	}
 	catch(const std::invalid_argument& e)
 	{
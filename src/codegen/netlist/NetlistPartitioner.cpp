@@ -0,0 +1,358 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/netlist/NetlistPartitioner.hpp"
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <stdexcept>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+
+namespace lblmc
+{
+
+NetlistPartitioner::NetlistPartitioner() :
+	decoupling_types({"Inductor", "Capacitor"}),
+	num_cut_components(0)
+{}
+
+void NetlistPartitioner::setDecouplingComponentTypes(const std::set<std::string>& types)
+{
+	decoupling_types = types;
+}
+
+bool NetlistPartitioner::isDecoupling(const ComponentListing& comp) const
+{
+	const auto& terms = comp.getTerminalConnections();
+
+	return decoupling_types.count(comp.getType()) != 0 &&
+	       terms.size() == 2 && terms[0] != 0 && terms[1] != 0 && terms[0] != terms[1];
+}
+
+std::vector<NetlistPartitioner::Subsystem> NetlistPartitioner::partition(const Netlist& netlist, unsigned int num_subsystems)
+{
+	if(num_subsystems == 0)
+		throw std::invalid_argument("NetlistPartitioner::partition(): num_subsystems must be 1 or greater");
+
+	const unsigned int num_nodes = netlist.getNumberOfNodes();
+	const auto& components = netlist.getComponents();
+
+	for(const auto& comp : components)
+	{
+		if(comp.getType() == "IdealVoltageSource" || comp.getType() == "IdealFunctionalVoltageSource")
+		{
+			throw std::runtime_error("NetlistPartitioner::partition(): component "+comp.getLabel()+
+			" of type "+comp.getType()+" is not supported for partitioning");
+		}
+	}
+
+		// cluster nodes tied together by non-decoupling components
+
+	std::vector<unsigned int> parent(num_nodes+1);
+	for(unsigned int n = 0; n <= num_nodes; n++)
+		parent[n] = n;
+
+	auto find = [&parent](unsigned int n)
+	{
+		while(parent[n] != n)
+		{
+			parent[n] = parent[parent[n]];
+			n = parent[n];
+		}
+		return n;
+	};
+
+	for(const auto& comp : components)
+	{
+		if(isDecoupling(comp))
+			continue;
+
+		unsigned int first = 0;
+		for(const auto& t : comp.getTerminalConnections())
+		{
+			if(t == 0)
+				continue; // ground is shared by all subsystems
+
+			if(first == 0)
+			{
+				first = t;
+				continue;
+			}
+
+			unsigned int a = find(first);
+			unsigned int b = find(t);
+			if(a != b)
+				parent[std::max(a,b)] = std::min(a,b);
+		}
+	}
+
+	std::vector<unsigned int> cluster_of_node(num_nodes+1, 0);
+	std::vector<unsigned int> cluster_weight;
+	std::map<unsigned int, unsigned int> cluster_of_root;
+
+	for(unsigned int n = 1; n <= num_nodes; n++)
+	{
+		unsigned int root = find(n);
+
+		if(cluster_of_root.find(root) == cluster_of_root.end())
+		{
+			cluster_of_root[root] = cluster_weight.size();
+			cluster_weight.push_back(0);
+		}
+
+		cluster_of_node[n] = cluster_of_root[root];
+		cluster_weight[cluster_of_node[n]]++;
+	}
+
+	const unsigned int num_clusters = cluster_weight.size();
+
+	if(num_clusters < num_subsystems)
+	{
+		std::stringstream sstrm;
+		sstrm << "NetlistPartitioner::partition(): netlist can be partitioned into at most " << num_clusters << " subsystems";
+		throw std::runtime_error(sstrm.str());
+	}
+
+		// adjacency of clusters across decoupling components
+
+	std::vector< std::map<unsigned int, unsigned int> > adjacency(num_clusters);
+
+	for(const auto& comp : components)
+	{
+		if(!isDecoupling(comp))
+			continue;
+
+		unsigned int a = cluster_of_node[comp.getTerminalConnection(0)];
+		unsigned int b = cluster_of_node[comp.getTerminalConnection(1)];
+
+		if(a == b)
+			continue;
+
+		adjacency[a][b]++;
+		adjacency[b][a]++;
+	}
+
+		// greedily grow balanced subsystems from the clusters
+
+	const int UNASSIGNED = -1;
+	std::vector<int> subsystem_of_cluster(num_clusters, UNASSIGNED);
+
+	unsigned int remaining_weight = num_nodes;
+	unsigned int remaining_clusters = num_clusters;
+
+	for(unsigned int s = 0; s < num_subsystems; s++)
+	{
+		const unsigned int parts_left = num_subsystems - s;
+		const double target = double(remaining_weight)/double(parts_left);
+
+		unsigned int weight = 0;
+		std::map<unsigned int, unsigned int> frontier; // unassigned neighbor cluster -> connections to subsystem
+
+		auto add_cluster = [&](unsigned int c)
+		{
+			subsystem_of_cluster[c] = s;
+			weight += cluster_weight[c];
+			remaining_weight -= cluster_weight[c];
+			remaining_clusters--;
+			frontier.erase(c);
+
+			for(const auto& adj : adjacency[c])
+			{
+				if(subsystem_of_cluster[adj.first] == UNASSIGNED)
+					frontier[adj.first] += adj.second;
+			}
+		};
+
+		while(remaining_clusters > 0)
+		{
+			if(parts_left != 1 && weight > 0)
+			{
+				if(remaining_clusters < parts_left)
+					break; // leave at least one cluster for each remaining subsystem
+			}
+
+			// prefer the frontier cluster most connected to the subsystem; start from the
+			// lowest unassigned cluster when the subsystem is empty or cut off from the rest
+
+			int next = UNASSIGNED;
+			unsigned int best_connections = 0;
+
+			for(const auto& f : frontier)
+			{
+				if(f.second > best_connections)
+				{
+					next = f.first;
+					best_connections = f.second;
+				}
+			}
+
+			if(next == UNASSIGNED)
+			{
+				for(unsigned int c = 0; c < num_clusters; c++)
+				{
+					if(subsystem_of_cluster[c] == UNASSIGNED)
+					{
+						next = c;
+						break;
+					}
+				}
+			}
+
+			if(parts_left != 1 && weight > 0)
+			{
+				// stop once adding the cluster would move the subsystem further from its target
+				if( std::abs(double(weight + cluster_weight[next]) - target) >= std::abs(double(weight) - target) )
+					break;
+			}
+
+			add_cluster(next);
+		}
+	}
+
+		// place cut decoupling components so that each node is copied into at most one other subsystem
+
+	num_cut_components = 0;
+
+	std::vector<int> subsystem_of_node(num_nodes+1, UNASSIGNED);
+	for(unsigned int n = 1; n <= num_nodes; n++)
+		subsystem_of_node[n] = subsystem_of_cluster[cluster_of_node[n]];
+
+	std::vector<int> copied_by(num_nodes+1, UNASSIGNED);
+	std::vector<int> holder_of_component(components.size(), UNASSIGNED);
+
+	for(unsigned int i = 0; i < components.size(); i++)
+	{
+		const auto& comp = components[i];
+
+		unsigned int s_home = 0;
+		for(const auto& t : comp.getTerminalConnections())
+		{
+			if(t != 0)
+			{
+				s_home = subsystem_of_node[t];
+				break;
+			}
+		}
+
+		if(!isDecoupling(comp))
+		{
+			holder_of_component[i] = s_home;
+			continue;
+		}
+
+		const unsigned int n0 = comp.getTerminalConnection(0);
+		const unsigned int n1 = comp.getTerminalConnection(1);
+		const int s0 = subsystem_of_node[n0];
+		const int s1 = subsystem_of_node[n1];
+
+		if(s0 == s1)
+		{
+			holder_of_component[i] = s0;
+			continue;
+		}
+
+		num_cut_components++;
+
+		if(copied_by[n1] == UNASSIGNED || copied_by[n1] == s0)
+		{
+			holder_of_component[i] = s0;
+			copied_by[n1] = s0;
+		}
+		else if(copied_by[n0] == UNASSIGNED || copied_by[n0] == s1)
+		{
+			holder_of_component[i] = s1;
+			copied_by[n0] = s1;
+		}
+		else
+		{
+			throw std::runtime_error("NetlistPartitioner::partition(): component "+comp.getLabel()+
+			" connects nodes that are already shared with other subsystems; try fewer subsystems");
+		}
+	}
+
+		// build subsystem netlists with local node indices and ports
+
+	std::vector<Subsystem> subsystems(num_subsystems);
+	std::vector< std::map<unsigned int, unsigned int> > local_of_global(num_subsystems);
+
+	for(unsigned int s = 0; s < num_subsystems; s++)
+	{
+		std::stringstream name;
+		name << netlist.getModelName() << "_sub" << s;
+		subsystems[s].netlist.setModelName(name.str());
+
+		for(unsigned int n = 1; n <= num_nodes; n++)
+		{
+			if(subsystem_of_node[n] == int(s))
+			{
+				subsystems[s].global_nodes.push_back(n);
+				local_of_global[s][n] = subsystems[s].global_nodes.size();
+			}
+		}
+
+		subsystems[s].num_owned_nodes = subsystems[s].global_nodes.size();
+	}
+
+	unsigned int next_port_id = 1;
+
+	for(unsigned int n = 1; n <= num_nodes; n++)
+	{
+		if(copied_by[n] == UNASSIGNED)
+			continue;
+
+		Subsystem& holder = subsystems[copied_by[n]];
+		Subsystem& owner = subsystems[subsystem_of_node[n]];
+
+		holder.global_nodes.push_back(n);
+		local_of_global[copied_by[n]][n] = holder.global_nodes.size();
+
+		holder.ports.push_back( Port{next_port_id, (unsigned int)(holder.global_nodes.size()), (unsigned int)(subsystem_of_node[n])} );
+		owner.ports.push_back( Port{next_port_id, local_of_global[subsystem_of_node[n]][n], (unsigned int)(copied_by[n])} );
+
+		next_port_id++;
+	}
+
+	for(unsigned int i = 0; i < components.size(); i++)
+	{
+		const unsigned int s = holder_of_component[i];
+
+		ComponentListing local_comp(components[i]);
+
+		std::vector<unsigned int> terms;
+		for(const auto& t : components[i].getTerminalConnections())
+		{
+			terms.push_back( t == 0 ? 0 : local_of_global[s].at(t) );
+		}
+		local_comp.setTerminalConnections(std::move(terms));
+
+		subsystems[s].netlist.addComponent(local_comp);
+	}
+
+	return subsystems;
+}
+
+} //namespace lblmc
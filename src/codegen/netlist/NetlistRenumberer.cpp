@@ -0,0 +1,349 @@
+/*
+
+Copyright (C) 2018-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/netlist/NetlistRenumberer.hpp"
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include <Eigen/Sparse>
+#include <Eigen/OrderingMethods>
+
+namespace lblmc
+{
+
+namespace
+{
+
+/**
+	\brief gets the index of the parameter of a component that gives a solution id
+	\return index of the parameter; -1 if the component has none
+**/
+int solutionParameterIndex(const ComponentListing& comp)
+{
+	if(comp.getType() == "IdealVoltageSource")
+		return 1;
+
+	if(comp.getType() == "IdealFunctionalVoltageSource")
+		return 0;
+
+	return -1;
+}
+
+/**
+	\brief gets the solution id of a component if it is a node of the netlist
+	\return the solution id; 0 if the component has none or it is outside 1 to num_nodes
+**/
+unsigned int solutionNode(const ComponentListing& comp, unsigned int num_nodes)
+{
+	const int p = solutionParameterIndex(comp);
+
+	if(p < 0 || (unsigned int)(p) >= comp.getParameters().size())
+		return 0;
+
+	const double id = comp.getParameter(p);
+
+	if(id < 1.0 || id > double(num_nodes) || id != std::floor(id))
+		return 0;
+
+	return (unsigned int)(id);
+}
+
+} //anonymous namespace
+
+NetlistRenumberer::NetlistRenumberer() :
+	netlist_nodes(),
+	bandwidth_before(0),
+	bandwidth_after(0)
+{}
+
+std::vector< std::vector<unsigned int> > NetlistRenumberer::buildAdjacency(const Netlist& netlist)
+{
+	const unsigned int num_nodes = netlist.getNumberOfNodes();
+
+	std::vector< std::vector<unsigned int> > adjacency(num_nodes);
+
+	for(const auto& comp : netlist.getComponents())
+	{
+		std::vector<unsigned int> nodes;
+
+		for(const auto& t : comp.getTerminalConnections())
+		{
+			if(t != 0)
+				nodes.push_back(t-1);
+		}
+
+		const unsigned int s = solutionNode(comp, num_nodes);
+
+		if(s != 0)
+			nodes.push_back(s-1);
+
+		for(const auto& a : nodes)
+		{
+			for(const auto& b : nodes)
+			{
+				if(a != b)
+					adjacency[a].push_back(b);
+			}
+		}
+	}
+
+	for(auto& adj : adjacency)
+	{
+		std::sort(adj.begin(), adj.end());
+		adj.erase(std::unique(adj.begin(), adj.end()), adj.end());
+	}
+
+	return adjacency;
+}
+
+std::vector<unsigned int> NetlistRenumberer::orderRCM(const std::vector< std::vector<unsigned int> >& adjacency)
+{
+	const unsigned int n = adjacency.size();
+
+	std::vector<unsigned int> order;
+	order.reserve(n);
+
+	std::vector<bool> visited(n, false);
+	std::vector<int> level(n, -1);
+
+	auto byDegree = [&adjacency](unsigned int a, unsigned int b)
+	{
+		return (adjacency[a].size() != adjacency[b].size()) ? (adjacency[a].size() < adjacency[b].size()) : (a < b);
+	};
+
+		// breadth first search from root within its connected part; returns nodes in search
+		// order, with the level of each node in level[]
+
+	auto search = [&](unsigned int root)
+	{
+		std::vector<unsigned int> reached(1, root);
+		level[root] = 0;
+
+		for(std::size_t i = 0; i < reached.size(); i++)
+		{
+			for(const auto& v : adjacency[reached[i]])
+			{
+				if(level[v] < 0)
+				{
+					level[v] = level[reached[i]]+1;
+					reached.push_back(v);
+				}
+			}
+		}
+
+		return reached;
+	};
+
+	for(unsigned int start = 0; start < n; start++)
+	{
+		if(visited[start])
+			continue;
+
+			// pseudo-peripheral root by George and Liu: move the root to a least degree node of
+			// the last level of its search while that lengthens the search
+
+		unsigned int root = start;
+		std::vector<unsigned int> reached = search(root);
+		int eccentricity = level[reached.back()];
+
+		while(true)
+		{
+			unsigned int candidate = reached.back();
+			for(const auto& v : reached)
+			{
+				if(level[v] == eccentricity && byDegree(v, candidate))
+					candidate = v;
+			}
+
+			for(const auto& v : reached)
+				level[v] = -1;
+
+			std::vector<unsigned int> candidate_reached = search(candidate);
+			const int candidate_eccentricity = level[candidate_reached.back()];
+
+			if(candidate_eccentricity <= eccentricity)
+			{
+				for(const auto& v : candidate_reached)
+					level[v] = -1;
+				break;
+			}
+
+			root = candidate;
+			reached.swap(candidate_reached);
+			eccentricity = candidate_eccentricity;
+		}
+
+			// Cuthill-McKee: breadth first from the root, visiting the neighbours of each node in
+			// order of increasing degree
+
+		const std::size_t first = order.size();
+		order.push_back(root);
+		visited[root] = true;
+
+		for(std::size_t i = first; i < order.size(); i++)
+		{
+			std::vector<unsigned int> next;
+
+			for(const auto& v : adjacency[order[i]])
+			{
+				if(!visited[v])
+				{
+					visited[v] = true;
+					next.push_back(v);
+				}
+			}
+
+			std::sort(next.begin(), next.end(), byDegree);
+			order.insert(order.end(), next.begin(), next.end());
+		}
+	}
+
+	std::reverse(order.begin(), order.end());
+
+	return order;
+}
+
+std::vector<unsigned int> NetlistRenumberer::orderAMD(const std::vector< std::vector<unsigned int> >& adjacency)
+{
+	const unsigned int n = adjacency.size();
+
+	std::vector< Eigen::Triplet<double> > triplets;
+
+	for(unsigned int r = 0; r < n; r++)
+	{
+		triplets.push_back(Eigen::Triplet<double>(r, r, 1.0));
+
+		for(const auto& c : adjacency[r])
+			triplets.push_back(Eigen::Triplet<double>(r, c, 1.0));
+	}
+
+	Eigen::SparseMatrix<double> pattern(n, n);
+	pattern.setFromTriplets(triplets.begin(), triplets.end());
+
+	Eigen::AMDOrdering<int> amd;
+	Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> perm_inv;
+	amd(pattern, perm_inv);
+
+	std::vector<unsigned int> order(n);
+	for(unsigned int k = 0; k < n; k++)
+		order[k] = perm_inv.indices()[k];
+
+	return order;
+}
+
+unsigned int NetlistRenumberer::computeBandwidth(const std::vector< std::vector<unsigned int> >& adjacency, const std::vector<unsigned int>& new_nodes)
+{
+	unsigned int bandwidth = 0;
+
+	for(unsigned int a = 0; a < adjacency.size(); a++)
+	{
+		for(const auto& b : adjacency[a])
+		{
+			if(new_nodes[b] > new_nodes[a])
+				bandwidth = std::max(bandwidth, new_nodes[b]-new_nodes[a]);
+		}
+	}
+
+	return bandwidth;
+}
+
+Netlist NetlistRenumberer::renumber(const Netlist& netlist, Ordering ordering)
+{
+	const unsigned int num_nodes = netlist.getNumberOfNodes();
+
+	const std::vector< std::vector<unsigned int> > adjacency = buildAdjacency(netlist);
+
+	std::vector<unsigned int> order(num_nodes);
+	for(unsigned int k = 0; k < num_nodes; k++)
+		order[k] = k;
+
+	if(ordering == RCM)
+		order = orderRCM(adjacency);
+	else if(ordering == AMD)
+		order = orderAMD(adjacency);
+
+		// order[k] is the zero-based netlist node of renumbered node k+1
+
+	std::vector<unsigned int> new_nodes(num_nodes);
+	netlist_nodes.assign(num_nodes, 0);
+
+	for(unsigned int k = 0; k < num_nodes; k++)
+	{
+		new_nodes[order[k]] = k;
+		netlist_nodes[k] = order[k]+1;
+	}
+
+	std::vector<unsigned int> identity(num_nodes);
+	for(unsigned int k = 0; k < num_nodes; k++)
+		identity[k] = k;
+
+	bandwidth_before = computeBandwidth(adjacency, identity);
+	bandwidth_after = computeBandwidth(adjacency, new_nodes);
+
+	Netlist renumbered;
+	renumbered.setModelName(netlist.getModelName());
+
+	for(const auto& comp : netlist.getComponents())
+	{
+		ComponentListing renumbered_comp(comp);
+
+		std::vector<unsigned int> terms;
+		for(const auto& t : comp.getTerminalConnections())
+			terms.push_back( t == 0 ? 0 : new_nodes[t-1]+1 );
+
+		renumbered_comp.setTerminalConnections(std::move(terms));
+
+		const unsigned int s = solutionNode(comp, num_nodes);
+
+		if(s != 0)
+		{
+			std::vector<double> params = comp.getParameters();
+			params[solutionParameterIndex(comp)] = double(new_nodes[s-1]+1);
+			renumbered_comp.setParameters(std::move(params));
+		}
+
+		renumbered.addComponent(std::move(renumbered_comp));
+	}
+
+	renumbered.setNumberOfNodes(num_nodes);
+
+	return renumbered;
+}
+
+NetlistRenumberer::Ordering NetlistRenumberer::getOrdering(const std::string& name)
+{
+	if(name == "natural")
+		return NATURAL;
+	else if(name == "rcm")
+		return RCM;
+	else if(name == "amd")
+		return AMD;
+
+	throw std::invalid_argument("NetlistRenumberer::getOrdering(): unknown ordering \'" + name + "\'");
+}
+
+} //namespace lblmc
@@ -0,0 +1,294 @@
+/*
+
+Copyright (C) 2019-2020 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <cmath>
+
+#include "codegen/netlist/NetlistSynthesizer.hpp"
+
+namespace lblmc
+{
+
+NetlistSynthesizer::NetlistSynthesizer() :
+	params()
+{}
+
+NetlistSynthesizer::NetlistSynthesizer(const NetlistSynthesizerParameters& p) :
+	params(p)
+{}
+
+void NetlistSynthesizer::addComponent
+(
+	Netlist& netlist,
+	std::string type,
+	std::string label,
+	std::vector<double> parameters,
+	std::vector<unsigned int> terminals
+) const
+{
+	netlist.addComponent( ComponentListing(std::move(type), std::move(label), std::move(parameters), std::move(terminals)) );
+}
+
+void NetlistSynthesizer::addSlowComponent
+(
+	Netlist& netlist,
+	std::string type,
+	std::string label,
+	double value,
+	std::vector<unsigned int> terminals
+) const
+{
+	const unsigned int k = params.slow_rate_divisor;
+
+	if(k == 0)
+		throw std::invalid_argument("NetlistSynthesizer::addSlowComponent(): slow_rate_divisor must be 1 or greater");
+
+	ComponentListing listing(std::move(type), std::move(label), {params.dt*double(k), value}, std::move(terminals));
+	listing.setRate(k, netlist.getComponentsCount() % k);
+
+	netlist.addComponent( std::move(listing) );
+}
+
+void NetlistSynthesizer::addBusShunts(Netlist& netlist, const std::string& suffix, unsigned int node) const
+{
+	addSlowComponent(netlist, "Capacitor", "c_"+suffix, params.shunt_capacitance, {node, 0});
+	addComponent(netlist, "Resistor", "rl_"+suffix, {params.load_resistance}, {node, 0});
+}
+
+Netlist NetlistSynthesizer::synthesizeLadder(std::string model_name, unsigned int sections) const
+{
+	if(sections == 0)
+		throw std::invalid_argument("NetlistSynthesizer::synthesizeLadder(): number of sections must be 1 or greater");
+
+	Netlist netlist;
+	netlist.setModelName(model_name);
+
+	addComponent(netlist, "VoltageSource", "vs", {params.source_voltage, params.source_resistance}, {1, 0});
+
+		// section k spans from node 2k-1 through node 2k to node 2k+1
+
+	for(unsigned int k = 1; k <= sections; k++)
+	{
+		const std::string id = std::to_string(k);
+
+		addComponent(netlist, "Resistor", "r_"+id, {params.line_resistance}, {2*k-1, 2*k});
+		addSlowComponent(netlist, "Inductor", "l_"+id, params.line_inductance, {2*k, 2*k+1});
+		addBusShunts(netlist, id, 2*k+1);
+	}
+
+	return netlist;
+}
+
+Netlist NetlistSynthesizer::synthesizeMesh(std::string model_name, unsigned int rows, unsigned int cols) const
+{
+	if(rows == 0 || cols == 0)
+		throw std::invalid_argument("NetlistSynthesizer::synthesizeMesh(): number of rows and columns must be 1 or greater");
+
+	Netlist netlist;
+	netlist.setModelName(model_name);
+
+	auto node = [cols](unsigned int i, unsigned int j) { return i*cols+j+1; };
+
+	addComponent(netlist, "VoltageSource", "vs", {params.source_voltage, params.source_resistance}, {1, 0});
+
+	for(unsigned int i = 0; i < rows; i++)
+	{
+		for(unsigned int j = 0; j < cols; j++)
+		{
+			const std::string id = std::to_string(i)+"_"+std::to_string(j);
+
+			if(j+1 < cols)
+				addComponent(netlist, "Resistor", "r_"+id, {params.line_resistance}, {node(i,j), node(i,j+1)});
+
+			if(i+1 < rows)
+				addSlowComponent(netlist, "Inductor", "l_"+id, params.line_inductance, {node(i,j), node(i+1,j)});
+
+			addBusShunts(netlist, id, node(i,j));
+		}
+	}
+
+	return netlist;
+}
+
+Netlist NetlistSynthesizer::synthesizeFeeder(std::string model_name, unsigned int buses, unsigned int branching) const
+{
+	if(buses < 2)
+		throw std::invalid_argument("NetlistSynthesizer::synthesizeFeeder(): number of buses must be 2 or greater");
+
+	if(branching == 0)
+		throw std::invalid_argument("NetlistSynthesizer::synthesizeFeeder(): branching must be 1 or greater");
+
+	Netlist netlist;
+	netlist.setModelName(model_name);
+
+	addComponent(netlist, "VoltageSource", "vs", {params.source_voltage, params.source_resistance}, {1, 0});
+
+		// bus b is at node 2b-1 and its lateral from its parent bus passes through node 2b-2;
+		// buses are numbered breadth first so each bus has its branching children in sequence
+
+	for(unsigned int b = 2; b <= buses; b++)
+	{
+		const unsigned int parent = (b-2)/branching + 1;
+		const std::string id = std::to_string(b);
+
+		addComponent(netlist, "Resistor", "r_"+id, {params.line_resistance}, {2*parent-1, 2*b-2});
+		addSlowComponent(netlist, "Inductor", "l_"+id, params.line_inductance, {2*b-2, 2*b-1});
+		addBusShunts(netlist, id, 2*b-1);
+	}
+
+	return netlist;
+}
+
+Netlist NetlistSynthesizer::synthesizeMicrogrid(std::string model_name, unsigned int converters) const
+{
+	if(converters == 0)
+		throw std::invalid_argument("NetlistSynthesizer::synthesizeMicrogrid(): number of converters must be 1 or greater");
+
+	Netlist netlist;
+	netlist.setModelName(model_name);
+
+		// positive rail at node 1 and negative rail at node 2
+
+	addComponent(netlist, "VoltageSource", "vs_p", {params.source_voltage, params.source_resistance}, {1, 0});
+	addComponent(netlist, "VoltageSource", "vs_n", {params.source_voltage, params.source_resistance}, {0, 2});
+
+	unsigned int prev_p = 1;
+	unsigned int prev_n = 2;
+
+	for(unsigned int k = 1; k <= converters; k++)
+	{
+		const unsigned int base = 7*(k-1)+2;
+		const std::string id = std::to_string(k);
+
+		addSlowComponent(netlist, "Inductor", "lp_"+id, params.line_inductance, {prev_p, base+1});
+		addComponent(netlist, "Resistor", "rp_"+id, {params.line_resistance}, {base+1, base+2});
+		addSlowComponent(netlist, "Inductor", "ln_"+id, params.line_inductance, {base+3, prev_n});
+		addComponent(netlist, "Resistor", "rn_"+id, {params.line_resistance}, {base+4, base+3});
+
+		addComponent
+		(
+			netlist,
+			"BridgeConverter3LegIdealSwitches",
+			"conv_"+id,
+			{params.dt, params.converter_capacitance, params.converter_inductance, params.converter_resistance},
+			{base+2, 0, base+4, base+5, base+6, base+7}
+		);
+
+		addBusShunts(netlist, id+"a", base+5);
+		addBusShunts(netlist, id+"b", base+6);
+		addBusShunts(netlist, id+"c", base+7);
+
+		prev_p = base+2;
+		prev_n = base+4;
+	}
+
+	return netlist;
+}
+
+Netlist NetlistSynthesizer::synthesize(std::string model_name, Topology topology, unsigned int num_nodes, unsigned int branching) const
+{
+	auto nearest = [](double size, unsigned int min)
+	{
+		const double rounded = std::floor(size+0.5);
+		return rounded < double(min) ? min : (unsigned int)(rounded);
+	};
+
+	switch(topology)
+	{
+		case LADDER:
+			return synthesizeLadder(model_name, nearest((double(num_nodes)-1.0)/2.0, 1));
+
+		case MESH:
+		{
+			const unsigned int rows = nearest(std::sqrt(double(num_nodes)), 1);
+			return synthesizeMesh(model_name, rows, nearest(double(num_nodes)/double(rows), 1));
+		}
+
+		case FEEDER:
+			return synthesizeFeeder(model_name, nearest((double(num_nodes)+1.0)/2.0, 2), branching);
+
+		case MICROGRID:
+			return synthesizeMicrogrid(model_name, nearest((double(num_nodes)-2.0)/7.0, 1));
+	}
+
+	throw std::invalid_argument("NetlistSynthesizer::synthesize(): unknown topology");
+}
+
+NetlistSynthesizer::Topology NetlistSynthesizer::getTopology(const std::string& name)
+{
+	if(name == "ladder")
+		return LADDER;
+	else if(name == "mesh")
+		return MESH;
+	else if(name == "feeder")
+		return FEEDER;
+	else if(name == "microgrid")
+		return MICROGRID;
+
+	throw std::invalid_argument("NetlistSynthesizer::getTopology(): unknown topology \'" + name + "\'");
+}
+
+std::string NetlistSynthesizer::generateNetlistText(const Netlist& netlist, const std::string& comment)
+{
+	std::stringstream sstrm;
+
+	if(!comment.empty())
+	{
+		std::stringstream cstrm(comment);
+		std::string line;
+
+		while(std::getline(cstrm, line))
+			sstrm << (line.empty() ? "%" : "% ") << line << "\n";
+
+		sstrm << "\n";
+	}
+
+	sstrm << "#name " << netlist.getModelName() << "\n\n";
+
+	for(const auto& comp : netlist.getComponents())
+		sstrm << comp.toNetlistLine() << "\n";
+
+	return sstrm.str();
+}
+
+void NetlistSynthesizer::generateNetlistTextAndExport(const Netlist& netlist, std::string filename, const std::string& comment)
+{
+	if(filename == "")
+		throw std::invalid_argument("NetlistSynthesizer::generateNetlistTextAndExport(): filename cannot be null or empty");
+
+	std::ofstream file(filename.c_str(), std::ofstream::out | std::ofstream::trunc);
+
+	if(!file)
+		throw std::runtime_error("NetlistSynthesizer::generateNetlistTextAndExport(): failed to open or create file \'" + filename + "\'");
+
+	file << generateNetlistText(netlist, comment);
+
+	if(!file)
+		throw std::runtime_error("NetlistSynthesizer::generateNetlistTextAndExport(): failed to write file \'" + filename + "\'");
+}
+
+} //namespace lblmc
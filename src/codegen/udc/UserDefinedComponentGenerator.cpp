@@ -26,7 +26,6 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
 
 #include <exprpar/exprpar.hpp>
 
@@ -780,73 +779,43 @@ UserDefinedComponentGenerator::generateUpdateBody()
 	std::fixed <<
 	std::scientific;
 
-	std::string body = component_definition->getModelUpdateCode();
-
-	StringProcessor str_proc(body);
+	CodeTemplate::Substitutions subs;
 
 	//append component label to variables in model code
 
 	for(const auto& elem : component_definition->getParameters())
 	{
-		str_proc.replaceWordAll
-		(
-			elem.label,
-			appendName(elem.label)
-		);
+		subs.set(elem.label, appendName(elem.label));
 	}
 
 	for(const auto& elem : component_definition->getConstants())
 	{
-		str_proc.replaceWordAll
-		(
-			elem.label,
-			appendName(elem.label)
-		);
+		subs.set(elem.label, appendName(elem.label));
 	}
 
 	for(const auto& elem : component_definition->getPersistents())
 	{
-		str_proc.replaceWordAll
-		(
-			elem.label,
-			appendName(elem.label)
-		);
+		subs.set(elem.label, appendName(elem.label));
 	}
 
 	for(const auto& elem : component_definition->getTemporaries())
 	{
-		str_proc.replaceWordAll
-		(
-			elem.label,
-			appendName(elem.label)
-		);
+		subs.set(elem.label, appendName(elem.label));
 	}
 
 	for(const auto& elem : component_definition->getInputSignalPorts())
 	{
-		str_proc.replaceWordAll
-		(
-			elem.label,
-			appendName(elem.label)
-		);
+		subs.set(elem.label, appendName(elem.label));
 	}
 
 	for(const auto& elem : component_definition->getOutputSignalPorts())
 	{
-		str_proc.replaceWordAll
-		(
-			elem.label,
-			appendName(elem.label)
-		);
+		subs.set(elem.label, appendName(elem.label));
 	}
 
 	for(const auto& elem : terminal_node_assignments)
 	{
-		str_proc.replaceWordAll
-		(
-			elem.first,
-			std::to_string(elem.second)
-		);
+		subs.set(elem.first, std::to_string(elem.second));
 	}
 
 	for(const auto& elem : through_source_id_assignments)
@@ -855,11 +824,7 @@ UserDefinedComponentGenerator::generateUpdateBody()
 		sstrm.clear();
 		sstrm << "b_components["<< (elem.second - 1) <<"]";
 
-		str_proc.replaceWordAll
-		(
-			elem.first,
-			sstrm.str()
-		);
+		subs.set(elem.first, sstrm.str());
 	}
 
 	for(const auto& elem : across_source_id_assignments)
@@ -868,14 +833,10 @@ UserDefinedComponentGenerator::generateUpdateBody()
 		sstrm.clear();
 		sstrm << "b_components["<< (elem.second - 1) <<"]";
 
-		str_proc.replaceWordAll
-		(
-			elem.first,
-			sstrm.str()
-		);
+		subs.set(elem.first, sstrm.str());
 	}
 
-	return body;
+	return CodeTemplate(component_definition->getModelUpdateCode()).substitute(subs);
 }
 
 //==================================================================================================